@@ -0,0 +1,234 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_ACCUMULATE_HPP
+#define NANI_ACCUMULATE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <nani/meta.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <vector>
+
+namespace nani::accumulate {
+/* Number of elements handed to a thread at once. */
+inline constexpr std::size_t grain = 8192;
+
+/** Strategy
+ *
+ * How concurrent additions into the same target are made safe.
+ *
+ * - `atomic`     : component-wise `std::atomic_ref` additions straight into the field.
+ * - `privatized` : every thread adds into a private copy of the field, the copies are summed in
+ *                  parallel afterwards. Needs one field worth of memory per thread.
+ * - `striped`    : the targets are cut into one contiguous stripe per thread and the items are
+ *                  bucketed by stripe, so every thread owns its stripe and adds without atomics.
+ * - `automatic`  : choose one of the above with `choose`.
+ **/
+enum class strategy { atomic, privatized, striped, automatic };
+
+/* \brief target += value, component-wise atomic
+ *
+ * Each component is added atomically; the vector as a whole is not updated atomically, which is
+ * all that a sum needs.
+ */
+template <typename F, std::size_t N>
+void atomic_add(nani::vector<F, N>& target, nani::vector<F, N> const& value) noexcept;
+
+/* \brief Strategy used by `strategy::automatic` for `nitem` additions into `ntarget` targets
+ *
+ * The average number of additions per target measures contention. Atomics are cheapest when
+ * collisions are rare; when many items hit the same targets they serialize on cache lines, and
+ * the private buffers win as long as their merge (proportional to `ntarget * threads`) stays
+ * small compared to the scatter itself. Striping is the fallback that has neither cost.
+ */
+auto choose(std::size_t nitem, std::size_t ntarget, std::size_t nthread) noexcept -> strategy;
+
+/* \brief field[index[k]] += value[k], in parallel
+ *
+ * PreConditions : value.size() == index.size()
+ */
+template <typename F, std::size_t N, std::integral I>
+void scatter_add(
+  nani::soa_span<F const, N> value,
+  std::span<I const> index,
+  std::span<nani::vector<F, N>> field,
+  strategy s = strategy::automatic);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* Cut [0, n) into at most `nthread` blocks; returns the block length. */
+inline auto block_size(std::size_t n, std::size_t nthread) noexcept -> std::size_t
+{
+  auto const nblock = std::max<std::size_t>(1, std::min(nthread, (n + grain - 1) / grain));
+  return std::max<std::size_t>(1, (n + nblock - 1) / nblock);
+}
+
+template <typename F, std::size_t N, std::integral I>
+void scatter_atomic(
+  nani::soa_span<F const, N> const& value,
+  std::span<I const> index,
+  std::span<nani::vector<F, N>> field)
+{
+  nani::parallel_for(index.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t k = begin; k < end; ++k) {
+      atomic_add(field[static_cast<std::size_t>(index[k])], value.load(k));
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::integral I>
+void scatter_privatized(
+  nani::soa_span<F const, N> const& value,
+  std::span<I const> index,
+  std::span<nani::vector<F, N>> field,
+  std::size_t nthread)
+{
+  auto const block = block_size(index.size(), nthread);
+  auto const nblock = (index.size() + block - 1) / block;
+  auto buffer = std::vector<nani::vector<F, N>>(nblock * field.size());
+
+  nani::parallel_for(index.size(), block, [&](std::size_t begin, std::size_t end) {
+    auto* const local = buffer.data() + (begin / block) * field.size();
+    for (std::size_t k = begin; k < end; ++k) {
+      local[static_cast<std::size_t>(index[k])] += value.load(k);
+    }
+  });
+
+  nani::parallel_for(field.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t b = 0; b < nblock; ++b) {
+      auto const* const local = buffer.data() + b * field.size();
+      for (std::size_t i = begin; i < end; ++i) {
+        field[i] += local[i];
+      }
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::integral I>
+void scatter_striped(
+  nani::soa_span<F const, N> const& value,
+  std::span<I const> index,
+  std::span<nani::vector<F, N>> field,
+  std::size_t nthread)
+{
+  auto const stripe = block_size(field.size(), nthread);
+  auto const nstripe = (field.size() + stripe - 1) / stripe;
+  auto const block = block_size(index.size(), nthread);
+  auto const nblock = (index.size() + block - 1) / block;
+
+  // Counting sort of the items by stripe, stable within each stripe.
+  auto count = std::vector<std::size_t>(nblock * nstripe);
+  nani::parallel_for(index.size(), block, [&](std::size_t begin, std::size_t end) {
+    auto* const histogram = count.data() + (begin / block) * nstripe;
+    for (std::size_t k = begin; k < end; ++k) {
+      ++histogram[static_cast<std::size_t>(index[k]) / stripe];
+    }
+  });
+
+  auto start = std::vector<std::size_t>(nstripe + 1);
+  std::size_t offset = 0;
+  for (std::size_t s = 0; s < nstripe; ++s) {
+    start[s] = offset;
+    for (std::size_t b = 0; b < nblock; ++b) {
+      auto const c = count[b * nstripe + s];
+      count[b * nstripe + s] = offset;
+      offset += c;
+    }
+  }
+  start[nstripe] = offset;
+
+  auto bucket = std::vector<std::size_t>(index.size());
+  nani::parallel_for(index.size(), block, [&](std::size_t begin, std::size_t end) {
+    auto* const cursor = count.data() + (begin / block) * nstripe;
+    for (std::size_t k = begin; k < end; ++k) {
+      bucket[cursor[static_cast<std::size_t>(index[k]) / stripe]++] = k;
+    }
+  });
+
+  nani::parallel_for(nstripe, 1, [&](std::size_t first, std::size_t last) {
+    for (auto s = first; s < last; ++s) {
+      for (auto j = start[s]; j < start[s + 1]; ++j) {
+        auto const k = bucket[j];
+        field[static_cast<std::size_t>(index[k])] += value.load(k);
+      }
+    }
+  });
+}
+} // namespace detail
+
+template <typename F, std::size_t N>
+void atomic_add(nani::vector<F, N>& target, nani::vector<F, N> const& value) noexcept
+{
+  for (std::size_t c = 0; c < N; ++c) {
+    std::atomic_ref<F>(target[c]).fetch_add(value[c], std::memory_order_relaxed);
+  }
+}
+
+inline auto choose(std::size_t nitem, std::size_t ntarget, std::size_t nthread) noexcept
+  -> strategy
+{
+  if (nthread <= 1 or ntarget == 0) {
+    return strategy::striped;
+  }
+
+  // Below one addition per target on average, collisions between threads are rare.
+  auto const contention = static_cast<double>(nitem) / static_cast<double>(ntarget);
+  if (contention < 1.0) {
+    return strategy::atomic;
+  }
+
+  // The merge of the private buffers reads nthread * ntarget vectors; keep it well below the
+  // nitem additions it saves from being atomic.
+  if (nthread * ntarget <= nitem / 4) {
+    return strategy::privatized;
+  }
+  return strategy::striped;
+}
+
+template <typename F, std::size_t N, std::integral I>
+void scatter_add(
+  nani::soa_span<F const, N> value,
+  std::span<I const> index,
+  std::span<nani::vector<F, N>> field,
+  strategy s)
+{
+  meta::check_size(index.size(), value.size());
+
+  auto const nthread = nani::thread_count();
+  if (s == strategy::automatic) {
+    s = choose(index.size(), field.size(), nthread);
+  }
+
+  if (nthread <= 1) {
+    for (std::size_t k = 0; k < index.size(); ++k) {
+      field[static_cast<std::size_t>(index[k])] += value.load(k);
+    }
+    return;
+  }
+
+  switch (s) {
+  case strategy::atomic:
+    detail::scatter_atomic(value, index, field);
+    break;
+  case strategy::privatized:
+    detail::scatter_privatized(value, index, field, nthread);
+    break;
+  case strategy::striped:
+  case strategy::automatic:
+    detail::scatter_striped(value, index, field, nthread);
+    break;
+  }
+}
+} // namespace nani::accumulate
+
+#endif // NANI_ACCUMULATE_HPP
@@ -0,0 +1,79 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_ALIGNED_ALLOCATOR_HPP
+#define NANI_ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+
+namespace nani {
+/** Aligned Allocator
+ *
+ * Allocator for the storage of batched fields. The default alignment is a cache line, which is
+ * also wide enough for every SIMD register we target, so that component streams can be loaded and
+ * stored with aligned instructions.
+ **/
+template <typename T, std::size_t Alignment = 64>
+class aligned_allocator {
+public:
+  using value_type = T;
+  static constexpr auto alignment = std::align_val_t(Alignment);
+
+  template <typename U>
+  struct rebind {
+    using other = aligned_allocator<U, Alignment>;
+  };
+
+public:
+  aligned_allocator() = default;
+
+  template <typename U>
+  constexpr explicit aligned_allocator(aligned_allocator<U, Alignment> const& /*unused*/) noexcept;
+
+public:
+  [[nodiscard]] auto allocate(std::size_t n) -> T*;
+
+  void deallocate(T* p, std::size_t n) noexcept;
+};
+
+template <typename T, typename U, std::size_t Alignment>
+constexpr auto operator==(
+  aligned_allocator<T, Alignment> const& /*unused*/,
+  aligned_allocator<U, Alignment> const& /*unused*/) noexcept -> bool;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename T, std::size_t Alignment>
+template <typename U>
+constexpr aligned_allocator<T, Alignment>::aligned_allocator(
+  aligned_allocator<U, Alignment> const& /*unused*/) noexcept
+{
+}
+
+template <typename T, std::size_t Alignment>
+auto aligned_allocator<T, Alignment>::allocate(std::size_t n) -> T*
+{
+  return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+}
+
+template <typename T, std::size_t Alignment>
+void aligned_allocator<T, Alignment>::deallocate(T* p, std::size_t n) noexcept
+{
+  ::operator delete(p, n * sizeof(T), alignment);
+}
+
+template <typename T, typename U, std::size_t Alignment>
+constexpr auto operator==(
+  aligned_allocator<T, Alignment> const& /*unused*/,
+  aligned_allocator<U, Alignment> const& /*unused*/) noexcept -> bool
+{
+  return true;
+}
+} // namespace nani
+
+#endif // NANI_ALIGNED_ALLOCATOR_HPP
@@ -0,0 +1,575 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_CHOLESKY_HPP
+#define NANI_CHOLESKY_HPP
+
+#include <cstddef>
+#include <nani/factor.hpp>
+#include <nani/matrix.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/smath.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <type_traits>
+
+/** Cholesky and LDL^T Factorizations
+ *
+ * Factorizations of small symmetric matrices, A = L L^T for positive definite A and A = L D L^T
+ * with unit lower L and diagonal D for any A whose leading minors are nonzero. Both read only the
+ * lower triangle of A and take half the operations of an LU factorization. A factor is an object
+ * that is computed once and then solves any number of right-hand sides.
+ *
+ * The value type T is a scalar or a `pack`: a `cholesky_factor<pack<F, W>, R>` holds the factors
+ * of W matrices, one per lane, which is how the batched functions below factor and solve W
+ * matrices at once. The loops over R are unrolled for R up to 8.
+ **/
+namespace nani {
+/* Number of matrices handed to a thread at once by the batched functions. */
+inline constexpr std::size_t factor_grain = 1024;
+
+namespace detail::factor {
+struct access;
+} // namespace detail::factor
+
+template <typename T, std::size_t R>
+class cholesky_factor {
+public:
+  using value_type = T;
+  using matrix_type = nani::matrix<T, R, R>;
+  using vector_type = nani::vector<T, R>;
+  static constexpr std::size_t dim = R;
+
+public:
+  cholesky_factor() = default;
+
+  /* \brief Factor of a symmetric positive definite matrix, from its lower triangle
+   *
+   * PreConditions : a is positive definite (checked in debug builds for scalar T)
+   */
+  explicit cholesky_factor(matrix_type const& a);
+
+  /* \brief Factor from its lower triangular L, as returned by `lower()` */
+  static auto from_lower(matrix_type const& lower) noexcept -> cholesky_factor;
+
+public:
+  /* \brief L, with zeros above the diagonal */
+  auto lower() const noexcept -> matrix_type const&;
+
+  auto solve(vector_type const& b) const noexcept -> vector_type;
+
+  template <std::size_t C>
+  auto solve(nani::matrix<T, R, C> const& b) const noexcept -> nani::matrix<T, R, C>;
+
+  auto inverse() const noexcept -> matrix_type;
+
+  auto determinant() const noexcept -> T;
+
+private:
+  friend struct detail::factor::access;
+
+  matrix_type l_;
+  vector_type reciprocal_; // 1 / L[i][i], so that the solves do not divide
+};
+
+template <typename T, std::size_t R>
+class ldlt_factor {
+public:
+  using value_type = T;
+  using matrix_type = nani::matrix<T, R, R>;
+  using vector_type = nani::vector<T, R>;
+  static constexpr std::size_t dim = R;
+
+public:
+  ldlt_factor() = default;
+
+  /* \brief Factor of a symmetric matrix, from its lower triangle, without pivoting
+   *
+   * PreConditions : the leading principal minors of a are nonzero (checked in debug builds for
+   *                 scalar T)
+   */
+  explicit ldlt_factor(matrix_type const& a);
+
+  /* \brief Factor from its unit lower triangular L and diagonal D */
+  static auto from_parts(matrix_type const& lower, vector_type const& diagonal) noexcept
+    -> ldlt_factor;
+
+public:
+  /* \brief L, with ones on and zeros above the diagonal */
+  auto lower() const noexcept -> matrix_type const&;
+
+  /* \brief D */
+  auto diagonal() const noexcept -> vector_type const&;
+
+  auto solve(vector_type const& b) const noexcept -> vector_type;
+
+  template <std::size_t C>
+  auto solve(nani::matrix<T, R, C> const& b) const noexcept -> nani::matrix<T, R, C>;
+
+  auto inverse() const noexcept -> matrix_type;
+
+  auto determinant() const noexcept -> T;
+
+private:
+  friend struct detail::factor::access;
+
+  matrix_type l_;
+  vector_type d_;
+  vector_type reciprocal_; // 1 / D[i]
+};
+
+template <typename T, std::size_t R>
+auto cholesky(nani::matrix<T, R, R> const& a) -> cholesky_factor<T, R>;
+
+template <typename T, std::size_t R>
+auto ldlt(nani::matrix<T, R, R> const& a) -> ldlt_factor<T, R>;
+
+/* \brief factor[m] = cholesky(a[m]), SIMD across matrices
+ *
+ * PreConditions : factor.size() == a.size(), every a[m] is positive definite (checked in debug
+ *                 builds, once all matrices are factored)
+ */
+template <typename F, std::size_t R>
+void cholesky(
+  std::span<nani::matrix<F, R, R> const> a, std::span<cholesky_factor<F, R>> factor);
+
+/* \brief factor[m] = ldlt(a[m]), SIMD across matrices
+ *
+ * PreConditions : factor.size() == a.size(), the leading principal minors of every a[m] are
+ *                 nonzero (checked in debug builds, once all matrices are factored)
+ */
+template <typename F, std::size_t R>
+void ldlt(std::span<nani::matrix<F, R, R> const> a, std::span<ldlt_factor<F, R>> factor);
+
+/* \brief x[m] = factor[m].solve(b[m]), SIMD across matrices
+ *
+ * PreConditions : factor.size() == b.size() == x.size()
+ */
+template <typename F, std::size_t R>
+void solve(
+  std::span<cholesky_factor<F, R> const> factor,
+  std::span<nani::vector<F, R> const> b,
+  std::span<nani::vector<F, R>> x);
+
+template <typename F, std::size_t R>
+void solve(
+  std::span<ldlt_factor<F, R> const> factor,
+  std::span<nani::vector<F, R> const> b,
+  std::span<nani::vector<F, R>> x);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename T, std::size_t R>
+cholesky_factor<T, R>::cholesky_factor(matrix_type const& a) : l_(matrix_type::zero())
+{
+#pragma GCC unroll 8
+  for (std::size_t j = 0; j < R; ++j) {
+    auto pivot = a[j][j];
+#pragma GCC unroll 8
+    for (std::size_t k = 0; k < j; ++k) {
+      pivot -= l_[j][k] * l_[j][k];
+    }
+    detail::factor::check_pivot(pivot, true);
+    l_[j][j] = nani::sqrt(pivot);
+    reciprocal_[j] = T(1) / l_[j][j];
+
+#pragma GCC unroll 8
+    for (auto i = j + 1; i < R; ++i) {
+      auto s = a[i][j];
+#pragma GCC unroll 8
+      for (std::size_t k = 0; k < j; ++k) {
+        s -= l_[i][k] * l_[j][k];
+      }
+      l_[i][j] = s * reciprocal_[j];
+    }
+  }
+}
+
+template <typename T, std::size_t R>
+auto cholesky_factor<T, R>::from_lower(matrix_type const& lower) noexcept -> cholesky_factor
+{
+  auto result = cholesky_factor();
+  result.l_ = lower;
+  for (std::size_t i = 0; i < R; ++i) {
+    result.reciprocal_[i] = T(1) / lower[i][i];
+  }
+  return result;
+}
+
+template <typename T, std::size_t R>
+auto cholesky_factor<T, R>::lower() const noexcept -> matrix_type const&
+{
+  return l_;
+}
+
+template <typename T, std::size_t R>
+auto cholesky_factor<T, R>::solve(vector_type const& b) const noexcept -> vector_type
+{
+  auto x = b;
+  detail::factor::forward<false, R>(detail::factor::rows(l_), reciprocal_, x);
+  detail::factor::backward<false, R>(detail::factor::rows(l_), reciprocal_, x);
+  return x;
+}
+
+template <typename T, std::size_t R>
+template <std::size_t C>
+auto cholesky_factor<T, R>::solve(nani::matrix<T, R, C> const& b) const noexcept
+  -> nani::matrix<T, R, C>
+{
+  // Rows of b as vectors, so that the solves treat all columns at once.
+  auto x = nani::static_array<nani::vector<T, C>, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t c = 0; c < C; ++c) {
+      x[i][c] = b[i][c];
+    }
+  }
+  detail::factor::forward<false, R>(detail::factor::rows(l_), reciprocal_, x);
+  detail::factor::backward<false, R>(detail::factor::rows(l_), reciprocal_, x);
+
+  auto result = nani::matrix<T, R, C>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t c = 0; c < C; ++c) {
+      result[i][c] = x[i][c];
+    }
+  }
+  return result;
+}
+
+template <typename T, std::size_t R>
+auto cholesky_factor<T, R>::inverse() const noexcept -> matrix_type
+{
+  return solve(matrix_type::identity());
+}
+
+template <typename T, std::size_t R>
+auto cholesky_factor<T, R>::determinant() const noexcept -> T
+{
+  auto result = T(1);
+  for (std::size_t i = 0; i < R; ++i) {
+    result *= l_[i][i] * l_[i][i];
+  }
+  return result;
+}
+
+template <typename T, std::size_t R>
+ldlt_factor<T, R>::ldlt_factor(matrix_type const& a) : l_(matrix_type::identity())
+{
+  detail::factor::ldlt<R>(detail::factor::rows(a), detail::factor::rows(l_), d_, reciprocal_);
+}
+
+template <typename T, std::size_t R>
+auto ldlt_factor<T, R>::from_parts(matrix_type const& lower, vector_type const& diagonal) noexcept
+  -> ldlt_factor
+{
+  auto result = ldlt_factor();
+  result.l_ = lower;
+  result.d_ = diagonal;
+  for (std::size_t i = 0; i < R; ++i) {
+    result.reciprocal_[i] = T(1) / diagonal[i];
+  }
+  return result;
+}
+
+template <typename T, std::size_t R>
+auto ldlt_factor<T, R>::lower() const noexcept -> matrix_type const&
+{
+  return l_;
+}
+
+template <typename T, std::size_t R>
+auto ldlt_factor<T, R>::diagonal() const noexcept -> vector_type const&
+{
+  return d_;
+}
+
+template <typename T, std::size_t R>
+auto ldlt_factor<T, R>::solve(vector_type const& b) const noexcept -> vector_type
+{
+  auto x = b;
+  detail::factor::ldlt_solve<R>(detail::factor::rows(l_), reciprocal_, x);
+  return x;
+}
+
+template <typename T, std::size_t R>
+template <std::size_t C>
+auto ldlt_factor<T, R>::solve(nani::matrix<T, R, C> const& b) const noexcept
+  -> nani::matrix<T, R, C>
+{
+  // Rows of b as vectors, so that the solves treat all columns at once.
+  auto x = nani::static_array<nani::vector<T, C>, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t c = 0; c < C; ++c) {
+      x[i][c] = b[i][c];
+    }
+  }
+  detail::factor::ldlt_solve<R>(detail::factor::rows(l_), reciprocal_, x);
+
+  auto result = nani::matrix<T, R, C>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t c = 0; c < C; ++c) {
+      result[i][c] = x[i][c];
+    }
+  }
+  return result;
+}
+
+template <typename T, std::size_t R>
+auto ldlt_factor<T, R>::inverse() const noexcept -> matrix_type
+{
+  return solve(matrix_type::identity());
+}
+
+template <typename T, std::size_t R>
+auto ldlt_factor<T, R>::determinant() const noexcept -> T
+{
+  auto result = T(1);
+  for (std::size_t i = 0; i < R; ++i) {
+    result *= d_[i];
+  }
+  return result;
+}
+
+template <typename T, std::size_t R>
+auto cholesky(nani::matrix<T, R, R> const& a) -> cholesky_factor<T, R>
+{
+  return cholesky_factor<T, R>(a);
+}
+
+template <typename T, std::size_t R>
+auto ldlt(nani::matrix<T, R, R> const& a) -> ldlt_factor<T, R>
+{
+  return ldlt_factor<T, R>(a);
+}
+
+namespace detail::factor {
+/* Lower triangles of a[m] ... a[m + W - 1] as one matrix of packs. */
+template <std::size_t W, typename F, std::size_t R>
+inline auto load_lower(nani::matrix<F, R, R> const* a) noexcept
+  -> nani::matrix<nani::pack<F, W>, R, R>
+{
+  auto result = nani::matrix<nani::pack<F, W>, R, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < R; ++j) {
+      for (std::size_t l = 0; l < W; ++l) {
+        result[i][j].set(l, j <= i ? a[l][i][j] : F(0));
+      }
+    }
+  }
+  return result;
+}
+
+template <std::size_t W, typename F, std::size_t R>
+inline auto load(nani::vector<F, R> const* v) noexcept -> nani::vector<nani::pack<F, W>, R>
+{
+  auto result = nani::vector<nani::pack<F, W>, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t l = 0; l < W; ++l) {
+      result[i].set(l, v[l][i]);
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t W, std::size_t R>
+inline auto lane(nani::vector<nani::pack<F, W>, R> const& v, std::size_t l) noexcept
+  -> nani::vector<F, R>
+{
+  auto result = nani::vector<F, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    result[i] = v[i][l];
+  }
+  return result;
+}
+
+/* Moves factors between one per matrix and one of packs, lane l being matrix l, as they are:
+ * the reciprocals are copied rather than recomputed, and only the lower triangle is touched.
+ */
+struct access {
+  template <std::size_t W, typename F, std::size_t R>
+  static auto gather(cholesky_factor<F, R> const* f) noexcept
+    -> cholesky_factor<nani::pack<F, W>, R>
+  {
+    auto result = cholesky_factor<nani::pack<F, W>, R>();
+    result.l_ = nani::matrix<nani::pack<F, W>, R, R>::zero();
+    for (std::size_t l = 0; l < W; ++l) {
+      for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+          result.l_[i][j].set(l, f[l].l_[i][j]);
+        }
+        result.reciprocal_[i].set(l, f[l].reciprocal_[i]);
+      }
+    }
+    return result;
+  }
+
+  template <std::size_t W, typename F, std::size_t R>
+  static auto gather(ldlt_factor<F, R> const* f) noexcept -> ldlt_factor<nani::pack<F, W>, R>
+  {
+    auto result = ldlt_factor<nani::pack<F, W>, R>();
+    result.l_ = nani::matrix<nani::pack<F, W>, R, R>::identity();
+    for (std::size_t l = 0; l < W; ++l) {
+      for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+          result.l_[i][j].set(l, f[l].l_[i][j]);
+        }
+        result.d_[i].set(l, f[l].d_[i]);
+        result.reciprocal_[i].set(l, f[l].reciprocal_[i]);
+      }
+    }
+    return result;
+  }
+
+  template <typename F, std::size_t W, std::size_t R>
+  static void scatter(cholesky_factor<nani::pack<F, W>, R> const& f, cholesky_factor<F, R>* out)
+  {
+    for (std::size_t l = 0; l < W; ++l) {
+      out[l].l_ = nani::matrix<F, R, R>::zero();
+      for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+          out[l].l_[i][j] = f.l_[i][j][l];
+        }
+        out[l].reciprocal_[i] = f.reciprocal_[i][l];
+      }
+    }
+  }
+
+  template <typename F, std::size_t W, std::size_t R>
+  static void scatter(ldlt_factor<nani::pack<F, W>, R> const& f, ldlt_factor<F, R>* out)
+  {
+    for (std::size_t l = 0; l < W; ++l) {
+      out[l].l_ = nani::matrix<F, R, R>::identity();
+      for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+          out[l].l_[i][j] = f.l_[i][j][l];
+        }
+        out[l].d_[i] = f.d_[i][l];
+        out[l].reciprocal_[i] = f.reciprocal_[i][l];
+      }
+    }
+  }
+};
+
+/* Calls kernel(m, W) for the packs of W matrices in [0, n) and kernel(m, 1) for the rest, which
+ * go through packs of one lane so that no worker throws on a failed pivot check.
+ */
+template <std::size_t W, typename Kernel>
+void batched(std::size_t n, Kernel const& kernel)
+{
+  nani::parallel_for(n, factor_grain, [&](std::size_t begin, std::size_t end) {
+    auto m = begin;
+    for (; m + W <= end; m += W) {
+      kernel(m, std::integral_constant<std::size_t, W>());
+    }
+    for (; m < end; ++m) {
+      kernel(m, std::integral_constant<std::size_t, 1>());
+    }
+  });
+}
+
+template <typename F, std::size_t R, typename Factor>
+void check_factors(std::span<Factor const> factor, bool positive)
+{
+  if constexpr (meta::is_debug_build()) {
+    for (auto const& f : factor) {
+      for (std::size_t i = 0; i < R; ++i) {
+        if constexpr (requires { f.diagonal(); }) {
+          check_pivot(f.diagonal()[i], positive);
+        }
+        else {
+          check_pivot(f.lower()[i][i] * f.lower()[i][i], positive);
+        }
+      }
+    }
+  }
+}
+} // namespace detail::factor
+
+template <typename F, std::size_t R>
+void cholesky(
+  std::span<nani::matrix<F, R, R> const> a, std::span<cholesky_factor<F, R>> factor)
+{
+  meta::check_size(a.size(), factor.size());
+
+  // The pivots of matrices that are not positive definite, NaN or not positive, are checked
+  // once the workers are done, on the calling thread.
+  constexpr auto width = simd_width_v<F>;
+  detail::factor::batched<width>(a.size(), [&](std::size_t m, auto w) {
+    constexpr auto W = decltype(w)::value;
+    auto const f = cholesky_factor<nani::pack<F, W>, R>(detail::factor::load_lower<W>(&a[m]));
+    detail::factor::access::scatter(f, &factor[m]);
+  });
+  detail::factor::check_factors<F, R>(std::span<cholesky_factor<F, R> const>(factor), true);
+}
+
+template <typename F, std::size_t R>
+void ldlt(std::span<nani::matrix<F, R, R> const> a, std::span<ldlt_factor<F, R>> factor)
+{
+  meta::check_size(a.size(), factor.size());
+
+  constexpr auto width = simd_width_v<F>;
+  detail::factor::batched<width>(a.size(), [&](std::size_t m, auto w) {
+    constexpr auto W = decltype(w)::value;
+    auto const f = ldlt_factor<nani::pack<F, W>, R>(detail::factor::load_lower<W>(&a[m]));
+    detail::factor::access::scatter(f, &factor[m]);
+  });
+  detail::factor::check_factors<F, R>(std::span<ldlt_factor<F, R> const>(factor), false);
+}
+
+template <typename F, std::size_t R>
+void solve(
+  std::span<cholesky_factor<F, R> const> factor,
+  std::span<nani::vector<F, R> const> b,
+  std::span<nani::vector<F, R>> x)
+{
+  meta::check_size(factor.size(), b.size());
+  meta::check_size(factor.size(), x.size());
+
+  constexpr auto width = simd_width_v<F>;
+  detail::factor::batched<width>(factor.size(), [&](std::size_t m, auto w) {
+    constexpr auto W = decltype(w)::value;
+    if constexpr (W == 1) {
+      x[m] = factor[m].solve(b[m]);
+    }
+    else {
+      auto const f = detail::factor::access::gather<W>(&factor[m]);
+      auto const y = f.solve(detail::factor::load<W>(&b[m]));
+      for (std::size_t l = 0; l < W; ++l) {
+        x[m + l] = detail::factor::lane(y, l);
+      }
+    }
+  });
+}
+
+template <typename F, std::size_t R>
+void solve(
+  std::span<ldlt_factor<F, R> const> factor,
+  std::span<nani::vector<F, R> const> b,
+  std::span<nani::vector<F, R>> x)
+{
+  meta::check_size(factor.size(), b.size());
+  meta::check_size(factor.size(), x.size());
+
+  constexpr auto width = simd_width_v<F>;
+  detail::factor::batched<width>(factor.size(), [&](std::size_t m, auto w) {
+    constexpr auto W = decltype(w)::value;
+    if constexpr (W == 1) {
+      x[m] = factor[m].solve(b[m]);
+    }
+    else {
+      auto const f = detail::factor::access::gather<W>(&factor[m]);
+      auto const y = f.solve(detail::factor::load<W>(&b[m]));
+      for (std::size_t l = 0; l < W; ++l) {
+        x[m + l] = detail::factor::lane(y, l);
+      }
+    }
+  });
+}
+} // namespace nani
+
+#endif // NANI_CHOLESKY_HPP
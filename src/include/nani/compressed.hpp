@@ -0,0 +1,491 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_COMPRESSED_HPP
+#define NANI_COMPRESSED_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <nani/meta.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace nani {
+/** Compression
+ *
+ * How a `compressed_field` encodes its blocks.
+ *
+ * - `lossless` : bit-exact. Neighbouring values are stored as differences of their bit patterns,
+ *                which is compact for smooth fields.
+ * - `accuracy` : every value within `tolerance` of the original (plus the rounding to F). Values
+ *                are quantized to steps of 2 * tolerance before the differences are taken.
+ * - `rate`     : exactly `bits` bits per value, so the size is known in advance. Values are
+ *                stored relative to the largest magnitude in their block, with a relative error of
+ *                about 2^(2 - bits) of that magnitude.
+ **/
+struct compression {
+  enum class mode { lossless, accuracy, rate };
+
+  mode kind = mode::lossless;
+  double tolerance = 0;
+  unsigned bits = 0;
+
+  static constexpr auto lossless() noexcept -> compression;
+
+  /* PreConditions : tolerance > 0, |value| < 2^62 tolerance for every value */
+  static constexpr auto accuracy(double tolerance) noexcept -> compression;
+
+  /* PreConditions : 2 <= bits <= 62 */
+  static constexpr auto rate(unsigned bits) noexcept -> compression;
+};
+
+/** Compressed Field
+ *
+ * Read-mostly storage for cold fields of `vector<F, N>`: previous time levels, checkpoints,
+ * cached gradients. Every component stream is cut into blocks of `block_size` elements that are
+ * encoded independently, in the spirit of ZFP, so any block can be decoded on its own.
+ *
+ * - `load` gives random access through a small cache of decoded blocks.
+ * - `stream` decodes consecutive chunks in parallel and hands them, as SoA spans, to a batched
+ *   kernel, so a kernel reads a compressed field without it ever being expanded in full.
+ * - `decompress` expands the whole field.
+ *
+ * The field is immutable between calls of `assign`.
+ **/
+template <typename F, std::size_t N>
+class compressed_field {
+public:
+  static_assert(std::is_same_v<F, float> or std::is_same_v<F, double>);
+
+  using value_type = F;
+  using vector_type = nani::vector<F, N>;
+  using size_type = std::size_t;
+  static constexpr std::size_t dim = N;
+
+  /* Elements per block. */
+  static constexpr size_type block_size = 64;
+
+  /* Decoded blocks kept by `load`, direct mapped. */
+  static constexpr size_type cache_blocks = 8;
+
+  /* Elements per chunk of `stream`, a multiple of the block size. */
+  static constexpr size_type stream_grain = 64 * block_size;
+
+public:
+  compressed_field() = default;
+
+  compressed_field(nani::soa_span<F const, N> data, compression method);
+
+public:
+  auto size() const noexcept -> size_type;
+
+  auto nblock() const noexcept -> size_type;
+
+  auto method() const noexcept -> compression const&;
+
+  /* \brief Bytes held by the encoded blocks and their offsets */
+  auto bytes() const noexcept -> std::size_t;
+
+  /* \brief Replace the contents with `data`, encoded with the current method */
+  void assign(nani::soa_span<F const, N> data);
+
+public:
+  /* \brief Element i, decoding its block into the cache if needed
+   *
+   * Not thread safe, the cache is shared; concurrent readers use `decompress_block`.
+   */
+  auto load(size_type i) -> vector_type;
+
+  /* \brief Elements of block b into out
+   *
+   * PreConditions : out.size() == number of elements in block b
+   */
+  void decompress_block(size_type b, nani::soa_span<F, N> out) const;
+
+  /* \brief The whole field into out, in parallel
+   *
+   * PreConditions : out.size() == size()
+   */
+  void decompress(nani::soa_span<F, N> out) const;
+
+  /* \brief Call function(begin, values) for consecutive chunks of the field, in parallel
+   *
+   * `values` is an `soa_span<F const, N>` of the decoded elements [begin, begin + values.size()),
+   * valid during the call.
+   */
+  template <typename Function>
+  void stream(Function const& function) const;
+
+private:
+  compression method_;
+  size_type size_ = 0;
+  std::vector<std::uint64_t> word_;
+  std::vector<std::size_t> offset_;
+
+  std::vector<size_type> cached_;
+  std::vector<F> cache_;
+};
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+constexpr auto compression::lossless() noexcept -> compression
+{
+  return compression{mode::lossless, 0, 0};
+}
+
+constexpr auto compression::accuracy(double tolerance) noexcept -> compression
+{
+  return compression{mode::accuracy, tolerance, 0};
+}
+
+constexpr auto compression::rate(unsigned bits) noexcept -> compression
+{
+  return compression{mode::rate, 0, bits};
+}
+
+namespace detail::compressed {
+/* Appends bit fields to a word array, least significant bit first. */
+class bit_writer {
+public:
+  explicit bit_writer(std::vector<std::uint64_t>& word) noexcept
+  : word_(word), bit_(word.size() * 64)
+  {
+  }
+
+  void put(std::uint64_t value, unsigned width)
+  {
+    if (width == 0) {
+      return;
+    }
+    auto const shift = bit_ % 64;
+    if (shift == 0) {
+      word_.push_back(0);
+    }
+    word_.back() |= value << shift;
+    if (shift + width > 64) {
+      word_.push_back(value >> (64 - shift));
+    }
+    bit_ += width;
+  }
+
+private:
+  std::vector<std::uint64_t>& word_;
+  std::size_t bit_;
+};
+
+class bit_reader {
+public:
+  bit_reader(std::uint64_t const* word, std::size_t bit) noexcept : word_(word), bit_(bit) {}
+
+  auto get(unsigned width) noexcept -> std::uint64_t
+  {
+    if (width == 0) {
+      return 0;
+    }
+    auto const w = bit_ / 64;
+    auto const shift = bit_ % 64;
+    auto value = word_[w] >> shift;
+    if (shift + width > 64) {
+      value |= word_[w + 1] << (64 - shift);
+    }
+    if (width < 64) {
+      value &= (std::uint64_t{1} << width) - 1;
+    }
+    bit_ += width;
+    return value;
+  }
+
+private:
+  std::uint64_t const* word_;
+  std::size_t bit_;
+};
+
+inline auto zigzag(std::int64_t x) noexcept -> std::uint64_t
+{
+  return (static_cast<std::uint64_t>(x) << 1U) ^ static_cast<std::uint64_t>(x >> 63);
+}
+
+inline auto unzigzag(std::uint64_t z) noexcept -> std::int64_t
+{
+  return static_cast<std::int64_t>(z >> 1U) ^ -static_cast<std::int64_t>(z & 1U);
+}
+
+/* Unsigned integer of the size of F. */
+template <typename F>
+using bits_t = std::conditional_t<sizeof(F) == 4, std::uint32_t, std::uint64_t>;
+
+/* Bit pattern of x, remapped so that the integer order is the order of the values. */
+template <typename F>
+inline auto ordered(F x) noexcept -> bits_t<F>
+{
+  using U = bits_t<F>;
+  constexpr auto top = U{1} << (sizeof(U) * 8 - 1);
+  auto const u = std::bit_cast<U>(x);
+  return (u & top) != 0 ? static_cast<U>(~u) : static_cast<U>(u | top);
+}
+
+template <typename F>
+inline auto unordered(bits_t<F> k) noexcept -> F
+{
+  using U = bits_t<F>;
+  constexpr auto top = U{1} << (sizeof(U) * 8 - 1);
+  return std::bit_cast<F>((k & top) != 0 ? static_cast<U>(k & ~top) : static_cast<U>(~k));
+}
+
+/* Key of value i for the difference coding modes, and its inverse. */
+template <typename F>
+inline auto key(F x, compression const& method) noexcept -> std::uint64_t
+{
+  if (method.kind == compression::mode::lossless) {
+    return ordered(x);
+  }
+  return static_cast<std::uint64_t>(std::llround(double(x) / (2 * method.tolerance)));
+}
+
+template <typename F>
+inline auto value(std::uint64_t k, compression const& method) noexcept -> F
+{
+  if (method.kind == compression::mode::lossless) {
+    return unordered<F>(static_cast<bits_t<F>>(k));
+  }
+  return static_cast<F>(double(static_cast<std::int64_t>(k)) * (2 * method.tolerance));
+}
+
+/* Difference of two keys, modulo the key width. */
+template <typename F>
+inline auto difference(std::uint64_t a, std::uint64_t b, compression const& method) noexcept
+  -> std::int64_t
+{
+  if (method.kind == compression::mode::lossless) {
+    using S = std::make_signed_t<bits_t<F>>;
+    return static_cast<S>(static_cast<bits_t<F>>(a - b));
+  }
+  return static_cast<std::int64_t>(a - b);
+}
+
+/* One component stream of one block.
+ *
+ * Difference modes : width (8 bits), first key (64 bits), zigzagged differences (width bits each)
+ * Rate mode        : block exponent (16 bits), zigzagged scaled values (bits each)
+ */
+template <typename F>
+void encode(F const* x, std::size_t n, compression const& method, bit_writer& out)
+{
+  if (method.kind == compression::mode::rate) {
+    auto const largest = std::abs(double(*std::max_element(
+      x, x + n, [](F a, F b) { return std::abs(double(a)) < std::abs(double(b)); })));
+    auto exponent = 0;
+    std::frexp(largest, &exponent);
+    out.put(static_cast<std::uint16_t>(static_cast<std::int16_t>(exponent)), 16);
+
+    auto const limit = (std::int64_t{1} << (method.bits - 1)) - 1;
+    auto const shift = static_cast<int>(method.bits) - 1 - exponent;
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const q = std::llround(std::ldexp(double(x[i]), shift));
+      out.put(zigzag(std::clamp<std::int64_t>(q, -limit, limit)), method.bits);
+    }
+    return;
+  }
+
+  auto const first = key(x[0], method);
+  auto previous = first;
+  std::uint64_t largest = 0;
+  for (std::size_t i = 1; i < n; ++i) {
+    auto const k = key(x[i], method);
+    largest = std::max(largest, zigzag(difference<F>(k, previous, method)));
+    previous = k;
+  }
+
+  auto const width = static_cast<unsigned>(std::bit_width(largest));
+  out.put(width, 8);
+  out.put(first, 64);
+  previous = first;
+  for (std::size_t i = 1; i < n; ++i) {
+    auto const k = key(x[i], method);
+    out.put(zigzag(difference<F>(k, previous, method)), width);
+    previous = k;
+  }
+}
+
+template <typename F>
+void decode(bit_reader& in, compression const& method, F* x, std::size_t n) noexcept
+{
+  if (method.kind == compression::mode::rate) {
+    auto const exponent = static_cast<std::int16_t>(static_cast<std::uint16_t>(in.get(16)));
+    auto const shift = exponent + 1 - static_cast<int>(method.bits);
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = static_cast<F>(std::ldexp(double(unzigzag(in.get(method.bits))), shift));
+    }
+    return;
+  }
+
+  auto const width = static_cast<unsigned>(in.get(8));
+  auto k = in.get(64);
+  x[0] = value<F>(k, method);
+  for (std::size_t i = 1; i < n; ++i) {
+    k += static_cast<std::uint64_t>(unzigzag(in.get(width)));
+    x[i] = value<F>(k, method);
+  }
+}
+} // namespace detail::compressed
+
+template <typename F, std::size_t N>
+compressed_field<F, N>::compressed_field(nani::soa_span<F const, N> data, compression method)
+: method_(method)
+{
+  if constexpr (meta::is_debug_build()) {
+    auto const valid = method.kind == compression::mode::lossless
+                       or (method.kind == compression::mode::accuracy and method.tolerance > 0)
+                       or (method.kind == compression::mode::rate and method.bits >= 2
+                           and method.bits <= 62);
+    if (not valid) {
+      throw std::runtime_error("Invalid Compression");
+    }
+  }
+  assign(data);
+}
+
+template <typename F, std::size_t N>
+auto compressed_field<F, N>::size() const noexcept -> size_type
+{
+  return size_;
+}
+
+template <typename F, std::size_t N>
+auto compressed_field<F, N>::nblock() const noexcept -> size_type
+{
+  return (size_ + block_size - 1) / block_size;
+}
+
+template <typename F, std::size_t N>
+auto compressed_field<F, N>::method() const noexcept -> compression const&
+{
+  return method_;
+}
+
+template <typename F, std::size_t N>
+auto compressed_field<F, N>::bytes() const noexcept -> std::size_t
+{
+  return word_.size() * sizeof(std::uint64_t) + offset_.size() * sizeof(std::size_t);
+}
+
+template <typename F, std::size_t N>
+void compressed_field<F, N>::assign(nani::soa_span<F const, N> data)
+{
+  size_ = data.size();
+  auto const nb = nblock();
+
+  // Blocks are encoded in parallel into one word array per chunk, then concatenated.
+  constexpr auto grain = stream_grain / block_size;
+  auto const nchunk = (nb + grain - 1) / grain;
+  auto chunk = std::vector<std::vector<std::uint64_t>>(nchunk);
+  auto length = std::vector<std::size_t>(nb);
+
+  nani::parallel_for(nb, grain, [&](std::size_t first, std::size_t last) {
+    auto& word = chunk[first / grain];
+    for (auto b = first; b < last; ++b) {
+      // Every block starts on a fresh word.
+      auto const start = word.size();
+      auto out = detail::compressed::bit_writer(word);
+      auto const begin = b * block_size;
+      auto const n = std::min(block_size, size_ - begin);
+      for (std::size_t c = 0; c < N; ++c) {
+        detail::compressed::encode(data.data(c) + begin, n, method_, out);
+      }
+      length[b] = word.size() - start;
+    }
+  });
+
+  offset_.assign(nb + 1, 0);
+  for (std::size_t b = 0; b < nb; ++b) {
+    offset_[b + 1] = offset_[b] + length[b];
+  }
+
+  word_.assign(offset_[nb], 0);
+  nani::parallel_for(nchunk, 1, [&](std::size_t first, std::size_t last) {
+    for (auto k = first; k < last; ++k) {
+      std::copy(chunk[k].begin(), chunk[k].end(), word_.begin() + offset_[k * grain]);
+    }
+  });
+
+  cached_.assign(cache_blocks, std::numeric_limits<size_type>::max());
+  cache_.assign(cache_blocks * N * block_size, F(0));
+}
+
+template <typename F, std::size_t N>
+auto compressed_field<F, N>::load(size_type i) -> vector_type
+{
+  auto const b = i / block_size;
+  auto const slot = b % cache_blocks;
+  auto data = nani::static_array<F*, N>();
+  for (std::size_t c = 0; c < N; ++c) {
+    data[c] = cache_.data() + (slot * N + c) * block_size;
+  }
+
+  auto const block = nani::soa_span<F, N>(data, std::min(block_size, size_ - b * block_size));
+  if (cached_[slot] != b) {
+    decompress_block(b, block);
+    cached_[slot] = b;
+  }
+  return block.load(i - b * block_size);
+}
+
+template <typename F, std::size_t N>
+void compressed_field<F, N>::decompress_block(size_type b, nani::soa_span<F, N> out) const
+{
+  auto const n = std::min(block_size, size_ - b * block_size);
+  meta::check_size(n, out.size());
+
+  auto in = detail::compressed::bit_reader(word_.data(), offset_[b] * 64);
+  for (std::size_t c = 0; c < N; ++c) {
+    detail::compressed::decode(in, method_, out.data(c), n);
+  }
+}
+
+template <typename F, std::size_t N>
+void compressed_field<F, N>::decompress(nani::soa_span<F, N> out) const
+{
+  meta::check_size(size_, out.size());
+
+  nani::parallel_for(size_, stream_grain, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; i += block_size) {
+      decompress_block(i / block_size, out.subspan(i, std::min(block_size, end - i)));
+    }
+  });
+}
+
+template <typename F, std::size_t N>
+template <typename Function>
+void compressed_field<F, N>::stream(Function const& function) const
+{
+  // A range handed out by parallel_for may be the whole field, on one thread; it is still
+  // decoded one grain at a time into the same buffer.
+  nani::parallel_for(size_, stream_grain, [&](std::size_t begin, std::size_t end) {
+    auto buffer = nani::soa_field<F, N>(std::min(stream_grain, end - begin));
+    for (auto first = begin; first < end; first += stream_grain) {
+      auto const last = std::min(first + stream_grain, end);
+      auto const values = buffer.span().subspan(0, last - first);
+      for (auto i = first; i < last; i += block_size) {
+        decompress_block(
+          i / block_size, values.subspan(i - first, std::min(block_size, last - i)));
+      }
+      function(first, nani::soa_span<F const, N>(values));
+    }
+  });
+}
+} // namespace nani
+
+#endif // NANI_COMPRESSED_HPP
@@ -0,0 +1,134 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_FACTOR_HPP
+#define NANI_FACTOR_HPP
+
+#include <cstddef>
+#include <nani/meta.hpp>
+#include <stdexcept>
+#include <type_traits>
+
+/** Factorization Kernels
+ *
+ * The loops of the L D L^T factorization and of the triangular solves, shared by the dense
+ * factors of `cholesky.hpp` and the packed ones of `structured.hpp`. They read and write the lower
+ * triangle through an accessor `l(i, j)`, j <= i, so that one implementation serves any storage:
+ * `rows(m)` adapts a dense `matrix`, and the structured matrices are accessors themselves.
+ **/
+namespace nani::detail::factor {
+template <typename T>
+inline constexpr bool scalar = std::is_arithmetic_v<T>;
+
+/* The lower triangle of a dense matrix, as an accessor. */
+template <typename M>
+struct dense_rows {
+  M& m;
+
+  constexpr auto operator()(std::size_t i, std::size_t j) const noexcept -> decltype(auto)
+  {
+    return m[i][j];
+  }
+};
+
+template <typename M>
+constexpr auto rows(M& m) noexcept -> dense_rows<M>
+{
+  return dense_rows<M>{m};
+}
+
+/* Rejects a pivot that is not positive, or zero, in debug builds; scalar T only. */
+template <typename T>
+constexpr void check_pivot(T const& pivot, bool positive)
+{
+  if constexpr (meta::is_debug_build() and scalar<T>) {
+    if (positive ? not(pivot > T(0)) : not(pivot != T(0))) {
+      throw std::runtime_error(
+        positive ? "cholesky: matrix is not positive definite" : "ldlt: zero pivot");
+    }
+  }
+}
+
+/* y = L^-1 y for lower triangular L, with the reciprocals of its diagonal, or unit if Unit. */
+template <bool Unit, std::size_t R, typename L, typename D, typename V>
+constexpr void forward(L const& l, D const& reciprocal, V& y) noexcept
+{
+#pragma GCC unroll 8
+  for (std::size_t i = 0; i < R; ++i) {
+#pragma GCC unroll 8
+    for (std::size_t k = 0; k < i; ++k) {
+      y[i] -= l(i, k) * y[k];
+    }
+    if constexpr (not Unit) {
+      y[i] = reciprocal[i] * y[i];
+    }
+  }
+}
+
+/* x = L^-T x for lower triangular L, with the reciprocals of its diagonal, or unit if Unit. */
+template <bool Unit, std::size_t R, typename L, typename D, typename V>
+constexpr void backward(L const& l, D const& reciprocal, V& x) noexcept
+{
+#pragma GCC unroll 8
+  for (std::size_t n = 0; n < R; ++n) {
+    auto const i = R - 1 - n;
+#pragma GCC unroll 8
+    for (auto k = i + 1; k < R; ++k) {
+      x[i] -= l(k, i) * x[k];
+    }
+    if constexpr (not Unit) {
+      x[i] = reciprocal[i] * x[i];
+    }
+  }
+}
+
+/* Factors the symmetric matrix with lower triangle a(i, j) as L D L^T, without pivoting: L into
+ * the strict lower triangle of l, whose diagonal is left as it is, D into d and 1 / D into
+ * reciprocal. Zero pivots are checked with `check_pivot`.
+ */
+template <std::size_t R, typename A, typename L, typename D>
+constexpr void ldlt(A const& a, L&& l, D& d, D& reciprocal)
+{
+  using T = std::remove_cvref_t<decltype(d[0])>;
+
+  // w[k] = L[j][k] D[k] for the current column j, shared by every row below it.
+  auto w = D{};
+#pragma GCC unroll 8
+  for (std::size_t j = 0; j < R; ++j) {
+    auto pivot = T(a(j, j));
+#pragma GCC unroll 8
+    for (std::size_t k = 0; k < j; ++k) {
+      w[k] = l(j, k) * d[k];
+      pivot -= l(j, k) * w[k];
+    }
+    check_pivot(pivot, false);
+    d[j] = pivot;
+    reciprocal[j] = T(1) / pivot;
+
+#pragma GCC unroll 8
+    for (auto i = j + 1; i < R; ++i) {
+      auto s = T(a(i, j));
+#pragma GCC unroll 8
+      for (std::size_t k = 0; k < j; ++k) {
+        s -= l(i, k) * w[k];
+      }
+      l(i, j) = s * reciprocal[j];
+    }
+  }
+}
+
+/* x = (L D L^T)^-1 x for unit lower L and the reciprocals of D. */
+template <std::size_t R, typename L, typename D, typename V>
+constexpr void ldlt_solve(L const& l, D const& reciprocal, V& x) noexcept
+{
+  forward<true, R>(l, reciprocal, x);
+  for (std::size_t i = 0; i < R; ++i) {
+    x[i] = reciprocal[i] * x[i];
+  }
+  backward<true, R>(l, reciprocal, x);
+}
+} // namespace nani::detail::factor
+
+#endif // NANI_FACTOR_HPP
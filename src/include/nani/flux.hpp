@@ -0,0 +1,395 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_FLUX_HPP
+#define NANI_FLUX_HPP
+
+#include <cstddef>
+#include <nani/gas.hpp>
+#include <nani/isa.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <type_traits>
+
+/** Numerical Fluxes for the two-dimensional Euler Equations
+ *
+ * States are conservative, u = (rho, rho u, rho v, E) with E the total energy per unit volume, and
+ * normals have unit length. Every function is a template over the lane type `T`: with `T = F` it
+ * evaluates one face, with `T = pack<F, W>` it evaluates W faces at once. The Riemann solvers are
+ * written without branches on the wave pattern (upwinding is done with `min`, `max` and `sign`),
+ * so that the lanes of a pack never diverge.
+ *
+ * `Gas` provides `pressure`, `sound_speed` and `gamma` (see `ideal_gas`). Roe averages are taken
+ * for a calorically perfect gas.
+ **/
+namespace nani::flux {
+/* Number of faces handed to a thread at once. */
+inline constexpr std::size_t grain = 4096;
+
+/* Width of the Harten entropy fix in the Roe flux, as a fraction of the averaged sound speed. */
+inline constexpr double harten = 0.1;
+
+enum class scheme { rusanov, hll, hllc, roe };
+
+/* \brief Exact flux F(u) . n */
+template <typename T, typename Gas>
+constexpr auto physical(
+  nani::vector<T, 4> const& u, nani::vector<T, 2> const& n, Gas const& gas) noexcept
+  -> nani::vector<T, 4>;
+
+/* \brief Local Lax-Friedrichs: central flux plus the largest wave speed times the jump */
+template <typename T, typename Gas>
+constexpr auto rusanov(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>;
+
+/* \brief Harten-Lax-van Leer with Einfeldt wave speed estimates */
+template <typename T, typename Gas>
+constexpr auto hll(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>;
+
+/* \brief HLL with the contact wave restored (Toro) */
+template <typename T, typename Gas>
+constexpr auto hllc(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>;
+
+/* \brief Roe flux difference splitting with the Harten entropy fix on the acoustic waves */
+template <typename T, typename Gas>
+constexpr auto roe(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>;
+
+template <scheme S, typename T, typename Gas>
+constexpr auto numerical(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>;
+
+/* \brief flux[f] = length[f] * numerical<S>(left[f], right[f], normal[f])
+ *
+ * SIMD across faces. `float` and `double` with `ideal_gas` are compiled once per instruction set
+ * into libnani and selected at run time (see `active_isa`).
+ *
+ * PreConditions : left, right, normal, length and flux have the same size
+ */
+template <scheme S, typename F, typename Gas>
+void evaluate(
+  nani::soa_span<F const, 4> left,
+  nani::soa_span<F const, 4> right,
+  nani::soa_span<F const, 2> normal,
+  std::span<F const> length,
+  Gas const& gas,
+  nani::soa_span<F, 4> flux);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* Primitive quantities of one side of a face. */
+template <typename T>
+struct state {
+  T rho;
+  T u;
+  T v;
+  T un;
+  T p;
+  T c;
+  T h;
+};
+
+template <typename T, typename Gas>
+constexpr auto decode(
+  nani::vector<T, 4> const& q, nani::vector<T, 2> const& n, Gas const& gas) noexcept -> state<T>
+{
+  auto const rho = q[0];
+  auto const u = q[1] / rho;
+  auto const v = q[2] / rho;
+  auto const p = gas.pressure(rho, q[3] - T(0.5) * (q[1] * u + q[2] * v));
+  return {rho, u, v, u * n[0] + v * n[1], p, gas.sound_speed(rho, p), (q[3] + p) / rho};
+}
+
+template <typename T>
+constexpr auto physical(
+  nani::vector<T, 4> const& q, state<T> const& s, nani::vector<T, 2> const& n) noexcept
+  -> nani::vector<T, 4>
+{
+  return nani::vector<T, 4>(
+    s.rho * s.un, q[1] * s.un + s.p * n[0], q[2] * s.un + s.p * n[1], (q[3] + s.p) * s.un);
+}
+
+/* Roe averaged state of a face. */
+template <typename T, typename Gas>
+constexpr auto average(
+  state<T> const& l, state<T> const& r, nani::vector<T, 2> const& n, Gas const& gas) noexcept
+  -> state<T>
+{
+  auto const sl = nani::sqrt(l.rho);
+  auto const sr = nani::sqrt(r.rho);
+  auto const wl = sl / (sl + sr);
+  auto const wr = T(1) - wl;
+
+  auto const u = wl * l.u + wr * r.u;
+  auto const v = wl * l.v + wr * r.v;
+  auto const h = wl * l.h + wr * r.h;
+  auto const c = nani::sqrt(T(gas.gamma - 1) * (h - T(0.5) * (u * u + v * v)));
+  return {sl * sr, u, v, u * n[0] + v * n[1], T(0), c, h};
+}
+
+/* Einfeldt estimates of the slowest and the fastest wave. */
+template <typename T>
+constexpr auto left_speed(state<T> const& l, state<T> const& a) noexcept -> T
+{
+  return nani::min(l.un - l.c, a.un - a.c);
+}
+
+template <typename T>
+constexpr auto right_speed(state<T> const& r, state<T> const& a) noexcept -> T
+{
+  return nani::max(r.un + r.c, a.un + a.c);
+}
+
+/* HLLC state between the wave of speed `s` and the contact of speed `sm`. */
+template <typename T>
+constexpr auto star(
+  nani::vector<T, 4> const& q,
+  state<T> const& k,
+  T const& s,
+  T const& sm,
+  nani::vector<T, 2> const& n) noexcept -> nani::vector<T, 4>
+{
+  auto const factor = k.rho * (s - k.un) / (s - sm);
+  auto const jump = sm - k.un;
+  return nani::vector<T, 4>(
+    factor,
+    factor * (k.u + jump * n[0]),
+    factor * (k.v + jump * n[1]),
+    factor * (q[3] / k.rho + jump * (sm + k.p / (k.rho * (s - k.un)))));
+}
+
+/* |lambda|, smoothed to a parabola within `delta` of zero. */
+template <typename T>
+constexpr auto entropy_fix(T const& lambda, T const& delta) noexcept -> T
+{
+  auto const a = nani::abs(lambda);
+  auto const d = nani::max(delta - a, T(0));
+  return a + d * d / (T(2) * delta);
+}
+
+template <scheme S, typename F, std::size_t W, typename Gas>
+inline void evaluate_range(
+  nani::soa_span<F const, 4> const& left,
+  nani::soa_span<F const, 4> const& right,
+  nani::soa_span<F const, 2> const& normal,
+  F const* length,
+  Gas const& gas,
+  nani::soa_span<F, 4> const& flux,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  using pack_type = nani::pack<F, W>;
+
+  auto i = begin;
+  for (; i + W <= end; i += W) {
+    auto const f = nani::flux::numerical<S>(
+      left.template load_pack<W>(i),
+      right.template load_pack<W>(i),
+      normal.template load_pack<W>(i),
+      gas);
+    flux.template store_pack<W>(i, f * pack_type::load(length + i));
+  }
+  for (; i < end; ++i) {
+    auto const f = nani::flux::numerical<S>(left.load(i), right.load(i), normal.load(i), gas);
+    flux.store(i, f * length[i]);
+  }
+}
+
+/* Value and gas types for which libnani carries one flux kernel per instruction set. */
+template <typename F, typename Gas>
+inline constexpr bool dispatched
+  = (std::is_same_v<F, float> or std::is_same_v<F, double>)
+    and std::is_same_v<Gas, nani::ideal_gas<F>>;
+
+/* One copy of `evaluate_range` per instruction set, selected by `target`; in libnani. */
+template <scheme S, typename F>
+void evaluate_dispatch(
+  isa target,
+  nani::soa_span<F const, 4> const& left,
+  nani::soa_span<F const, 4> const& right,
+  nani::soa_span<F const, 2> const& normal,
+  F const* length,
+  nani::ideal_gas<F> const& gas,
+  nani::soa_span<F, 4> const& flux,
+  std::size_t begin,
+  std::size_t end) noexcept;
+} // namespace detail
+
+template <typename T, typename Gas>
+constexpr auto physical(
+  nani::vector<T, 4> const& u, nani::vector<T, 2> const& n, Gas const& gas) noexcept
+  -> nani::vector<T, 4>
+{
+  return detail::physical(u, detail::decode(u, n, gas), n);
+}
+
+template <typename T, typename Gas>
+constexpr auto rusanov(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>
+{
+  auto const l = detail::decode(ul, n, gas);
+  auto const r = detail::decode(ur, n, gas);
+  auto const s = nani::max(nani::abs(l.un) + l.c, nani::abs(r.un) + r.c);
+  return T(0.5) * (detail::physical(ul, l, n) + detail::physical(ur, r, n) - s * (ur - ul));
+}
+
+template <typename T, typename Gas>
+constexpr auto hll(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>
+{
+  auto const l = detail::decode(ul, n, gas);
+  auto const r = detail::decode(ur, n, gas);
+  auto const a = detail::average(l, r, n, gas);
+
+  // Clipping the speeds at zero turns the HLL formula into the upwind flux for supersonic faces.
+  auto const sl = nani::min(detail::left_speed(l, a), T(0));
+  auto const sr = nani::max(detail::right_speed(r, a), T(0));
+  auto const fl = detail::physical(ul, l, n);
+  auto const fr = detail::physical(ur, r, n);
+  return (sr * fl - sl * fr + (sr * sl) * (ur - ul)) / (sr - sl);
+}
+
+template <typename T, typename Gas>
+constexpr auto hllc(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>
+{
+  auto const l = detail::decode(ul, n, gas);
+  auto const r = detail::decode(ur, n, gas);
+  auto const a = detail::average(l, r, n, gas);
+  auto const sl = detail::left_speed(l, a);
+  auto const sr = detail::right_speed(r, a);
+
+  auto const ml = l.rho * (sl - l.un);
+  auto const mr = r.rho * (sr - r.un);
+  auto const sm = (r.p - l.p + ml * l.un - mr * r.un) / (ml - mr);
+
+  // F*L = FL + min(sL, 0) (U*L - UL) equals FL for a supersonic face, likewise on the right;
+  // the sign of the contact speed picks the side.
+  auto const fl = detail::physical(ul, l, n)
+                  + nani::min(sl, T(0)) * (detail::star(ul, l, sl, sm, n) - ul);
+  auto const fr = detail::physical(ur, r, n)
+                  + nani::max(sr, T(0)) * (detail::star(ur, r, sr, sm, n) - ur);
+  auto const wl = T(0.5) * (T(1) + nani::sign(sm));
+  return wl * fl + (T(1) - wl) * fr;
+}
+
+template <typename T, typename Gas>
+constexpr auto roe(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>
+{
+  auto const l = detail::decode(ul, n, gas);
+  auto const r = detail::decode(ur, n, gas);
+  auto const a = detail::average(l, r, n, gas);
+
+  auto const drho = r.rho - l.rho;
+  auto const dp = r.p - l.p;
+  auto const du = r.u - l.u;
+  auto const dv = r.v - l.v;
+  auto const dun = r.un - l.un;
+  auto const c2 = a.c * a.c;
+  auto const delta = T(harten) * a.c;
+
+  // Wave strengths times |eigenvalue|: acoustic (1, 3), entropy (2) and shear (4).
+  auto const w1 = detail::entropy_fix(a.un - a.c, delta) * (dp - a.rho * a.c * dun) / (T(2) * c2);
+  auto const w3 = detail::entropy_fix(a.un + a.c, delta) * (dp + a.rho * a.c * dun) / (T(2) * c2);
+  auto const w2 = nani::abs(a.un) * (drho - dp / c2);
+  auto const w4 = nani::abs(a.un) * a.rho;
+
+  auto const dissipation = nani::vector<T, 4>(
+    w1 + w2 + w3,
+    w1 * (a.u - a.c * n[0]) + w2 * a.u + w4 * (du - dun * n[0]) + w3 * (a.u + a.c * n[0]),
+    w1 * (a.v - a.c * n[1]) + w2 * a.v + w4 * (dv - dun * n[1]) + w3 * (a.v + a.c * n[1]),
+    w1 * (a.h - a.c * a.un) + w2 * T(0.5) * (a.u * a.u + a.v * a.v)
+      + w4 * (a.u * du + a.v * dv - a.un * dun) + w3 * (a.h + a.c * a.un));
+  return T(0.5) * (detail::physical(ul, l, n) + detail::physical(ur, r, n) - dissipation);
+}
+
+template <scheme S, typename T, typename Gas>
+constexpr auto numerical(
+  nani::vector<T, 4> const& ul,
+  nani::vector<T, 4> const& ur,
+  nani::vector<T, 2> const& n,
+  Gas const& gas) noexcept -> nani::vector<T, 4>
+{
+  if constexpr (S == scheme::rusanov) {
+    return flux::rusanov(ul, ur, n, gas);
+  }
+  else if constexpr (S == scheme::hll) {
+    return flux::hll(ul, ur, n, gas);
+  }
+  else if constexpr (S == scheme::hllc) {
+    return flux::hllc(ul, ur, n, gas);
+  }
+  else {
+    return flux::roe(ul, ur, n, gas);
+  }
+}
+
+template <scheme S, typename F, typename Gas>
+void evaluate(
+  nani::soa_span<F const, 4> left,
+  nani::soa_span<F const, 4> right,
+  nani::soa_span<F const, 2> normal,
+  std::span<F const> length,
+  Gas const& gas,
+  nani::soa_span<F, 4> flux)
+{
+  meta::check_size(left.size(), flux.size());
+  meta::check_size(right.size(), flux.size());
+  meta::check_size(normal.size(), flux.size());
+  meta::check_size(length.size(), flux.size());
+
+  auto const target = nani::active_isa();
+  nani::parallel_for(flux.size(), grain, [&](std::size_t begin, std::size_t end) {
+    if constexpr (detail::dispatched<F, Gas>) {
+      detail::evaluate_dispatch<S>(
+        target, left, right, normal, length.data(), gas, flux, begin, end);
+    }
+    else {
+      detail::evaluate_range<S, F, nani::simd_width_v<F>>(
+        left, right, normal, length.data(), gas, flux, begin, end);
+    }
+  });
+}
+} // namespace nani::flux
+
+#endif // NANI_FLUX_HPP
@@ -0,0 +1,105 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_GAS_HPP
+#define NANI_GAS_HPP
+
+#include <nani/smath.hpp>
+
+namespace nani {
+/** Ideal Gas
+ *
+ * Calorically perfect gas, p = (gamma - 1) rho e. Energies are per unit volume. The member
+ * functions are templates over the value type, so that the same gas serves scalar code and
+ * `pack` code evaluating several faces or cells at once.
+ *
+ * Together with `stiffened_gas` this is the equation of state policy interface of the Euler
+ * kernels: `gamma`, `pressure`, `internal_energy` and `sound_speed`.
+ **/
+template <typename F>
+struct ideal_gas {
+  F gamma = F(1.4);
+
+  /* \brief Pressure from the density and the internal energy per unit volume */
+  template <typename T>
+  constexpr auto pressure(T const& rho, T const& rho_e) const noexcept -> T;
+
+  /* \brief Internal energy per unit volume from the density and the pressure */
+  template <typename T>
+  constexpr auto internal_energy(T const& rho, T const& p) const noexcept -> T;
+
+  template <typename T>
+  constexpr auto sound_speed(T const& rho, T const& p) const noexcept -> T;
+};
+
+/** Stiffened Gas
+ *
+ * p = (gamma - 1) rho e - gamma pinf, the usual model for liquids under pressure. With pinf = 0
+ * it is the ideal gas.
+ **/
+template <typename F>
+struct stiffened_gas {
+  F gamma = F(4.4);
+  F pinf = F(6e8);
+
+  template <typename T>
+  constexpr auto pressure(T const& rho, T const& rho_e) const noexcept -> T;
+
+  template <typename T>
+  constexpr auto internal_energy(T const& rho, T const& p) const noexcept -> T;
+
+  template <typename T>
+  constexpr auto sound_speed(T const& rho, T const& p) const noexcept -> T;
+};
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename F>
+template <typename T>
+constexpr auto ideal_gas<F>::pressure(T const& /*rho*/, T const& rho_e) const noexcept -> T
+{
+  return T(gamma - F(1)) * rho_e;
+}
+
+template <typename F>
+template <typename T>
+constexpr auto ideal_gas<F>::internal_energy(T const& /*rho*/, T const& p) const noexcept -> T
+{
+  return p / T(gamma - F(1));
+}
+
+template <typename F>
+template <typename T>
+constexpr auto ideal_gas<F>::sound_speed(T const& rho, T const& p) const noexcept -> T
+{
+  return nani::sqrt(T(gamma) * p / rho);
+}
+
+template <typename F>
+template <typename T>
+constexpr auto stiffened_gas<F>::pressure(T const& /*rho*/, T const& rho_e) const noexcept -> T
+{
+  return T(gamma - F(1)) * rho_e - T(gamma * pinf);
+}
+
+template <typename F>
+template <typename T>
+constexpr auto stiffened_gas<F>::internal_energy(T const& /*rho*/, T const& p) const noexcept
+  -> T
+{
+  return (p + T(gamma * pinf)) / T(gamma - F(1));
+}
+
+template <typename F>
+template <typename T>
+constexpr auto stiffened_gas<F>::sound_speed(T const& rho, T const& p) const noexcept -> T
+{
+  return nani::sqrt(T(gamma) * (p + T(pinf)) / rho);
+}
+} // namespace nani
+
+#endif // NANI_GAS_HPP
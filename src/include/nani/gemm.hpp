@@ -0,0 +1,296 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_GEMM_HPP
+#define NANI_GEMM_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <nani/matrix.fwd.hpp>
+#include <nani/static_array.hpp>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// The packed kernels rely on the GNU vector extensions; other compilers use `outer` in their place.
+#if defined(__GNUC__)
+#include <nani/pack.hpp>
+#endif
+
+/** Small Matrix Products
+ *
+ * A family of kernels for c = a * b with a of shape R x S and b of shape S x T, all known at
+ * compile time. Which one is fastest depends on the shape and on the processor, so every variant
+ * is generated for every shape and the choice is a table, `tuned<F, R, S, T>`:
+ *
+ * - `inner`    : one dot product per entry of c, the textbook loop order
+ * - `outer`    : rows of c accumulated as a[i][k] * (row k of b), contiguous in the inner loop
+ * - `unrolled` : `outer` with the loops over k and j unrolled at compile time
+ * - `packed`   : rows of c held in SIMD packs across k
+ * - `tiled`    : `packed`, four rows of c at a time, so that every pack of b loaded is used four
+ *                times
+ *
+ * Without tuning, `tuned` is a heuristic. The `nani-gemm-autotune` tool (built with
+ * NANI_BUILD_TOOLS) times every variant on the host and writes a header `nani/gemm.tuned.hpp` of
+ * specializations of `tuned`; if that header is on the include path, it overrides the heuristic
+ * for the shapes it lists. The timings hold for the compilation flags of the tool, so a build
+ * should use the table generated with its own flags.
+ **/
+namespace nani::gemm {
+enum class variant { inner, outer, unrolled, packed, tiled };
+
+/* \brief The variant used for the shape (R, S, T), unless one is given explicitly */
+template <typename F, std::size_t R, std::size_t S, std::size_t T>
+struct tuned;
+
+template <typename F, std::size_t R, std::size_t S, std::size_t T>
+inline constexpr variant tuned_v = tuned<F, R, S, T>::value;
+
+/* \brief c = a * b with the kernel variant V
+ *
+ * The `packed` and `tiled` variants load rows of b and c as packs, which needs owning matrices
+ * of an arithmetic type and GCC or Clang; for views, other value types (such as `dual`) and other
+ * compilers they fall back to `outer`.
+ *
+ * PreConditions : c shares no storage with a or b
+ */
+template <variant V, matrix_like A, matrix_like B, matrix_like C>
+  requires std::is_same_v<matrix_value_t<A>, matrix_value_t<B>>
+           and std::is_same_v<matrix_value_t<A>, matrix_value_t<C>>
+           and (matrix_cols_v<A> == matrix_rows_v<B>) and (matrix_rows_v<A> == matrix_rows_v<C>)
+           and (matrix_cols_v<B> == matrix_cols_v<C>)
+void multiply(A const& a, B const& b, C& c) noexcept;
+
+/* \brief c = a * b with the variant `tuned_v` of the shape */
+template <matrix_like A, matrix_like B, matrix_like C>
+  requires std::is_same_v<matrix_value_t<A>, matrix_value_t<B>>
+           and std::is_same_v<matrix_value_t<A>, matrix_value_t<C>>
+           and (matrix_cols_v<A> == matrix_rows_v<B>) and (matrix_rows_v<A> == matrix_rows_v<C>)
+           and (matrix_cols_v<B> == matrix_cols_v<C>)
+void multiply(A const& a, B const& b, C& c) noexcept;
+
+constexpr auto to_string(variant v) noexcept -> std::string_view;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* Types whose rows are contiguous arrays, which the packed kernels load from. */
+template <typename T>
+inline constexpr bool contiguous = false;
+
+template <typename F, std::size_t R, std::size_t C>
+inline constexpr bool contiguous<nani::matrix<F, R, C>> = true;
+
+/* Default for shapes without a tuned entry: dot products for a single column, packs once a row of
+ * c fills a register, and the contiguous loop order of `outer` in between.
+ */
+template <typename F, std::size_t R, std::size_t S, std::size_t T>
+constexpr auto heuristic() noexcept -> variant
+{
+  if (T == 1) {
+    return variant::inner;
+  }
+#if defined(__GNUC__)
+  return T < simd_width_v<F> ? variant::outer : variant::packed;
+#else
+  return variant::outer;
+#endif
+}
+
+template <typename F, std::size_t R, std::size_t S, std::size_t T, typename A, typename B,
+          typename C>
+inline void inner(A const& a, B const& b, C& c) noexcept
+{
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < T; ++j) {
+      auto sum = F(0);
+      for (std::size_t k = 0; k < S; ++k) {
+        sum += a[i][k] * b[k][j];
+      }
+      c[i][j] = sum;
+    }
+  }
+}
+
+template <typename F, std::size_t R, std::size_t S, std::size_t T, typename A, typename B,
+          typename C>
+inline void outer(A const& a, B const& b, C& c) noexcept
+{
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < T; ++j) {
+      c[i][j] = F(0);
+    }
+    for (std::size_t k = 0; k < S; ++k) {
+      auto const x = a[i][k];
+      for (std::size_t j = 0; j < T; ++j) {
+        c[i][j] += x * b[k][j];
+      }
+    }
+  }
+}
+
+template <typename F, std::size_t J, typename A, typename B, std::size_t... K>
+inline auto unrolled_entry(
+  A const& a, B const& b, std::size_t i, std::index_sequence<K...>) noexcept -> F
+{
+  return (F(0) + ... + (a[i][K] * b[K][J]));
+}
+
+template <typename F, std::size_t R, std::size_t S, std::size_t T, typename A, typename B,
+          typename C>
+inline void unrolled(A const& a, B const& b, C& c) noexcept
+{
+  for (std::size_t i = 0; i < R; ++i) {
+    [&]<std::size_t... J>(std::index_sequence<J...>) {
+      ((c[i][J] = unrolled_entry<F, J>(a, b, i, std::make_index_sequence<S>())), ...);
+    }(std::make_index_sequence<T>());
+  }
+}
+
+#if defined(__GNUC__)
+/* Pack width for rows of T values: the SIMD width, narrowed to fit in one row. */
+template <typename F, std::size_t T>
+inline constexpr std::size_t panel_width
+  = T == 0 ? 1 : std::min(simd_width_v<F>, std::bit_floor(T));
+
+/* Rows [i, i + M) of c, the leading T / W * W columns in packs of W. */
+template <typename F, std::size_t S, std::size_t T, std::size_t M, typename A, typename B,
+          typename C>
+inline void panel_rows(A const& a, B const& b, C& c, std::size_t i) noexcept
+{
+  constexpr auto W = panel_width<F, T>;
+  constexpr auto P = T / W;
+  using pack_type = nani::pack<F, W>;
+
+  auto sum = nani::static_array<nani::static_array<pack_type, P>, M>();
+  for (std::size_t r = 0; r < M; ++r) {
+    sum[r] = pack_type(F(0));
+  }
+  for (std::size_t k = 0; k < S; ++k) {
+    for (std::size_t p = 0; p < P; ++p) {
+      auto const y = pack_type::load(&b[k][p * W]);
+      for (std::size_t r = 0; r < M; ++r) {
+        sum[r][p] += a[i + r][k] * y;
+      }
+    }
+  }
+  for (std::size_t r = 0; r < M; ++r) {
+    for (std::size_t p = 0; p < P; ++p) {
+      sum[r][p].store(&c[i + r][p * W]);
+    }
+  }
+}
+
+/* c in blocks of M rows, then the leftover rows one at a time; columns past the last full pack
+ * are computed as dot products.
+ */
+template <typename F, std::size_t R, std::size_t S, std::size_t T, std::size_t M, typename A,
+          typename B, typename C>
+inline void panel(A const& a, B const& b, C& c) noexcept
+{
+  constexpr auto tail = T / panel_width<F, T> * panel_width<F, T>;
+  constexpr auto blocked = R / M * M;
+
+  for (std::size_t i = 0; i < blocked; i += M) {
+    panel_rows<F, S, T, M>(a, b, c, i);
+  }
+  if constexpr (blocked < R) {
+    for (auto i = blocked; i < R; ++i) {
+      panel_rows<F, S, T, 1>(a, b, c, i);
+    }
+  }
+
+  for (std::size_t i = 0; i < R; ++i) {
+    for (auto j = tail; j < T; ++j) {
+      auto sum = F(0);
+      for (std::size_t k = 0; k < S; ++k) {
+        sum += a[i][k] * b[k][j];
+      }
+      c[i][j] = sum;
+    }
+  }
+}
+#endif
+} // namespace detail
+
+template <typename F, std::size_t R, std::size_t S, std::size_t T>
+struct tuned {
+  static constexpr variant value = detail::heuristic<F, R, S, T>();
+};
+
+template <variant V, matrix_like A, matrix_like B, matrix_like C>
+  requires std::is_same_v<matrix_value_t<A>, matrix_value_t<B>>
+           and std::is_same_v<matrix_value_t<A>, matrix_value_t<C>>
+           and (matrix_cols_v<A> == matrix_rows_v<B>) and (matrix_rows_v<A> == matrix_rows_v<C>)
+           and (matrix_cols_v<B> == matrix_cols_v<C>)
+void multiply(A const& a, B const& b, C& c) noexcept
+{
+  using F = matrix_value_t<A>;
+  constexpr auto R = matrix_rows_v<A>;
+  constexpr auto S = matrix_cols_v<A>;
+  constexpr auto T = matrix_cols_v<B>;
+#if defined(__GNUC__)
+  constexpr auto packable = std::is_arithmetic_v<F> and detail::contiguous<std::remove_cvref_t<B>>
+                            and detail::contiguous<std::remove_cvref_t<C>> and T > 0;
+#endif
+
+  if constexpr (V == variant::inner) {
+    detail::inner<F, R, S, T>(a, b, c);
+  }
+  else if constexpr (V == variant::unrolled) {
+    detail::unrolled<F, R, S, T>(a, b, c);
+  }
+#if defined(__GNUC__)
+  else if constexpr (V == variant::packed and packable) {
+    detail::panel<F, R, S, T, 1>(a, b, c);
+  }
+  else if constexpr (V == variant::tiled and packable) {
+    detail::panel<F, R, S, T, 4>(a, b, c);
+  }
+#endif
+  else {
+    detail::outer<F, R, S, T>(a, b, c);
+  }
+}
+
+template <matrix_like A, matrix_like B, matrix_like C>
+  requires std::is_same_v<matrix_value_t<A>, matrix_value_t<B>>
+           and std::is_same_v<matrix_value_t<A>, matrix_value_t<C>>
+           and (matrix_cols_v<A> == matrix_rows_v<B>) and (matrix_rows_v<A> == matrix_rows_v<C>)
+           and (matrix_cols_v<B> == matrix_cols_v<C>)
+void multiply(A const& a, B const& b, C& c) noexcept
+{
+  constexpr auto V
+    = tuned_v<matrix_value_t<A>, matrix_rows_v<A>, matrix_cols_v<A>, matrix_cols_v<B>>;
+  gemm::multiply<V>(a, b, c);
+}
+
+constexpr auto to_string(variant v) noexcept -> std::string_view
+{
+  switch (v) {
+  case variant::inner:
+    return "inner";
+  case variant::outer:
+    return "outer";
+  case variant::unrolled:
+    return "unrolled";
+  case variant::packed:
+    return "packed";
+  case variant::tiled:
+    return "tiled";
+  }
+  return "unknown";
+}
+} // namespace nani::gemm
+
+// Specializations of `tuned` for the host, written by nani-gemm-autotune.
+#if __has_include(<nani/gemm.tuned.hpp>)
+#include <nani/gemm.tuned.hpp>
+#endif
+
+#endif // NANI_GEMM_HPP
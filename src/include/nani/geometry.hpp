@@ -0,0 +1,399 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_GEOMETRY_HPP
+#define NANI_GEOMETRY_HPP
+
+#include <concepts>
+#include <nani/meta.hpp>
+#include <nani/parallel.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <span>
+
+namespace nani::geometry {
+/* Number of faces or cells handed to a thread at once. Large enough to amortize scheduling, small
+ * enough that the outputs of one chunk stay in L2.
+ */
+inline constexpr std::size_t grain = 4096;
+
+/* \brief Unit normals and lengths of the faces of a 2D mesh
+ *
+ * Face `f` runs from `vertex[face[f][0]]` to `vertex[face[f][1]]`. Its normal is
+ * `normalize(normal(t))` for the tangent `t`, i.e. it points to the left of the face, which is the
+ * outward direction for a cell traversed clockwise and the inward direction for a cell traversed
+ * counter-clockwise.
+ *
+ * PreConditions : normal.size() == length.size() == face.size()
+ */
+template <typename F, std::integral I>
+void face_metrics(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<nani::static_array<I, 2> const> face,
+  nani::soa_span<F, 2> normal,
+  std::span<F> length);
+
+/* \brief Midpoints of the faces of a 2D mesh
+ *
+ * PreConditions : centroid.size() == face.size()
+ */
+template <typename F, std::integral I>
+void face_centroids(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<nani::static_array<I, 2> const> face,
+  nani::soa_span<F, 2> centroid);
+
+/* \brief Signed areas and centroids of polygonal cells with K vertices each
+ *
+ * Areas are computed with the shoelace formula, `A = 1/2 sum x_i ^ x_{i+1}`, and are positive for
+ * counter-clockwise cells. The fixed vertex count lets the kernel vectorize across cells.
+ *
+ * PreConditions : area.size() == centroid.size() == cell.size()
+ */
+template <typename F, std::integral I, std::size_t K>
+void cell_metrics(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<nani::static_array<I, K> const> cell,
+  std::span<F> area,
+  nani::soa_span<F, 2> centroid)
+  requires(K > 2);
+
+/* \brief Signed areas and centroids of general polygonal cells
+ *
+ * The vertices of cell `c` are `connectivity[offset[c]] ... connectivity[offset[c + 1] - 1]`
+ * (compressed row storage), so `offset` has one entry more than there are cells.
+ *
+ * PreConditions : area.size() == centroid.size() == offset.size() - 1
+ */
+template <typename F, std::integral I>
+void cell_metrics(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<I const> offset,
+  std::span<I const> connectivity,
+  std::span<F> area,
+  nani::soa_span<F, 2> centroid);
+
+/* \brief Signed volume of the tetrahedron (a, b, c, d)
+ *
+ * Positive when (b - a, c - a, d - a) is right-handed.
+ */
+template <typename F>
+constexpr auto tetrahedron_volume(
+  nani::vector<F, 3> const& a,
+  nani::vector<F, 3> const& b,
+  nani::vector<F, 3> const& c,
+  nani::vector<F, 3> const& d) noexcept -> F;
+
+/* \brief Volume of a hexahedron with VTK vertex ordering
+ *
+ * Vertices 0-3 are the bottom face and 4-7 the top face, with 0-1-2-3 counter-clockwise seen from
+ * the top. Faces are triangulated around their vertex average, so the result is exact for planar
+ * faces and consistent with `cell_volumes` for warped ones.
+ */
+template <typename F>
+constexpr auto hexahedron_volume(nani::static_array<nani::vector<F, 3>, 8> const& x) noexcept -> F;
+
+/* \brief Area vectors and centers of the faces of a 3D mesh, K vertices per face
+ *
+ * The area vector is `1/2 sum (x_k - c) ^ (x_{k+1} - c)` with `c` the vertex average (stored in
+ * `center`). It points along the right-hand normal of the vertex ordering and its length is the
+ * area of the face triangulated around `c`.
+ *
+ * PreConditions : area.size() == center.size() == face.size()
+ */
+template <typename F, std::integral I, std::size_t K>
+void face_area_vectors(
+  std::span<nani::vector<F, 3> const> vertex,
+  std::span<nani::static_array<I, K> const> face,
+  nani::soa_span<F, 3> area,
+  nani::soa_span<F, 3> center)
+  requires(K > 2);
+
+/* \brief Area vectors and centers of general polygonal faces in compressed row storage
+ *
+ * PreConditions : area.size() == center.size() == offset.size() - 1
+ */
+template <typename F, std::integral I>
+void face_area_vectors(
+  std::span<nani::vector<F, 3> const> vertex,
+  std::span<I const> offset,
+  std::span<I const> connectivity,
+  nani::soa_span<F, 3> area,
+  nani::soa_span<F, 3> center);
+
+/* \brief Volumes of polyhedral cells from the face area vectors and centers
+ *
+ * The faces of cell `c` are `cell_face[offset[c]] ... cell_face[offset[c + 1] - 1]`. A face area
+ * vector points out of `owner[f]` and into the other cell. With faces triangulated around their
+ * centers, the divergence theorem gives the volume exactly as `1/3 sum (c_f - o) . S_f`, where `o`
+ * is any reference point; the center of the first face is used to limit cancellation. A cell
+ * without faces has volume 0.
+ *
+ * PreConditions : volume.size() == offset.size() - 1
+ */
+template <typename F, std::integral I>
+void cell_volumes(
+  nani::soa_span<F const, 3> area,
+  nani::soa_span<F const, 3> center,
+  std::span<I const> owner,
+  std::span<I const> offset,
+  std::span<I const> cell_face,
+  std::span<F> volume);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* Accumulate the shoelace terms of one polygon edge into the area and the first moments. */
+template <typename F>
+constexpr void shoelace(
+  nani::vector<F, 2> const& a, nani::vector<F, 2> const& b, F& area, F& mx, F& my) noexcept
+{
+  auto const cross = a ^ b;
+  area += cross;
+  mx += (a[0] + b[0]) * cross;
+  my += (a[1] + b[1]) * cross;
+}
+
+/* Vertex average and area vector of the polygon `point(0) ... point(k - 1)`. */
+template <typename F, typename Point>
+constexpr void polygon(
+  std::size_t k, Point const& point, nani::vector<F, 3>& area, nani::vector<F, 3>& center) noexcept
+{
+  center = nani::vector<F, 3>::fill(0);
+  for (std::size_t i = 0; i < k; ++i) {
+    center += point(i);
+  }
+  center = center / static_cast<F>(k);
+
+  area = nani::vector<F, 3>::fill(0);
+  auto previous = point(k - 1) - center;
+  for (std::size_t i = 0; i < k; ++i) {
+    auto const current = point(i) - center;
+    area += previous ^ current;
+    previous = current;
+  }
+  area = area * F(0.5);
+}
+} // namespace detail
+
+template <typename F, std::integral I>
+void face_metrics(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<nani::static_array<I, 2> const> face,
+  nani::soa_span<F, 2> normal,
+  std::span<F> length)
+{
+  meta::check_size(face.size(), normal.size());
+  meta::check_size(face.size(), length.size());
+
+  nani::parallel_for(face.size(), grain, [&](std::size_t begin, std::size_t end) {
+    F* __restrict nx = normal.data(0);
+    F* __restrict ny = normal.data(1);
+    F* __restrict l = length.data();
+    for (std::size_t f = begin; f < end; ++f) {
+      auto const t = vertex[face[f][1]] - vertex[face[f][0]];
+      auto const n = nani::normal(t);
+      auto const norm = nani::l2_norm(n);
+      nx[f] = n[0] / norm;
+      ny[f] = n[1] / norm;
+      l[f] = norm;
+    }
+  });
+}
+
+template <typename F, std::integral I>
+void face_centroids(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<nani::static_array<I, 2> const> face,
+  nani::soa_span<F, 2> centroid)
+{
+  meta::check_size(face.size(), centroid.size());
+
+  nani::parallel_for(face.size(), grain, [&](std::size_t begin, std::size_t end) {
+    F* __restrict cx = centroid.data(0);
+    F* __restrict cy = centroid.data(1);
+    for (std::size_t f = begin; f < end; ++f) {
+      auto const& a = vertex[face[f][0]];
+      auto const& b = vertex[face[f][1]];
+      cx[f] = F(0.5) * (a[0] + b[0]);
+      cy[f] = F(0.5) * (a[1] + b[1]);
+    }
+  });
+}
+
+template <typename F, std::integral I, std::size_t K>
+void cell_metrics(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<nani::static_array<I, K> const> cell,
+  std::span<F> area,
+  nani::soa_span<F, 2> centroid)
+  requires(K > 2)
+{
+  meta::check_size(cell.size(), area.size());
+  meta::check_size(cell.size(), centroid.size());
+
+  nani::parallel_for(cell.size(), grain, [&](std::size_t begin, std::size_t end) {
+    F* __restrict a = area.data();
+    F* __restrict cx = centroid.data(0);
+    F* __restrict cy = centroid.data(1);
+    for (std::size_t c = begin; c < end; ++c) {
+      F twice_area = 0;
+      F mx = 0;
+      F my = 0;
+      for (std::size_t k = 0; k < K; ++k) {
+        auto const& p = vertex[cell[c][k]];
+        auto const& q = vertex[cell[c][(k + 1) % K]];
+        detail::shoelace(p, q, twice_area, mx, my);
+      }
+      auto const scale = F(1) / (F(3) * twice_area);
+      a[c] = F(0.5) * twice_area;
+      cx[c] = mx * scale;
+      cy[c] = my * scale;
+    }
+  });
+}
+
+template <typename F, std::integral I>
+void cell_metrics(
+  std::span<nani::vector<F, 2> const> vertex,
+  std::span<I const> offset,
+  std::span<I const> connectivity,
+  std::span<F> area,
+  nani::soa_span<F, 2> centroid)
+{
+  meta::check_size(offset.size(), area.size() + 1);
+  meta::check_size(offset.size(), centroid.size() + 1);
+
+  nani::parallel_for(area.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      auto const first = static_cast<std::size_t>(offset[c]);
+      auto const last = static_cast<std::size_t>(offset[c + 1]);
+      F twice_area = 0;
+      F mx = 0;
+      F my = 0;
+      for (std::size_t k = first; k < last; ++k) {
+        auto const next = (k + 1 == last) ? first : k + 1;
+        detail::shoelace(vertex[connectivity[k]], vertex[connectivity[next]], twice_area, mx, my);
+      }
+      auto const scale = F(1) / (F(3) * twice_area);
+      area[c] = F(0.5) * twice_area;
+      centroid.data(0)[c] = mx * scale;
+      centroid.data(1)[c] = my * scale;
+    }
+  });
+}
+
+template <typename F>
+constexpr auto tetrahedron_volume(
+  nani::vector<F, 3> const& a,
+  nani::vector<F, 3> const& b,
+  nani::vector<F, 3> const& c,
+  nani::vector<F, 3> const& d) noexcept -> F
+{
+  return nani::triple(b - a, c - a, d - a) / F(6);
+}
+
+template <typename F>
+constexpr auto hexahedron_volume(nani::static_array<nani::vector<F, 3>, 8> const& x) noexcept -> F
+{
+  // Faces oriented outward.
+  constexpr std::size_t face[6][4] = {
+    {0, 3, 2, 1}, {4, 5, 6, 7}, {0, 1, 5, 4}, {1, 2, 6, 5}, {2, 3, 7, 6}, {3, 0, 4, 7}};
+
+  F volume = 0;
+  for (auto const& f : face) {
+    auto area = nani::vector<F, 3>();
+    auto center = nani::vector<F, 3>();
+    detail::polygon<F>(4, [&](std::size_t i) { return x[f[i]]; }, area, center);
+    volume += (center - x[0]) * area;
+  }
+  return volume / F(3);
+}
+
+template <typename F, std::integral I, std::size_t K>
+void face_area_vectors(
+  std::span<nani::vector<F, 3> const> vertex,
+  std::span<nani::static_array<I, K> const> face,
+  nani::soa_span<F, 3> area,
+  nani::soa_span<F, 3> center)
+  requires(K > 2)
+{
+  meta::check_size(face.size(), area.size());
+  meta::check_size(face.size(), center.size());
+
+  nani::parallel_for(face.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t f = begin; f < end; ++f) {
+      auto s = nani::vector<F, 3>();
+      auto c = nani::vector<F, 3>();
+      detail::polygon<F>(K, [&](std::size_t i) { return vertex[face[f][i]]; }, s, c);
+      area.store(f, s);
+      center.store(f, c);
+    }
+  });
+}
+
+template <typename F, std::integral I>
+void face_area_vectors(
+  std::span<nani::vector<F, 3> const> vertex,
+  std::span<I const> offset,
+  std::span<I const> connectivity,
+  nani::soa_span<F, 3> area,
+  nani::soa_span<F, 3> center)
+{
+  meta::check_size(offset.size(), area.size() + 1);
+  meta::check_size(offset.size(), center.size() + 1);
+
+  nani::parallel_for(area.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t f = begin; f < end; ++f) {
+      auto const first = static_cast<std::size_t>(offset[f]);
+      auto const k = static_cast<std::size_t>(offset[f + 1]) - first;
+      auto s = nani::vector<F, 3>();
+      auto c = nani::vector<F, 3>();
+      detail::polygon<F>(k, [&](std::size_t i) { return vertex[connectivity[first + i]]; }, s, c);
+      area.store(f, s);
+      center.store(f, c);
+    }
+  });
+}
+
+template <typename F, std::integral I>
+void cell_volumes(
+  nani::soa_span<F const, 3> area,
+  nani::soa_span<F const, 3> center,
+  std::span<I const> owner,
+  std::span<I const> offset,
+  std::span<I const> cell_face,
+  std::span<F> volume)
+{
+  meta::check_size(offset.size(), volume.size() + 1);
+  meta::check_size(area.size(), center.size());
+  meta::check_size(area.size(), owner.size());
+
+  nani::parallel_for(volume.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      auto const first = static_cast<std::size_t>(offset[c]);
+      auto const last = static_cast<std::size_t>(offset[c + 1]);
+      if (first == last) {
+        volume[c] = F(0);
+        continue;
+      }
+      auto const origin = center.load(static_cast<std::size_t>(cell_face[first]));
+      F sum = 0;
+      for (std::size_t k = first; k < last; ++k) {
+        auto const f = static_cast<std::size_t>(cell_face[k]);
+        auto const term = (center.load(f) - origin) * area.load(f);
+        sum += (static_cast<std::size_t>(owner[f]) == c) ? term : -term;
+      }
+      volume[c] = sum / F(3);
+    }
+  });
+}
+} // namespace nani::geometry
+
+#endif // NANI_GEOMETRY_HPP
@@ -0,0 +1,347 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_GRADIENT_HPP
+#define NANI_GRADIENT_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <nani/indirect.hpp>
+#include <nani/isa.hpp>
+#include <nani/matrix.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/** Least-Squares Gradients
+ *
+ * The gradient g of a field u in a cell minimizes sum_j w_j (g . dx_j - du_j)^2 over the
+ * neighbours j of the cell, with dx_j and du_j the differences of centroid and value to the
+ * neighbour. Its solution g = sum_j w_j M^-1 dx_j du_j, with the normal matrix
+ * M = sum_j w_j dx_j dx_j^T, is linear in the du_j with coefficients c_j = w_j M^-1 dx_j that
+ * depend on the geometry alone: the columns of the pseudo-inverse of the weighted system.
+ *
+ * `least_squares` computes M^-1 and the c_j once, and `apply` is then a sum of products per cell.
+ * The coefficients are stored in slices of `width` cells, one cell per SIMD lane, padded to the
+ * largest neighbour count of the slice with zero coefficients, so that `apply` evaluates `width`
+ * cells at once with no branches on the neighbour count. The neighbour values of a slice are
+ * fetched with the gathers of `nani::indirect`, hardware ones where the processor has them.
+ **/
+namespace nani::gradient {
+/* Number of cells handed to a thread at once, a multiple of every SIMD width. */
+inline constexpr std::size_t grain = 4096;
+
+enum class weighting {
+  uniform,         // w_j = 1
+  inverse_distance // w_j = 1 / |dx_j|^2, so that near and far neighbours count alike
+};
+
+template <typename F, std::size_t D, std::integral I>
+  requires(D >= 1 and D <= 3)
+class least_squares {
+public:
+  using value_type = F;
+  using size_type = std::size_t;
+  using matrix_type = nani::matrix<F, D, D>;
+  static constexpr std::size_t dim = D;
+  static constexpr std::size_t width = simd_width_v<F>;
+
+public:
+  /* \brief Pseudo-inverses of the cells with the given centroids
+   *
+   * The neighbours of cell `c` are `neighbour[offset[c]] ... neighbour[offset[c + 1] - 1]`
+   * (compressed row storage). A cell whose neighbours do not span D dimensions gets a zero
+   * gradient.
+   *
+   * PreConditions : offset.size() == centroid.size() + 1, neighbour[k] < centroid.size()
+   */
+  least_squares(
+    nani::soa_span<F const, D> centroid,
+    std::span<I const> offset,
+    std::span<I const> neighbour,
+    weighting weight = weighting::inverse_distance);
+
+public:
+  auto size() const noexcept -> size_type;
+
+  /* \brief M^-1 of a cell, zero for a degenerate cell */
+  auto inverse(size_type cell) const noexcept -> matrix_type const&;
+
+  /* \brief Gradient of u in one cell; row n is the gradient of component n */
+  template <std::size_t N>
+  auto evaluate(nani::soa_span<F const, N> u, size_type cell) const noexcept
+    -> nani::matrix<F, N, D>;
+
+  /* \brief gradient[cell][n * D + d] = du_n / dx_d in every cell, SIMD across cells
+   *
+   * PreConditions : u.size() == gradient.size() == size()
+   */
+  template <std::size_t N>
+  void apply(nani::soa_span<F const, N> u, nani::soa_span<F, N * D> gradient) const;
+
+private:
+  size_type size_ = 0;
+  std::vector<matrix_type> inverse_;
+  // Slice s holds its slots [slot_[s], slot_[s + 1]); the entry of lane l in slot k is at
+  // k * width + l in `index_` and `coefficient_`.
+  std::vector<size_type> slot_;
+  std::vector<I> index_;
+  nani::soa_field<F, D> coefficient_;
+};
+
+template <typename F, std::size_t D, std::integral I>
+least_squares(nani::soa_span<F, D>, std::span<I const>, std::span<I const>, weighting)
+  -> least_squares<F, D, I>;
+
+template <typename F, std::size_t D, std::integral I>
+least_squares(nani::soa_span<F const, D>, std::span<I const>, std::span<I const>, weighting)
+  -> least_squares<F, D, I>;
+
+template <typename F, std::size_t D, std::integral I>
+least_squares(nani::soa_span<F, D>, std::span<I const>, std::span<I const>)
+  -> least_squares<F, D, I>;
+
+template <typename F, std::size_t D, std::integral I>
+least_squares(nani::soa_span<F const, D>, std::span<I const>, std::span<I const>)
+  -> least_squares<F, D, I>;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* M^-1 of one cell, or zero if M is singular relative to its scale. */
+template <typename F, std::size_t D>
+auto normal_inverse(nani::matrix<F, D, D> const& m) noexcept -> nani::matrix<F, D, D>
+{
+  auto const adjugate = nani::adjugate(m);
+  auto det = F(0);
+  auto scale = F(1);
+  auto trace = F(0);
+  for (std::size_t j = 0; j < D; ++j) {
+    det += m[0][j] * adjugate[j][0];
+    trace += m[j][j];
+  }
+  for (std::size_t d = 0; d < D; ++d) {
+    scale *= trace / F(D);
+  }
+  // M is positive semi-definite, so det <= (trace / D)^D, with equality for isotropic stencils.
+  if (not(det > F(64) * std::numeric_limits<F>::epsilon() * scale)) {
+    return nani::matrix<F, D, D>::zero();
+  }
+  return (F(1) / det) * adjugate;
+}
+} // namespace detail
+
+template <typename F, std::size_t D, std::integral I>
+  requires(D >= 1 and D <= 3)
+least_squares<F, D, I>::least_squares(
+  nani::soa_span<F const, D> centroid,
+  std::span<I const> offset,
+  std::span<I const> neighbour,
+  weighting weight)
+: size_(centroid.size()), inverse_(centroid.size())
+{
+  meta::check_size(offset.size(), size_ + 1);
+  if constexpr (meta::is_debug_build()) {
+    for (auto const j : neighbour) {
+      if (static_cast<size_type>(j) >= size_) {
+        throw std::runtime_error("least_squares: neighbour index out of range");
+      }
+    }
+  }
+
+  auto const count = [&](size_type c) {
+    return static_cast<size_type>(offset[c + 1]) - static_cast<size_type>(offset[c]);
+  };
+
+  auto const nslice = (size_ + width - 1) / width;
+  slot_.assign(nslice + 1, 0);
+  for (size_type s = 0; s < nslice; ++s) {
+    auto most = size_type(0);
+    for (auto c = s * width; c < std::min(size_, (s + 1) * width); ++c) {
+      most = std::max(most, count(c));
+    }
+    slot_[s + 1] = slot_[s] + most;
+  }
+
+  // Padding entries point to the cell itself (or the last cell past the end) with a zero
+  // coefficient, so that they add nothing.
+  index_.resize(slot_[nslice] * width);
+  coefficient_ = nani::soa_field<F, D>(index_.size());
+  auto const coefficient = coefficient_.span();
+
+  // dx_j of every neighbour, in the compressed row storage of `neighbour`.
+  auto difference = std::vector<nani::vector<F, D>>(neighbour.size());
+  auto const weight_of = [&](nani::vector<F, D> const& dx) {
+    auto const distance = dx * dx;
+    return weight == weighting::uniform ? F(1) : (distance > F(0) ? F(1) / distance : F(0));
+  };
+
+  nani::parallel_for(nslice, grain / width, [&](size_type first, size_type last) {
+    for (auto s = first; s < last; ++s) {
+      for (size_type l = 0; l < width; ++l) {
+        auto const c = std::min(s * width + l, size_ - 1);
+        auto const real = s * width + l < size_;
+        auto const xc = centroid.load(c);
+        auto const n = real ? count(c) : size_type(0);
+        auto const first_neighbour = static_cast<size_type>(offset[c]);
+        auto* const dx = difference.data() + first_neighbour;
+
+        auto m = matrix_type::zero();
+        for (size_type k = 0; k < n; ++k) {
+          dx[k] = centroid.load(static_cast<size_type>(neighbour[first_neighbour + k])) - xc;
+          m = m + weight_of(dx[k]) * nani::outer(dx[k], dx[k]);
+        }
+        auto const inv = detail::normal_inverse(m);
+        if (real) {
+          inverse_[c] = inv;
+        }
+
+        for (auto k = size_type(0); k < slot_[s + 1] - slot_[s]; ++k) {
+          auto const e = (slot_[s] + k) * width + l;
+          if (k < n) {
+            index_[e] = neighbour[first_neighbour + k];
+            coefficient.store(e, weight_of(dx[k]) * (inv * dx[k]));
+          }
+          else {
+            index_[e] = static_cast<I>(c);
+            coefficient.store(e, nani::vector<F, D>());
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename F, std::size_t D, std::integral I>
+  requires(D >= 1 and D <= 3)
+auto least_squares<F, D, I>::size() const noexcept -> size_type
+{
+  return size_;
+}
+
+template <typename F, std::size_t D, std::integral I>
+  requires(D >= 1 and D <= 3)
+auto least_squares<F, D, I>::inverse(size_type cell) const noexcept -> matrix_type const&
+{
+  return inverse_[cell];
+}
+
+template <typename F, std::size_t D, std::integral I>
+  requires(D >= 1 and D <= 3)
+template <std::size_t N>
+auto least_squares<F, D, I>::evaluate(nani::soa_span<F const, N> u, size_type cell) const noexcept
+  -> nani::matrix<F, N, D>
+{
+  auto const s = cell / width;
+  auto const l = cell % width;
+  auto const ui = u.load(cell);
+  auto result = nani::matrix<F, N, D>::zero();
+  for (auto k = slot_[s]; k < slot_[s + 1]; ++k) {
+    auto const e = k * width + l;
+    auto const du = u.load(static_cast<size_type>(index_[e])) - ui;
+    auto const c = coefficient_.span().load(e);
+    for (std::size_t n = 0; n < N; ++n) {
+      for (std::size_t d = 0; d < D; ++d) {
+        result[n][d] += c[d] * du[n];
+      }
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t D, std::integral I>
+  requires(D >= 1 and D <= 3)
+template <std::size_t N>
+void least_squares<F, D, I>::apply(
+  nani::soa_span<F const, N> u, nani::soa_span<F, N * D> gradient) const
+{
+  meta::check_size(u.size(), size_);
+  meta::check_size(gradient.size(), size_);
+
+  using pack_type = nani::pack<F, width>;
+  auto const coefficient = coefficient_.span();
+  auto const nslice = slot_.size() - 1;
+  auto const target = nani::active_isa();
+
+  nani::parallel_for(nslice, grain / width, [&](size_type first, size_type last) {
+    // The neighbour values u_j of one slice, slot by slot, for each component.
+    auto most = size_type(0);
+    for (auto s = first; s < last; ++s) {
+      most = std::max(most, slot_[s + 1] - slot_[s]);
+    }
+    auto gathered = std::vector<F>(N * most * width);
+
+    for (auto s = first; s < last; ++s) {
+      auto const begin = s * width;
+      auto const full = begin + width <= size_;
+      auto const entries = (slot_[s + 1] - slot_[s]) * width;
+      for (std::size_t n = 0; n < N; ++n) {
+        nani::indirect::detail::gather_block(
+          target,
+          u.data(n),
+          index_.data() + slot_[s] * width,
+          gathered.data() + n * most * width,
+          entries);
+      }
+
+      auto ui = nani::static_array<pack_type, N>();
+      for (std::size_t n = 0; n < N; ++n) {
+        if (full) {
+          ui[n] = pack_type::load(u.data(n) + begin);
+        }
+        else {
+          // The last slice is padded with its last cell.
+          auto tail = nani::static_array<F, width>();
+          for (size_type l = 0; l < width; ++l) {
+            tail[l] = u.data(n)[std::min(begin + l, size_ - 1)];
+          }
+          ui[n] = pack_type::load(&tail[0]);
+        }
+      }
+
+      auto sum = nani::static_array<pack_type, N * D>();
+      sum = pack_type(F(0));
+      for (auto k = slot_[s]; k < slot_[s + 1]; ++k) {
+        auto const e = k * width;
+        auto c = nani::static_array<pack_type, D>();
+        for (std::size_t d = 0; d < D; ++d) {
+          c[d] = pack_type::load(coefficient.data(d) + e);
+        }
+        for (std::size_t n = 0; n < N; ++n) {
+          auto const uj = pack_type::load(gathered.data() + (n * most + k - slot_[s]) * width);
+          auto const du = uj - ui[n];
+          for (std::size_t d = 0; d < D; ++d) {
+            sum[n * D + d] += c[d] * du;
+          }
+        }
+      }
+
+      for (std::size_t g = 0; g < N * D; ++g) {
+        if (full) {
+          sum[g].store(gradient.data(g) + begin);
+        }
+        else {
+          for (auto l = size_type(0); begin + l < size_; ++l) {
+            gradient.data(g)[begin + l] = sum[g][l];
+          }
+        }
+      }
+    }
+  });
+}
+} // namespace nani::gradient
+
+#endif // NANI_GRADIENT_HPP
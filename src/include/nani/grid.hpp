@@ -0,0 +1,220 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_GRID_HPP
+#define NANI_GRID_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <nani/aligned_allocator.hpp>
+#include <nani/pack.hpp>
+#include <nani/vector.hpp>
+#include <vector>
+
+namespace nani {
+/** Structured-Grid Field
+ *
+ * A field of `vector<F, N>` on a D-dimensional Cartesian block of `extent[0] x ... x
+ * extent[D - 1]` points, surrounded by a halo of `halo` points on every side. Indices run from
+ * -halo to extent[d] + halo - 1, the negative ones and those past the extent being the halo.
+ *
+ * Each component is stored as its own D-dimensional array, the last index contiguous (structure
+ * of arrays), so that a loop along the last dimension vectorizes across points. Rows of the last
+ * dimension are padded so that the first interior point of every row starts on a SIMD boundary,
+ * and every component starts on a cache line.
+ **/
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+class grid_field {
+public:
+  using value_type = F;
+  using vector_type = nani::vector<F, N>;
+  using size_type = std::size_t;
+  using index_type = std::array<std::ptrdiff_t, D>;
+  static constexpr std::size_t dim = N;
+  static constexpr std::size_t rank = D;
+  static constexpr std::size_t width = simd_width_v<F>;
+
+public:
+  grid_field() = default;
+
+  /* \brief Zero-valued field with the given interior extents and halo width */
+  grid_field(std::array<size_type, D> const& extent, size_type halo);
+
+public:
+  auto extent() const noexcept -> std::array<size_type, D> const&;
+
+  auto halo() const noexcept -> size_type;
+
+  /* \brief Distance in elements between neighbours along each dimension; stride()[D - 1] == 1 */
+  auto stride() const noexcept -> index_type const&;
+
+  /* \brief Component c at the interior point (0, ..., 0) */
+  auto data(std::size_t c) noexcept -> F*;
+
+  auto data(std::size_t c) const noexcept -> F const*;
+
+  /* \brief Start of the slice of component c with first index i0, halo included
+   *
+   * A slice holds stride()[0] elements, and the slices of consecutive i0 are contiguous.
+   */
+  auto slice(std::size_t c, std::ptrdiff_t i0) noexcept -> F*;
+
+  auto slice(std::size_t c, std::ptrdiff_t i0) const noexcept -> F const*;
+
+public:
+  auto operator()(std::size_t c, index_type const& i) noexcept -> F&;
+
+  auto operator()(std::size_t c, index_type const& i) const noexcept -> F const&;
+
+  auto load(index_type const& i) const noexcept -> vector_type;
+
+  void store(index_type const& i, vector_type const& v) noexcept;
+
+private:
+  auto offset(index_type const& i) const noexcept -> std::ptrdiff_t;
+
+  std::array<size_type, D> extent_{};
+  size_type halo_ = 0;
+  index_type stride_{};
+  // Offset of the interior origin in a component, and from there back to the start of its slice.
+  std::ptrdiff_t origin_ = 0;
+  std::ptrdiff_t inner_ = 0;
+  size_type component_ = 0;
+  std::vector<F, nani::aligned_allocator<F>> buffer_;
+};
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+grid_field<F, N, D>::grid_field(std::array<size_type, D> const& extent, size_type halo)
+: extent_(extent), halo_(halo)
+{
+  auto const round_up = [](size_type n, size_type m) { return (n + m - 1) / m * m; };
+  auto const lead = round_up(halo, width);
+  auto const row = round_up(lead + extent[D - 1] + halo, width);
+
+  stride_[D - 1] = 1;
+  for (auto d = D - 1; d > 0; --d) {
+    auto const padded = d == D - 1 ? row : extent[d] + 2 * halo;
+    stride_[d - 1] = stride_[d] * static_cast<std::ptrdiff_t>(padded);
+  }
+
+  auto const h = static_cast<std::ptrdiff_t>(halo);
+  origin_ = static_cast<std::ptrdiff_t>(lead);
+  for (std::size_t d = 0; d + 1 < D; ++d) {
+    origin_ += h * stride_[d];
+  }
+  inner_ = D == 1 ? 0 : origin_ - h * stride_[0];
+
+  auto const slices = D == 1 ? row : extent[0] + 2 * halo;
+  auto const size = slices * static_cast<size_type>(stride_[0]);
+  component_ = round_up(size, std::max<size_type>(64 / sizeof(F), 1));
+  buffer_.assign(component_ * N, F(0));
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::extent() const noexcept -> std::array<size_type, D> const&
+{
+  return extent_;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::halo() const noexcept -> size_type
+{
+  return halo_;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::stride() const noexcept -> index_type const&
+{
+  return stride_;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::data(std::size_t c) noexcept -> F*
+{
+  return buffer_.data() + c * component_ + origin_;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::data(std::size_t c) const noexcept -> F const*
+{
+  return buffer_.data() + c * component_ + origin_;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::slice(std::size_t c, std::ptrdiff_t i0) noexcept -> F*
+{
+  return data(c) + i0 * stride_[0] - inner_;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::slice(std::size_t c, std::ptrdiff_t i0) const noexcept -> F const*
+{
+  return data(c) + i0 * stride_[0] - inner_;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::offset(index_type const& i) const noexcept -> std::ptrdiff_t
+{
+  auto result = std::ptrdiff_t(0);
+  for (std::size_t d = 0; d < D; ++d) {
+    result += i[d] * stride_[d];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::operator()(std::size_t c, index_type const& i) noexcept -> F&
+{
+  return data(c)[offset(i)];
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::operator()(std::size_t c, index_type const& i) const noexcept
+  -> F const&
+{
+  return data(c)[offset(i)];
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+auto grid_field<F, N, D>::load(index_type const& i) const noexcept -> vector_type
+{
+  auto result = vector_type();
+  auto const o = offset(i);
+  for (std::size_t c = 0; c < N; ++c) {
+    result[c] = data(c)[o];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t D>
+  requires(D >= 1)
+void grid_field<F, N, D>::store(index_type const& i, vector_type const& v) noexcept
+{
+  auto const o = offset(i);
+  for (std::size_t c = 0; c < N; ++c) {
+    data(c)[o] = v[c];
+  }
+}
+} // namespace nani
+
+#endif // NANI_GRID_HPP
@@ -0,0 +1,485 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_INDIRECT_HPP
+#define NANI_INDIRECT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <nani/isa.hpp>
+#include <nani/meta.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#if NANI_X86
+#include <immintrin.h>
+#endif
+
+namespace nani::indirect {
+/* Number of elements handed to a thread at once. */
+inline constexpr std::size_t grain = 8192;
+
+/* How far ahead of the current element the kernels prefetch the indexed field entries. Far
+ * enough to cover memory latency at the rate the kernels consume elements.
+ */
+inline constexpr std::size_t prefetch_distance = 16;
+
+/** Colouring
+ *
+ * A permutation of items (typically edges) grouped into colours such that no two items of the
+ * same colour touch the same target. Items of colour `c` are
+ * `order[offset[c]] ... order[offset[c + 1] - 1]`.
+ **/
+template <std::integral I>
+struct colouring {
+  std::vector<I> order;
+  std::vector<I> offset;
+
+  auto ncolour() const noexcept -> std::size_t;
+};
+
+/* \brief out[k] = field[index[k]]
+ *
+ * `float` and `double` fields with 32 bit indices use hardware gathers on processors with AVX2 or
+ * AVX-512, selected at run time (see `active_isa`).
+ *
+ * PreConditions : out.size() == index.size(), index[k] * N < 2^31 for 32 bit indices
+ */
+template <typename F, std::size_t N, std::integral I>
+void gather(
+  std::span<nani::vector<F, N> const> field, std::span<I const> index, nani::soa_span<F, N> out);
+
+/* \brief left[e] = field[edge[e][0]], right[e] = field[edge[e][1]]
+ *
+ * PreConditions : left.size() == right.size() == edge.size()
+ */
+template <typename F, std::size_t N, std::integral I>
+void gather(
+  std::span<nani::vector<F, N> const> field,
+  std::span<nani::static_array<I, 2> const> edge,
+  nani::soa_span<F, N> left,
+  nani::soa_span<F, N> right);
+
+/* \brief field[index[k]] += value[k], sequentially
+ *
+ * PreConditions : value.size() == index.size()
+ */
+template <typename F, std::size_t N, std::integral I>
+void scatter_add(
+  nani::soa_span<F const, N> value, std::span<I const> index, std::span<nani::vector<F, N>> field);
+
+/* \brief field[index[k]] += value[k], in parallel within each colour
+ *
+ * PreConditions : value.size() == index.size(), `colour` is a valid colouring of `index`
+ */
+template <typename F, std::size_t N, std::integral I>
+void scatter_add(
+  nani::soa_span<F const, N> value,
+  std::span<I const> index,
+  colouring<I> const& colour,
+  std::span<nani::vector<F, N>> field);
+
+/* \brief field[edge[e][0]] += value[e], field[edge[e][1]] -= value[e], in parallel within colours
+ *
+ * This is the accumulation of a conservative flux into the two cells of a face.
+ *
+ * PreConditions : value.size() == edge.size(), `colour` is a valid colouring of `edge`
+ */
+template <typename F, std::size_t N, std::integral I>
+void scatter_flux(
+  nani::soa_span<F const, N> value,
+  std::span<nani::static_array<I, 2> const> edge,
+  colouring<I> const& colour,
+  std::span<nani::vector<F, N>> field);
+
+/* \brief Greedy colouring of items with K targets each, such that no two items of a colour share
+ * a target
+ *
+ * PreConditions : item[k][j] < ntarget
+ */
+template <std::integral I, std::size_t K>
+auto colour(std::span<nani::static_array<I, K> const> item, std::size_t ntarget) -> colouring<I>;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+template <typename T>
+inline void prefetch(T const* p) noexcept
+{
+#if defined(__GNUC__)
+  __builtin_prefetch(p, 0, 1);
+#endif
+}
+
+template <typename F, std::size_t N>
+inline auto scalars(nani::vector<F, N> const* field) noexcept -> F const*
+{
+  static_assert(sizeof(nani::vector<F, N>) == N * sizeof(F));
+  return reinterpret_cast<F const*>(field); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <typename F, std::size_t N>
+inline auto scalars(nani::vector<F, N>* field) noexcept -> F*
+{
+  static_assert(sizeof(nani::vector<F, N>) == N * sizeof(F));
+  return reinterpret_cast<F*>(field); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+/* Prefetches the field rows of the W elements `prefetch_distance` past `begin`: all of the block
+ * that a later step of W elements gathers, not only its first row.
+ */
+template <std::size_t W, std::size_t N, typename F, typename I>
+inline void prefetch_block(
+  F const* base, I const* index, std::size_t begin, std::size_t end) noexcept
+{
+  if (begin + prefetch_distance + W <= end) {
+    for (std::size_t l = 0; l < W; ++l) {
+      prefetch(base + N * static_cast<std::size_t>(index[begin + prefetch_distance + l]));
+    }
+  }
+}
+
+#if NANI_X86
+/* Gathers elements [begin, end) with AVX-512 gathers and returns the first element left over. */
+template <typename F, std::size_t N, typename I>
+NANI_TARGET_AVX512 inline auto gather_avx512(
+  F const* base,
+  I const* index,
+  nani::soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept -> std::size_t
+{
+  if constexpr (std::is_same_v<F, double>) {
+    auto const stride = _mm256_set1_epi32(static_cast<int>(N));
+    for (; begin + 8 <= end; begin += 8) {
+      prefetch_block<8, N>(base, index, begin, end);
+      auto const vindex = _mm256_mullo_epi32(
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(index + begin)), stride);
+      for (std::size_t c = 0; c < N; ++c) {
+        auto const zero = _mm512_setzero_pd();
+        auto const v = _mm512_mask_i32gather_pd(zero, 0xFF, vindex, base + c, 8);
+        _mm512_storeu_pd(out.data(c) + begin, v);
+      }
+    }
+  }
+  else if constexpr (std::is_same_v<F, float>) {
+    auto const stride = _mm512_set1_epi32(static_cast<int>(N));
+    for (; begin + 16 <= end; begin += 16) {
+      prefetch_block<16, N>(base, index, begin, end);
+      auto const vindex = _mm512_mullo_epi32(_mm512_loadu_si512(index + begin), stride);
+      for (std::size_t c = 0; c < N; ++c) {
+        auto const zero = _mm512_setzero_ps();
+        auto const v = _mm512_mask_i32gather_ps(zero, 0xFFFF, vindex, base + c, 4);
+        _mm512_storeu_ps(out.data(c) + begin, v);
+      }
+    }
+  }
+  return begin;
+}
+
+/* Gathers elements [begin, end) with AVX2 gathers and returns the first element left over. */
+template <typename F, std::size_t N, typename I>
+NANI_TARGET_AVX2 inline auto gather_avx2(
+  F const* base,
+  I const* index,
+  nani::soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept -> std::size_t
+{
+  if constexpr (std::is_same_v<F, double>) {
+    auto const stride = _mm_set1_epi32(static_cast<int>(N));
+    auto const all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (; begin + 4 <= end; begin += 4) {
+      prefetch_block<4, N>(base, index, begin, end);
+      auto const vindex = _mm_mullo_epi32(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(index + begin)), stride);
+      for (std::size_t c = 0; c < N; ++c) {
+        auto const v = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base + c, vindex, all, 8);
+        _mm256_storeu_pd(out.data(c) + begin, v);
+      }
+    }
+  }
+  else if constexpr (std::is_same_v<F, float>) {
+    auto const stride = _mm256_set1_epi32(static_cast<int>(N));
+    for (; begin + 8 <= end; begin += 8) {
+      prefetch_block<8, N>(base, index, begin, end);
+      auto const vindex = _mm256_mullo_epi32(
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(index + begin)), stride);
+      for (std::size_t c = 0; c < N; ++c) {
+        _mm256_storeu_ps(out.data(c) + begin, _mm256_i32gather_ps(base + c, vindex, 4));
+      }
+    }
+  }
+  return begin;
+}
+#endif
+
+/* Gathers with the hardware gathers of Target, if any, and returns the first element left over. */
+template <isa Target, typename F, std::size_t N, typename I>
+inline auto gather_simd(
+  [[maybe_unused]] F const* base,
+  [[maybe_unused]] I const* index,
+  [[maybe_unused]] nani::soa_span<F, N> const& out,
+  std::size_t begin,
+  [[maybe_unused]] std::size_t end) noexcept -> std::size_t
+{
+#if NANI_X86
+  if constexpr (sizeof(I) == 4 and Target == isa::avx512) {
+    return gather_avx512(base, index, out, begin, end);
+  }
+  else if constexpr (sizeof(I) == 4 and Target == isa::avx2) {
+    return gather_avx2(base, index, out, begin, end);
+  }
+#endif
+  return begin;
+}
+
+/* Gathers elements [begin, end) from the rows of N scalars at `base`. */
+template <isa Target, typename F, std::size_t N, typename I>
+inline void gather_range(
+  F const* base,
+  I const* index,
+  nani::soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  begin = gather_simd<Target, F, N, I>(base, index, out, begin, end);
+  for (std::size_t k = begin; k < end; ++k) {
+    if (k + prefetch_distance < end) {
+      detail::prefetch(base + N * static_cast<std::size_t>(index[k + prefetch_distance]));
+    }
+    auto const row = base + N * static_cast<std::size_t>(index[k]);
+    for (std::size_t c = 0; c < N; ++c) {
+      out.data(c)[k] = row[c];
+    }
+  }
+}
+
+template <isa Target, typename F, std::size_t N, typename I>
+inline void gather_range(
+  nani::vector<F, N> const* field,
+  I const* index,
+  nani::soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  gather_range<Target>(scalars(field), index, out, begin, end);
+}
+
+/* Element and index types for which libnani carries one gather per instruction set. */
+template <typename F, std::size_t N, typename I>
+inline constexpr bool dispatched = (std::is_same_v<F, float> or std::is_same_v<F, double>)
+                                   and (std::is_same_v<I, std::int32_t>
+                                        or std::is_same_v<I, std::uint32_t>)
+                                   and N >= 1 and N <= 8;
+
+/* One copy of `gather_range` per instruction set, selected by `target`; in libnani. */
+template <typename F, std::size_t N, typename I>
+void gather_dispatch(
+  isa target,
+  F const* base,
+  I const* index,
+  nani::soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept;
+
+template <typename F, std::size_t N, typename I>
+inline void gather_dispatch(
+  isa target,
+  nani::vector<F, N> const* field,
+  I const* index,
+  nani::soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  gather_dispatch(target, scalars(field), index, out, begin, end);
+}
+
+/* out[k] = field[index[k]] for k in [0, count) on the calling thread, with the gathers of
+ * `target`: one block of a kernel that consumes it right away, such as the neighbour values of
+ * `gradient::least_squares::apply`.
+ */
+template <typename F, typename I>
+inline void gather_block(
+  isa target, F const* field, I const* index, F* out, std::size_t count) noexcept
+{
+  auto const destination = nani::soa_span<F, 1>(nani::static_array<F*, 1>(out), count);
+  if constexpr (dispatched<F, 1, I>) {
+    gather_dispatch(target, field, index, destination, 0, count);
+  }
+  else {
+    gather_range<nani::compiled_isa>(field, index, destination, 0, count);
+  }
+}
+} // namespace detail
+
+template <std::integral I>
+auto colouring<I>::ncolour() const noexcept -> std::size_t
+{
+  return offset.empty() ? 0 : offset.size() - 1;
+}
+
+template <typename F, std::size_t N, std::integral I>
+void gather(
+  std::span<nani::vector<F, N> const> field, std::span<I const> index, nani::soa_span<F, N> out)
+{
+  meta::check_size(index.size(), out.size());
+
+  auto const target = nani::active_isa();
+  nani::parallel_for(index.size(), grain, [&](std::size_t begin, std::size_t end) {
+    if constexpr (detail::dispatched<F, N, I>) {
+      detail::gather_dispatch(target, field.data(), index.data(), out, begin, end);
+    }
+    else {
+      detail::gather_range<nani::compiled_isa>(field.data(), index.data(), out, begin, end);
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::integral I>
+void gather(
+  std::span<nani::vector<F, N> const> field,
+  std::span<nani::static_array<I, 2> const> edge,
+  nani::soa_span<F, N> left,
+  nani::soa_span<F, N> right)
+{
+  meta::check_size(edge.size(), left.size());
+  meta::check_size(edge.size(), right.size());
+
+  nani::parallel_for(edge.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t e = begin; e < end; ++e) {
+      if (e + prefetch_distance < end) {
+        auto const& ahead = edge[e + prefetch_distance];
+        detail::prefetch(&field[static_cast<std::size_t>(ahead[0])]);
+        detail::prefetch(&field[static_cast<std::size_t>(ahead[1])]);
+      }
+      left.store(e, field[static_cast<std::size_t>(edge[e][0])]);
+      right.store(e, field[static_cast<std::size_t>(edge[e][1])]);
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::integral I>
+void scatter_add(
+  nani::soa_span<F const, N> value, std::span<I const> index, std::span<nani::vector<F, N>> field)
+{
+  meta::check_size(index.size(), value.size());
+
+  for (std::size_t k = 0; k < index.size(); ++k) {
+    if (k + prefetch_distance < index.size()) {
+      detail::prefetch(&field[static_cast<std::size_t>(index[k + prefetch_distance])]);
+    }
+    field[static_cast<std::size_t>(index[k])] += value.load(k);
+  }
+}
+
+template <typename F, std::size_t N, std::integral I>
+void scatter_add(
+  nani::soa_span<F const, N> value,
+  std::span<I const> index,
+  colouring<I> const& colour,
+  std::span<nani::vector<F, N>> field)
+{
+  meta::check_size(index.size(), value.size());
+  meta::check_size(index.size(), colour.order.size());
+
+  for (std::size_t c = 0; c < colour.ncolour(); ++c) {
+    auto const first = static_cast<std::size_t>(colour.offset[c]);
+    auto const count = static_cast<std::size_t>(colour.offset[c + 1]) - first;
+    nani::parallel_for(count, grain, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t j = first + begin; j < first + end; ++j) {
+        auto const k = static_cast<std::size_t>(colour.order[j]);
+        field[static_cast<std::size_t>(index[k])] += value.load(k);
+      }
+    });
+  }
+}
+
+template <typename F, std::size_t N, std::integral I>
+void scatter_flux(
+  nani::soa_span<F const, N> value,
+  std::span<nani::static_array<I, 2> const> edge,
+  colouring<I> const& colour,
+  std::span<nani::vector<F, N>> field)
+{
+  meta::check_size(edge.size(), value.size());
+  meta::check_size(edge.size(), colour.order.size());
+
+  for (std::size_t c = 0; c < colour.ncolour(); ++c) {
+    auto const first = static_cast<std::size_t>(colour.offset[c]);
+    auto const count = static_cast<std::size_t>(colour.offset[c + 1]) - first;
+    nani::parallel_for(count, grain, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t j = first + begin; j < first + end; ++j) {
+        auto const e = static_cast<std::size_t>(colour.order[j]);
+        auto const v = value.load(e);
+        field[static_cast<std::size_t>(edge[e][0])] += v;
+        field[static_cast<std::size_t>(edge[e][1])] -= v;
+      }
+    });
+  }
+}
+
+template <std::integral I, std::size_t K>
+auto colour(std::span<nani::static_array<I, K> const> item, std::size_t ntarget) -> colouring<I>
+{
+  // Colour of every item, chosen as the smallest colour not yet used at any of its targets. The
+  // used colours of a target are kept as a bit mask, with the rare overflow past 64 colours
+  // handled by starting a fresh round of 64.
+  auto item_colour = std::vector<std::size_t>(item.size());
+  auto used = std::vector<std::uint64_t>(ntarget);
+  std::size_t ncolour = 0;
+
+  for (std::size_t round = 0, nleft = item.size(); nleft != 0; ++round) {
+    std::fill(used.begin(), used.end(), std::uint64_t{0});
+    nleft = 0;
+    for (std::size_t k = 0; k < item.size(); ++k) {
+      if (round != 0 and item_colour[k] != 64 * round) {
+        continue;
+      }
+      std::uint64_t mask = 0;
+      for (std::size_t j = 0; j < K; ++j) {
+        mask |= used[static_cast<std::size_t>(item[k][j])];
+      }
+      if (mask == ~std::uint64_t{0}) {
+        item_colour[k] = 64 * (round + 1);
+        ++nleft;
+        continue;
+      }
+      auto const bit = static_cast<std::size_t>(std::countr_one(mask));
+      item_colour[k] = 64 * round + bit;
+      ncolour = std::max(ncolour, item_colour[k] + 1);
+      for (std::size_t j = 0; j < K; ++j) {
+        used[static_cast<std::size_t>(item[k][j])] |= std::uint64_t{1} << bit;
+      }
+    }
+  }
+
+  auto result = colouring<I>();
+  result.offset.assign(ncolour + 1, I{0});
+  for (auto const c : item_colour) {
+    ++result.offset[c + 1];
+  }
+  for (std::size_t c = 0; c < ncolour; ++c) {
+    result.offset[c + 1] += result.offset[c];
+  }
+  result.order.resize(item.size());
+  auto cursor = std::vector<I>(result.offset.begin(), result.offset.end() - 1);
+  for (std::size_t k = 0; k < item.size(); ++k) {
+    result.order[static_cast<std::size_t>(cursor[item_colour[k]]++)] = static_cast<I>(k);
+  }
+  return result;
+}
+} // namespace nani::indirect
+
+#endif // NANI_INDIRECT_HPP
@@ -0,0 +1,103 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_ISA_HPP
+#define NANI_ISA_HPP
+
+#include <cstddef>
+#include <string_view>
+
+/* Function attributes that compile one function for a given instruction set, independently of the
+ * flags of the translation unit, and that inline all of its callees so that they are compiled for
+ * it too. Empty, and NANI_X86 is 0, where there is nothing to dispatch between.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define NANI_X86 1
+#define NANI_TARGET_SSE4_2 __attribute__((target("sse4.2")))
+#define NANI_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define NANI_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma")))
+#define NANI_FLATTEN __attribute__((flatten))
+#else
+#define NANI_X86 0
+#define NANI_TARGET_SSE4_2
+#define NANI_TARGET_AVX2
+#define NANI_TARGET_AVX512
+#define NANI_FLATTEN
+#endif
+
+namespace nani {
+/** Instruction Set
+ *
+ * The x86 vector instruction sets for which libnani carries a separate copy of each dispatched
+ * batched kernel, in increasing order of capability. `generic` is whatever the library was
+ * compiled for and is the only level on other architectures.
+ **/
+enum class isa : unsigned char { generic, sse4_2, avx2, avx512 };
+
+/* \brief The instruction set the current translation unit is compiled for */
+inline constexpr isa compiled_isa =
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+  isa::avx512;
+#elif defined(__AVX2__) && defined(__FMA__)
+  isa::avx2;
+#elif defined(__SSE4_2__)
+  isa::sse4_2;
+#else
+  isa::generic;
+#endif
+
+/* \brief The best instruction set supported by the processor, from cpuid */
+auto detected_isa() noexcept -> isa;
+
+/* \brief The instruction set used by the dispatched kernels
+ *
+ * This is `detected_isa()`, unless the `NANI_ISA` environment variable names a lower level
+ * (`generic`, `sse4.2`, `avx2` or `avx512`), which is then used instead. Requests above the
+ * detected level are capped to it. The value is read once, on first use.
+ */
+auto active_isa() noexcept -> isa;
+
+/* \brief Width in bytes of the vector registers of an instruction set */
+constexpr auto register_bytes(isa target) noexcept -> std::size_t;
+
+/* \brief Number of lanes of type F in one vector register of an instruction set */
+template <isa Target, typename F>
+inline constexpr std::size_t isa_width_v =
+  register_bytes(Target) / sizeof(F) > 0 ? register_bytes(Target) / sizeof(F) : 1;
+
+constexpr auto to_string(isa target) noexcept -> std::string_view;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+constexpr auto register_bytes(isa target) noexcept -> std::size_t
+{
+  switch (target) {
+  case isa::avx512:
+    return 64;
+  case isa::avx2:
+    return 32;
+  default:
+    return 16;
+  }
+}
+
+constexpr auto to_string(isa target) noexcept -> std::string_view
+{
+  switch (target) {
+  case isa::sse4_2:
+    return "sse4.2";
+  case isa::avx2:
+    return "avx2";
+  case isa::avx512:
+    return "avx512";
+  default:
+    return "generic";
+  }
+}
+} // namespace nani
+
+#endif // NANI_ISA_HPP
@@ -0,0 +1,408 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_LAYOUT_HPP
+#define NANI_LAYOUT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <nani/isa.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if NANI_X86
+#include <immintrin.h>
+#endif
+
+namespace nani::layout {
+/* Elements per parallel chunk. A multiple of every SIMD width, so that chunks of component
+ * streams start on a register boundary.
+ */
+inline constexpr std::size_t grain = 16384;
+
+/* Fields whose destination is larger than this, roughly a last-level cache, are written with
+ * non-temporal stores: they would be evicted before being read again anyway, and bypassing the
+ * cache saves the read-for-ownership traffic.
+ */
+inline constexpr std::size_t streaming_bytes = std::size_t{16} << 20;
+
+/* \brief Transpose an array of structures into component streams
+ *
+ * Blocks of W elements (the SIMD width of F) are loaded as N registers, transposed in registers
+ * with lane shuffles and stored as one register per component. For float and double with
+ * N = 2 ... 8 the kernel is dispatched at run time to the widest instruction set available.
+ */
+template <typename F, std::size_t N>
+void to_soa(std::span<nani::vector<F, N> const> aos, nani::soa_span<F, N> soa);
+
+/* \brief Transpose component streams into an array of structures */
+template <typename F, std::size_t N>
+void to_aos(nani::soa_span<F const, N> soa, std::span<nani::vector<F, N>> aos);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+template <typename F, std::size_t W>
+using native_t = typename nani::pack<F, W>::native_type;
+
+/* Element types and sizes for which libnani carries one kernel per instruction set. */
+template <typename F, std::size_t N>
+inline constexpr bool dispatched =
+  (std::is_same_v<F, float> or std::is_same_v<F, double>) and N >= 2 and N <= 8;
+
+/* Lane of the (acc, in[K]) shuffle that builds lane L of component C in an AoS to SoA block. */
+template <std::size_t N, std::size_t W, std::size_t C, std::size_t K>
+consteval auto soa_lane(std::size_t l) -> int
+{
+  auto const s = l * N + C;
+  return static_cast<int>(s / W == K ? W + s % W : l);
+}
+
+/* Lane of the (acc, in[C]) shuffle that builds lane L of register K in an SoA to AoS block. */
+template <std::size_t N, std::size_t W, std::size_t K, std::size_t C>
+consteval auto aos_lane(std::size_t l) -> int
+{
+  auto const s = K * W + l;
+  return static_cast<int>(s % N == C ? W + s / N : l);
+}
+
+/* One shuffle step: lanes of component C that live in register K of an AoS block. */
+template <std::size_t N, std::size_t W, std::size_t C, std::size_t K, typename V, std::size_t... L>
+inline auto soa_merge(V const& acc, V const& in, std::index_sequence<L...> /*unused*/) noexcept -> V
+{
+  return __builtin_shufflevector(acc, in, soa_lane<N, W, C, K>(L)...);
+}
+
+/* One shuffle step: lanes of register K of an AoS block that live in component stream C. */
+template <std::size_t N, std::size_t W, std::size_t K, std::size_t C, typename V, std::size_t... L>
+inline auto aos_merge(V const& acc, V const& in, std::index_sequence<L...> /*unused*/) noexcept -> V
+{
+  return __builtin_shufflevector(acc, in, aos_lane<N, W, K, C>(L)...);
+}
+
+template <std::size_t N, std::size_t W, std::size_t C, typename V, std::size_t... K>
+inline auto to_soa_register(V const* in, std::index_sequence<K...> /*unused*/) noexcept -> V
+{
+  auto acc = V{};
+  ((acc = soa_merge<N, W, C, K>(acc, in[K], std::make_index_sequence<W>())), ...);
+  return acc;
+}
+
+template <std::size_t N, std::size_t W, std::size_t K, typename V, std::size_t... C>
+inline auto to_aos_register(V const* in, std::index_sequence<C...> /*unused*/) noexcept -> V
+{
+  auto acc = V{};
+  ((acc = aos_merge<N, W, K, C>(acc, in[C], std::make_index_sequence<W>())), ...);
+  return acc;
+}
+
+/* Power-of-two blocks: position p = r * W + l of lane l in register r has log2(N W) bits. A
+ * rotation of those bits by one is a stage of N two-input shuffles; the AoS to SoA transpose is
+ * a rotation by log2(N) to the right, or equivalently by log2(W) to the left, so log2(min(N, W))
+ * stages replace the N - 1 shuffles per register of the generic path.
+ */
+template <std::size_t N, std::size_t W, bool Left>
+consteval auto rotate_source(std::size_t r, std::size_t l) -> std::size_t
+{
+  constexpr auto bits = static_cast<std::size_t>(std::bit_width(N * W) - 1);
+  auto const p = r * W + l;
+  return Left ? (p >> 1) | ((p & 1) << (bits - 1)) : ((p << 1) & (N * W - 1)) | (p >> (bits - 1));
+}
+
+template <std::size_t N, std::size_t W, bool Left>
+consteval auto rotate_first(std::size_t r) -> std::size_t
+{
+  return Left ? r / 2 : (2 * r) % N;
+}
+
+template <std::size_t N, std::size_t W, bool Left>
+consteval auto rotate_second(std::size_t r) -> std::size_t
+{
+  return Left ? r / 2 + N / 2 : (2 * r) % N + 1;
+}
+
+template <std::size_t N, std::size_t W, bool Left, std::size_t R>
+consteval auto rotate_lane(std::size_t l) -> int
+{
+  auto const p = rotate_source<N, W, Left>(R, l);
+  return static_cast<int>(p / W == rotate_first<N, W, Left>(R) ? p % W : W + p % W);
+}
+
+template <std::size_t N, std::size_t W, bool Left, std::size_t R, typename V, std::size_t... L>
+inline auto rotate_register(V const* in, std::index_sequence<L...> /*unused*/) noexcept -> V
+{
+  return __builtin_shufflevector(
+    in[rotate_first<N, W, Left>(R)],
+    in[rotate_second<N, W, Left>(R)],
+    rotate_lane<N, W, Left, R>(L)...);
+}
+
+template <std::size_t N, std::size_t W, bool Left, typename V, std::size_t... R>
+inline void rotate(V* x, std::index_sequence<R...> /*unused*/) noexcept
+{
+  V const in[N] = {x[R]...};
+  ((x[R] = rotate_register<N, W, Left, R>(in, std::make_index_sequence<W>())), ...);
+}
+
+template <std::size_t N, std::size_t W, bool Left, typename V>
+inline void rotate(V* x, std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    rotate<N, W, Left>(x, std::make_index_sequence<N>());
+  }
+}
+
+/* Transpose one block of W elements held in N registers, in place. */
+template <std::size_t N, std::size_t W, bool ToSoa, typename V>
+inline void transpose(V* x) noexcept
+{
+  if constexpr (std::has_single_bit(N) and W >= 2) {
+    constexpr auto n = static_cast<std::size_t>(std::bit_width(N) - 1);
+    constexpr auto w = static_cast<std::size_t>(std::bit_width(W) - 1);
+    if constexpr (n <= w) {
+      rotate<N, W, not ToSoa>(x, n);
+    }
+    else {
+      rotate<N, W, ToSoa>(x, w);
+    }
+  }
+  else {
+    V in[N];
+    std::copy(x, x + N, in);
+    [&]<std::size_t... R>(std::index_sequence<R...> /*unused*/) {
+      if constexpr (ToSoa) {
+        ((x[R] = to_soa_register<N, W, R>(in, std::make_index_sequence<N>())), ...);
+      }
+      else {
+        ((x[R] = to_aos_register<N, W, R>(in, std::make_index_sequence<N>())), ...);
+      }
+    }(std::make_index_sequence<N>());
+  }
+}
+
+template <typename V>
+inline auto load(void const* p) noexcept -> V
+{
+  auto result = V();
+  std::memcpy(&result, p, sizeof(V));
+  return result;
+}
+
+template <typename V>
+inline void store(void* p, V const& v) noexcept
+{
+  std::memcpy(p, &v, sizeof(V));
+}
+
+#if NANI_X86
+/* The intrinsics must be inlined into a function compiled for their instruction set, so the
+ * non-temporal stores are wrappers carrying the target, which take the register by address.
+ */
+NANI_TARGET_AVX512 inline void stream_64(void* p, void const* v) noexcept
+{
+  _mm512_stream_si512(static_cast<__m512i*>(p), _mm512_loadu_si512(v));
+}
+
+NANI_TARGET_AVX2 inline void stream_32(void* p, void const* v) noexcept
+{
+  _mm256_stream_si256(
+    static_cast<__m256i*>(p), _mm256_loadu_si256(static_cast<__m256i const*>(v)));
+}
+
+inline void stream_16(void* p, void const* v) noexcept
+{
+  _mm_stream_si128(static_cast<__m128i*>(p), _mm_loadu_si128(static_cast<__m128i const*>(v)));
+}
+#endif
+
+/* Non-temporal store of one register; p must be aligned to sizeof(V). */
+template <typename V>
+inline void stream(void* p, V const& v) noexcept
+{
+#if NANI_X86
+  if constexpr (sizeof(V) == 64) {
+    stream_64(p, &v);
+    return;
+  }
+  else if constexpr (sizeof(V) == 32) {
+    stream_32(p, &v);
+    return;
+  }
+  else if constexpr (sizeof(V) == 16) {
+    stream_16(p, &v);
+    return;
+  }
+#endif
+  store(p, v);
+}
+
+inline void fence() noexcept
+{
+#if NANI_X86
+  _mm_sfence();
+#endif
+}
+
+template <typename V>
+inline auto aligned(void const* p) noexcept -> bool
+{
+  return reinterpret_cast<std::uintptr_t>(p) % sizeof(V) == 0;
+}
+
+/* Transpose elements [begin, end) with registers of W lanes. */
+template <typename F, std::size_t N, std::size_t W>
+inline void to_soa_range(
+  F const* aos,
+  nani::soa_span<F, N> const& soa,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept
+{
+  using V = native_t<F, W>;
+
+  auto nt = streaming;
+  for (std::size_t c = 0; c < N; ++c) {
+    nt = nt and aligned<V>(soa.data(c) + begin);
+  }
+
+  // Transpose a cache line worth of elements before writing, so that each component stream
+  // receives whole lines: partial lines spread over N streams would thrash the write-combining
+  // buffers of the non-temporal stores.
+  constexpr auto R = sizeof(V) < 64 ? 64 / sizeof(V) : 1;
+  auto i = begin;
+  for (; i + R * W <= end; i += R * W) {
+    V x[R][N];
+    for (std::size_t r = 0; r < R; ++r) {
+      for (std::size_t k = 0; k < N; ++k) {
+        x[r][k] = load<V>(aos + (i + r * W) * N + k * W);
+      }
+      transpose<N, W, true>(x[r]);
+    }
+    for (std::size_t c = 0; c < N; ++c) {
+      for (std::size_t r = 0; r < R; ++r) {
+        auto* const p = soa.data(c) + i + r * W;
+        nt ? stream(p, x[r][c]) : store(p, x[r][c]);
+      }
+    }
+  }
+  for (; i < end; ++i) {
+    for (std::size_t c = 0; c < N; ++c) {
+      soa.data(c)[i] = aos[i * N + c];
+    }
+  }
+
+  if (nt) {
+    fence();
+  }
+}
+
+template <typename F, std::size_t N, std::size_t W>
+inline void to_aos_range(
+  nani::soa_span<F const, N> const& soa,
+  F* aos,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept
+{
+  using V = native_t<F, W>;
+
+  auto const nt = streaming and aligned<V>(aos + begin * N);
+
+  auto i = begin;
+  for (; i + W <= end; i += W) {
+    V x[N];
+    for (std::size_t c = 0; c < N; ++c) {
+      x[c] = load<V>(soa.data(c) + i);
+    }
+    transpose<N, W, false>(x);
+    for (std::size_t k = 0; k < N; ++k) {
+      auto* const p = aos + i * N + k * W;
+      nt ? stream(p, x[k]) : store(p, x[k]);
+    }
+  }
+  for (; i < end; ++i) {
+    for (std::size_t c = 0; c < N; ++c) {
+      aos[i * N + c] = soa.data(c)[i];
+    }
+  }
+
+  if (nt) {
+    fence();
+  }
+}
+
+/* One copy of the range kernels per instruction set, selected by `target`; in libnani. */
+template <typename F, std::size_t N>
+void to_soa_dispatch(
+  isa target,
+  F const* aos,
+  nani::soa_span<F, N> const& soa,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept;
+
+template <typename F, std::size_t N>
+void to_aos_dispatch(
+  isa target,
+  nani::soa_span<F const, N> const& soa,
+  F* aos,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept;
+} // namespace detail
+
+template <typename F, std::size_t N>
+void to_soa(std::span<nani::vector<F, N> const> aos, nani::soa_span<F, N> soa)
+{
+  static_assert(sizeof(nani::vector<F, N>) == N * sizeof(F));
+  meta::check_size(aos.size(), soa.size());
+
+  auto const streaming = aos.size() * sizeof(nani::vector<F, N>) > streaming_bytes;
+  auto const* const base = aos.empty() ? nullptr : &aos[0][0];
+  auto const target = nani::active_isa();
+
+  nani::parallel_for(aos.size(), grain, [&](std::size_t begin, std::size_t end) {
+    if constexpr (detail::dispatched<F, N>) {
+      detail::to_soa_dispatch(target, base, soa, begin, end, streaming);
+    }
+    else {
+      detail::to_soa_range<F, N, nani::simd_width_v<F>>(base, soa, begin, end, streaming);
+    }
+  });
+}
+
+template <typename F, std::size_t N>
+void to_aos(nani::soa_span<F const, N> soa, std::span<nani::vector<F, N>> aos)
+{
+  static_assert(sizeof(nani::vector<F, N>) == N * sizeof(F));
+  meta::check_size(soa.size(), aos.size());
+
+  auto const streaming = aos.size() * sizeof(nani::vector<F, N>) > streaming_bytes;
+  auto* const base = aos.empty() ? nullptr : &aos[0][0];
+  auto const target = nani::active_isa();
+
+  nani::parallel_for(aos.size(), grain, [&](std::size_t begin, std::size_t end) {
+    if constexpr (detail::dispatched<F, N>) {
+      detail::to_aos_dispatch(target, soa, base, begin, end, streaming);
+    }
+    else {
+      detail::to_aos_range<F, N, nani::simd_width_v<F>>(soa, base, begin, end, streaming);
+    }
+  });
+}
+} // namespace nani::layout
+
+#endif // NANI_LAYOUT_HPP
@@ -0,0 +1,177 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_LIMITER_HPP
+#define NANI_LIMITER_HPP
+
+#include <cstddef>
+#include <limits>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+
+/** Slope Limiters
+ *
+ * A limiter maps the backward difference `a` and the forward difference `b` of a cell to the
+ * slope used for the reconstruction: zero at an extremum (a and b of opposite sign), and between
+ * a and b otherwise, within the TVD region.
+ *
+ * The limiters are written without branches, from `abs`, `sign`, `min` and `max` alone, so that
+ * the same code runs on scalars, on `pack`s of cells and, component by component, on vectors.
+ **/
+namespace nani::limiter {
+/* Number of cells handed to a thread at once. */
+inline constexpr std::size_t grain = 8192;
+
+enum class kind { minmod, van_leer, superbee, mc };
+
+/* \brief sign * min(|a|, |b|), the most diffusive TVD limiter */
+template <typename T>
+constexpr auto minmod(T const& a, T const& b) noexcept -> T;
+
+/* \brief Harmonic mean 2ab / (a + b) of slopes of the same sign */
+template <typename T>
+constexpr auto van_leer(T const& a, T const& b) noexcept -> T;
+
+/* \brief sign * max(min(2|a|, |b|), min(|a|, 2|b|)), the least diffusive TVD limiter */
+template <typename T>
+constexpr auto superbee(T const& a, T const& b) noexcept -> T;
+
+/* \brief Monotonized central: sign * min(2|a|, 2|b|, |a + b| / 2) */
+template <typename T>
+constexpr auto mc(T const& a, T const& b) noexcept -> T;
+
+template <kind K, typename T>
+constexpr auto limit(T const& a, T const& b) noexcept -> T;
+
+/* \brief Component-wise limit<K> */
+template <kind K, vector_like A>
+constexpr auto limit(A const& a, A const& b) noexcept -> vector_of<A>;
+
+/* \brief slope[i] = limit<K>(backward[i], forward[i]), SIMD across cells
+ *
+ * PreConditions : backward, forward and slope have the same size
+ */
+template <kind K, typename F, std::size_t N>
+void apply(
+  nani::soa_span<F const, N> backward,
+  nani::soa_span<F const, N> forward,
+  nani::soa_span<F, N> slope);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* Value type of a lane type. */
+template <typename T>
+struct lane {
+  using type = T;
+};
+
+template <typename F, std::size_t W>
+struct lane<nani::pack<F, W>> {
+  using type = F;
+};
+
+/* 1 where a and b have the same sign, 0 where they differ. Where exactly one of them is zero it
+ * is 1/2, and every limiter below vanishes there anyway.
+ */
+template <typename T>
+constexpr auto agree(T const& a, T const& b) noexcept -> T
+{
+  return T(0.5) * (nani::sign(a) + nani::sign(b));
+}
+} // namespace detail
+
+template <typename T>
+constexpr auto minmod(T const& a, T const& b) noexcept -> T
+{
+  return detail::agree(a, b) * nani::min(nani::abs(a), nani::abs(b));
+}
+
+template <typename T>
+constexpr auto van_leer(T const& a, T const& b) noexcept -> T
+{
+  // (a |b| + |a| b) / (|a| + |b|) is 2ab / (a + b) for slopes of the same sign and 0 otherwise;
+  // the floor on the denominator keeps a flat region at 0 instead of 0 / 0.
+  using F = typename detail::lane<T>::type;
+  auto const aa = nani::abs(a);
+  auto const ab = nani::abs(b);
+  return (a * ab + aa * b) / nani::max(aa + ab, T(std::numeric_limits<F>::min()));
+}
+
+template <typename T>
+constexpr auto superbee(T const& a, T const& b) noexcept -> T
+{
+  auto const aa = nani::abs(a);
+  auto const ab = nani::abs(b);
+  return detail::agree(a, b) * nani::max(nani::min(T(2) * aa, ab), nani::min(aa, T(2) * ab));
+}
+
+template <typename T>
+constexpr auto mc(T const& a, T const& b) noexcept -> T
+{
+  auto const steepest = T(2) * nani::min(nani::abs(a), nani::abs(b));
+  return detail::agree(a, b) * nani::min(steepest, T(0.5) * nani::abs(a + b));
+}
+
+template <kind K, typename T>
+constexpr auto limit(T const& a, T const& b) noexcept -> T
+{
+  if constexpr (K == kind::minmod) {
+    return limiter::minmod(a, b);
+  }
+  else if constexpr (K == kind::van_leer) {
+    return limiter::van_leer(a, b);
+  }
+  else if constexpr (K == kind::superbee) {
+    return limiter::superbee(a, b);
+  }
+  else {
+    return limiter::mc(a, b);
+  }
+}
+
+template <kind K, vector_like A>
+constexpr auto limit(A const& a, A const& b) noexcept -> vector_of<A>
+{
+  using type = vector_of<A>;
+  auto result = type();
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = limiter::limit<K>(a[i], b[i]);
+  }
+  return result;
+}
+
+template <kind K, typename F, std::size_t N>
+void apply(
+  nani::soa_span<F const, N> backward,
+  nani::soa_span<F const, N> forward,
+  nani::soa_span<F, N> slope)
+{
+  meta::check_size(backward.size(), slope.size());
+  meta::check_size(forward.size(), slope.size());
+
+  constexpr auto width = nani::simd_width_v<F>;
+  nani::parallel_for(slope.size(), grain, [&](std::size_t begin, std::size_t end) {
+    auto i = begin;
+    for (; i + width <= end; i += width) {
+      slope.template store_pack<width>(
+        i,
+        limiter::limit<K>(
+          backward.template load_pack<width>(i), forward.template load_pack<width>(i)));
+    }
+    for (; i < end; ++i) {
+      slope.store(i, limiter::limit<K>(backward.load(i), forward.load(i)));
+    }
+  });
+}
+} // namespace nani::limiter
+
+#endif // NANI_LIMITER_HPP
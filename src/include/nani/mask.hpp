@@ -0,0 +1,330 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_MASK_HPP
+#define NANI_MASK_HPP
+
+#include <cstddef>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace nani {
+/** Mask
+ *
+ * One flag per component of a `vector<F, N>`, the result of the component-wise comparisons
+ * below. Masks replace data-dependent branches: compute both alternatives and `select` between
+ * them, and the loops over the components stay free of jumps.
+ *
+ * A flag is a `bool`, or for a vector of packs the `pack_mask` of the lanes of the component, so
+ * that a batched kernel selects per lane. `all`, `any`, `none` and `count` then look at every
+ * lane of every component.
+ **/
+template <std::size_t N, typename M = bool>
+class mask {
+public:
+  using value_type = M;
+  using size_type = std::size_t;
+  static constexpr std::size_t dim = N;
+
+public:
+  mask() = default;
+
+  constexpr static auto fill(bool value) noexcept -> mask;
+
+public:
+  constexpr auto operator[](std::size_t i) const noexcept -> M const&;
+
+  constexpr auto operator[](std::size_t i) noexcept -> M&;
+
+  constexpr auto size() const noexcept -> size_type;
+
+public:
+  constexpr auto operator&=(mask const& other) noexcept -> mask&;
+  constexpr auto operator|=(mask const& other) noexcept -> mask&;
+  constexpr auto operator^=(mask const& other) noexcept -> mask&;
+
+private:
+  nani::static_array<M, N> x_{};
+};
+
+template <std::size_t N, typename M>
+constexpr auto operator&(mask<N, M> a, mask<N, M> const& b) noexcept -> mask<N, M>;
+
+template <std::size_t N, typename M>
+constexpr auto operator|(mask<N, M> a, mask<N, M> const& b) noexcept -> mask<N, M>;
+
+template <std::size_t N, typename M>
+constexpr auto operator^(mask<N, M> a, mask<N, M> const& b) noexcept -> mask<N, M>;
+
+template <std::size_t N, typename M>
+constexpr auto operator!(mask<N, M> const& a) noexcept -> mask<N, M>;
+
+template <std::size_t N, typename M>
+constexpr auto all(mask<N, M> const& m) noexcept -> bool;
+
+template <std::size_t N, typename M>
+constexpr auto any(mask<N, M> const& m) noexcept -> bool;
+
+template <std::size_t N, typename M>
+constexpr auto none(mask<N, M> const& m) noexcept -> bool;
+
+/* \brief Number of set components, or of set lanes for a vector of packs */
+template <std::size_t N, typename M>
+constexpr auto count(mask<N, M> const& m) noexcept -> std::size_t;
+
+/* \brief Mask of the component-wise comparison of A and B */
+template <vector_like A, vector_like B>
+using mask_of = mask<
+  vector_dim_v<A>,
+  decltype(std::declval<vector_value_t<A>>() < std::declval<vector_value_t<B>>())>;
+
+/* \brief Component-wise a < b */
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto less(A const& a, B const& b) noexcept -> mask_of<A, B>;
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto less_equal(A const& a, B const& b) noexcept -> mask_of<A, B>;
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto greater(A const& a, B const& b) noexcept -> mask_of<A, B>;
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto greater_equal(A const& a, B const& b) noexcept -> mask_of<A, B>;
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto equal(A const& a, B const& b) noexcept -> mask_of<A, B>;
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto not_equal(A const& a, B const& b) noexcept -> mask_of<A, B>;
+
+/* \brief result[i] = m[i] ? a[i] : b[i], lane by lane for a vector of packs */
+template <typename M, vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto select(mask<vector_dim_v<A>, M> const& m, A const& a, B const& b) noexcept
+  -> vector_of<A>;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+template <vector_like A, vector_like B, typename Compare>
+constexpr auto compare(A const& a, B const& b, Compare const& compare) noexcept -> mask_of<A, B>
+{
+  auto result = mask_of<A, B>();
+  for (std::size_t i = 0; i < vector_dim_v<A>; ++i) {
+    result[i] = compare(a[i], b[i]);
+  }
+  return result;
+}
+
+// The flags of one component: a bool, or a pack mask whose own overloads are found by ADL.
+constexpr auto lanes(bool m) noexcept -> std::size_t
+{
+  return m ? 1 : 0;
+}
+
+template <typename M>
+constexpr auto lanes(M const& m) noexcept -> std::size_t
+{
+  return count(m);
+}
+
+template <typename M>
+constexpr auto width() noexcept -> std::size_t
+{
+  if constexpr (std::is_same_v<M, bool>) {
+    return 1;
+  }
+  else {
+    return M::width;
+  }
+}
+
+template <typename T>
+constexpr auto choose(bool m, T const& a, T const& b) noexcept -> T
+{
+  return m ? a : b;
+}
+
+template <typename M, typename T>
+constexpr auto choose(M const& m, T const& a, T const& b) noexcept -> T
+{
+  return select(m, a, b);
+}
+} // namespace detail
+
+template <std::size_t N, typename M>
+constexpr auto mask<N, M>::fill(bool value) noexcept -> mask
+{
+  auto m = mask();
+  for (std::size_t i = 0; i < N; ++i) {
+    m.x_[i] = M(value);
+  }
+  return m;
+}
+
+template <std::size_t N, typename M>
+constexpr auto mask<N, M>::operator[](std::size_t i) const noexcept -> M const&
+{
+  return x_[i];
+}
+
+template <std::size_t N, typename M>
+constexpr auto mask<N, M>::operator[](std::size_t i) noexcept -> M&
+{
+  return x_[i];
+}
+
+template <std::size_t N, typename M>
+constexpr auto mask<N, M>::size() const noexcept -> size_type
+{
+  return dim;
+}
+
+template <std::size_t N, typename M>
+constexpr auto mask<N, M>::operator&=(mask const& other) noexcept -> mask&
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    x_[i] = M(x_[i] & other.x_[i]);
+  }
+  return *this;
+}
+
+template <std::size_t N, typename M>
+constexpr auto mask<N, M>::operator|=(mask const& other) noexcept -> mask&
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    x_[i] = M(x_[i] | other.x_[i]);
+  }
+  return *this;
+}
+
+template <std::size_t N, typename M>
+constexpr auto mask<N, M>::operator^=(mask const& other) noexcept -> mask&
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    x_[i] = M(x_[i] ^ other.x_[i]);
+  }
+  return *this;
+}
+
+template <std::size_t N, typename M>
+constexpr auto operator&(mask<N, M> a, mask<N, M> const& b) noexcept -> mask<N, M>
+{
+  return a &= b;
+}
+
+template <std::size_t N, typename M>
+constexpr auto operator|(mask<N, M> a, mask<N, M> const& b) noexcept -> mask<N, M>
+{
+  return a |= b;
+}
+
+template <std::size_t N, typename M>
+constexpr auto operator^(mask<N, M> a, mask<N, M> const& b) noexcept -> mask<N, M>
+{
+  return a ^= b;
+}
+
+template <std::size_t N, typename M>
+constexpr auto operator!(mask<N, M> const& a) noexcept -> mask<N, M>
+{
+  return a ^ mask<N, M>::fill(true);
+}
+
+template <std::size_t N, typename M>
+constexpr auto all(mask<N, M> const& m) noexcept -> bool
+{
+  return count(m) == N * detail::width<M>();
+}
+
+template <std::size_t N, typename M>
+constexpr auto any(mask<N, M> const& m) noexcept -> bool
+{
+  return count(m) != 0;
+}
+
+template <std::size_t N, typename M>
+constexpr auto none(mask<N, M> const& m) noexcept -> bool
+{
+  return count(m) == 0;
+}
+
+template <std::size_t N, typename M>
+constexpr auto count(mask<N, M> const& m) noexcept -> std::size_t
+{
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    result += detail::lanes(m[i]);
+  }
+  return result;
+}
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto less(A const& a, B const& b) noexcept -> mask_of<A, B>
+{
+  return detail::compare(a, b, [](auto const& x, auto const& y) { return x < y; });
+}
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto less_equal(A const& a, B const& b) noexcept -> mask_of<A, B>
+{
+  return detail::compare(a, b, [](auto const& x, auto const& y) { return x <= y; });
+}
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto greater(A const& a, B const& b) noexcept -> mask_of<A, B>
+{
+  return detail::compare(a, b, [](auto const& x, auto const& y) { return x > y; });
+}
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto greater_equal(A const& a, B const& b) noexcept -> mask_of<A, B>
+{
+  return detail::compare(a, b, [](auto const& x, auto const& y) { return x >= y; });
+}
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto equal(A const& a, B const& b) noexcept -> mask_of<A, B>
+{
+  return detail::compare(a, b, [](auto const& x, auto const& y) { return x == y; });
+}
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto not_equal(A const& a, B const& b) noexcept -> mask_of<A, B>
+{
+  return detail::compare(a, b, [](auto const& x, auto const& y) { return x != y; });
+}
+
+template <typename M, vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto select(mask<vector_dim_v<A>, M> const& m, A const& a, B const& b) noexcept
+  -> vector_of<A>
+{
+  using type = vector_of<A>;
+  auto result = type();
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = detail::choose(m[i], a[i], b[i]);
+  }
+  return result;
+}
+} // namespace nani
+
+#endif // NANI_MASK_HPP
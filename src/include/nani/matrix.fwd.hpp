@@ -3,14 +3,60 @@
 // SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
 // -------------------------------------------------------------------------------------------------
 
-#ifndef BATI_MATRIX_FWD_HPP
-#define BATI_MATRIX_FWD_HPP
+#ifndef NANI_MATRIX_FWD_HPP
+#define NANI_MATRIX_FWD_HPP
 
 #include <cstddef>
+#include <type_traits>
 
-namespace bati {
+namespace nani {
 template <typename F, std::size_t R, std::size_t C>
 class matrix;
-} // namespace bati
 
-#endif // BATI_MATRIX_FWD_HPP
+template <typename F, std::size_t R, std::size_t C>
+class matrix_view;
+
+/** Matrix Traits
+ *
+ * Counterpart of `vector_traits` for `matrix` and `matrix_view`.
+ **/
+template <typename T>
+struct matrix_traits {};
+
+template <typename F, std::size_t R, std::size_t C>
+struct matrix_traits<matrix<F, R, C>> {
+  using value_type = F;
+  static constexpr std::size_t rows = R;
+  static constexpr std::size_t cols = C;
+};
+
+template <typename F, std::size_t R, std::size_t C>
+struct matrix_traits<matrix_view<F, R, C>> {
+  using value_type = std::remove_cv_t<F>;
+  static constexpr std::size_t rows = R;
+  static constexpr std::size_t cols = C;
+};
+
+template <typename T>
+concept matrix_like = requires { typename matrix_traits<std::remove_cvref_t<T>>::value_type; };
+
+template <matrix_like T>
+using matrix_value_t = typename matrix_traits<std::remove_cvref_t<T>>::value_type;
+
+template <matrix_like T>
+inline constexpr std::size_t matrix_rows_v = matrix_traits<std::remove_cvref_t<T>>::rows;
+
+template <matrix_like T>
+inline constexpr std::size_t matrix_cols_v = matrix_traits<std::remove_cvref_t<T>>::cols;
+
+template <matrix_like T>
+using matrix_of = matrix<matrix_value_t<T>, matrix_rows_v<T>, matrix_cols_v<T>>;
+
+template <typename A, typename B>
+concept same_matrix_shape = matrix_like<A> and matrix_like<B>
+                            and std::is_same_v<matrix_value_t<A>, matrix_value_t<B>>
+                            and matrix_rows_v<A> == matrix_rows_v<B>
+                            and matrix_cols_v<A> == matrix_cols_v<B>;
+} // namespace nani
+
+#endif // NANI_MATRIX_FWD_HPP
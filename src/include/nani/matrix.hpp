@@ -6,10 +6,13 @@
 #ifndef NANI_MATRIX_HPP
 #define NANI_MATRIX_HPP
 
+#include <algorithm>
+#include <nani/gemm.hpp>
 #include <nani/matrix.fwd.hpp>
 #include <nani/smath.hpp>
 #include <nani/static_array.hpp>
 #include <nani/vector.hpp>
+#include <type_traits>
 
 namespace nani {
 template <typename F, std::size_t R, std::size_t C>
@@ -18,7 +21,7 @@ private:
   static constexpr auto const nrow_ = R;
   static constexpr auto const ncol_ = C;
 
-  using row_type = typename nani::static_array<double, ncol_>;
+  using row_type = typename nani::static_array<F, ncol_>;
 
 public:
   using size_type = nani::static_array<std::size_t, 2>;
@@ -62,41 +65,70 @@ private:
   storage_type x_{};
 };
 
-template <typename F, std::size_t R, std::size_t C>
-
-constexpr auto operator+(matrix<F, R, C> const& a, matrix<F, R, C> const& b) -> matrix<F, R, C>;
-
-template <typename F, std::size_t R, std::size_t C>
+template <matrix_like A, matrix_like B>
+  requires same_matrix_shape<A, B>
+constexpr auto operator+(A const& a, B const& b) -> matrix_of<A>;
 
-constexpr auto operator-(matrix<F, R, C> const& a, matrix<F, R, C> const& b) -> matrix<F, R, C>;
+template <matrix_like A, matrix_like B>
+  requires same_matrix_shape<A, B>
+constexpr auto operator-(A const& a, B const& b) -> matrix_of<A>;
 
-template <typename F, std::size_t R, std::size_t S, std::size_t T>
-
-constexpr auto operator-(matrix<F, R, S> const& a, matrix<F, S, T> const& b) -> matrix<F, R, T>;
-
-template <typename F, std::size_t R, std::size_t C>
-
-constexpr auto operator*(matrix<F, R, C> const& a, vector<F, C> const& b) -> vector<F, R>;
-
-template <typename F, std::size_t R, std::size_t C>
-
-constexpr auto operator*(vector<F, R> const& a, matrix<F, R, C> const& b) -> vector<F, C>;
-
-template <typename F, std::size_t R, std::size_t C>
-
-constexpr auto operator*(matrix<F, R, C> const& a, double b) -> matrix<F, R, C>;
-
-template <typename F, std::size_t R, std::size_t C>
-
-constexpr auto operator*(double a, matrix<F, R, C> const& b) -> matrix<F, R, C>;
-
-template <typename F, std::size_t R, std::size_t C>
-
-constexpr auto operator/(matrix<F, R, C> const& a, double b) -> matrix<F, R, C>;
-
-template <typename F, std::size_t R, std::size_t C>
+/* \brief Matrix product, with the kernel `gemm::tuned_v` of the shape outside of constant
+ * evaluation
+ */
+template <matrix_like A, matrix_like B>
+  requires std::is_same_v<matrix_value_t<A>, matrix_value_t<B>>
+           and (matrix_cols_v<A> == matrix_rows_v<B>)
+constexpr auto operator*(A const& a, B const& b)
+  -> matrix<matrix_value_t<A>, matrix_rows_v<A>, matrix_cols_v<B>>;
+
+template <matrix_like A, vector_like B>
+  requires std::is_same_v<matrix_value_t<A>, vector_value_t<B>>
+           and (matrix_cols_v<A> == vector_dim_v<B>)
+constexpr auto operator*(A const& a, B const& b) -> vector<matrix_value_t<A>, matrix_rows_v<A>>;
+
+template <vector_like A, matrix_like B>
+  requires std::is_same_v<vector_value_t<A>, matrix_value_t<B>>
+           and (vector_dim_v<A> == matrix_rows_v<B>)
+constexpr auto operator*(A const& a, B const& b) -> vector<matrix_value_t<B>, matrix_cols_v<B>>;
+
+template <matrix_like A>
+constexpr auto operator*(A const& a, double b) -> matrix_of<A>;
+
+template <matrix_like B>
+constexpr auto operator*(double a, B const& b) -> matrix_of<B>;
+
+template <matrix_like A>
+constexpr auto operator/(A const& a, double b) -> matrix_of<A>;
+
+template <vector_like A, vector_like B>
+  requires std::is_same_v<vector_value_t<A>, vector_value_t<B>>
+constexpr auto outer(A const& a, B const& b)
+  -> matrix<vector_value_t<A>, vector_dim_v<A>, vector_dim_v<B>>;
+
+/* \brief Skew-symmetric matrix [a]x such that [a]x * b == a ^ b */
+template <vector_like A>
+  requires(vector_dim_v<A> == 3)
+constexpr auto cross_matrix(A const& a) -> matrix<vector_value_t<A>, 3, 3>;
+
+/* \brief Rotation by `angle` (right-handed) about the unit vector `axis` (Rodrigues' formula)
+ *
+ * PreConditions : l2_norm(axis) == 1
+ */
+template <vector_like A>
+  requires(vector_dim_v<A> == 3)
+constexpr auto rotation(A const& axis, vector_value_t<A> angle) -> matrix<vector_value_t<A>, 3, 3>;
 
-constexpr auto outer(vector<F, R> const& a, vector<F, C> const& b) -> matrix<F, R, C>;
+/* \brief Orthonormal frame whose first row is the unit vector `n`
+ *
+ * Multiplying with the frame expresses a vector in (normal, tangent, bitangent) coordinates, as
+ * needed to rotate momentum into the frame of a face.
+ *
+ * PreConditions : l2_norm(n) == 1
+ */
+template <vector_like A>
+  requires(vector_dim_v<A> == 3)
+constexpr auto frame(A const& n) -> matrix<vector_value_t<A>, 3, 3>;
 
 /* \brief Compute determinant of a Small Matrix
  *
@@ -106,9 +138,22 @@ constexpr auto outer(vector<F, R> const& a, vector<F, C> const& b) -> matrix<F,
  *
  * PreConditions : R<6
  */
-template <typename F, std::size_t R>
-constexpr auto determinant(matrix<F, R, R> const& a) -> double
-  requires(R < 6);
+template <matrix_like A>
+constexpr auto determinant(A const& a) -> double
+  requires(matrix_rows_v<A> == matrix_cols_v<A> and matrix_rows_v<A> < 6);
+
+/* \brief Adjugate of a matrix of size up to 3, such that a * adjugate(a) == determinant(a) * I */
+template <matrix_like A>
+  requires(matrix_rows_v<A> == matrix_cols_v<A> and matrix_rows_v<A> <= 3)
+constexpr auto adjugate(A const& a) -> matrix_of<A>;
+
+/* \brief Inverse of a matrix of size up to 3, from its adjugate
+ *
+ * PreConditions : determinant(a) != 0
+ */
+template <matrix_like A>
+  requires(matrix_rows_v<A> == matrix_cols_v<A> and matrix_rows_v<A> <= 3)
+constexpr auto inverse(A const& a) -> matrix_of<A>;
 
 //------------------------------------------------------------------------------
 // Implementation
@@ -185,16 +230,11 @@ template <std::size_t N>
 constexpr matrix<F, R, C>::operator vector<F, N>() const noexcept
   requires((C == 1 and N == R) or (R == 1 and N == C))
 {
-  if constexpr (C == 1) {
-    auto x = vector<F, N>();
-    for (std::size_t i = 0; i < R; ++i) {
-      x[i] = x_[i][0];
-      return x;
-    }
-  }
-  else {
-    return x_[0];
+  auto x = vector<F, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    x[i] = C == 1 ? x_[i][0] : x_[0][i];
   }
+  return x;
 }
 
 template <typename F, std::size_t R, std::size_t C>
@@ -203,122 +243,196 @@ constexpr auto matrix<F, R, C>::size() const noexcept -> nani::static_array<std:
   return nani::static_array<std::size_t, 2>(R, C);
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto operator+(matrix<F, R, C> const& a, matrix<F, R, C> const& b) -> matrix<F, R, C>
+template <matrix_like A, matrix_like B>
+  requires same_matrix_shape<A, B>
+constexpr auto operator+(A const& a, B const& b) -> matrix_of<A>
 {
-  auto result = matrix<F, R, C>();
-  for (std::size_t i = 0; i < R; ++i) {
-    for (std::size_t j = 0; j < C; ++j) {
+  auto result = matrix_of<A>();
+  for (std::size_t i = 0; i < matrix_rows_v<A>; ++i) {
+    for (std::size_t j = 0; j < matrix_cols_v<A>; ++j) {
       result[i][j] = a[i][j] + b[i][j];
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto operator-(matrix<F, R, C> const& a, matrix<F, R, C> const& b) -> matrix<F, R, C>
+template <matrix_like A, matrix_like B>
+  requires same_matrix_shape<A, B>
+constexpr auto operator-(A const& a, B const& b) -> matrix_of<A>
 {
-  auto result = matrix<F, R, C>();
-  for (std::size_t i = 0; i < R; ++i) {
-    for (std::size_t j = 0; j < C; ++j) {
+  auto result = matrix_of<A>();
+  for (std::size_t i = 0; i < matrix_rows_v<A>; ++i) {
+    for (std::size_t j = 0; j < matrix_cols_v<A>; ++j) {
       result[i][j] = a[i][j] - b[i][j];
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto operator*(matrix<F, R, C> const& a, vector<F, C> const& b) -> vector<F, R>
+template <matrix_like A, vector_like B>
+  requires std::is_same_v<matrix_value_t<A>, vector_value_t<B>>
+           and (matrix_cols_v<A> == vector_dim_v<B>)
+constexpr auto operator*(A const& a, B const& b) -> vector<matrix_value_t<A>, matrix_rows_v<A>>
 {
-  auto result = vector<F, R>();
-  for (std::size_t i = 0; i < R; ++i) {
+  auto result = vector<matrix_value_t<A>, matrix_rows_v<A>>();
+  for (std::size_t i = 0; i < matrix_rows_v<A>; ++i) {
     result[i] = 0;
-    for (std::size_t j = 0; j < C; ++j) {
+    for (std::size_t j = 0; j < matrix_cols_v<A>; ++j) {
       result[i] += a[i][j] * b[j];
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto operator*(vector<F, R> const& a, matrix<F, R, C> const& b) -> vector<F, C>
+template <vector_like A, matrix_like B>
+  requires std::is_same_v<vector_value_t<A>, matrix_value_t<B>>
+           and (vector_dim_v<A> == matrix_rows_v<B>)
+constexpr auto operator*(A const& a, B const& b) -> vector<matrix_value_t<B>, matrix_cols_v<B>>
 {
-  auto result = vector<F, C>();
-  for (std::size_t i = 0; i < C; ++i) {
+  auto result = vector<matrix_value_t<B>, matrix_cols_v<B>>();
+  for (std::size_t i = 0; i < matrix_cols_v<B>; ++i) {
     result[i] = 0;
-    for (std::size_t j = 0; j < R; ++j) {
+    for (std::size_t j = 0; j < matrix_rows_v<B>; ++j) {
       result[i] += a[j] * b[j][i];
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R, std::size_t S, std::size_t T>
-constexpr auto operator-(matrix<F, R, S> const& a, matrix<F, S, T> const& b) -> matrix<F, R, T>
+template <matrix_like A, matrix_like B>
+  requires std::is_same_v<matrix_value_t<A>, matrix_value_t<B>>
+           and (matrix_cols_v<A> == matrix_rows_v<B>)
+constexpr auto operator*(A const& a, B const& b)
+  -> matrix<matrix_value_t<A>, matrix_rows_v<A>, matrix_cols_v<B>>
 {
-  auto result = matrix<F, S, T>();
-  for (std::size_t i = 0; i < R; ++i) {
-    for (std::size_t j = 0; j < T; ++j) {
+  auto result = matrix<matrix_value_t<A>, matrix_rows_v<A>, matrix_cols_v<B>>();
+  if (not std::is_constant_evaluated()) {
+    gemm::multiply(a, b, result);
+    return result;
+  }
+  for (std::size_t i = 0; i < matrix_rows_v<A>; ++i) {
+    for (std::size_t j = 0; j < matrix_cols_v<B>; ++j) {
       result[i][j] = 0;
-      for (std::size_t k = 0; k < S; ++k) {
+      for (std::size_t k = 0; k < matrix_cols_v<A>; ++k) {
         result[i][j] += a[i][k] * b[k][j];
       }
     }
   }
+  return result;
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto operator*(matrix<F, R, C> const& a, double b) -> matrix<F, R, C>
+template <matrix_like A>
+constexpr auto operator*(A const& a, double b) -> matrix_of<A>
 {
-  auto result = a;
-  for (std::size_t i = 0; i < R; ++i) {
-    for (std::size_t j = 0; j < C; ++j) {
-      result[i][j] *= b;
+  auto result = matrix_of<A>();
+  for (std::size_t i = 0; i < matrix_rows_v<A>; ++i) {
+    for (std::size_t j = 0; j < matrix_cols_v<A>; ++j) {
+      result[i][j] = a[i][j] * b;
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto operator*(double a, matrix<F, R, C> const& b) -> matrix<F, R, C>
+template <matrix_like B>
+constexpr auto operator*(double a, B const& b) -> matrix_of<B>
 {
-  auto result = b;
-  for (std::size_t i = 0; i < R; ++i) {
-    for (std::size_t j = 0; j < C; ++j) {
-      result[i][j] *= a;
+  auto result = matrix_of<B>();
+  for (std::size_t i = 0; i < matrix_rows_v<B>; ++i) {
+    for (std::size_t j = 0; j < matrix_cols_v<B>; ++j) {
+      result[i][j] = a * b[i][j];
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto operator/(matrix<F, R, C> const& a, double b) -> matrix<F, R, C>
+template <matrix_like A>
+constexpr auto operator/(A const& a, double b) -> matrix_of<A>
 {
-  auto result = a;
-  for (std::size_t i = 0; i < R; ++i) {
-    for (std::size_t j = 0; j < C; ++j) {
-      result[i][j] /= b;
+  auto result = matrix_of<A>();
+  for (std::size_t i = 0; i < matrix_rows_v<A>; ++i) {
+    for (std::size_t j = 0; j < matrix_cols_v<A>; ++j) {
+      result[i][j] = a[i][j] / b;
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R, std::size_t C>
-constexpr auto outer(vector<F, R> const& a, vector<F, C> const& b) -> matrix<F, R, C>
+template <vector_like A, vector_like B>
+  requires std::is_same_v<vector_value_t<A>, vector_value_t<B>>
+constexpr auto outer(A const& a, B const& b)
+  -> matrix<vector_value_t<A>, vector_dim_v<A>, vector_dim_v<B>>
 {
-  auto result = matrix<F, R, C>();
-  for (std::size_t i = 0; i < R; ++i) {
-    for (std::size_t j = 0; j < C; ++j) {
+  auto result = matrix<vector_value_t<A>, vector_dim_v<A>, vector_dim_v<B>>();
+  for (std::size_t i = 0; i < vector_dim_v<A>; ++i) {
+    for (std::size_t j = 0; j < vector_dim_v<B>; ++j) {
       result[i][j] = a[i] * b[j];
     }
   }
   return result;
 }
 
-template <typename F, std::size_t R>
-constexpr auto determinant(matrix<F, R, R> const& a) -> double
-  requires(R < 6)
+template <vector_like A>
+  requires(vector_dim_v<A> == 3)
+constexpr auto cross_matrix(A const& a) -> matrix<vector_value_t<A>, 3, 3>
+{
+  using F = vector_value_t<A>;
+  auto result = matrix<F, 3, 3>::zero();
+  result[0][1] = -a[2];
+  result[0][2] = a[1];
+  result[1][0] = a[2];
+  result[1][2] = -a[0];
+  result[2][0] = -a[1];
+  result[2][1] = a[0];
+  return result;
+}
+
+template <vector_like A>
+  requires(vector_dim_v<A> == 3)
+constexpr auto rotation(A const& axis, vector_value_t<A> angle) -> matrix<vector_value_t<A>, 3, 3>
+{
+  using F = vector_value_t<A>;
+  auto const c = nani::cos(angle);
+  auto const s = nani::sin(angle);
+  auto const k = cross_matrix(axis);
+  auto result = matrix<F, 3, 3>::identity();
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      // (1 - c) * k * k == (1 - c) * (outer(axis, axis) - identity)
+      result[i][j] += s * k[i][j] + (1 - c) * (axis[i] * axis[j] - (i == j ? 1 : 0));
+    }
+  }
+  return result;
+}
+
+template <vector_like A>
+  requires(vector_dim_v<A> == 3)
+constexpr auto frame(A const& n) -> matrix<vector_value_t<A>, 3, 3>
+{
+  using F = vector_value_t<A>;
+  // Pick the coordinate axis least aligned with n, so that the tangent is well conditioned.
+  auto const ax = nani::abs(n[0]);
+  auto const ay = nani::abs(n[1]);
+  auto const az = nani::abs(n[2]);
+  auto const e = (ax <= ay and ax <= az) ? vector<F, 3>::unit(0)
+                 : (ay <= az)            ? vector<F, 3>::unit(1)
+                                         : vector<F, 3>::unit(2);
+  auto const t = normalize(n ^ e);
+  auto const b = n ^ t;
+
+  auto result = matrix<F, 3, 3>();
+  for (std::size_t j = 0; j < 3; ++j) {
+    result[0][j] = n[j];
+    result[1][j] = t[j];
+    result[2][j] = b[j];
+  }
+  return result;
+}
+
+template <matrix_like A>
+constexpr auto determinant(A const& a) -> double
+  requires(matrix_rows_v<A> == matrix_cols_v<A> and matrix_rows_v<A> < 6)
 {
+  constexpr auto R = matrix_rows_v<A>;
   nani::static_array<std::size_t, R> permutation{};
   for (std::size_t i = 0; i < R; ++i) {
     permutation[i] = i;
@@ -331,6 +445,9 @@ constexpr auto determinant(matrix<F, R, R> const& a) -> double
     double term = 1.0;
     for (std::size_t j = 0; j < R; ++j) {
       term *= a[j][permutation[j]];
+      for (std::size_t k = j + 1; k < R; ++k) {
+        term = permutation[k] < permutation[j] ? -term : term;
+      }
     }
     determinant += term;
     std::next_permutation(permutation.begin(), permutation.end());
@@ -338,5 +455,53 @@ constexpr auto determinant(matrix<F, R, R> const& a) -> double
   return determinant;
 }
 
+template <matrix_like A>
+  requires(matrix_rows_v<A> == matrix_cols_v<A> and matrix_rows_v<A> <= 3)
+constexpr auto adjugate(A const& a) -> matrix_of<A>
+{
+  constexpr auto R = matrix_rows_v<A>;
+  auto result = matrix_of<A>();
+  if constexpr (R == 1) {
+    result[0][0] = 1;
+  }
+  else if constexpr (R == 2) {
+    result[0][0] = a[1][1];
+    result[0][1] = -a[0][1];
+    result[1][0] = -a[1][0];
+    result[1][1] = a[0][0];
+  }
+  else if constexpr (R == 3) {
+    // Cofactors by cyclic permutation of the indices, which carries the sign.
+    for (std::size_t i = 0; i < 3; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        auto const j1 = (j + 1) % 3;
+        auto const j2 = (j + 2) % 3;
+        auto const i1 = (i + 1) % 3;
+        auto const i2 = (i + 2) % 3;
+        result[i][j] = a[j1][i1] * a[j2][i2] - a[j1][i2] * a[j2][i1];
+      }
+    }
+  }
+  return result;
+}
+
+template <matrix_like A>
+  requires(matrix_rows_v<A> == matrix_cols_v<A> and matrix_rows_v<A> <= 3)
+constexpr auto inverse(A const& a) -> matrix_of<A>
+{
+  constexpr auto R = matrix_rows_v<A>;
+  auto result = adjugate(a);
+  auto det = matrix_value_t<A>(0);
+  for (std::size_t j = 0; j < R; ++j) {
+    det += a[0][j] * result[j][0];
+  }
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < R; ++j) {
+      result[i][j] /= det;
+    }
+  }
+  return result;
+}
+
 } // namespace nani
 #endif // NANI_MATRIX_HPP
@@ -6,6 +6,9 @@
 #ifndef NANI_META_HPP
 #define NANI_META_HPP
 
+#include <cstddef>
+#include <stdexcept>
+
 namespace nani::meta {
 constexpr auto is_debug_build() noexcept -> bool
 {
@@ -15,6 +18,16 @@ constexpr auto is_debug_build() noexcept -> bool
   return false;
 #endif
 }
+
+/* \brief Reject inconsistent argument sizes of batched kernels in debug builds */
+inline void check_size(std::size_t expected, std::size_t actual)
+{
+  if constexpr (is_debug_build()) {
+    if (expected != actual) {
+      throw std::runtime_error("Size Mismatch");
+    }
+  }
+}
 } // namespace nani::meta
 
 #endif // NANI_META_HPP
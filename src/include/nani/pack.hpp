@@ -0,0 +1,498 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_PACK_HPP
+#define NANI_PACK_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <nani/isa.hpp>
+#include <type_traits>
+
+#if NANI_X86
+#include <immintrin.h>
+#endif
+
+#if not defined(__GNUC__)
+#error "nani::pack requires the GNU vector extensions (GCC or Clang)"
+#endif
+
+namespace nani {
+/* \brief Width in bytes of the widest SIMD register of the compilation target */
+inline constexpr std::size_t simd_bytes =
+#if defined(__AVX512F__)
+  64;
+#elif defined(__AVX__)
+  32;
+#else
+  16;
+#endif
+
+/* \brief Number of lanes of type F in one SIMD register of the compilation target */
+template <typename F>
+inline constexpr std::size_t simd_width_v = simd_bytes / sizeof(F) > 0 ? simd_bytes / sizeof(F) : 1;
+
+template <typename F, std::size_t W>
+class pack_mask;
+
+/** SIMD Pack
+ *
+ * W lanes of an arithmetic type F held in one (or a few) SIMD registers. Arithmetic is lane-wise
+ * and a scalar converts implicitly to a pack by broadcasting, so `pack<F, W>` can stand in for `F`
+ * as the value type of `vector`: `vector<pack<F, W>, N>` is N components of W cells each, and
+ * generic point-wise kernels evaluate W cells at once.
+ *
+ * Comparisons are lane-wise too and give a `pack_mask`, for `select` rather than a branch.
+ *
+ * The overloads of `abs`, `sqrt`, `sign`, `min` and `max` below are picked over the scalar ones in
+ * `smath.hpp`, which includes this header (with GCC and Clang) so that both are visible to every
+ * generic kernel.
+ **/
+template <typename F, std::size_t W>
+class pack {
+public:
+  static_assert(std::is_arithmetic_v<F>);
+  static_assert(W > 0 and (W & (W - 1)) == 0, "the width of a pack must be a power of two");
+
+public:
+  using value_type = F;
+  typedef F native_type __attribute__((vector_size(W * sizeof(F)))); // NOLINT(modernize-use-using)
+  static constexpr std::size_t width = W;
+
+public:
+  pack() = default;
+
+  constexpr pack(value_type x) noexcept; // NOLINT(google-explicit-constructor)
+
+  static constexpr auto from_native(native_type const& v) noexcept -> pack;
+
+  /* \brief Load W consecutive values from p, which need not be aligned */
+  static auto load(value_type const* p) noexcept -> pack;
+
+public:
+  /* \brief Store the W lanes to p, which need not be aligned */
+  void store(value_type* p) const noexcept;
+
+  constexpr auto operator[](std::size_t i) const noexcept -> value_type;
+
+  constexpr void set(std::size_t i, value_type x) noexcept;
+
+  constexpr auto native() const noexcept -> native_type;
+
+public:
+  constexpr auto operator+=(pack const& other) noexcept -> pack&;
+  constexpr auto operator-=(pack const& other) noexcept -> pack&;
+  constexpr auto operator*=(pack const& other) noexcept -> pack&;
+  constexpr auto operator/=(pack const& other) noexcept -> pack&;
+
+public:
+  // Hidden friends, so that a scalar operand converts to a pack.
+  friend constexpr auto operator-(pack const& a) noexcept -> pack
+  {
+    return from_native(-a.v_);
+  }
+
+  friend constexpr auto operator+(pack const& a, pack const& b) noexcept -> pack
+  {
+    return from_native(a.v_ + b.v_);
+  }
+
+  friend constexpr auto operator-(pack const& a, pack const& b) noexcept -> pack
+  {
+    return from_native(a.v_ - b.v_);
+  }
+
+  friend constexpr auto operator*(pack const& a, pack const& b) noexcept -> pack
+  {
+    return from_native(a.v_ * b.v_);
+  }
+
+  friend constexpr auto operator/(pack const& a, pack const& b) noexcept -> pack
+  {
+    return from_native(a.v_ / b.v_);
+  }
+
+  friend constexpr auto operator<(pack const& a, pack const& b) noexcept -> pack_mask<F, W>
+  {
+    return pack_mask<F, W>::from_native(a.v_ < b.v_);
+  }
+
+  friend constexpr auto operator<=(pack const& a, pack const& b) noexcept -> pack_mask<F, W>
+  {
+    return pack_mask<F, W>::from_native(a.v_ <= b.v_);
+  }
+
+  friend constexpr auto operator>(pack const& a, pack const& b) noexcept -> pack_mask<F, W>
+  {
+    return pack_mask<F, W>::from_native(a.v_ > b.v_);
+  }
+
+  friend constexpr auto operator>=(pack const& a, pack const& b) noexcept -> pack_mask<F, W>
+  {
+    return pack_mask<F, W>::from_native(a.v_ >= b.v_);
+  }
+
+  friend constexpr auto operator==(pack const& a, pack const& b) noexcept -> pack_mask<F, W>
+  {
+    return pack_mask<F, W>::from_native(a.v_ == b.v_);
+  }
+
+  friend constexpr auto operator!=(pack const& a, pack const& b) noexcept -> pack_mask<F, W>
+  {
+    return pack_mask<F, W>::from_native(a.v_ != b.v_);
+  }
+
+private:
+  native_type v_;
+};
+
+/** Pack Mask
+ *
+ * One flag per lane of a `pack<F, W>`, held as the SIMD comparisons produce it: a lane of all
+ * ones or all zeros, of the width of F. `select` on it lowers to a blend.
+ **/
+template <typename F, std::size_t W>
+class pack_mask {
+public:
+  using value_type = bool;
+  using native_type
+    = decltype(typename pack<F, W>::native_type() < typename pack<F, W>::native_type());
+  static constexpr std::size_t width = W;
+
+public:
+  pack_mask() = default;
+
+  constexpr pack_mask(bool value) noexcept; // NOLINT(google-explicit-constructor)
+
+  static constexpr auto from_native(native_type const& m) noexcept -> pack_mask;
+
+public:
+  constexpr auto operator[](std::size_t i) const noexcept -> bool;
+
+  constexpr auto native() const noexcept -> native_type;
+
+public:
+  friend constexpr auto operator&(pack_mask const& a, pack_mask const& b) noexcept -> pack_mask
+  {
+    return from_native(a.m_ & b.m_);
+  }
+
+  friend constexpr auto operator|(pack_mask const& a, pack_mask const& b) noexcept -> pack_mask
+  {
+    return from_native(a.m_ | b.m_);
+  }
+
+  friend constexpr auto operator^(pack_mask const& a, pack_mask const& b) noexcept -> pack_mask
+  {
+    return from_native(a.m_ ^ b.m_);
+  }
+
+  friend constexpr auto operator!(pack_mask const& a) noexcept -> pack_mask
+  {
+    return from_native(~a.m_);
+  }
+
+private:
+  native_type m_;
+};
+
+/* \brief Lane-wise |a| */
+template <typename F, std::size_t W>
+constexpr auto abs(pack<F, W> const& a) noexcept -> pack<F, W>;
+
+/* \brief Lane-wise square root
+ *
+ * One square-root instruction per register on x86, rather than one libm call per lane.
+ */
+template <typename F, std::size_t W>
+auto sqrt(pack<F, W> const& a) noexcept -> pack<F, W>;
+
+/* \brief Lane-wise -1, 0 or 1 */
+template <typename F, std::size_t W>
+constexpr auto sign(pack<F, W> const& a) noexcept -> pack<F, W>;
+
+/* \brief Lane-wise a < b ? a : b */
+template <typename F, std::size_t W>
+constexpr auto min(pack<F, W> const& a, pack<F, W> const& b) noexcept -> pack<F, W>;
+
+/* \brief Lane-wise a > b ? a : b */
+template <typename F, std::size_t W>
+constexpr auto max(pack<F, W> const& a, pack<F, W> const& b) noexcept -> pack<F, W>;
+
+/* \brief Sum of the lanes */
+template <typename F, std::size_t W>
+constexpr auto reduce(pack<F, W> const& a) noexcept -> F;
+
+/* \brief Lane-wise m ? a : b */
+template <typename F, std::size_t W>
+constexpr auto select(pack_mask<F, W> const& m, pack<F, W> const& a, pack<F, W> const& b) noexcept
+  -> pack<F, W>;
+
+template <typename F, std::size_t W>
+constexpr auto all(pack_mask<F, W> const& m) noexcept -> bool;
+
+template <typename F, std::size_t W>
+constexpr auto any(pack_mask<F, W> const& m) noexcept -> bool;
+
+template <typename F, std::size_t W>
+constexpr auto none(pack_mask<F, W> const& m) noexcept -> bool;
+
+/* \brief Number of set lanes */
+template <typename F, std::size_t W>
+constexpr auto count(pack_mask<F, W> const& m) noexcept -> std::size_t;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename F, std::size_t W>
+constexpr pack<F, W>::pack(value_type x) noexcept : v_(native_type{} + x)
+{
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack<F, W>::from_native(native_type const& v) noexcept -> pack
+{
+  auto result = pack();
+  result.v_ = v;
+  return result;
+}
+
+template <typename F, std::size_t W>
+auto pack<F, W>::load(value_type const* p) noexcept -> pack
+{
+  auto result = native_type();
+  std::memcpy(&result, p, sizeof(native_type));
+  return from_native(result);
+}
+
+template <typename F, std::size_t W>
+void pack<F, W>::store(value_type* p) const noexcept
+{
+  std::memcpy(p, &v_, sizeof(native_type));
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack<F, W>::operator[](std::size_t i) const noexcept -> value_type
+{
+  return v_[i];
+}
+
+template <typename F, std::size_t W>
+constexpr void pack<F, W>::set(std::size_t i, value_type x) noexcept
+{
+  v_[i] = x;
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack<F, W>::native() const noexcept -> native_type
+{
+  return v_;
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack<F, W>::operator+=(pack const& other) noexcept -> pack&
+{
+  v_ += other.v_;
+  return *this;
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack<F, W>::operator-=(pack const& other) noexcept -> pack&
+{
+  v_ -= other.v_;
+  return *this;
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack<F, W>::operator*=(pack const& other) noexcept -> pack&
+{
+  v_ *= other.v_;
+  return *this;
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack<F, W>::operator/=(pack const& other) noexcept -> pack&
+{
+  v_ /= other.v_;
+  return *this;
+}
+
+template <typename F, std::size_t W>
+constexpr pack_mask<F, W>::pack_mask(bool value) noexcept : m_(native_type{} - (value ? 1 : 0))
+{
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack_mask<F, W>::from_native(native_type const& m) noexcept -> pack_mask
+{
+  auto result = pack_mask();
+  result.m_ = m;
+  return result;
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack_mask<F, W>::operator[](std::size_t i) const noexcept -> bool
+{
+  return m_[i] != 0;
+}
+
+template <typename F, std::size_t W>
+constexpr auto pack_mask<F, W>::native() const noexcept -> native_type
+{
+  return m_;
+}
+
+template <typename F, std::size_t W>
+constexpr auto abs(pack<F, W> const& a) noexcept -> pack<F, W>
+{
+  return pack<F, W>::from_native(a.native() < 0 ? -a.native() : a.native());
+}
+
+namespace detail::simd {
+#if NANI_X86
+/* The wide square roots exist only where the translation unit is compiled for their instruction
+ * set, so that a pack never executes instructions the build did not ask for; other widths go lane
+ * by lane. AVX-512 goes through the zero-masking forms with every lane set: the unmasked ones read
+ * an undefined register that GCC reports as maybe uninitialized.
+ */
+#if defined(__AVX512F__)
+inline void sqrt_64(double const* a, double* r) noexcept
+{
+  _mm512_storeu_pd(r, _mm512_maskz_sqrt_pd(__mmask8(0xFF), _mm512_loadu_pd(a)));
+}
+
+inline void sqrt_64(float const* a, float* r) noexcept
+{
+  _mm512_storeu_ps(r, _mm512_maskz_sqrt_ps(__mmask16(0xFFFF), _mm512_loadu_ps(a)));
+}
+#endif
+
+#if defined(__AVX__)
+inline void sqrt_32(double const* a, double* r) noexcept
+{
+  _mm256_storeu_pd(r, _mm256_sqrt_pd(_mm256_loadu_pd(a)));
+}
+
+inline void sqrt_32(float const* a, float* r) noexcept
+{
+  _mm256_storeu_ps(r, _mm256_sqrt_ps(_mm256_loadu_ps(a)));
+}
+#endif
+
+inline void sqrt_16(double const* a, double* r) noexcept
+{
+  _mm_storeu_pd(r, _mm_sqrt_pd(_mm_loadu_pd(a)));
+}
+
+inline void sqrt_16(float const* a, float* r) noexcept
+{
+  _mm_storeu_ps(r, _mm_sqrt_ps(_mm_loadu_ps(a)));
+}
+#endif
+} // namespace detail::simd
+
+template <typename F, std::size_t W>
+auto sqrt(pack<F, W> const& a) noexcept -> pack<F, W>
+{
+  alignas(W * sizeof(F)) F in[W];
+  alignas(W * sizeof(F)) F out[W];
+  a.store(in);
+#if NANI_X86
+  if constexpr (std::is_same_v<F, double> or std::is_same_v<F, float>) {
+#if defined(__AVX512F__)
+    if constexpr (sizeof(in) == 64) {
+      detail::simd::sqrt_64(in, out);
+      return pack<F, W>::load(out);
+    }
+#endif
+#if defined(__AVX__)
+    if constexpr (sizeof(in) == 32) {
+      detail::simd::sqrt_32(in, out);
+      return pack<F, W>::load(out);
+    }
+#endif
+    if constexpr (sizeof(in) == 16) {
+      detail::simd::sqrt_16(in, out);
+      return pack<F, W>::load(out);
+    }
+  }
+#endif
+  for (std::size_t i = 0; i < W; ++i) {
+    out[i] = std::sqrt(in[i]);
+  }
+  return pack<F, W>::load(out);
+}
+
+template <typename F, std::size_t W>
+constexpr auto sign(pack<F, W> const& a) noexcept -> pack<F, W>
+{
+  using native_type = typename pack<F, W>::native_type;
+  auto const one = native_type{} + F(1);
+  auto const zero = native_type{};
+  auto const v = a.native();
+  return pack<F, W>::from_native((v > 0 ? one : zero) - (v < 0 ? one : zero));
+}
+
+template <typename F, std::size_t W>
+constexpr auto min(pack<F, W> const& a, pack<F, W> const& b) noexcept -> pack<F, W>
+{
+  return pack<F, W>::from_native(a.native() < b.native() ? a.native() : b.native());
+}
+
+template <typename F, std::size_t W>
+constexpr auto max(pack<F, W> const& a, pack<F, W> const& b) noexcept -> pack<F, W>
+{
+  return pack<F, W>::from_native(a.native() > b.native() ? a.native() : b.native());
+}
+
+template <typename F, std::size_t W>
+constexpr auto reduce(pack<F, W> const& a) noexcept -> F
+{
+  F result = 0;
+  for (std::size_t i = 0; i < W; ++i) {
+    result += a[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t W>
+constexpr auto select(pack_mask<F, W> const& m, pack<F, W> const& a, pack<F, W> const& b) noexcept
+  -> pack<F, W>
+{
+  return pack<F, W>::from_native(m.native() ? a.native() : b.native());
+}
+
+template <typename F, std::size_t W>
+constexpr auto all(pack_mask<F, W> const& m) noexcept -> bool
+{
+  return count(m) == W;
+}
+
+template <typename F, std::size_t W>
+constexpr auto any(pack_mask<F, W> const& m) noexcept -> bool
+{
+  return count(m) != 0;
+}
+
+template <typename F, std::size_t W>
+constexpr auto none(pack_mask<F, W> const& m) noexcept -> bool
+{
+  return count(m) == 0;
+}
+
+template <typename F, std::size_t W>
+constexpr auto count(pack_mask<F, W> const& m) noexcept -> std::size_t
+{
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < W; ++i) {
+    result += m[i] ? 1 : 0;
+  }
+  return result;
+}
+} // namespace nani
+
+#endif // NANI_PACK_HPP
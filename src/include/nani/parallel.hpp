@@ -0,0 +1,92 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_PARALLEL_HPP
+#define NANI_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+
+namespace nani {
+/* \brief Number of threads used by the batched kernels
+ *
+ * Defaults to the hardware concurrency and can be overridden with the `NANI_NUM_THREADS`
+ * environment variable. The value is read once, on first use.
+ */
+auto thread_count() noexcept -> std::size_t;
+
+/* \brief Run `function(begin, end)` over chunks of `[0, n)` on the thread pool
+ *
+ * The range is cut into chunks of `grain` elements which are handed out dynamically, so chunk
+ * boundaries are multiples of `grain` and kernels may rely on that for alignment. Ranges smaller
+ * than two chunks are processed on the calling thread, and so are calls made from within a
+ * running `parallel_for`.
+ *
+ * The pool of `thread_count() - 1` threads is started on first use and kept for the lifetime of
+ * the program; the calling thread works alongside it. If `function` throws, no further chunks are
+ * handed out and the first exception is rethrown on the calling thread once all threads are done.
+ */
+template <typename Function>
+void parallel_for(std::size_t n, std::size_t grain, Function const& function);
+
+namespace detail::parallel {
+/* Runs `task(context)` on the calling thread and on `nworker` threads of the pool, and returns
+ * once all of them have returned. `task` must not throw. Runs `task` on the calling thread only
+ * when called from within a task.
+ */
+void run(void (*task)(void*), void* context, std::size_t nworker);
+} // namespace detail::parallel
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename Function>
+void parallel_for(std::size_t n, std::size_t grain, Function const& function)
+{
+  if (n == 0) {
+    return;
+  }
+
+  grain = std::max<std::size_t>(grain, 1);
+  auto const nchunk = (n + grain - 1) / grain;
+  auto const nthread = std::min(thread_count(), nchunk);
+
+  if (nthread <= 1) {
+    function(std::size_t{0}, n);
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::atomic_flag failed;
+  std::exception_ptr error;
+  auto worker = [&]() noexcept {
+    try {
+      for (auto chunk = next.fetch_add(1); chunk < nchunk; chunk = next.fetch_add(1)) {
+        auto const begin = chunk * grain;
+        function(begin, std::min(n, begin + grain));
+      }
+    }
+    catch (...) {
+      if (not failed.test_and_set()) {
+        error = std::current_exception();
+      }
+      next.store(nchunk);
+    }
+  };
+
+  using worker_type = decltype(worker);
+  detail::parallel::run(
+    [](void* context) { (*static_cast<worker_type*>(context))(); }, &worker, nthread - 1);
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+} // namespace nani
+
+#endif // NANI_PARALLEL_HPP
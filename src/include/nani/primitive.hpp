@@ -0,0 +1,267 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_PRIMITIVE_HPP
+#define NANI_PRIMITIVE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <nani/gas.hpp>
+#include <nani/isa.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/** Conservative and Primitive Variables of the Euler Equations
+ *
+ * A state of `vector<T, N>` describes a flow in N - 2 dimensions. Conservative states are
+ * (rho, rho v, E) with E the total energy per unit volume, primitive states are (rho, v, p). The
+ * equation of state is a compile time policy (`ideal_gas`, `stiffened_gas`).
+ *
+ * As in `nani::flux`, the point-wise functions are templates over the lane type `T`, and the
+ * batched functions run them on `pack`s of cells.
+ **/
+namespace nani::primitive {
+/* Number of cells handed to a thread at once. */
+inline constexpr std::size_t grain = 8192;
+
+/* \brief Primitive state of the conservative state `u` */
+template <typename T, std::size_t N, typename Gas>
+constexpr auto from_conservative(nani::vector<T, N> const& u, Gas const& gas) noexcept
+  -> nani::vector<T, N>
+  requires(N >= 3);
+
+/* \brief Conservative state of the primitive state `w` */
+template <typename T, std::size_t N, typename Gas>
+constexpr auto to_conservative(nani::vector<T, N> const& w, Gas const& gas) noexcept
+  -> nani::vector<T, N>
+  requires(N >= 3);
+
+/* \brief Fastest signal speed |v| + c of the primitive state `w` */
+template <typename T, std::size_t N, typename Gas>
+constexpr auto wave_speed(nani::vector<T, N> const& w, Gas const& gas) noexcept -> T
+  requires(N >= 3);
+
+/* \brief w[i] = from_conservative(u[i]), sound[i] = c[i]; returns max(|v[i]| + c[i])
+ *
+ * One pass over the cells computes the primitive state, the speed of sound and the largest wave
+ * speed for the time step restriction. `w` may be the same field as `u`. `float` and `double`
+ * with `ideal_gas` or `stiffened_gas` in two and three dimensions are compiled once per
+ * instruction set into libnani and selected at run time (see `active_isa`).
+ *
+ * PreConditions : u, w and sound have the same size
+ */
+template <typename F, std::size_t N, typename Gas>
+auto from_conservative(
+  nani::soa_span<F const, N> u, Gas const& gas, nani::soa_span<F, N> w, std::span<F> sound) -> F
+  requires(N >= 3);
+
+/* \brief u[i] = to_conservative(w[i])
+ *
+ * `u` may be the same field as `w`.
+ *
+ * PreConditions : w.size() == u.size()
+ */
+template <typename F, std::size_t N, typename Gas>
+void to_conservative(nani::soa_span<F const, N> w, Gas const& gas, nani::soa_span<F, N> u)
+  requires(N >= 3);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+template <typename T, std::size_t N>
+struct decoded {
+  nani::vector<T, N> w;
+  T c;
+  T speed;
+};
+
+/* Primitive state, sound speed and wave speed with a single division by the density. */
+template <typename T, std::size_t N, typename Gas>
+constexpr auto decode(nani::vector<T, N> const& u, Gas const& gas) noexcept -> decoded<T, N>
+{
+  auto const rho = u[0];
+  auto const r = T(1) / rho;
+
+  auto result = decoded<T, N>();
+  auto v2 = T(0);
+  result.w[0] = rho;
+  for (std::size_t d = 1; d + 1 < N; ++d) {
+    auto const v = u[d] * r;
+    result.w[d] = v;
+    v2 += v * v;
+  }
+
+  auto const p = gas.pressure(rho, u[N - 1] - T(0.5) * rho * v2);
+  result.w[N - 1] = p;
+  result.c = gas.sound_speed(rho, p);
+  result.speed = nani::sqrt(v2) + result.c;
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t W, typename Gas>
+inline auto from_conservative_range(
+  nani::soa_span<F const, N> const& u,
+  Gas const& gas,
+  nani::soa_span<F, N> const& w,
+  F* sound,
+  std::size_t begin,
+  std::size_t end) noexcept -> F
+{
+  using pack_type = nani::pack<F, W>;
+
+  auto fastest = pack_type(F(0));
+  auto i = begin;
+  for (; i + W <= end; i += W) {
+    auto const s = detail::decode(u.template load_pack<W>(i), gas);
+    w.template store_pack<W>(i, s.w);
+    s.c.store(sound + i);
+    fastest = nani::max(fastest, s.speed);
+  }
+
+  auto result = F(0);
+  for (std::size_t k = 0; k < W; ++k) {
+    result = nani::max(result, fastest[k]);
+  }
+  for (; i < end; ++i) {
+    auto const s = detail::decode(u.load(i), gas);
+    w.store(i, s.w);
+    sound[i] = s.c;
+    result = nani::max(result, s.speed);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t W, typename Gas>
+inline void to_conservative_range(
+  nani::soa_span<F const, N> const& w,
+  Gas const& gas,
+  nani::soa_span<F, N> const& u,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  auto i = begin;
+  for (; i + W <= end; i += W) {
+    u.template store_pack<W>(i, primitive::to_conservative(w.template load_pack<W>(i), gas));
+  }
+  for (; i < end; ++i) {
+    u.store(i, primitive::to_conservative(w.load(i), gas));
+  }
+}
+
+/* Types for which libnani carries one conversion kernel per instruction set. */
+template <typename F, std::size_t N, typename Gas>
+inline constexpr bool dispatched
+  = (std::is_same_v<F, float> or std::is_same_v<F, double>) and (N == 4 or N == 5)
+    and (std::is_same_v<Gas, nani::ideal_gas<F>> or std::is_same_v<Gas, nani::stiffened_gas<F>>);
+
+/* One copy of the conversion kernels per instruction set, selected by `target`; in libnani. */
+template <typename F, std::size_t N, typename Gas>
+auto from_conservative_dispatch(
+  isa target,
+  nani::soa_span<F const, N> const& u,
+  Gas const& gas,
+  nani::soa_span<F, N> const& w,
+  F* sound,
+  std::size_t begin,
+  std::size_t end) noexcept -> F;
+
+template <typename F, std::size_t N, typename Gas>
+void to_conservative_dispatch(
+  isa target,
+  nani::soa_span<F const, N> const& w,
+  Gas const& gas,
+  nani::soa_span<F, N> const& u,
+  std::size_t begin,
+  std::size_t end) noexcept;
+} // namespace detail
+
+template <typename T, std::size_t N, typename Gas>
+constexpr auto from_conservative(nani::vector<T, N> const& u, Gas const& gas) noexcept
+  -> nani::vector<T, N>
+  requires(N >= 3)
+{
+  return detail::decode(u, gas).w;
+}
+
+template <typename T, std::size_t N, typename Gas>
+constexpr auto to_conservative(nani::vector<T, N> const& w, Gas const& gas) noexcept
+  -> nani::vector<T, N>
+  requires(N >= 3)
+{
+  auto const rho = w[0];
+
+  auto result = nani::vector<T, N>();
+  auto v2 = T(0);
+  result[0] = rho;
+  for (std::size_t d = 1; d + 1 < N; ++d) {
+    result[d] = rho * w[d];
+    v2 += w[d] * w[d];
+  }
+  result[N - 1] = gas.internal_energy(rho, w[N - 1]) + T(0.5) * rho * v2;
+  return result;
+}
+
+template <typename T, std::size_t N, typename Gas>
+constexpr auto wave_speed(nani::vector<T, N> const& w, Gas const& gas) noexcept -> T
+  requires(N >= 3)
+{
+  auto v2 = T(0);
+  for (std::size_t d = 1; d + 1 < N; ++d) {
+    v2 += w[d] * w[d];
+  }
+  return nani::sqrt(v2) + gas.sound_speed(w[0], w[N - 1]);
+}
+
+template <typename F, std::size_t N, typename Gas>
+auto from_conservative(
+  nani::soa_span<F const, N> u, Gas const& gas, nani::soa_span<F, N> w, std::span<F> sound) -> F
+  requires(N >= 3)
+{
+  meta::check_size(u.size(), w.size());
+  meta::check_size(sound.size(), w.size());
+
+  auto const target = nani::active_isa();
+  auto fastest = std::vector<F>((w.size() + grain - 1) / grain);
+  nani::parallel_for(w.size(), grain, [&](std::size_t begin, std::size_t end) {
+    if constexpr (detail::dispatched<F, N, Gas>) {
+      fastest[begin / grain]
+        = detail::from_conservative_dispatch(target, u, gas, w, sound.data(), begin, end);
+    }
+    else {
+      fastest[begin / grain] = detail::from_conservative_range<F, N, nani::simd_width_v<F>>(
+        u, gas, w, sound.data(), begin, end);
+    }
+  });
+  return fastest.empty() ? F(0) : *std::max_element(fastest.begin(), fastest.end());
+}
+
+template <typename F, std::size_t N, typename Gas>
+void to_conservative(nani::soa_span<F const, N> w, Gas const& gas, nani::soa_span<F, N> u)
+  requires(N >= 3)
+{
+  meta::check_size(w.size(), u.size());
+
+  auto const target = nani::active_isa();
+  nani::parallel_for(u.size(), grain, [&](std::size_t begin, std::size_t end) {
+    if constexpr (detail::dispatched<F, N, Gas>) {
+      detail::to_conservative_dispatch(target, w, gas, u, begin, end);
+    }
+    else {
+      detail::to_conservative_range<F, N, nani::simd_width_v<F>>(w, gas, u, begin, end);
+    }
+  });
+}
+} // namespace nani::primitive
+
+#endif // NANI_PRIMITIVE_HPP
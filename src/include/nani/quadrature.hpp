@@ -0,0 +1,238 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_QUADRATURE_HPP
+#define NANI_QUADRATURE_HPP
+
+#include <limits>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/vector.hpp>
+#include <numbers>
+
+namespace nani::quadrature {
+/** Quadrature Rule
+ *
+ * N nodes on the reference interval [-1, 1] in ascending order, and their weights.
+ **/
+template <typename F, std::size_t N>
+struct rule {
+  nani::vector<F, N> node;
+  nani::vector<F, N> weight;
+};
+
+/* \brief N point Gauss-Legendre rule, exact for polynomials of degree 2N - 1 */
+template <typename F, std::size_t N>
+consteval auto gauss_legendre() -> rule<F, N>
+  requires(N > 0);
+
+/* \brief N point Gauss-Lobatto rule, including both end points, exact up to degree 2N - 3 */
+template <typename F, std::size_t N>
+consteval auto gauss_lobatto() -> rule<F, N>
+  requires(N > 1);
+
+/* \brief Generalized Vandermonde matrix V[i][j] = P_j(x_i) of the orthonormal Legendre
+ * polynomials P_j, j < M
+ */
+template <typename F, std::size_t N, std::size_t M = N>
+consteval auto vandermonde(nani::vector<F, N> const& x) -> nani::matrix<F, N, M>;
+
+/* \brief Matrix I[i][j] = l_j(y_i) of the Lagrange polynomials l_j through the nodes x
+ *
+ * Multiplying nodal values at x with I gives the values of the interpolant at y.
+ */
+template <typename F, std::size_t N, std::size_t M>
+consteval auto interpolation(nani::vector<F, N> const& x, nani::vector<F, M> const& y)
+  -> nani::matrix<F, M, N>;
+
+/* \brief Matrix D[i][j] = l_j'(x_i) that differentiates the interpolant through the nodes x */
+template <typename F, std::size_t N>
+consteval auto differentiation(nani::vector<F, N> const& x) -> nani::matrix<F, N, N>;
+
+/* Tables baked into the binary. Indexing them in a kernel with a compile-time order lets the
+ * compiler fold the coefficients into the instructions.
+ */
+template <typename F, std::size_t N>
+inline constexpr auto gauss_legendre_v = gauss_legendre<F, N>();
+
+template <typename F, std::size_t N>
+inline constexpr auto gauss_lobatto_v = gauss_lobatto<F, N>();
+
+template <typename F, std::size_t N>
+inline constexpr auto legendre_differentiation_v = differentiation(gauss_legendre_v<F, N>.node);
+
+template <typename F, std::size_t N>
+inline constexpr auto lobatto_differentiation_v = differentiation(gauss_lobatto_v<F, N>.node);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/** Value and derivative of the Legendre polynomial of degree n **/
+template <typename F>
+struct legendre_value {
+  F p;
+  F dp;
+  F p_previous;
+};
+
+template <typename F>
+constexpr auto legendre(std::size_t n, F x) -> legendre_value<F>
+{
+  F p_previous = 0;
+  F p = 1;
+  for (std::size_t k = 0; k < n; ++k) {
+    auto const next = (static_cast<F>(2 * k + 1) * x * p - static_cast<F>(k) * p_previous)
+                      / static_cast<F>(k + 1);
+    p_previous = p;
+    p = next;
+  }
+  if (n == 0) {
+    return {p, F(0), p_previous};
+  }
+  if (x * x == 1) {
+    // P_n'(+-1) = (+-1)^(n + 1) n (n + 1) / 2
+    auto const dp = static_cast<F>(n * (n + 1)) / 2;
+    return {p, (n % 2 == 1 or x > 0) ? dp : -dp, p_previous};
+  }
+  return {p, static_cast<F>(n) * (x * p - p_previous) / (x * x - 1), p_previous};
+}
+
+/* Newton iteration for a root of `f`, which returns the pair (f, f'). Converges quadratically
+ * from the Chebyshev initial guesses used below; the iteration count only bounds the work.
+ */
+template <typename F, typename Function>
+constexpr auto newton(F x, Function const& f) -> F
+{
+  for (std::size_t iteration = 0; iteration < 100; ++iteration) {
+    auto const [value, derivative] = f(x);
+    auto const dx = value / derivative;
+    x -= dx;
+    if (nani::abs(dx) <= std::numeric_limits<F>::epsilon()) {
+      break;
+    }
+  }
+  return x;
+}
+
+template <typename F, std::size_t N>
+constexpr auto barycentric(nani::vector<F, N> const& x) -> nani::vector<F, N>
+{
+  auto w = nani::vector<F, N>::fill(1);
+  for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t k = 0; k < N; ++k) {
+      if (k != j) {
+        w[j] /= (x[j] - x[k]);
+      }
+    }
+  }
+  return w;
+}
+
+template <typename F>
+struct value_pair {
+  F value;
+  F derivative;
+};
+} // namespace detail
+
+template <typename F, std::size_t N>
+consteval auto gauss_legendre() -> rule<F, N>
+  requires(N > 0)
+{
+  auto result = rule<F, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    // Roots numbered from the right, so that node i is stored at position N - 1 - i.
+    auto const guess = nani::cos(
+      std::numbers::pi_v<F> * (static_cast<F>(i) + F(0.75)) / (static_cast<F>(N) + F(0.5)));
+    auto const x = detail::newton(guess, [](F t) {
+      auto const l = detail::legendre(N, t);
+      return detail::value_pair<F>{l.p, l.dp};
+    });
+    auto const dp = detail::legendre(N, x).dp;
+    result.node[N - 1 - i] = x;
+    result.weight[N - 1 - i] = F(2) / ((1 - x * x) * dp * dp);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+consteval auto gauss_lobatto() -> rule<F, N>
+  requires(N > 1)
+{
+  constexpr auto m = N - 1;
+  constexpr auto mm = static_cast<F>(m * (m + 1));
+
+  auto result = rule<F, N>();
+  result.node[0] = -1;
+  result.node[N - 1] = 1;
+  for (std::size_t i = 1; i + 1 < N; ++i) {
+    // Interior nodes are the roots of P_m'. Its derivative follows from the Legendre equation.
+    auto const guess = -nani::cos(std::numbers::pi_v<F> * static_cast<F>(i) / static_cast<F>(m));
+    result.node[i] = detail::newton(guess, [&](F t) {
+      auto const l = detail::legendre(m, t);
+      return detail::value_pair<F>{l.dp, (2 * t * l.dp - mm * l.p) / (1 - t * t)};
+    });
+  }
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const p = detail::legendre(m, result.node[i]).p;
+    result.weight[i] = F(2) / (mm * p * p);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t M>
+consteval auto vandermonde(nani::vector<F, N> const& x) -> nani::matrix<F, N, M>
+{
+  auto result = nani::matrix<F, N, M>();
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < M; ++j) {
+      auto const scale = nani::sqrt(static_cast<F>(2 * j + 1) / F(2));
+      result[i][j] = scale * detail::legendre(j, x[i]).p;
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t M>
+consteval auto interpolation(nani::vector<F, N> const& x, nani::vector<F, M> const& y)
+  -> nani::matrix<F, M, N>
+{
+  auto result = nani::matrix<F, M, N>();
+  for (std::size_t i = 0; i < M; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      F l = 1;
+      for (std::size_t k = 0; k < N; ++k) {
+        if (k != j) {
+          l *= (y[i] - x[k]) / (x[j] - x[k]);
+        }
+      }
+      result[i][j] = l;
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+consteval auto differentiation(nani::vector<F, N> const& x) -> nani::matrix<F, N, N>
+{
+  auto const w = detail::barycentric(x);
+  auto result = nani::matrix<F, N, N>::zero();
+  for (std::size_t i = 0; i < N; ++i) {
+    F diagonal = 0;
+    for (std::size_t j = 0; j < N; ++j) {
+      if (j != i) {
+        result[i][j] = (w[j] / w[i]) / (x[i] - x[j]);
+        diagonal -= result[i][j];
+      }
+    }
+    result[i][i] = diagonal;
+  }
+  return result;
+}
+} // namespace nani::quadrature
+
+#endif // NANI_QUADRATURE_HPP
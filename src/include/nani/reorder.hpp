@@ -0,0 +1,376 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_REORDER_HPP
+#define NANI_REORDER_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <nani/meta.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <numeric>
+#include <queue>
+#include <span>
+#include <vector>
+
+namespace nani::reorder {
+/* Number of elements handed to a thread at once. */
+inline constexpr std::size_t grain = 16384;
+
+enum class curve { morton, hilbert };
+
+/** Box
+ *
+ * Axis-aligned bounding box of a point set, used to quantize coordinates for the curve keys.
+ **/
+template <typename F, std::size_t D>
+struct box {
+  nani::vector<F, D> lo;
+  nani::vector<F, D> hi;
+};
+
+/* \brief Bounding box of a point set */
+template <typename F, std::size_t D>
+auto bounding_box(std::span<nani::vector<F, D> const> point) -> box<F, D>;
+
+/* \brief Position of `p` along a space-filling curve through `domain`
+ *
+ * Coordinates are quantized to 32 bits in 2D and 21 bits in 3D, so keys fit into 64 bits. Points
+ * outside of `domain` are clamped onto it.
+ */
+template <curve C, typename F, std::size_t D>
+constexpr auto key(nani::vector<F, D> const& p, box<F, D> const& domain) noexcept -> std::uint64_t
+  requires(D == 2 or D == 3);
+
+/* \brief Curve keys of a point set within its bounding box
+ *
+ * PreConditions : key.size() == point.size()
+ */
+template <curve C, typename F, std::size_t D>
+void keys(std::span<nani::vector<F, D> const> point, std::span<std::uint64_t> key)
+  requires(D == 2 or D == 3);
+
+/* \brief Permutation that sorts `key` in ascending order, computed with a parallel LSD radix sort
+ *
+ * The sort is stable. `order[new] = old`, which is what `permute` expects.
+ */
+template <std::integral I>
+auto sort(std::span<std::uint64_t const> key) -> std::vector<I>;
+
+/* \brief Reverse Cuthill-McKee ordering of a graph in compressed row storage
+ *
+ * The neighbours of vertex `v` are `adjacency[offset[v]] ... adjacency[offset[v + 1] - 1]`. Every
+ * connected component is started from a vertex of minimum degree. Returns `order[new] = old`.
+ */
+template <std::integral I>
+auto reverse_cuthill_mckee(std::span<I const> offset, std::span<I const> adjacency)
+  -> std::vector<I>;
+
+/* \brief Inverse of a permutation, `inverse[old] = new` */
+template <std::integral I>
+auto inverse(std::span<I const> order) -> std::vector<I>;
+
+/* \brief out[new] = in[order[new]] for any field of nani values
+ *
+ * PreConditions : in.size() == out.size() == order.size()
+ */
+template <typename T, std::integral I>
+void permute(std::span<T const> in, std::span<I const> order, std::span<T> out);
+
+/* \brief out[new] = in[order[new]] for SoA fields
+ *
+ * PreConditions : in.size() == out.size() == order.size()
+ */
+template <typename F, std::size_t N, std::integral I>
+void permute(
+  nani::soa_span<F const, N> in, std::span<I const> order, nani::soa_span<F, N> out);
+
+/* \brief Replace every old index in a connectivity array by its new index
+ *
+ * Use with the inverse of the permutation that was applied to the indexed field.
+ */
+template <std::integral I>
+void renumber(std::span<I> index, std::span<I const> inverse);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+template <std::size_t D>
+inline constexpr std::uint32_t bits = (D == 2) ? 32 : 21;
+
+/* Interleave the coordinates bit by bit, most significant bit first, x before y before z. */
+template <std::size_t D>
+constexpr auto interleave(nani::static_array<std::uint32_t, D> const& x) noexcept -> std::uint64_t
+{
+  std::uint64_t result = 0;
+  for (auto bit = bits<D>; bit-- > 0;) {
+    for (std::size_t i = 0; i < D; ++i) {
+      result = (result << 1U) | ((x[i] >> bit) & 1U);
+    }
+  }
+  return result;
+}
+
+/* Skilling's transform of coordinates into the transposed Hilbert index ("Programming the Hilbert
+ * curve", AIP Conf. Proc. 707, 2004).
+ */
+template <std::size_t D>
+constexpr void axes_to_transpose(nani::static_array<std::uint32_t, D>& x) noexcept
+{
+  constexpr std::uint32_t m = std::uint32_t{1} << (bits<D> - 1);
+
+  for (auto q = m; q > 1; q >>= 1U) {
+    auto const p = q - 1;
+    for (std::size_t i = 0; i < D; ++i) {
+      if ((x[i] & q) != 0) {
+        x[0] ^= p;
+      }
+      else {
+        auto const t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  for (std::size_t i = 1; i < D; ++i) {
+    x[i] ^= x[i - 1];
+  }
+  std::uint32_t t = 0;
+  for (auto q = m; q > 1; q >>= 1U) {
+    if ((x[D - 1] & q) != 0) {
+      t ^= q - 1;
+    }
+  }
+  for (std::size_t i = 0; i < D; ++i) {
+    x[i] ^= t;
+  }
+}
+
+template <typename F, std::size_t D>
+constexpr auto quantize(nani::vector<F, D> const& p, box<F, D> const& domain) noexcept
+  -> nani::static_array<std::uint32_t, D>
+{
+  // Scaled in double: 2^32 - 1 is not representable in float.
+  constexpr auto top = static_cast<double>((std::uint64_t{1} << bits<D>) - 1);
+  auto result = nani::static_array<std::uint32_t, D>();
+  for (std::size_t i = 0; i < D; ++i) {
+    auto const extent = domain.hi[i] - domain.lo[i];
+    auto const s = extent > 0 ? (p[i] - domain.lo[i]) / extent : F(0);
+    auto const clamped = s < 0 ? F(0) : (s > 1 ? F(1) : s);
+    result[i] = static_cast<std::uint32_t>(static_cast<double>(clamped) * top);
+  }
+  return result;
+}
+} // namespace detail
+
+template <typename F, std::size_t D>
+auto bounding_box(std::span<nani::vector<F, D> const> point) -> box<F, D>
+{
+  auto result = box<F, D>{
+    nani::vector<F, D>::fill(std::numeric_limits<F>::max()),
+    nani::vector<F, D>::fill(std::numeric_limits<F>::lowest())};
+  for (auto const& p : point) {
+    for (std::size_t i = 0; i < D; ++i) {
+      result.lo[i] = std::min(result.lo[i], p[i]);
+      result.hi[i] = std::max(result.hi[i], p[i]);
+    }
+  }
+  return result;
+}
+
+template <curve C, typename F, std::size_t D>
+constexpr auto key(nani::vector<F, D> const& p, box<F, D> const& domain) noexcept -> std::uint64_t
+  requires(D == 2 or D == 3)
+{
+  auto x = detail::quantize(p, domain);
+  if constexpr (C == curve::hilbert) {
+    detail::axes_to_transpose(x);
+  }
+  return detail::interleave(x);
+}
+
+template <curve C, typename F, std::size_t D>
+void keys(std::span<nani::vector<F, D> const> point, std::span<std::uint64_t> key)
+  requires(D == 2 or D == 3)
+{
+  meta::check_size(point.size(), key.size());
+
+  auto const domain = bounding_box(point);
+  nani::parallel_for(point.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      key[i] = reorder::key<C>(point[i], domain);
+    }
+  });
+}
+
+template <std::integral I>
+auto sort(std::span<std::uint64_t const> key) -> std::vector<I>
+{
+  constexpr std::size_t radix = 256;
+  auto const n = key.size();
+  auto const nblock = std::max<std::size_t>(1, std::min(nani::thread_count(), n / grain));
+  auto const block = (n + nblock - 1) / nblock;
+
+  auto order = std::vector<I>(n);
+  auto order_next = std::vector<I>(n);
+  auto current = std::vector<std::uint64_t>(key.begin(), key.end());
+  auto next = std::vector<std::uint64_t>(n);
+  std::iota(order.begin(), order.end(), I{0});
+
+  auto count = std::vector<std::size_t>(nblock * radix);
+  for (unsigned shift = 0; shift < 64; shift += 8) {
+    std::fill(count.begin(), count.end(), std::size_t{0});
+    nani::parallel_for(n, block, [&](std::size_t begin, std::size_t end) {
+      auto* histogram = count.data() + (begin / block) * radix;
+      for (std::size_t i = begin; i < end; ++i) {
+        ++histogram[(current[i] >> shift) & (radix - 1)];
+      }
+    });
+
+    // Exclusive prefix sum in (digit, block) order keeps the sort stable. A pass in which every
+    // key has the same digit does not move anything and is skipped.
+    std::size_t offset = 0;
+    std::size_t nonempty = 0;
+    for (std::size_t d = 0; d < radix; ++d) {
+      auto const before = offset;
+      for (std::size_t b = 0; b < nblock; ++b) {
+        auto const c = count[b * radix + d];
+        count[b * radix + d] = offset;
+        offset += c;
+      }
+      nonempty += (offset != before) ? 1 : 0;
+    }
+    if (nonempty <= 1) {
+      continue;
+    }
+
+    nani::parallel_for(n, block, [&](std::size_t begin, std::size_t end) {
+      auto* cursor = count.data() + (begin / block) * radix;
+      for (std::size_t i = begin; i < end; ++i) {
+        auto const target = cursor[(current[i] >> shift) & (radix - 1)]++;
+        next[target] = current[i];
+        order_next[target] = order[i];
+      }
+    });
+    current.swap(next);
+    order.swap(order_next);
+  }
+  return order;
+}
+
+template <std::integral I>
+auto reverse_cuthill_mckee(std::span<I const> offset, std::span<I const> adjacency)
+  -> std::vector<I>
+{
+  auto const n = offset.empty() ? std::size_t{0} : offset.size() - 1;
+  auto const degree = [&](std::size_t v) {
+    return static_cast<std::size_t>(offset[v + 1] - offset[v]);
+  };
+
+  auto by_degree = std::vector<std::size_t>(n);
+  std::iota(by_degree.begin(), by_degree.end(), std::size_t{0});
+  std::stable_sort(by_degree.begin(), by_degree.end(), [&](auto a, auto b) {
+    return degree(a) < degree(b);
+  });
+
+  auto order = std::vector<I>();
+  order.reserve(n);
+  auto visited = std::vector<bool>(n, false);
+  auto neighbour = std::vector<std::size_t>();
+
+  for (auto const start : by_degree) {
+    if (visited[start]) {
+      continue;
+    }
+    visited[start] = true;
+    order.push_back(static_cast<I>(start));
+
+    for (auto head = order.size() - 1; head < order.size(); ++head) {
+      auto const v = static_cast<std::size_t>(order[head]);
+      neighbour.clear();
+      auto const last = static_cast<std::size_t>(offset[v + 1]);
+      for (auto k = static_cast<std::size_t>(offset[v]); k < last; ++k) {
+        auto const w = static_cast<std::size_t>(adjacency[k]);
+        if (not visited[w]) {
+          visited[w] = true;
+          neighbour.push_back(w);
+        }
+      }
+      std::stable_sort(neighbour.begin(), neighbour.end(), [&](auto a, auto b) {
+        return degree(a) < degree(b);
+      });
+      for (auto const w : neighbour) {
+        order.push_back(static_cast<I>(w));
+      }
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+template <std::integral I>
+auto inverse(std::span<I const> order) -> std::vector<I>
+{
+  auto result = std::vector<I>(order.size());
+  nani::parallel_for(order.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      result[static_cast<std::size_t>(order[i])] = static_cast<I>(i);
+    }
+  });
+  return result;
+}
+
+template <typename T, std::integral I>
+void permute(std::span<T const> in, std::span<I const> order, std::span<T> out)
+{
+  meta::check_size(order.size(), in.size());
+  meta::check_size(order.size(), out.size());
+
+  nani::parallel_for(order.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      out[i] = in[static_cast<std::size_t>(order[i])];
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::integral I>
+void permute(
+  nani::soa_span<F const, N> in, std::span<I const> order, nani::soa_span<F, N> out)
+{
+  meta::check_size(order.size(), in.size());
+  meta::check_size(order.size(), out.size());
+
+  nani::parallel_for(order.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = 0; c < N; ++c) {
+      auto const* source = in.data(c);
+      auto* target = out.data(c);
+      for (std::size_t i = begin; i < end; ++i) {
+        target[i] = source[static_cast<std::size_t>(order[i])];
+      }
+    }
+  });
+}
+
+template <std::integral I>
+void renumber(std::span<I> index, std::span<I const> inverse)
+{
+  nani::parallel_for(index.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      index[i] = inverse[static_cast<std::size_t>(index[i])];
+    }
+  });
+}
+} // namespace nani::reorder
+
+#endif // NANI_REORDER_HPP
@@ -8,16 +8,21 @@
 
 #include <cmath>
 #include <limits>
+#include <numbers>
 #include <type_traits>
 
+// The pack overloads rely on the GNU vector extensions; other compilers get the scalar ones only.
+#if defined(__GNUC__)
+#include <nani/pack.hpp>
+#endif
+
 namespace nani {
+// abs, max and min select with a conditional expression rather than branching, which compilers
+// lower to a blend or a min/max instruction, also inside vectorized loops.
 template <typename T>
 constexpr auto abs(T const& a) -> T
 {
-  if (a < 0) {
-    return -a;
-  }
-  return a;
+  return (a < 0) ? -a : a;
 }
 
 constexpr auto factorial(std::size_t n) -> std::size_t
@@ -55,12 +60,51 @@ constexpr auto sqrt(T const& a) -> T
 }
 
 template <typename T>
-constexpr auto max(T const& a, T const& b) -> T
+constexpr auto sin(T const& a) -> T
+{
+  if (std::is_constant_evaluated()) {
+    constexpr auto pi = std::numbers::pi_v<T>;
+    auto x = a - T(2) * pi * static_cast<T>(static_cast<long long>(a / (T(2) * pi)));
+    x = (x > pi) ? x - T(2) * pi : (x < -pi) ? x + T(2) * pi : x;
+
+    T result = 0;
+    T term = x;
+    for (std::size_t k = 1; abs(term) > std::numeric_limits<T>::epsilon() * abs(result); k += 2) {
+      result += term;
+      term *= -x * x / static_cast<T>((k + 1) * (k + 2));
+    }
+    return result;
+  }
+
+  return std::sin(a);
+}
+
+template <typename T>
+constexpr auto cos(T const& a) -> T
 {
-  if (a > b) {
-    return a;
+  if (std::is_constant_evaluated()) {
+    return sin(a + std::numbers::pi_v<T> / T(2));
   }
-  return b;
+
+  return std::cos(a);
+}
+
+template <typename T>
+constexpr auto sign(T const& a) -> T
+{
+  return static_cast<T>((T(0) < a) - (a < T(0)));
+}
+
+template <typename T>
+constexpr auto max(T const& a, T const& b) -> T
+{
+  return (a > b) ? a : b;
+}
+
+template <typename T>
+constexpr auto min(T const& a, T const& b) -> T
+{
+  return (b < a) ? b : a;
 }
 } // namespace nani
 
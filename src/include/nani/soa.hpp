@@ -0,0 +1,281 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_SOA_HPP
+#define NANI_SOA_HPP
+
+#include <nani/aligned_allocator.hpp>
+#include <nani/pack.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <nani/view.hpp>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace nani {
+/** Structure-of-Arrays Span
+ *
+ * A non-owning view of a field of `vector<F, N>` stored as N separate component streams. This is
+ * the layout the batched kernels read and write: every component is a contiguous array, so a loop
+ * over elements vectorizes across elements instead of across the (small) components.
+ *
+ * `F` may be const-qualified for read-only views.
+ **/
+template <typename F, std::size_t N>
+class soa_span {
+public:
+  using element_type = F;
+  using value_type = std::remove_cv_t<F>;
+  using vector_type = nani::vector<value_type, N>;
+  using size_type = std::size_t;
+  static constexpr std::size_t dim = N;
+
+public:
+  soa_span() = default;
+
+  constexpr soa_span(nani::static_array<F*, N> const& data, size_type size) noexcept;
+
+  template <typename G>
+  constexpr soa_span(soa_span<G, N> const& other) noexcept // NOLINT(google-explicit-constructor)
+    requires(std::is_convertible_v<G (*)[], F (*)[]> and not std::is_same_v<G, F>);
+
+public:
+  constexpr auto size() const noexcept -> size_type;
+
+  constexpr auto data(std::size_t c) const noexcept -> F*;
+
+  constexpr auto component(std::size_t c) const noexcept -> std::span<F>;
+
+  constexpr auto subspan(size_type offset, size_type count) const noexcept -> soa_span;
+
+public:
+  constexpr auto load(size_type i) const noexcept -> vector_type;
+
+  constexpr void store(size_type i, vector_type const& v) const noexcept
+    requires(not std::is_const_v<F>);
+
+  /* \brief Elements [i, i + W) with lane k of each component holding element i + k */
+  template <std::size_t W>
+  auto load_pack(size_type i) const noexcept -> nani::vector<nani::pack<value_type, W>, N>;
+
+  template <std::size_t W>
+  void store_pack(size_type i, nani::vector<nani::pack<value_type, W>, N> const& v) const noexcept
+    requires(not std::is_const_v<F>);
+
+private:
+  nani::static_array<F*, N> data_{};
+  size_type size_ = 0;
+};
+
+/** Structure-of-Arrays Field
+ *
+ * Owning storage for an SoA field. All components live in one allocation; every component stream
+ * starts on a cache line so that kernels can use aligned loads and stores on each of them.
+ **/
+template <typename F, std::size_t N>
+class soa_field {
+public:
+  using value_type = F;
+  using vector_type = nani::vector<F, N>;
+  using size_type = std::size_t;
+  static constexpr std::size_t dim = N;
+
+public:
+  soa_field() = default;
+
+  explicit soa_field(size_type size);
+
+public:
+  auto size() const noexcept -> size_type;
+
+  auto span() noexcept -> soa_span<F, N>;
+
+  auto span() const noexcept -> soa_span<F const, N>;
+
+  auto component(std::size_t c) noexcept -> std::span<F>;
+
+  auto component(std::size_t c) const noexcept -> std::span<F const>;
+
+  auto load(size_type i) const noexcept -> vector_type;
+
+  void store(size_type i, vector_type const& v) noexcept;
+
+  /* \brief Strided view of element `i` across the component arrays */
+  auto view(size_type i) noexcept -> vector_view<F, N>;
+
+  auto view(size_type i) const noexcept -> vector_view<F const, N>;
+
+private:
+  static constexpr auto padding_ = 64 / sizeof(F) > 0 ? 64 / sizeof(F) : 1;
+
+  size_type size_ = 0;
+  size_type stride_ = 0;
+  std::vector<F, nani::aligned_allocator<F>> buffer_;
+};
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename F, std::size_t N>
+constexpr soa_span<F, N>::soa_span(nani::static_array<F*, N> const& data, size_type size) noexcept
+: data_(data), size_(size)
+{
+}
+
+template <typename F, std::size_t N>
+template <typename G>
+constexpr soa_span<F, N>::soa_span(soa_span<G, N> const& other) noexcept
+  requires(std::is_convertible_v<G (*)[], F (*)[]> and not std::is_same_v<G, F>)
+: size_(other.size())
+{
+  for (std::size_t c = 0; c < N; ++c) {
+    data_[c] = other.data(c);
+  }
+}
+
+template <typename F, std::size_t N>
+constexpr auto soa_span<F, N>::size() const noexcept -> size_type
+{
+  return size_;
+}
+
+template <typename F, std::size_t N>
+constexpr auto soa_span<F, N>::data(std::size_t c) const noexcept -> F*
+{
+  return data_[c];
+}
+
+template <typename F, std::size_t N>
+constexpr auto soa_span<F, N>::component(std::size_t c) const noexcept -> std::span<F>
+{
+  return std::span<F>(data_[c], size_);
+}
+
+template <typename F, std::size_t N>
+constexpr auto soa_span<F, N>::subspan(size_type offset, size_type count) const noexcept
+  -> soa_span
+{
+  auto result = *this;
+  for (std::size_t c = 0; c < N; ++c) {
+    result.data_[c] += offset;
+  }
+  result.size_ = count;
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto soa_span<F, N>::load(size_type i) const noexcept -> vector_type
+{
+  auto result = vector_type();
+  for (std::size_t c = 0; c < N; ++c) {
+    result[c] = data_[c][i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr void soa_span<F, N>::store(size_type i, vector_type const& v) const noexcept
+  requires(not std::is_const_v<F>)
+{
+  for (std::size_t c = 0; c < N; ++c) {
+    data_[c][i] = v[c];
+  }
+}
+
+template <typename F, std::size_t N>
+template <std::size_t W>
+auto soa_span<F, N>::load_pack(size_type i) const noexcept
+  -> nani::vector<nani::pack<value_type, W>, N>
+{
+  auto result = nani::vector<nani::pack<value_type, W>, N>();
+  for (std::size_t c = 0; c < N; ++c) {
+    result[c] = nani::pack<value_type, W>::load(data_[c] + i);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+template <std::size_t W>
+void soa_span<F, N>::store_pack(
+  size_type i, nani::vector<nani::pack<value_type, W>, N> const& v) const noexcept
+  requires(not std::is_const_v<F>)
+{
+  for (std::size_t c = 0; c < N; ++c) {
+    v[c].store(data_[c] + i);
+  }
+}
+
+template <typename F, std::size_t N>
+soa_field<F, N>::soa_field(size_type size)
+: size_(size), stride_((size + padding_ - 1) / padding_ * padding_), buffer_(stride_ * N)
+{
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::size() const noexcept -> size_type
+{
+  return size_;
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::span() noexcept -> soa_span<F, N>
+{
+  auto data = nani::static_array<F*, N>();
+  for (std::size_t c = 0; c < N; ++c) {
+    data[c] = buffer_.data() + c * stride_;
+  }
+  return soa_span<F, N>(data, size_);
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::span() const noexcept -> soa_span<F const, N>
+{
+  auto data = nani::static_array<F const*, N>();
+  for (std::size_t c = 0; c < N; ++c) {
+    data[c] = buffer_.data() + c * stride_;
+  }
+  return soa_span<F const, N>(data, size_);
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::component(std::size_t c) noexcept -> std::span<F>
+{
+  return std::span<F>(buffer_.data() + c * stride_, size_);
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::component(std::size_t c) const noexcept -> std::span<F const>
+{
+  return std::span<F const>(buffer_.data() + c * stride_, size_);
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::load(size_type i) const noexcept -> vector_type
+{
+  return span().load(i);
+}
+
+template <typename F, std::size_t N>
+void soa_field<F, N>::store(size_type i, vector_type const& v) noexcept
+{
+  span().store(i, v);
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::view(size_type i) noexcept -> vector_view<F, N>
+{
+  return vector_view<F, N>(buffer_.data() + i, static_cast<std::ptrdiff_t>(stride_));
+}
+
+template <typename F, std::size_t N>
+auto soa_field<F, N>::view(size_type i) const noexcept -> vector_view<F const, N>
+{
+  return vector_view<F const, N>(buffer_.data() + i, static_cast<std::ptrdiff_t>(stride_));
+}
+} // namespace nani
+
+#endif // NANI_SOA_HPP
@@ -0,0 +1,673 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_SPARSE_HPP
+#define NANI_SPARSE_HPP
+
+#include <array>
+#include <cstddef>
+#include <nani/matrix.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/** Compile-Time Sparsity Patterns
+ *
+ * Flux Jacobians, rotations into a face frame and similar small matrices have zero patterns that
+ * are fixed by the equations rather than by the data. A `sparse_pattern<R, C>` is that pattern
+ * as a compile-time value, and a `sparse_matrix<F, P>` stores only the entries that the pattern
+ * `P` marks as nonzero, row by row.
+ *
+ * Every product is a fold over a table of (row, column) pairs computed at compile time, one
+ * multiply-add per structural nonzero, with the loops unrolled away: the same code as a
+ * hand-written specialization of the product, generated from the pattern. Products and sums of
+ * sparse matrices compute the pattern of their result at compile time as well, so that chains of
+ * operations stay sparse.
+ *
+ * A pattern is written as a string of rows, `x` or `*` for a nonzero and `.` or `0` for a zero,
+ * with whitespace ignored:
+ *
+ *     constexpr auto rotate = nani::sparse_pattern<4, 4>::parse("x... .xxx .xxx .xxx");
+ *     auto const r = nani::sparse_matrix<double, rotate>(dense);
+ **/
+namespace nani {
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+struct sparse_pattern {
+  static constexpr std::size_t rows = R;
+  static constexpr std::size_t cols = C;
+
+  // Public, so that a pattern is a structural type and can be a template argument. Every function
+  // below that makes a pattern writes all of its entries: GCC 12 compares template arguments by
+  // their constant-evaluated representation, in which entries left at their initializer differ
+  // from written ones, so that two equal patterns would otherwise name different types.
+  std::array<bool, R * C> nonzero{};
+
+  static constexpr auto dense() noexcept -> sparse_pattern;
+
+  /* \brief Entries (i, i) for i < min(R, C) */
+  static constexpr auto diagonal() noexcept -> sparse_pattern;
+
+  /* \brief Entries (i, j) with i in [row, row + nrow) and j in [col, col + ncol) */
+  static constexpr auto block(std::size_t row, std::size_t col, std::size_t nrow, std::size_t ncol)
+    -> sparse_pattern;
+
+  /* \brief Pattern from R rows of C characters each, see above */
+  static consteval auto parse(std::string_view text) -> sparse_pattern;
+
+  /* \brief Nonzero entries of a matrix, typically a constexpr one */
+  template <typename F>
+  static constexpr auto of(nani::matrix<F, R, C> const& a) noexcept -> sparse_pattern;
+
+  constexpr auto operator()(std::size_t i, std::size_t j) const noexcept -> bool;
+
+  /* \brief Number of nonzeros */
+  constexpr auto count() const noexcept -> std::size_t;
+
+  /* \brief Position of the nonzero (i, j) among the nonzeros, row by row
+   *
+   * PreConditions : (*this)(i, j)
+   */
+  constexpr auto index(std::size_t i, std::size_t j) const noexcept -> std::size_t;
+
+  friend constexpr auto operator==(sparse_pattern const&, sparse_pattern const&) -> bool
+    = default;
+
+  /* \brief Union of the nonzeros, the pattern of a + b */
+  friend constexpr auto operator|(sparse_pattern const& a, sparse_pattern const& b) noexcept
+    -> sparse_pattern
+  {
+    auto result = sparse_pattern();
+    for (std::size_t e = 0; e < R * C; ++e) {
+      result.nonzero[e] = a.nonzero[e] or b.nonzero[e];
+    }
+    return result;
+  }
+};
+
+/* \brief Pattern of a * b: (i, j) is nonzero if a(i, k) and b(k, j) are for some k */
+template <std::size_t R, std::size_t S, std::size_t T>
+constexpr auto product(sparse_pattern<R, S> const& a, sparse_pattern<S, T> const& b) noexcept
+  -> sparse_pattern<R, T>;
+
+template <std::size_t R, std::size_t C>
+constexpr auto transpose(sparse_pattern<R, C> const& a) noexcept -> sparse_pattern<C, R>;
+
+namespace detail::sparse {
+template <typename T>
+inline constexpr bool is_pattern = false;
+
+template <std::size_t R, std::size_t C>
+inline constexpr bool is_pattern<sparse_pattern<R, C>> = true;
+} // namespace detail::sparse
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+class sparse_matrix {
+public:
+  using value_type = F;
+  using pattern_type = std::remove_cvref_t<decltype(P)>;
+  static constexpr pattern_type pattern = P;
+  static constexpr std::size_t rows = pattern_type::rows;
+  static constexpr std::size_t cols = pattern_type::cols;
+  static constexpr std::size_t size = P.count();
+  // An empty pattern, such as the product of matrices with orthogonal patterns, stores nothing.
+  using storage_type =
+    std::conditional_t<size == 0, std::array<F, 0>, nani::static_array<F, size>>;
+  using matrix_type = nani::matrix<F, rows, cols>;
+
+public:
+  sparse_matrix() = default;
+
+  /* \brief The entries of a on the pattern; the others are not read */
+  constexpr explicit sparse_matrix(matrix_type const& a) noexcept;
+
+  static constexpr auto zero() noexcept -> sparse_matrix;
+
+public:
+  constexpr explicit operator matrix_type() const noexcept;
+
+public:
+  /* \brief Entry (i, j), zero off the pattern */
+  constexpr auto operator()(std::size_t i, std::size_t j) const noexcept -> F;
+
+  /* \brief Entry (i, j)
+   *
+   * PreConditions : pattern(i, j)
+   */
+  constexpr auto operator()(std::size_t i, std::size_t j) noexcept -> F&;
+
+  /* \brief The nonzeros, row by row */
+  constexpr auto values() const noexcept -> storage_type const&;
+
+  constexpr auto values() noexcept -> storage_type&;
+
+private:
+  storage_type x_{};
+};
+
+/* \brief a + b and a - b, with the union of the patterns */
+template <typename F, auto P, auto Q>
+  requires(std::is_same_v<std::remove_cvref_t<decltype(P)>, std::remove_cvref_t<decltype(Q)>>)
+constexpr auto operator+(sparse_matrix<F, P> const& a, sparse_matrix<F, Q> const& b)
+  -> sparse_matrix<F, P | Q>;
+
+template <typename F, auto P, auto Q>
+  requires(std::is_same_v<std::remove_cvref_t<decltype(P)>, std::remove_cvref_t<decltype(Q)>>)
+constexpr auto operator-(sparse_matrix<F, P> const& a, sparse_matrix<F, Q> const& b)
+  -> sparse_matrix<F, P | Q>;
+
+template <typename F, auto P>
+constexpr auto operator*(sparse_matrix<F, P> const& a, std::type_identity_t<F> s)
+  -> sparse_matrix<F, P>;
+
+template <typename F, auto P>
+constexpr auto operator*(std::type_identity_t<F> s, sparse_matrix<F, P> const& a)
+  -> sparse_matrix<F, P>;
+
+template <typename F, auto P>
+constexpr auto operator/(sparse_matrix<F, P> const& a, std::type_identity_t<F> s)
+  -> sparse_matrix<F, P>;
+
+/* \brief Products with vectors, one multiply-add per nonzero */
+template <typename F, auto P, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == P.cols)
+constexpr auto operator*(sparse_matrix<F, P> const& a, B const& b)
+  -> nani::vector<F, P.rows>;
+
+template <vector_like A, typename F, auto P>
+  requires std::is_same_v<F, vector_value_t<A>> and (vector_dim_v<A> == P.rows)
+constexpr auto operator*(A const& a, sparse_matrix<F, P> const& b)
+  -> nani::vector<F, P.cols>;
+
+/* \brief Products with dense matrices on either side, with dense results */
+template <typename F, auto P, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == P.cols)
+constexpr auto operator*(sparse_matrix<F, P> const& a, B const& b)
+  -> nani::matrix<F, P.rows, matrix_cols_v<B>>;
+
+template <matrix_like A, typename F, auto P>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == P.rows)
+constexpr auto operator*(A const& a, sparse_matrix<F, P> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, P.cols>;
+
+/* \brief Product of two sparse matrices, with the pattern `product(P, Q)` */
+template <typename F, auto P, auto Q>
+  requires(P.cols == Q.rows)
+constexpr auto operator*(sparse_matrix<F, P> const& a, sparse_matrix<F, Q> const& b)
+  -> sparse_matrix<F, product(P, Q)>;
+
+template <typename F, auto P>
+constexpr auto transpose(sparse_matrix<F, P> const& a) -> sparse_matrix<F, transpose(P)>;
+
+/* \brief The entries of outer(a, b) on the pattern P, and no others */
+template <auto P, vector_like A, vector_like B>
+  requires std::is_same_v<vector_value_t<A>, vector_value_t<B>>
+           and (vector_dim_v<A> == P.rows) and (vector_dim_v<B> == P.cols)
+constexpr auto outer(A const& a, B const& b) -> sparse_matrix<vector_value_t<A>, P>;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+constexpr auto sparse_pattern<R, C>::dense() noexcept -> sparse_pattern
+{
+  auto result = sparse_pattern();
+  for (auto& x : result.nonzero) {
+    x = true;
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+constexpr auto sparse_pattern<R, C>::diagonal() noexcept -> sparse_pattern
+{
+  auto result = sparse_pattern();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result.nonzero[i * C + j] = i == j;
+    }
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+constexpr auto sparse_pattern<R, C>::block(
+  std::size_t row, std::size_t col, std::size_t nrow, std::size_t ncol) -> sparse_pattern
+{
+  if (row + nrow > R or col + ncol > C) {
+    throw std::out_of_range("sparse_pattern: block out of range");
+  }
+  auto result = sparse_pattern();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result.nonzero[i * C + j] = i >= row and i < row + nrow and j >= col and j < col + ncol;
+    }
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+consteval auto sparse_pattern<R, C>::parse(std::string_view text) -> sparse_pattern
+{
+  auto result = sparse_pattern();
+  auto e = std::size_t(0);
+  for (auto const c : text) {
+    if (c == ' ' or c == '\n' or c == '\t' or c == '/' or c == '|') {
+      continue;
+    }
+    if (e == R * C) {
+      throw std::invalid_argument("sparse_pattern: too many entries");
+    }
+    if (c == 'x' or c == 'X' or c == '*') {
+      result.nonzero[e++] = true;
+    }
+    else if (c == '.' or c == '0') {
+      result.nonzero[e++] = false;
+    }
+    else {
+      throw std::invalid_argument("sparse_pattern: expected one of x, *, . or 0");
+    }
+  }
+  if (e != R * C) {
+    throw std::invalid_argument("sparse_pattern: too few entries");
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+template <typename F>
+constexpr auto sparse_pattern<R, C>::of(nani::matrix<F, R, C> const& a) noexcept
+  -> sparse_pattern
+{
+  auto result = sparse_pattern();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result.nonzero[i * C + j] = a[i][j] != F(0);
+    }
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+constexpr auto sparse_pattern<R, C>::operator()(std::size_t i, std::size_t j) const noexcept
+  -> bool
+{
+  return nonzero[i * C + j];
+}
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+constexpr auto sparse_pattern<R, C>::count() const noexcept -> std::size_t
+{
+  auto result = std::size_t(0);
+  for (auto const x : nonzero) {
+    result += x ? 1 : 0;
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+  requires(R >= 1 and C >= 1)
+constexpr auto sparse_pattern<R, C>::index(std::size_t i, std::size_t j) const noexcept
+  -> std::size_t
+{
+  auto result = std::size_t(0);
+  for (std::size_t e = 0; e < i * C + j; ++e) {
+    result += nonzero[e] ? 1 : 0;
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t S, std::size_t T>
+constexpr auto product(sparse_pattern<R, S> const& a, sparse_pattern<S, T> const& b) noexcept
+  -> sparse_pattern<R, T>
+{
+  auto result = sparse_pattern<R, T>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < T; ++j) {
+      auto nonzero = false;
+      for (std::size_t k = 0; k < S; ++k) {
+        nonzero = nonzero or (a(i, k) and b(k, j));
+      }
+      result.nonzero[i * T + j] = nonzero;
+    }
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+constexpr auto transpose(sparse_pattern<R, C> const& a) noexcept -> sparse_pattern<C, R>
+{
+  auto result = sparse_pattern<C, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result.nonzero[j * R + i] = a(i, j);
+    }
+  }
+  return result;
+}
+
+namespace detail::sparse {
+/* Row and column of every nonzero of P, in storage order. */
+template <auto P>
+struct entries {
+  static constexpr std::size_t size = P.count();
+
+  static constexpr auto row = [] {
+    auto result = std::array<std::size_t, size>();
+    auto e = std::size_t(0);
+    for (std::size_t i = 0; i < P.rows; ++i) {
+      for (std::size_t j = 0; j < P.cols; ++j) {
+        if (P(i, j)) {
+          result[e++] = i;
+        }
+      }
+    }
+    return result;
+  }();
+
+  static constexpr auto col = [] {
+    auto result = std::array<std::size_t, size>();
+    auto e = std::size_t(0);
+    for (std::size_t i = 0; i < P.rows; ++i) {
+      for (std::size_t j = 0; j < P.cols; ++j) {
+        if (P(i, j)) {
+          result[e++] = j;
+        }
+      }
+    }
+    return result;
+  }();
+};
+
+/* Every term a(i, k) * b(k, j) of the product of P and Q, as the positions of its factors among
+ * the nonzeros of P and Q and of its result among the nonzeros of product(P, Q).
+ */
+template <auto P, auto Q>
+struct terms {
+  static constexpr auto pattern = product(P, Q);
+
+  static constexpr std::size_t size = [] {
+    auto result = std::size_t(0);
+    for (std::size_t i = 0; i < P.rows; ++i) {
+      for (std::size_t k = 0; k < P.cols; ++k) {
+        for (std::size_t j = 0; j < Q.cols; ++j) {
+          result += P(i, k) and Q(k, j) ? 1 : 0;
+        }
+      }
+    }
+    return result;
+  }();
+
+  struct term {
+    std::size_t a;
+    std::size_t b;
+    std::size_t c;
+  };
+
+  static constexpr auto table = [] {
+    auto result = std::array<term, size>();
+    auto e = std::size_t(0);
+    for (std::size_t i = 0; i < P.rows; ++i) {
+      for (std::size_t k = 0; k < P.cols; ++k) {
+        for (std::size_t j = 0; j < Q.cols; ++j) {
+          if (P(i, k) and Q(k, j)) {
+            result[e++] = term{P.index(i, k), Q.index(k, j), pattern.index(i, j)};
+          }
+        }
+      }
+    }
+    return result;
+  }();
+};
+
+/* op(integral_constant<K>) for K in [0, N), unrolled. */
+template <std::size_t N, typename Op>
+constexpr void unroll(Op&& op)
+{
+  [&]<std::size_t... K>(std::index_sequence<K...>) {
+    (op(std::integral_constant<std::size_t, K>()), ...);
+  }(std::make_index_sequence<N>());
+}
+
+/* a[op] b entry by entry, on the union of the patterns. */
+template <typename F, auto P, auto Q, typename Op>
+constexpr auto combine(sparse_matrix<F, P> const& a, sparse_matrix<F, Q> const& b, Op op)
+  -> sparse_matrix<F, P | Q>
+{
+  using result_type = sparse_matrix<F, P | Q>;
+  using layout = entries<P | Q>;
+  auto result = result_type();
+  unroll<layout::size>([&](auto e) {
+    constexpr auto i = layout::row[e];
+    constexpr auto j = layout::col[e];
+    auto const x = P(i, j) ? a.values()[P.index(i, j)] : F(0);
+    auto const y = Q(i, j) ? b.values()[Q.index(i, j)] : F(0);
+    result.values()[e] = op(x, y);
+  });
+  return result;
+}
+} // namespace detail::sparse
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+constexpr sparse_matrix<F, P>::sparse_matrix(matrix_type const& a) noexcept
+{
+  using layout = detail::sparse::entries<P>;
+  for (std::size_t e = 0; e < size; ++e) {
+    x_[e] = a[layout::row[e]][layout::col[e]];
+  }
+}
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+constexpr auto sparse_matrix<F, P>::zero() noexcept -> sparse_matrix
+{
+  auto result = sparse_matrix();
+  if constexpr (size > 0) {
+    result.x_ = F(0);
+  }
+  return result;
+}
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+constexpr sparse_matrix<F, P>::operator matrix_type() const noexcept
+{
+  using layout = detail::sparse::entries<P>;
+  auto result = matrix_type::zero();
+  for (std::size_t e = 0; e < size; ++e) {
+    result[layout::row[e]][layout::col[e]] = x_[e];
+  }
+  return result;
+}
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+constexpr auto sparse_matrix<F, P>::operator()(std::size_t i, std::size_t j) const noexcept -> F
+{
+  return P(i, j) ? x_[P.index(i, j)] : F(0);
+}
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+constexpr auto sparse_matrix<F, P>::operator()(std::size_t i, std::size_t j) noexcept -> F&
+{
+  return x_[P.index(i, j)];
+}
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+constexpr auto sparse_matrix<F, P>::values() const noexcept -> storage_type const&
+{
+  return x_;
+}
+
+template <typename F, auto P>
+  requires detail::sparse::is_pattern<std::remove_cvref_t<decltype(P)>>
+constexpr auto sparse_matrix<F, P>::values() noexcept -> storage_type&
+{
+  return x_;
+}
+
+template <typename F, auto P, auto Q>
+  requires(std::is_same_v<std::remove_cvref_t<decltype(P)>, std::remove_cvref_t<decltype(Q)>>)
+constexpr auto operator+(sparse_matrix<F, P> const& a, sparse_matrix<F, Q> const& b)
+  -> sparse_matrix<F, P | Q>
+{
+  return detail::sparse::combine(a, b, [](F x, F y) { return x + y; });
+}
+
+template <typename F, auto P, auto Q>
+  requires(std::is_same_v<std::remove_cvref_t<decltype(P)>, std::remove_cvref_t<decltype(Q)>>)
+constexpr auto operator-(sparse_matrix<F, P> const& a, sparse_matrix<F, Q> const& b)
+  -> sparse_matrix<F, P | Q>
+{
+  return detail::sparse::combine(a, b, [](F x, F y) { return x - y; });
+}
+
+template <typename F, auto P>
+constexpr auto operator*(sparse_matrix<F, P> const& a, std::type_identity_t<F> s)
+  -> sparse_matrix<F, P>
+{
+  auto result = a;
+  for (auto& x : result.values()) {
+    x *= s;
+  }
+  return result;
+}
+
+template <typename F, auto P>
+constexpr auto operator*(std::type_identity_t<F> s, sparse_matrix<F, P> const& a)
+  -> sparse_matrix<F, P>
+{
+  return a * s;
+}
+
+template <typename F, auto P>
+constexpr auto operator/(sparse_matrix<F, P> const& a, std::type_identity_t<F> s)
+  -> sparse_matrix<F, P>
+{
+  auto result = a;
+  for (auto& x : result.values()) {
+    x /= s;
+  }
+  return result;
+}
+
+template <typename F, auto P, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == P.cols)
+constexpr auto operator*(sparse_matrix<F, P> const& a, B const& b)
+  -> nani::vector<F, P.rows>
+{
+  using layout = detail::sparse::entries<P>;
+  auto result = nani::vector<F, P.rows>();
+  for (std::size_t i = 0; i < P.rows; ++i) {
+    result[i] = F(0);
+  }
+  detail::sparse::unroll<layout::size>([&](auto e) {
+    result[layout::row[e]] += a.values()[e] * b[layout::col[e]];
+  });
+  return result;
+}
+
+template <vector_like A, typename F, auto P>
+  requires std::is_same_v<F, vector_value_t<A>> and (vector_dim_v<A> == P.rows)
+constexpr auto operator*(A const& a, sparse_matrix<F, P> const& b)
+  -> nani::vector<F, P.cols>
+{
+  using layout = detail::sparse::entries<P>;
+  auto result = nani::vector<F, P.cols>();
+  for (std::size_t j = 0; j < P.cols; ++j) {
+    result[j] = F(0);
+  }
+  detail::sparse::unroll<layout::size>([&](auto e) {
+    result[layout::col[e]] += a[layout::row[e]] * b.values()[e];
+  });
+  return result;
+}
+
+template <typename F, auto P, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == P.cols)
+constexpr auto operator*(sparse_matrix<F, P> const& a, B const& b)
+  -> nani::matrix<F, P.rows, matrix_cols_v<B>>
+{
+  using layout = detail::sparse::entries<P>;
+  auto result = nani::matrix<F, P.rows, matrix_cols_v<B>>::zero();
+  detail::sparse::unroll<layout::size>([&](auto e) {
+    auto const x = a.values()[e];
+    for (std::size_t k = 0; k < matrix_cols_v<B>; ++k) {
+      result[layout::row[e]][k] += x * b[layout::col[e]][k];
+    }
+  });
+  return result;
+}
+
+template <matrix_like A, typename F, auto P>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == P.rows)
+constexpr auto operator*(A const& a, sparse_matrix<F, P> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, P.cols>
+{
+  using layout = detail::sparse::entries<P>;
+  auto result = nani::matrix<F, matrix_rows_v<A>, P.cols>::zero();
+  for (std::size_t r = 0; r < matrix_rows_v<A>; ++r) {
+    detail::sparse::unroll<layout::size>([&](auto e) {
+      result[r][layout::col[e]] += a[r][layout::row[e]] * b.values()[e];
+    });
+  }
+  return result;
+}
+
+template <typename F, auto P, auto Q>
+  requires(P.cols == Q.rows)
+constexpr auto operator*(sparse_matrix<F, P> const& a, sparse_matrix<F, Q> const& b)
+  -> sparse_matrix<F, product(P, Q)>
+{
+  using terms = detail::sparse::terms<P, Q>;
+  auto result = sparse_matrix<F, product(P, Q)>::zero();
+  detail::sparse::unroll<terms::size>([&](auto t) {
+    constexpr auto term = terms::table[t];
+    result.values()[term.c] += a.values()[term.a] * b.values()[term.b];
+  });
+  return result;
+}
+
+template <typename F, auto P>
+constexpr auto transpose(sparse_matrix<F, P> const& a) -> sparse_matrix<F, transpose(P)>
+{
+  using layout = detail::sparse::entries<P>;
+  auto result = sparse_matrix<F, transpose(P)>();
+  detail::sparse::unroll<layout::size>([&](auto e) {
+    result(layout::col[e], layout::row[e]) = a.values()[e];
+  });
+  return result;
+}
+
+template <auto P, vector_like A, vector_like B>
+  requires std::is_same_v<vector_value_t<A>, vector_value_t<B>>
+           and (vector_dim_v<A> == P.rows) and (vector_dim_v<B> == P.cols)
+constexpr auto outer(A const& a, B const& b) -> sparse_matrix<vector_value_t<A>, P>
+{
+  using layout = detail::sparse::entries<P>;
+  auto result = sparse_matrix<vector_value_t<A>, P>();
+  detail::sparse::unroll<layout::size>([&](auto e) {
+    result.values()[e] = a[layout::row[e]] * b[layout::col[e]];
+  });
+  return result;
+}
+} // namespace nani
+
+#endif // NANI_SPARSE_HPP
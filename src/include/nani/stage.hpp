@@ -0,0 +1,206 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_STAGE_HPP
+#define NANI_STAGE_HPP
+
+#include <cstddef>
+#include <nani/isa.hpp>
+#include <nani/layout.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <type_traits>
+#include <vector>
+
+/** Runge-Kutta Stage Combinations
+ *
+ * A stage of a low-storage or strong stability preserving Runge-Kutta method is a linear
+ * combination of a few fields, u = a u0 + b u1 + c dt R. `combine` evaluates it in a single pass
+ * over memory, without temporaries: every output value is read from the inputs, combined in
+ * registers and written once. These updates are bound by memory bandwidth, so outputs larger than
+ * the last-level cache are written with non-temporal stores (see `layout::streaming_bytes`).
+ **/
+namespace nani::stage {
+/* Elements per parallel chunk, a multiple of every SIMD width. */
+inline constexpr std::size_t grain = 16384;
+
+/* Largest number of terms of a combination. */
+inline constexpr std::size_t max_terms = 5;
+
+/* One term `coefficient * field` of a combination. */
+template <typename F, std::size_t N>
+struct term {
+  F coefficient;
+  nani::soa_span<F const, N> field;
+};
+
+template <typename F, std::size_t N>
+term(F, nani::soa_span<F, N>) -> term<F, N>;
+
+template <typename F, std::size_t N>
+term(F, nani::soa_span<F const, N>) -> term<F, N>;
+
+/* \brief out = sum of the terms
+ *
+ * `out` may be the field of one of the terms.
+ *
+ * PreConditions : every field has the size of out
+ */
+template <typename F, std::size_t N, typename... T>
+  requires(sizeof...(T) >= 1 and sizeof...(T) <= max_terms
+           and (std::is_same_v<T, term<F, N>> and ...))
+void combine(nani::soa_span<F, N> out, T const&... terms);
+
+/* \brief combine, returning the component-wise L2 norm of the field of the last term
+ *
+ * With the residual as the last term, as in u = a u0 + b u1 + c dt R, this is the residual norm
+ * of the stage at no additional memory traffic. The sum is taken in a fixed order, independent of
+ * the number of threads.
+ */
+template <typename F, std::size_t N, typename... T>
+  requires(sizeof...(T) >= 1 and sizeof...(T) <= max_terms
+           and (std::is_same_v<T, term<F, N>> and ...))
+auto combine_norm(nani::soa_span<F, N> out, T const&... terms) -> nani::vector<F, N>;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* out[i] = sum_k coefficient[k] * input[k][i] over one component stream; returns the sum of
+ * squares of input[K - 1][i] if Norm.
+ */
+template <typename F, std::size_t K, std::size_t W, bool Norm>
+inline auto combine_range(
+  nani::static_array<F, K> const& coefficient,
+  nani::static_array<F const*, K> const& input,
+  F* out,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept -> F
+{
+  using pack_type = nani::pack<F, W>;
+  using V = typename pack_type::native_type;
+
+  auto const nt = streaming and layout::detail::aligned<V>(out + begin);
+
+  auto square = pack_type(F(0));
+  auto i = begin;
+  for (; i + W <= end; i += W) {
+    auto x = coefficient[0] * pack_type::load(input[0] + i);
+    for (std::size_t k = 1; k < K; ++k) {
+      x += coefficient[k] * pack_type::load(input[k] + i);
+    }
+    if constexpr (Norm) {
+      auto const r = pack_type::load(input[K - 1] + i);
+      square += r * r;
+    }
+    nt ? layout::detail::stream(out + i, x.native()) : x.store(out + i);
+  }
+
+  auto result = nani::reduce(square);
+  for (; i < end; ++i) {
+    auto x = coefficient[0] * input[0][i];
+    for (std::size_t k = 1; k < K; ++k) {
+      x += coefficient[k] * input[k][i];
+    }
+    if constexpr (Norm) {
+      result += input[K - 1][i] * input[K - 1][i];
+    }
+    out[i] = x;
+  }
+
+  if (nt) {
+    layout::detail::fence();
+  }
+  return result;
+}
+
+/* Value types for which libnani carries one kernel per instruction set. */
+template <typename F>
+inline constexpr bool dispatched = std::is_same_v<F, float> or std::is_same_v<F, double>;
+
+/* One copy of `combine_range` per instruction set, selected by `target`; in libnani. */
+template <typename F, std::size_t K, bool Norm>
+auto combine_dispatch(
+  isa target,
+  nani::static_array<F, K> const& coefficient,
+  nani::static_array<F const*, K> const& input,
+  F* out,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept -> F;
+
+template <bool Norm, typename F, std::size_t N, typename... T>
+auto combine(nani::soa_span<F, N> const& out, T const&... terms) -> nani::vector<F, N>
+{
+  constexpr auto K = sizeof...(T);
+  (meta::check_size(terms.field.size(), out.size()), ...);
+
+  auto const coefficient = nani::static_array<F, K>(terms.coefficient...);
+  auto const streaming = out.size() * N * sizeof(F) > layout::streaming_bytes;
+  auto const target = nani::active_isa();
+
+  // One partial sum per chunk and component, added up in chunk order below.
+  auto const nchunk = (out.size() + grain - 1) / grain;
+  auto square = std::vector<F>(Norm ? nchunk * N : 0);
+
+  nani::parallel_for(out.size(), grain, [&](std::size_t begin, std::size_t end) {
+    // Stream by stream, so that non-temporal stores fill one write-combining buffer at a time.
+    for (std::size_t c = 0; c < N; ++c) {
+      auto const input = nani::static_array<F const*, K>(terms.field.data(c)...);
+      auto s = F(0);
+      if constexpr (dispatched<F>) {
+        s = combine_dispatch<F, K, Norm>(
+          target, coefficient, input, out.data(c), begin, end, streaming);
+      }
+      else {
+        s = combine_range<F, K, nani::simd_width_v<F>, Norm>(
+          coefficient, input, out.data(c), begin, end, streaming);
+      }
+      if constexpr (Norm) {
+        square[(begin / grain) * N + c] = s;
+      }
+    }
+  });
+
+  auto result = nani::vector<F, N>();
+  if constexpr (Norm) {
+    for (std::size_t chunk = 0; chunk < nchunk; ++chunk) {
+      for (std::size_t c = 0; c < N; ++c) {
+        result[c] += square[chunk * N + c];
+      }
+    }
+    for (std::size_t c = 0; c < N; ++c) {
+      result[c] = nani::sqrt(result[c]);
+    }
+  }
+  return result;
+}
+} // namespace detail
+
+template <typename F, std::size_t N, typename... T>
+  requires(sizeof...(T) >= 1 and sizeof...(T) <= max_terms
+           and (std::is_same_v<T, term<F, N>> and ...))
+void combine(nani::soa_span<F, N> out, T const&... terms)
+{
+  detail::combine<false>(out, terms...);
+}
+
+template <typename F, std::size_t N, typename... T>
+  requires(sizeof...(T) >= 1 and sizeof...(T) <= max_terms
+           and (std::is_same_v<T, term<F, N>> and ...))
+auto combine_norm(nani::soa_span<F, N> out, T const&... terms) -> nani::vector<F, N>
+{
+  return detail::combine<true>(out, terms...);
+}
+} // namespace nani::stage
+
+#endif // NANI_STAGE_HPP
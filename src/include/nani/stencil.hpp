@@ -0,0 +1,808 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_STENCIL_HPP
+#define NANI_STENCIL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <nani/aligned_allocator.hpp>
+#include <nani/grid.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** Stencils on Structured Grids
+ *
+ * A stencil is a compile-time list of offsets and weights, passed as a template argument:
+ * `apply<S>(u, v, s)` sets v(x) = s sum_k w_k u(x + o_k) at every interior point of a
+ * `grid_field`, reading the halo of u near the boundary. The factories below give the usual
+ * central differences, Laplacians and upwind-biased differences on a unit grid; the scale s
+ * carries the grid spacing.
+ *
+ * A sweep visits the interior in tiles that are processed in parallel. Within a tile the
+ * innermost loop runs along the contiguous last dimension in SIMD packs, with every term of the
+ * stencil a load at a fixed offset, and the tiles are sized so that the rows a tile reads again
+ * stay in a cache of `cache_bytes`.
+ *
+ * `iterate` repeats the update u <- u + s S(u) with the halo held fixed, as a relaxation or an
+ * explicit time step does. With a temporal block of b > 1 it marches tiles of the cross-section
+ * through the first dimension as a wavefront of b steps, each step keeping only the 2 r + 1
+ * planes the next one reads in a buffer that fits in the cache, and recomputing the b r layers
+ * each tile shares with its neighbours, so that the field makes one round trip through memory per
+ * b steps instead of per step. Where the cache cannot hold such tiles without recomputing more
+ * than it saves, or they are too few to keep every thread busy, fewer steps are fused, down to
+ * plain sweeps.
+ **/
+namespace nani::stencil {
+/* \brief Size of the per-core cache the tiles are sized for */
+inline constexpr std::size_t cache_bytes = std::size_t(256) * 1024;
+
+/* \brief K weights at offsets of a D-dimensional grid, a structural type */
+template <std::size_t D, std::size_t K>
+struct coefficients {
+  static constexpr std::size_t dim = D;
+  static constexpr std::size_t size = K;
+
+  std::array<std::array<int, D>, K> offset;
+  std::array<double, K> weight;
+
+  /* \brief Largest offset along any dimension */
+  constexpr auto radius() const noexcept -> std::size_t;
+};
+
+/* \brief First derivative along `axis` by central differences of the given order */
+template <std::size_t D, std::size_t Order = 2>
+  requires(Order == 2 or Order == 4 or Order == 6)
+consteval auto central(std::size_t axis) -> coefficients<D, Order>;
+
+/* \brief Sum of the second derivatives by central differences of the given order */
+template <std::size_t D, std::size_t Order = 2>
+  requires(Order == 2 or Order == 4)
+consteval auto laplacian() -> coefficients<D, Order * D + 1>;
+
+/* \brief First derivative along `axis`, biased against a flow in `direction` (+1 or -1) */
+template <std::size_t D, std::size_t Order = 3>
+  requires(Order == 1 or Order == 3)
+consteval auto upwind(std::size_t axis, int direction = 1) -> coefficients<D, Order + 1>;
+
+/* \brief v = scale S(u), component by component */
+template <auto S, typename F, std::size_t N, std::size_t D>
+  requires(S.dim == D)
+void apply(
+  nani::grid_field<F, N, D> const& u,
+  nani::grid_field<F, N, D>& v,
+  std::type_identity_t<F> scale = F(1));
+
+/* \brief Component d of g is scale S(u) with the one-dimensional stencil S along dimension d */
+template <auto S, typename F, std::size_t D>
+  requires(S.dim == 1)
+void gradient(
+  nani::grid_field<F, 1, D> const& u,
+  nani::grid_field<F, D, D>& g,
+  std::type_identity_t<F> scale = F(1));
+
+/* \brief v = scale sum_d S_d(u_d), with the one-dimensional stencil S along dimension d */
+template <auto S, typename F, std::size_t D>
+  requires(S.dim == 1)
+void divergence(
+  nani::grid_field<F, D, D> const& u,
+  nani::grid_field<F, 1, D>& v,
+  std::type_identity_t<F> scale = F(1));
+
+/* \brief `steps` updates u <- u + scale S(u), the halo of u held fixed
+ *
+ * `block` is the largest number of steps fused in one pass over memory. The result does not
+ * depend on it.
+ */
+template <auto S, typename F, std::size_t N, std::size_t D>
+  requires(S.dim == D)
+void iterate(
+  nani::grid_field<F, N, D>& u,
+  std::size_t steps,
+  std::type_identity_t<F> scale,
+  std::size_t block = 1);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <std::size_t D, std::size_t K>
+constexpr auto coefficients<D, K>::radius() const noexcept -> std::size_t
+{
+  auto result = std::size_t(0);
+  for (auto const& o : offset) {
+    for (auto const x : o) {
+      result = std::max(result, static_cast<std::size_t>(x < 0 ? -x : x));
+    }
+  }
+  return result;
+}
+
+namespace detail {
+/* Every entry is written, including the zero offsets, so that equal stencils are the same
+ * template argument however they were built.
+ */
+template <std::size_t D, std::size_t K>
+consteval auto along(
+  std::size_t axis, std::array<int, K> const& offset, std::array<double, K> const& weight)
+  -> coefficients<D, K>
+{
+  if (axis >= D) {
+    throw std::invalid_argument("stencil: axis out of range");
+  }
+  auto result = coefficients<D, K>();
+  for (std::size_t k = 0; k < K; ++k) {
+    for (std::size_t d = 0; d < D; ++d) {
+      result.offset[k][d] = d == axis ? offset[k] : 0;
+    }
+    result.weight[k] = weight[k];
+  }
+  return result;
+}
+
+template <std::size_t D>
+using index = std::array<std::ptrdiff_t, D>;
+
+/* A box [lo, hi) of grid points. */
+template <std::size_t D>
+struct box {
+  index<D> lo;
+  index<D> hi;
+};
+
+template <typename F, std::size_t N, std::size_t D>
+auto interior(nani::grid_field<F, N, D> const& u) -> box<D>
+{
+  auto result = box<D>();
+  for (std::size_t d = 0; d < D; ++d) {
+    result.lo[d] = 0;
+    result.hi[d] = static_cast<std::ptrdiff_t>(u.extent()[d]);
+  }
+  return result;
+}
+
+template <std::size_t D>
+auto position(index<D> const& stride, index<D> const& i) noexcept -> std::ptrdiff_t
+{
+  auto result = std::ptrdiff_t(0);
+  for (std::size_t d = 0; d < D; ++d) {
+    result += i[d] * stride[d];
+  }
+  return result;
+}
+
+/* Linear offsets of the terms of S on a grid with the given strides. */
+template <auto S, std::size_t D>
+auto offsets(index<D> const& stride) noexcept -> std::array<std::ptrdiff_t, S.size>
+{
+  auto result = std::array<std::ptrdiff_t, S.size>();
+  for (std::size_t k = 0; k < S.size; ++k) {
+    auto o = index<D>();
+    for (std::size_t d = 0; d < D; ++d) {
+      o[d] = S.offset[k][d];
+    }
+    result[k] = position(stride, o);
+  }
+  return result;
+}
+
+/* out[x] = (Accumulate ? base[x] : 0) + sum_t w[t] in[t][x] for x < n, in SIMD packs. */
+template <bool Accumulate, std::size_t T, typename F>
+void row(
+  F* out,
+  std::type_identity_t<F> const* base,
+  std::array<F const*, T> const& in,
+  std::array<F, T> const& w,
+  std::size_t n) noexcept
+{
+  constexpr auto width = simd_width_v<F>;
+  using pack_type = nani::pack<F, width>;
+
+  auto x = std::size_t(0);
+  for (; x + width <= n; x += width) {
+    auto sum = Accumulate ? pack_type::load(base + x) : pack_type(F(0));
+    [&]<std::size_t... t>(std::index_sequence<t...>) {
+      ((sum += w[t] * pack_type::load(in[t] + x)), ...);
+    }(std::make_index_sequence<T>());
+    sum.store(out + x);
+  }
+  for (; x < n; ++x) {
+    auto sum = Accumulate ? base[x] : F(0);
+    [&]<std::size_t... t>(std::index_sequence<t...>) {
+      ((sum += w[t] * in[t][x]), ...);
+    }(std::make_index_sequence<T>());
+    out[x] = sum;
+  }
+}
+
+/* Calls segment(i, n) for the rows of b, each the n points from i along the last dimension, in
+ * tiles sized for the cache: a tile spans the rows a stencil of the given radius reads again
+ * while they are still cached, `point_bytes` being the data read and written per point.
+ */
+template <std::size_t D, typename Segment>
+void sweep(
+  box<D> const& b,
+  std::size_t radius,
+  std::size_t point_bytes,
+  bool parallel,
+  Segment const& segment)
+{
+  auto extent = index<D>();
+  for (std::size_t d = 0; d < D; ++d) {
+    extent[d] = b.hi[d] - b.lo[d];
+    if (extent[d] <= 0) {
+      return;
+    }
+  }
+
+  // Shortest tile along the last dimension, a multiple of every SIMD width.
+  constexpr auto minimum = std::ptrdiff_t(64);
+  auto const reach = static_cast<std::ptrdiff_t>(2 * radius + 1);
+  auto const cache = static_cast<std::ptrdiff_t>(cache_bytes / point_bytes);
+  auto tile = extent;
+  if constexpr (D == 1) {
+    tile[0] = std::max<std::ptrdiff_t>(cache / 4 / minimum * minimum, minimum);
+  }
+  else {
+    // The reach rows of a 2D tile, or the reach planes of rows of a 3D tile, fit in cache.
+    auto const planes = D == 2 ? reach : reach * reach;
+    if (planes * extent[D - 1] > cache) {
+      tile[D - 1] = std::max<std::ptrdiff_t>(cache / planes / minimum * minimum, minimum);
+    }
+    if constexpr (D >= 3) {
+      tile[D - 2] = std::max<std::ptrdiff_t>(cache / (reach * tile[D - 1]) - 2 * (reach / 2), 1);
+    }
+    for (std::size_t d = 0; d + (D >= 3 ? 2 : 1) < D; ++d) {
+      tile[d] = 16;
+    }
+  }
+
+  auto count = index<D>();
+  auto ntile = std::size_t(1);
+  for (std::size_t d = 0; d < D; ++d) {
+    tile[d] = std::min(tile[d], extent[d]);
+    count[d] = (extent[d] + tile[d] - 1) / tile[d];
+    ntile *= static_cast<std::size_t>(count[d]);
+  }
+
+  auto const run = [&](std::size_t begin, std::size_t end) {
+    for (auto t = begin; t < end; ++t) {
+      auto lo = index<D>();
+      auto hi = index<D>();
+      auto rest = t;
+      for (auto d = D; d-- > 0;) {
+        auto const k = static_cast<std::ptrdiff_t>(rest % static_cast<std::size_t>(count[d]));
+        rest /= static_cast<std::size_t>(count[d]);
+        lo[d] = b.lo[d] + k * tile[d];
+        hi[d] = std::min(lo[d] + tile[d], b.hi[d]);
+      }
+      auto const n = static_cast<std::size_t>(hi[D - 1] - lo[D - 1]);
+      auto i = lo;
+      while (true) {
+        segment(i, n);
+        auto d = D - 1;
+        while (d > 0) {
+          --d;
+          if (++i[d] < hi[d]) {
+            break;
+          }
+          i[d] = lo[d];
+        }
+        if (d == 0 and i[0] == lo[0]) {
+          break;
+        }
+      }
+    }
+  };
+
+  if (parallel) {
+    nani::parallel_for(ntile, 1, run);
+  }
+  else {
+    run(0, ntile);
+  }
+}
+
+template <typename F, std::size_t N, std::size_t M, std::size_t D>
+void check(
+  nani::grid_field<F, N, D> const& u, nani::grid_field<F, M, D> const& v, std::size_t radius)
+{
+  for (std::size_t d = 0; d < D; ++d) {
+    meta::check_size(u.extent()[d], v.extent()[d]);
+  }
+  if (u.halo() < radius) {
+    throw std::runtime_error("nani::stencil: the halo is narrower than the stencil");
+  }
+}
+
+template <auto S, typename F>
+auto weights(F scale) noexcept -> std::array<F, S.size>
+{
+  auto result = std::array<F, S.size>();
+  for (std::size_t k = 0; k < S.size; ++k) {
+    result[k] = scale * static_cast<F>(S.weight[k]);
+  }
+  return result;
+}
+
+/* One update out = in + scale S(in) over b, for grids with the same strides given by the
+ * pointers to component c at index (0, ..., 0).
+ */
+template <auto S, typename F, std::size_t N, std::size_t D>
+void step(
+  std::array<F const*, N> const& in,
+  std::array<F*, N> const& out,
+  index<D> const& stride,
+  box<D> const& b,
+  F scale,
+  bool parallel)
+{
+  auto const off = offsets<S>(stride);
+  auto const w = weights<S>(scale);
+  sweep<D>(b, S.radius(), 2 * N * sizeof(F), parallel, [&](index<D> const& i, std::size_t n) {
+    auto const p = position(stride, i);
+    for (std::size_t c = 0; c < N; ++c) {
+      auto terms = std::array<F const*, S.size>();
+      for (std::size_t k = 0; k < S.size; ++k) {
+        terms[k] = in[c] + p + off[k];
+      }
+      row<true>(out[c] + p, in[c] + p, terms, w, n);
+    }
+  });
+}
+
+/* Calls f(i) with the first point i of every row of b along the last dimension. */
+template <std::size_t D, typename Function>
+void for_each_row(box<D> const& b, Function const& f)
+{
+  for (std::size_t d = 0; d < D; ++d) {
+    if (b.hi[d] <= b.lo[d]) {
+      return;
+    }
+  }
+  auto i = b.lo;
+  while (true) {
+    f(i);
+    auto d = D - 1;
+    while (d > 0) {
+      --d;
+      if (++i[d] < b.hi[d]) {
+        break;
+      }
+      i[d] = b.lo[d];
+    }
+    if (d == 0 and i[0] == b.lo[0]) {
+      break;
+    }
+  }
+}
+
+template <std::size_t D>
+auto shift(index<D> const& i, index<D> const& origin) noexcept -> index<D>
+{
+  auto result = i;
+  for (std::size_t d = 0; d < D; ++d) {
+    result[d] -= origin[d];
+  }
+  return result;
+}
+
+/* Temporal blocking: tiles of the cross-section advanced by `depth` steps at a time. */
+template <std::size_t D>
+struct blocking {
+  index<D> tile;
+  std::size_t depth;
+};
+
+/* The deepest blocking up to `block` steps whose buffers fit in the cache while doing at most
+ * twice the work of plain sweeps, in at least one tile per thread. A tile spans all of dimension
+ * 0, which is marched through, and is cut along the others but the last, or along the last in 2D;
+ * each fused step keeps the 2 r + 1 planes the next one reads, over the tile grown by depth r
+ * points on every side. Along the last dimension tiles and growth are whole multiples of `width`,
+ * so that every point falls in the same SIMD pack as in a plain sweep and the result is the same
+ * to the bit. A depth of 1 means plain sweeps.
+ */
+template <std::size_t D>
+auto plan(
+  index<D> const& extent,
+  std::ptrdiff_t radius,
+  std::size_t block,
+  std::size_t point_bytes,
+  std::ptrdiff_t width) -> blocking<D>
+{
+  if constexpr (D == 1) {
+    return blocking<D>{extent, 1};
+  }
+  else {
+    auto const cut = [](std::size_t d) { return d + 1 < D or D == 2; };
+    auto const unit = [&](std::size_t d) { return d + 1 < D ? std::ptrdiff_t(1) : width; };
+    auto const grow = [&](std::size_t d) { return (radius + unit(d) - 1) / unit(d) * unit(d); };
+    auto const threads = nani::thread_count();
+    auto const longest = *std::max_element(extent.begin(), extent.end());
+    for (auto depth = block; depth > 1; --depth) {
+      auto const planes = depth * static_cast<std::size_t>(2 * radius + 1);
+      auto const budget = static_cast<std::ptrdiff_t>(cache_bytes / (planes * point_bytes));
+
+      // The tiles with edge e units in the cut dimensions, their number, the points of a grown
+      // plane of one, and their work relative to plain sweeps.
+      auto const tiling = [&](std::ptrdiff_t e) {
+        auto result = blocking<D>{extent, depth};
+        for (std::size_t d = 1; d < D; ++d) {
+          if (cut(d)) {
+            result.tile[d] = std::min(e * unit(d), extent[d]);
+          }
+        }
+        return result;
+      };
+      auto const count = [&](blocking<D> const& t) {
+        auto result = std::size_t(1);
+        for (std::size_t d = 1; d < D; ++d) {
+          result *= static_cast<std::size_t>((extent[d] + t.tile[d] - 1) / t.tile[d]);
+        }
+        return result;
+      };
+      auto const points = [&](blocking<D> const& t) {
+        auto result = std::ptrdiff_t(1);
+        for (std::size_t d = 1; d < D; ++d) {
+          auto const margin = static_cast<std::ptrdiff_t>(depth) * grow(d);
+          result *= std::min(t.tile[d] + 2 * margin, extent[d] + 2 * radius);
+        }
+        return result;
+      };
+      auto const work = [&](blocking<D> const& t) {
+        auto result = 1.0;
+        for (std::size_t d = 1; d < D; ++d) {
+          if (t.tile[d] < extent[d]) {
+            auto const margin = static_cast<std::ptrdiff_t>(depth) * grow(d);
+            result *= static_cast<double>(t.tile[d] + 2 * margin) / static_cast<double>(t.tile[d]);
+          }
+        }
+        return result;
+      };
+
+      auto edge = std::ptrdiff_t(1);
+      if (points(tiling(edge)) > budget) {
+        continue;
+      }
+      while (edge < longest and points(tiling(edge + 1)) <= budget) {
+        ++edge;
+      }
+      while (edge > 1 and count(tiling(edge)) < threads) {
+        --edge;
+      }
+      auto const result = tiling(edge);
+      if (count(result) >= threads and work(result) <= 2.0) {
+        return result;
+      }
+    }
+    return blocking<D>{extent, 1};
+  }
+}
+} // namespace detail
+
+template <std::size_t D, std::size_t Order>
+  requires(Order == 2 or Order == 4 or Order == 6)
+consteval auto central(std::size_t axis) -> coefficients<D, Order>
+{
+  if constexpr (Order == 2) {
+    return detail::along<D, 2>(axis, {-1, 1}, {-0.5, 0.5});
+  }
+  else if constexpr (Order == 4) {
+    return detail::along<D, 4>(
+      axis, {-2, -1, 1, 2}, {1.0 / 12.0, -2.0 / 3.0, 2.0 / 3.0, -1.0 / 12.0});
+  }
+  else {
+    return detail::along<D, 6>(
+      axis,
+      {-3, -2, -1, 1, 2, 3},
+      {-1.0 / 60.0, 3.0 / 20.0, -3.0 / 4.0, 3.0 / 4.0, -3.0 / 20.0, 1.0 / 60.0});
+  }
+}
+
+template <std::size_t D, std::size_t Order>
+  requires(Order == 2 or Order == 4)
+consteval auto laplacian() -> coefficients<D, Order * D + 1>
+{
+  // Centre first, then the neighbours of each axis in order.
+  constexpr auto k = Order / 2;
+  auto const offset
+    = Order == 2 ? std::array<int, 4>{-1, 1, 0, 0} : std::array<int, 4>{-2, -1, 1, 2};
+  auto const weight = Order == 2
+                        ? std::array<double, 4>{1.0, 1.0, 0.0, 0.0}
+                        : std::array<double, 4>{-1.0 / 12.0, 4.0 / 3.0, 4.0 / 3.0, -1.0 / 12.0};
+  auto const centre = Order == 2 ? -2.0 : -2.5;
+
+  auto result = coefficients<D, Order * D + 1>();
+  for (std::size_t d = 0; d < D; ++d) {
+    result.offset[0][d] = 0;
+  }
+  result.weight[0] = centre * static_cast<double>(D);
+  for (std::size_t axis = 0; axis < D; ++axis) {
+    for (std::size_t j = 0; j < 2 * k; ++j) {
+      auto const n = 1 + axis * 2 * k + j;
+      for (std::size_t d = 0; d < D; ++d) {
+        result.offset[n][d] = d == axis ? offset[j] : 0;
+      }
+      result.weight[n] = weight[j];
+    }
+  }
+  return result;
+}
+
+template <std::size_t D, std::size_t Order>
+  requires(Order == 1 or Order == 3)
+consteval auto upwind(std::size_t axis, int direction) -> coefficients<D, Order + 1>
+{
+  if (direction != 1 and direction != -1) {
+    throw std::invalid_argument("stencil: the direction is +1 or -1");
+  }
+  // For a negative flow the stencil is mirrored, which also flips the sign of the derivative.
+  auto const s = direction;
+  if constexpr (Order == 1) {
+    return detail::along<D, 2>(axis, {-s, 0}, {-1.0 * s, 1.0 * s});
+  }
+  else {
+    return detail::along<D, 4>(
+      axis, {-2 * s, -s, 0, s}, {s / 6.0, -1.0 * s, s / 2.0, s / 3.0});
+  }
+}
+
+template <auto S, typename F, std::size_t N, std::size_t D>
+  requires(S.dim == D)
+void apply(
+  nani::grid_field<F, N, D> const& u, nani::grid_field<F, N, D>& v, std::type_identity_t<F> scale)
+{
+  detail::check(u, v, S.radius());
+  auto const off = detail::offsets<S>(u.stride());
+  auto const w = detail::weights<S>(scale);
+  auto const b = detail::interior(u);
+  detail::sweep<D>(b, S.radius(), 2 * N * sizeof(F), true, [&](auto const& i, std::size_t n) {
+    auto const p = detail::position(u.stride(), i);
+    auto const q = detail::position(v.stride(), i);
+    for (std::size_t c = 0; c < N; ++c) {
+      auto terms = std::array<F const*, S.size>();
+      for (std::size_t k = 0; k < S.size; ++k) {
+        terms[k] = u.data(c) + p + off[k];
+      }
+      detail::row<false>(v.data(c) + q, nullptr, terms, w, n);
+    }
+  });
+}
+
+template <auto S, typename F, std::size_t D>
+  requires(S.dim == 1)
+void gradient(
+  nani::grid_field<F, 1, D> const& u, nani::grid_field<F, D, D>& g, std::type_identity_t<F> scale)
+{
+  detail::check(u, g, S.radius());
+  auto off = std::array<std::array<std::ptrdiff_t, S.size>, D>();
+  for (std::size_t d = 0; d < D; ++d) {
+    for (std::size_t k = 0; k < S.size; ++k) {
+      off[d][k] = S.offset[k][0] * u.stride()[d];
+    }
+  }
+  auto const w = detail::weights<S>(scale);
+  auto const b = detail::interior(u);
+  detail::sweep<D>(b, S.radius(), (D + 1) * sizeof(F), true, [&](auto const& i, std::size_t n) {
+    auto const p = detail::position(u.stride(), i);
+    auto const q = detail::position(g.stride(), i);
+    for (std::size_t d = 0; d < D; ++d) {
+      auto terms = std::array<F const*, S.size>();
+      for (std::size_t k = 0; k < S.size; ++k) {
+        terms[k] = u.data(0) + p + off[d][k];
+      }
+      detail::row<false>(g.data(d) + q, nullptr, terms, w, n);
+    }
+  });
+}
+
+template <auto S, typename F, std::size_t D>
+  requires(S.dim == 1)
+void divergence(
+  nani::grid_field<F, D, D> const& u, nani::grid_field<F, 1, D>& v, std::type_identity_t<F> scale)
+{
+  constexpr auto K = S.size;
+  detail::check(u, v, S.radius());
+  auto off = std::array<std::ptrdiff_t, D * K>();
+  auto w = std::array<F, D * K>();
+  auto const w1 = detail::weights<S>(scale);
+  for (std::size_t d = 0; d < D; ++d) {
+    for (std::size_t k = 0; k < K; ++k) {
+      off[d * K + k] = S.offset[k][0] * u.stride()[d];
+      w[d * K + k] = w1[k];
+    }
+  }
+  auto const b = detail::interior(u);
+  detail::sweep<D>(b, S.radius(), (D + 1) * sizeof(F), true, [&](auto const& i, std::size_t n) {
+    auto const p = detail::position(u.stride(), i);
+    auto terms = std::array<F const*, D * K>();
+    for (std::size_t d = 0; d < D; ++d) {
+      for (std::size_t k = 0; k < K; ++k) {
+        terms[d * K + k] = u.data(d) + p + off[d * K + k];
+      }
+    }
+    detail::row<false>(v.data(0) + detail::position(v.stride(), i), nullptr, terms, w, n);
+  });
+}
+
+template <auto S, typename F, std::size_t N, std::size_t D>
+  requires(S.dim == D)
+void iterate(
+  nani::grid_field<F, N, D>& u, std::size_t steps, std::type_identity_t<F> scale, std::size_t block)
+{
+  detail::check(u, u, S.radius());
+  if (steps == 0) {
+    return;
+  }
+
+  // The halo of the copy is that of u, and stays so: only the interior is written.
+  auto next = u;
+  auto const b = detail::interior(u);
+  auto const pointers = [](auto& field) {
+    using pointer = decltype(field.data(0));
+    auto result = std::array<pointer, N>();
+    for (std::size_t c = 0; c < N; ++c) {
+      result[c] = field.data(c);
+    }
+    return result;
+  };
+
+  auto const r = static_cast<std::ptrdiff_t>(S.radius());
+  constexpr auto width = static_cast<std::ptrdiff_t>(simd_width_v<F>);
+  auto const plan = detail::plan<D>(b.hi, r, block, N * sizeof(F), width);
+  if (plan.depth <= 1) {
+    for (std::size_t s = 0; s < steps; ++s) {
+      auto const& current = u;
+      detail::step<S, F, N, D>(pointers(current), pointers(next), u.stride(), b, scale, true);
+      std::swap(u, next);
+    }
+    return;
+  }
+
+  auto count = detail::index<D>();
+  auto ntile = std::size_t(1);
+  for (std::size_t d = 1; d < D; ++d) {
+    count[d] = (b.hi[d] + plan.tile[d] - 1) / plan.tile[d];
+    ntile *= static_cast<std::size_t>(count[d]);
+  }
+  auto const n0 = b.hi[0];
+  // Growth of a tile per step: r points, or whole packs along the last dimension.
+  auto const grow = [&](std::size_t d) { return d + 1 < D ? r : (r + width - 1) / width * width; };
+  auto const ring = 2 * r + 1;
+  auto const w = detail::weights<S>(scale);
+
+  for (std::size_t done = 0; done < steps; done += plan.depth) {
+    auto const depth = std::min(plan.depth, steps - done);
+    auto const margin = static_cast<std::ptrdiff_t>(depth) * r;
+    auto const zero = std::ptrdiff_t(0);
+
+    nani::parallel_for(ntile, 1, [&](std::size_t begin, std::size_t end) {
+      auto buffer = std::vector<F, nani::aligned_allocator<F>>();
+      for (auto t = begin; t < end; ++t) {
+        // The tile, and the box e of each of its planes that is read: depth steps of growth
+        // more on every side, within r of the interior. Dimension 0 of both is left at [0, 1).
+        auto tile = detail::box<D>();
+        auto e = detail::box<D>();
+        auto local = detail::index<D>();
+        auto plane = std::size_t(1);
+        auto rest = t;
+        for (auto d = D; d-- > 1;) {
+          auto const k = static_cast<std::ptrdiff_t>(rest % static_cast<std::size_t>(count[d]));
+          rest /= static_cast<std::size_t>(count[d]);
+          tile.lo[d] = k * plan.tile[d];
+          tile.hi[d] = std::min(tile.lo[d] + plan.tile[d], b.hi[d]);
+          auto const reach = static_cast<std::ptrdiff_t>(depth) * grow(d);
+          e.lo[d] = std::max(tile.lo[d] - reach, -r);
+          e.hi[d] = std::min(tile.hi[d] + reach, b.hi[d] + r);
+          local[d] = static_cast<std::ptrdiff_t>(plane);
+          plane *= static_cast<std::size_t>(e.hi[d] - e.lo[d]);
+        }
+        tile.hi[0] = 1;
+        e.hi[0] = 1;
+        // Offsets of the terms within a plane; local[0] is 0.
+        auto const off = detail::offsets<S>(local);
+
+        // Step s keeps the planes of its result that step s + 1 still reads, in slots of a ring.
+        buffer.resize(depth * static_cast<std::size_t>(ring) * N * plane);
+        auto const slot = [&](std::size_t s, std::ptrdiff_t i0, std::size_t c) {
+          auto const k = static_cast<std::size_t>((i0 + r) % ring);
+          return buffer.data() + ((s * static_cast<std::size_t>(ring) + k) * N + c) * plane;
+        };
+        auto const global = [](detail::index<D> i, std::ptrdiff_t i0) {
+          i[0] = i0;
+          return i;
+        };
+
+        // Copies the points of plane i0 of u that step s leaves as they are: all of them, or
+        // those of the halo only.
+        auto const load = [&](std::size_t s, std::ptrdiff_t i0, bool halo) {
+          // The halo points of a row, if the tile reaches either end of it.
+          auto const before = static_cast<std::size_t>(std::max(-e.lo[D - 1], zero));
+          auto const after = static_cast<std::size_t>(std::max(e.hi[D - 1] - b.hi[D - 1], zero));
+          detail::for_each_row(e, [&](detail::index<D> const& i) {
+            auto inside = true;
+            for (std::size_t d = 1; d + 1 < D; ++d) {
+              inside = inside and i[d] >= 0 and i[d] < b.hi[d];
+            }
+            auto const p = detail::position(u.stride(), global(i, i0));
+            auto const q = detail::position(local, detail::shift(i, e.lo));
+            auto const row = static_cast<std::size_t>(e.hi[D - 1] - e.lo[D - 1]);
+            for (std::size_t c = 0; c < N; ++c) {
+              auto const* source = u.data(c) + p;
+              auto* target = slot(s, i0, c) + q;
+              if (not halo or not inside) {
+                std::copy_n(source, row, target);
+                continue;
+              }
+              std::copy_n(source, before, target);
+              std::copy_n(source + (row - after), after, target + (row - after));
+            }
+          });
+        };
+
+        // Plane i0 of step s from the 2 r + 1 planes around it of step s - 1, over the points
+        // within depth - s steps of growth of the tile; the last step writes to next.
+        auto const compute = [&](std::size_t s, std::ptrdiff_t i0) {
+          auto region = tile;
+          for (std::size_t d = 1; d < D; ++d) {
+            auto const shrink = static_cast<std::ptrdiff_t>(depth - s) * grow(d);
+            region.lo[d] = std::max(tile.lo[d] - shrink, std::ptrdiff_t(0));
+            region.hi[d] = std::min(tile.hi[d] + shrink, b.hi[d]);
+          }
+          auto const n = static_cast<std::size_t>(region.hi[D - 1] - region.lo[D - 1]);
+          auto source = std::array<std::array<F const*, S.size>, N>();
+          for (std::size_t c = 0; c < N; ++c) {
+            for (std::size_t k = 0; k < S.size; ++k) {
+              source[c][k] = slot(s - 1, i0 + S.offset[k][0], c) + off[k];
+            }
+          }
+          detail::for_each_row(region, [&](detail::index<D> const& i) {
+            auto const p = detail::position(local, detail::shift(i, e.lo));
+            auto const q = detail::position(next.stride(), global(i, i0));
+            for (std::size_t c = 0; c < N; ++c) {
+              auto terms = std::array<F const*, S.size>();
+              for (std::size_t k = 0; k < S.size; ++k) {
+                terms[k] = source[c][k] + p;
+              }
+              auto* out = s == depth ? next.data(c) + q : slot(s, i0, c) + p;
+              detail::row<true>(out, slot(s - 1, i0, c) + p, terms, w, n);
+            }
+          });
+        };
+
+        // Step s produces plane q - s r, once step s - 1 has produced the planes it reads.
+        for (auto q = -r; q < n0 + margin; ++q) {
+          if (q < n0 + r) {
+            load(0, q, false);
+          }
+          for (std::size_t s = 1; s <= depth; ++s) {
+            auto const i0 = q - static_cast<std::ptrdiff_t>(s) * r;
+            if (i0 < -r or i0 >= n0 + r or (s == depth and (i0 < 0 or i0 >= n0))) {
+              continue;
+            }
+            if (i0 < 0 or i0 >= n0) {
+              load(s, i0, false);
+              continue;
+            }
+            if (s < depth) {
+              load(s, i0, true);
+            }
+            compute(s, i0);
+          }
+        }
+      }
+    });
+    std::swap(u, next);
+  }
+}
+} // namespace nani::stencil
+
+#endif // NANI_STENCIL_HPP
@@ -0,0 +1,1257 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_STRUCTURED_HPP
+#define NANI_STRUCTURED_HPP
+
+#include <cstddef>
+#include <functional>
+#include <nani/factor.hpp>
+#include <nani/matrix.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <type_traits>
+
+/** Structured Matrices
+ *
+ * Square matrices whose structure is known at compile time, stored without their structural
+ * zeros or repeated entries:
+ *
+ *  - `symmetric_matrix<F, N>` stores the lower triangle, N (N + 1) / 2 entries, row by row;
+ *  - `diagonal_matrix<F, N>` stores the N diagonal entries;
+ *  - `triangular_matrix<F, N, triangle::lower>` and `<..., triangle::upper>` store their
+ *    triangle, N (N + 1) / 2 entries, row by row.
+ *
+ * Products with `matrix` and `vector`, solves and determinants loop over the stored entries
+ * only. The structured types are not `matrix_like`, so that no dense operator silently applies
+ * to them; the conversion to `matrix` is explicit, and the conversion from `matrix` keeps the
+ * part of it that the structure stores.
+ **/
+namespace nani {
+enum class triangle { lower, upper };
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+class symmetric_matrix {
+public:
+  using value_type = F;
+  static constexpr std::size_t dim = N;
+  static constexpr std::size_t packed_size = N * (N + 1) / 2;
+  using storage_type = nani::static_array<F, packed_size>;
+
+public:
+  symmetric_matrix() = default;
+
+  /* \brief Symmetric matrix with the lower triangle of a; the upper triangle is not read */
+  constexpr explicit symmetric_matrix(nani::matrix<F, N, N> const& a) noexcept;
+
+  static constexpr auto zero() noexcept -> symmetric_matrix;
+
+  static constexpr auto identity() noexcept -> symmetric_matrix;
+
+public:
+  constexpr explicit operator nani::matrix<F, N, N>() const noexcept;
+
+public:
+  /* \brief Entry (i, j), which is the same storage as entry (j, i) */
+  constexpr auto operator()(std::size_t i, std::size_t j) const noexcept -> F const&;
+
+  constexpr auto operator()(std::size_t i, std::size_t j) noexcept -> F&;
+
+  /* \brief The lower triangle, row by row */
+  constexpr auto packed() const noexcept -> storage_type const&;
+
+  constexpr auto packed() noexcept -> storage_type&;
+
+private:
+  storage_type x_{};
+};
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+class diagonal_matrix {
+public:
+  using value_type = F;
+  static constexpr std::size_t dim = N;
+  using vector_type = nani::vector<F, N>;
+
+public:
+  diagonal_matrix() = default;
+
+  constexpr explicit diagonal_matrix(vector_type const& diagonal) noexcept;
+
+  /* \brief Diagonal matrix with the diagonal of a */
+  constexpr explicit diagonal_matrix(nani::matrix<F, N, N> const& a) noexcept;
+
+  static constexpr auto zero() noexcept -> diagonal_matrix;
+
+  static constexpr auto identity() noexcept -> diagonal_matrix;
+
+public:
+  constexpr explicit operator nani::matrix<F, N, N>() const noexcept;
+
+public:
+  /* \brief Entry (i, j), zero for i != j */
+  constexpr auto operator()(std::size_t i, std::size_t j) const noexcept -> F;
+
+  /* \brief Diagonal entry (i, i) */
+  constexpr auto operator[](std::size_t i) const noexcept -> F const&;
+
+  constexpr auto operator[](std::size_t i) noexcept -> F&;
+
+  constexpr auto diagonal() const noexcept -> vector_type const&;
+
+private:
+  vector_type x_{};
+};
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+class triangular_matrix {
+public:
+  using value_type = F;
+  static constexpr std::size_t dim = N;
+  static constexpr triangle shape = T;
+  static constexpr std::size_t packed_size = N * (N + 1) / 2;
+  using storage_type = nani::static_array<F, packed_size>;
+
+public:
+  triangular_matrix() = default;
+
+  /* \brief Triangular matrix with the triangle T of a, including the diagonal */
+  constexpr explicit triangular_matrix(nani::matrix<F, N, N> const& a) noexcept;
+
+  static constexpr auto zero() noexcept -> triangular_matrix;
+
+  static constexpr auto identity() noexcept -> triangular_matrix;
+
+public:
+  constexpr explicit operator nani::matrix<F, N, N>() const noexcept;
+
+public:
+  /* \brief Whether entry (i, j) is stored, that is lies in the triangle */
+  static constexpr auto stored(std::size_t i, std::size_t j) noexcept -> bool;
+
+  /* \brief Entry (i, j), zero outside of the triangle */
+  constexpr auto operator()(std::size_t i, std::size_t j) const noexcept -> F;
+
+  /* \brief Entry (i, j)
+   *
+   * PreConditions : stored(i, j)
+   */
+  constexpr auto operator()(std::size_t i, std::size_t j) noexcept -> F&;
+
+  /* \brief The triangle, row by row */
+  constexpr auto packed() const noexcept -> storage_type const&;
+
+  constexpr auto packed() noexcept -> storage_type&;
+
+private:
+  storage_type x_{};
+};
+
+template <typename F, std::size_t N>
+using lower_triangular = triangular_matrix<F, N, triangle::lower>;
+
+template <typename F, std::size_t N>
+using upper_triangular = triangular_matrix<F, N, triangle::upper>;
+
+/* \brief L D L^T factor of a symmetric matrix, without pivoting, computed once for any number of
+ * solves
+ *
+ * This is `ldlt_factor` of `cholesky.hpp`, through the same kernels and with the same checks, for
+ * `symmetric_matrix`: L is kept as a `lower_triangular`, and the factorization only reads the
+ * stored entries. It is available in constant evaluation.
+ */
+template <typename F, std::size_t N>
+  requires(N >= 1)
+class symmetric_factor {
+public:
+  using value_type = F;
+  static constexpr std::size_t dim = N;
+
+public:
+  symmetric_factor() = default;
+
+  /* \brief Factor of a symmetric matrix
+   *
+   * PreConditions : the leading principal minors of a are nonzero (checked in debug builds)
+   */
+  constexpr explicit symmetric_factor(symmetric_matrix<F, N> const& a);
+
+public:
+  /* \brief L, with ones on the diagonal */
+  constexpr auto lower() const noexcept -> lower_triangular<F, N> const&;
+
+  /* \brief D */
+  constexpr auto diagonal() const noexcept -> nani::vector<F, N> const&;
+
+  constexpr auto solve(nani::vector<F, N> const& b) const noexcept -> nani::vector<F, N>;
+
+  template <std::size_t C>
+  constexpr auto solve(nani::matrix<F, N, C> const& b) const noexcept -> nani::matrix<F, N, C>;
+
+  constexpr auto determinant() const noexcept -> F;
+
+private:
+  lower_triangular<F, N> l_;
+  nani::vector<F, N> d_{};
+  nani::vector<F, N> reciprocal_{}; // 1 / D[i]
+};
+
+template <typename F, std::size_t N>
+constexpr auto ldlt(symmetric_matrix<F, N> const& a) -> symmetric_factor<F, N>;
+
+/* \brief a + b, a - b, s * a, a * s and a / s, entry by entry on the stored entries */
+template <typename F, std::size_t N>
+constexpr auto operator+(symmetric_matrix<F, N> const& a, symmetric_matrix<F, N> const& b)
+  -> symmetric_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator-(symmetric_matrix<F, N> const& a, symmetric_matrix<F, N> const& b)
+  -> symmetric_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator*(symmetric_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> symmetric_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator*(std::type_identity_t<F> s, symmetric_matrix<F, N> const& a)
+  -> symmetric_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator/(symmetric_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> symmetric_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator+(diagonal_matrix<F, N> const& a, diagonal_matrix<F, N> const& b)
+  -> diagonal_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator-(diagonal_matrix<F, N> const& a, diagonal_matrix<F, N> const& b)
+  -> diagonal_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator*(diagonal_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> diagonal_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator*(std::type_identity_t<F> s, diagonal_matrix<F, N> const& a)
+  -> diagonal_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto operator/(diagonal_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> diagonal_matrix<F, N>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator+(triangular_matrix<F, N, T> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator-(triangular_matrix<F, N, T> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, std::type_identity_t<F> s)
+  -> triangular_matrix<F, N, T>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(std::type_identity_t<F> s, triangular_matrix<F, N, T> const& a)
+  -> triangular_matrix<F, N, T>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator/(triangular_matrix<F, N, T> const& a, std::type_identity_t<F> s)
+  -> triangular_matrix<F, N, T>;
+
+/* \brief Products with vectors, reading every stored entry once */
+template <typename F, std::size_t N, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == N)
+constexpr auto operator*(symmetric_matrix<F, N> const& a, B const& b) -> nani::vector<F, N>;
+
+template <typename F, std::size_t N, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == N)
+constexpr auto operator*(diagonal_matrix<F, N> const& a, B const& b) -> nani::vector<F, N>;
+
+template <typename F, std::size_t N, triangle T, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == N)
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, B const& b) -> nani::vector<F, N>;
+
+/* \brief Products with dense matrices on either side, with dense results */
+template <typename F, std::size_t N, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == N)
+constexpr auto operator*(symmetric_matrix<F, N> const& a, B const& b)
+  -> nani::matrix<F, N, matrix_cols_v<B>>;
+
+template <matrix_like A, typename F, std::size_t N>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == N)
+constexpr auto operator*(A const& a, symmetric_matrix<F, N> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, N>;
+
+template <typename F, std::size_t N, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == N)
+constexpr auto operator*(diagonal_matrix<F, N> const& a, B const& b)
+  -> nani::matrix<F, N, matrix_cols_v<B>>;
+
+template <matrix_like A, typename F, std::size_t N>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == N)
+constexpr auto operator*(A const& a, diagonal_matrix<F, N> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, N>;
+
+template <typename F, std::size_t N, triangle T, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == N)
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, B const& b)
+  -> nani::matrix<F, N, matrix_cols_v<B>>;
+
+template <matrix_like A, typename F, std::size_t N, triangle T>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == N)
+constexpr auto operator*(A const& a, triangular_matrix<F, N, T> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, N>;
+
+/* \brief Products that keep the structure */
+template <typename F, std::size_t N>
+constexpr auto operator*(diagonal_matrix<F, N> const& a, diagonal_matrix<F, N> const& b)
+  -> diagonal_matrix<F, N>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(diagonal_matrix<F, N> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, diagonal_matrix<F, N> const& b)
+  -> triangular_matrix<F, N, T>;
+
+template <typename F, std::size_t N>
+constexpr auto transpose(symmetric_matrix<F, N> const& a) -> symmetric_matrix<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto transpose(diagonal_matrix<F, N> const& a) -> diagonal_matrix<F, N>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto transpose(triangular_matrix<F, N, T> const& a)
+  -> triangular_matrix<F, N, T == triangle::lower ? triangle::upper : triangle::lower>;
+
+/* \brief x such that a * x == b
+ *
+ * The triangular solve is a forward or backward substitution. The symmetric solve factors a as
+ * L D L^T in packed storage, without pivoting; `ldlt` keeps the factor for further solves.
+ *
+ * PreConditions : the diagonal of a diagonal or triangular a is nonzero; the leading principal
+ *                 minors of a symmetric a are nonzero (checked in debug builds)
+ */
+template <typename F, std::size_t N>
+constexpr auto solve(symmetric_matrix<F, N> const& a, nani::vector<F, N> const& b)
+  -> nani::vector<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto solve(diagonal_matrix<F, N> const& a, nani::vector<F, N> const& b)
+  -> nani::vector<F, N>;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto solve(triangular_matrix<F, N, T> const& a, nani::vector<F, N> const& b)
+  -> nani::vector<F, N>;
+
+/* \brief X such that a * X == b, column by column */
+template <typename F, std::size_t N, std::size_t C>
+constexpr auto solve(symmetric_matrix<F, N> const& a, nani::matrix<F, N, C> const& b)
+  -> nani::matrix<F, N, C>;
+
+template <typename F, std::size_t N, std::size_t C>
+constexpr auto solve(diagonal_matrix<F, N> const& a, nani::matrix<F, N, C> const& b)
+  -> nani::matrix<F, N, C>;
+
+template <typename F, std::size_t N, std::size_t C, triangle T>
+constexpr auto solve(triangular_matrix<F, N, T> const& a, nani::matrix<F, N, C> const& b)
+  -> nani::matrix<F, N, C>;
+
+/* \brief Determinant, the product of the diagonal for diagonal and triangular matrices and of
+ * the pivots of L D L^T for symmetric matrices
+ *
+ * The symmetric factorization does not pivot, so it needs every leading principal minor to be
+ * nonzero, which rules out singular matrices but also nonsingular ones such as [[0, 1], [1, 0]];
+ * the dense `determinant` of `matrix.hpp` has no such restriction, for N < 6.
+ *
+ * PreConditions : the leading principal minors of a symmetric a are nonzero (checked in debug
+ *                 builds)
+ */
+template <typename F, std::size_t N>
+constexpr auto determinant(symmetric_matrix<F, N> const& a) -> F;
+
+template <typename F, std::size_t N>
+constexpr auto determinant(diagonal_matrix<F, N> const& a) -> F;
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto determinant(triangular_matrix<F, N, T> const& a) -> F;
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail::structured {
+/* Position of the lower entry (i, j), j <= i, in row-by-row packed storage. */
+constexpr auto lower_index(std::size_t i, std::size_t j) noexcept -> std::size_t
+{
+  return i * (i + 1) / 2 + j;
+}
+
+/* Position of the upper entry (i, j), j >= i, of an N x N matrix in row-by-row packed storage. */
+template <std::size_t N>
+constexpr auto upper_index(std::size_t i, std::size_t j) noexcept -> std::size_t
+{
+  return i * (2 * N - i + 1) / 2 + (j - i);
+}
+
+/* Columns [first, last) of row i in the triangle T. */
+template <triangle T>
+constexpr auto row_first(std::size_t i) noexcept -> std::size_t
+{
+  return T == triangle::lower ? 0 : i;
+}
+
+template <triangle T, std::size_t N>
+constexpr auto row_last(std::size_t i) noexcept -> std::size_t
+{
+  return T == triangle::lower ? i + 1 : N;
+}
+
+/* Rows [first, last) of column j in the triangle T. */
+template <triangle T>
+constexpr auto column_first(std::size_t j) noexcept -> std::size_t
+{
+  return T == triangle::lower ? j : 0;
+}
+
+template <triangle T, std::size_t N>
+constexpr auto column_last(std::size_t j) noexcept -> std::size_t
+{
+  return T == triangle::lower ? N : j + 1;
+}
+
+/* y = a x for a symmetric a, reading every stored entry once. */
+template <typename F, std::size_t N, typename X, typename Y>
+constexpr void symmetric_product(symmetric_matrix<F, N> const& a, X const& x, Y& y) noexcept
+{
+  auto const& p = a.packed();
+  for (std::size_t i = 0; i < N; ++i) {
+    y[i] = F(0);
+  }
+  auto e = std::size_t(0);
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < i; ++j, ++e) {
+      y[i] += p[e] * x[j];
+      y[j] += p[e] * x[i];
+    }
+    y[i] += p[e++] * x[i];
+  }
+}
+
+/* x = a^-1 x for a triangular a, by forward (lower) or backward (upper) substitution. */
+template <typename F, std::size_t N, triangle T, typename X>
+constexpr void substitute(triangular_matrix<F, N, T> const& a, X& x) noexcept
+{
+  if constexpr (T == triangle::lower) {
+    for (std::size_t i = 0; i < N; ++i) {
+      for (std::size_t j = 0; j < i; ++j) {
+        x[i] -= a(i, j) * x[j];
+      }
+      x[i] /= a(i, i);
+    }
+  }
+  else {
+    for (auto i = N; i-- > 0;) {
+      for (auto j = i + 1; j < N; ++j) {
+        x[i] -= a(i, j) * x[j];
+      }
+      x[i] /= a(i, i);
+    }
+  }
+}
+
+/* Column j of b, and its inverse. */
+template <typename F, std::size_t N, std::size_t C>
+constexpr auto column(nani::matrix<F, N, C> const& b, std::size_t j) noexcept -> nani::vector<F, N>
+{
+  auto x = nani::vector<F, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    x[i] = b[i][j];
+  }
+  return x;
+}
+
+template <typename F, std::size_t N, std::size_t C>
+constexpr void set_column(nani::matrix<F, N, C>& b, std::size_t j, nani::vector<F, N> const& x)
+  noexcept
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    b[i][j] = x[i];
+  }
+}
+
+/* Entry by entry op on two packed storages. */
+template <typename S, typename Op>
+constexpr auto zip(S const& a, S const& b, Op op) noexcept -> S
+{
+  auto result = S();
+  for (std::size_t e = 0; e < a.size(); ++e) {
+    result[e] = op(a[e], b[e]);
+  }
+  return result;
+}
+} // namespace detail::structured
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr symmetric_matrix<F, N>::symmetric_matrix(nani::matrix<F, N, N> const& a) noexcept
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j <= i; ++j) {
+      x_[detail::structured::lower_index(i, j)] = a[i][j];
+    }
+  }
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_matrix<F, N>::zero() noexcept -> symmetric_matrix
+{
+  auto result = symmetric_matrix();
+  result.x_ = F(0);
+  return result;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_matrix<F, N>::identity() noexcept -> symmetric_matrix
+{
+  auto result = zero();
+  for (std::size_t i = 0; i < N; ++i) {
+    result(i, i) = F(1);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr symmetric_matrix<F, N>::operator nani::matrix<F, N, N>() const noexcept
+{
+  auto result = nani::matrix<F, N, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      result[i][j] = (*this)(i, j);
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_matrix<F, N>::operator()(std::size_t i, std::size_t j) const noexcept
+  -> F const&
+{
+  return i >= j ? x_[detail::structured::lower_index(i, j)]
+                : x_[detail::structured::lower_index(j, i)];
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_matrix<F, N>::operator()(std::size_t i, std::size_t j) noexcept -> F&
+{
+  return i >= j ? x_[detail::structured::lower_index(i, j)]
+                : x_[detail::structured::lower_index(j, i)];
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_matrix<F, N>::packed() const noexcept -> storage_type const&
+{
+  return x_;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_matrix<F, N>::packed() noexcept -> storage_type&
+{
+  return x_;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr diagonal_matrix<F, N>::diagonal_matrix(vector_type const& diagonal) noexcept
+: x_(diagonal)
+{
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr diagonal_matrix<F, N>::diagonal_matrix(nani::matrix<F, N, N> const& a) noexcept
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    x_[i] = a[i][i];
+  }
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto diagonal_matrix<F, N>::zero() noexcept -> diagonal_matrix
+{
+  auto result = diagonal_matrix();
+  for (std::size_t i = 0; i < N; ++i) {
+    result[i] = F(0);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto diagonal_matrix<F, N>::identity() noexcept -> diagonal_matrix
+{
+  auto result = diagonal_matrix();
+  for (std::size_t i = 0; i < N; ++i) {
+    result[i] = F(1);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr diagonal_matrix<F, N>::operator nani::matrix<F, N, N>() const noexcept
+{
+  auto result = nani::matrix<F, N, N>::zero();
+  for (std::size_t i = 0; i < N; ++i) {
+    result[i][i] = x_[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto diagonal_matrix<F, N>::operator()(std::size_t i, std::size_t j) const noexcept -> F
+{
+  return i == j ? x_[i] : F(0);
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto diagonal_matrix<F, N>::operator[](std::size_t i) const noexcept -> F const&
+{
+  return x_[i];
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto diagonal_matrix<F, N>::operator[](std::size_t i) noexcept -> F&
+{
+  return x_[i];
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto diagonal_matrix<F, N>::diagonal() const noexcept -> vector_type const&
+{
+  return x_;
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr triangular_matrix<F, N, T>::triangular_matrix(nani::matrix<F, N, N> const& a) noexcept
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const last = detail::structured::row_last<T, N>(i);
+    for (auto j = detail::structured::row_first<T>(i); j < last; ++j) {
+      (*this)(i, j) = a[i][j];
+    }
+  }
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr auto triangular_matrix<F, N, T>::zero() noexcept -> triangular_matrix
+{
+  auto result = triangular_matrix();
+  result.x_ = F(0);
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr auto triangular_matrix<F, N, T>::identity() noexcept -> triangular_matrix
+{
+  auto result = zero();
+  for (std::size_t i = 0; i < N; ++i) {
+    result(i, i) = F(1);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr triangular_matrix<F, N, T>::operator nani::matrix<F, N, N>() const noexcept
+{
+  auto result = nani::matrix<F, N, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      result[i][j] = (*this)(i, j);
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr auto triangular_matrix<F, N, T>::stored(std::size_t i, std::size_t j) noexcept -> bool
+{
+  return T == triangle::lower ? j <= i : j >= i;
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr auto triangular_matrix<F, N, T>::operator()(std::size_t i, std::size_t j) const noexcept
+  -> F
+{
+  if (not stored(i, j)) {
+    return F(0);
+  }
+  if constexpr (T == triangle::lower) {
+    return x_[detail::structured::lower_index(i, j)];
+  }
+  else {
+    return x_[detail::structured::upper_index<N>(i, j)];
+  }
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr auto triangular_matrix<F, N, T>::operator()(std::size_t i, std::size_t j) noexcept -> F&
+{
+  if constexpr (T == triangle::lower) {
+    return x_[detail::structured::lower_index(i, j)];
+  }
+  else {
+    return x_[detail::structured::upper_index<N>(i, j)];
+  }
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr auto triangular_matrix<F, N, T>::packed() const noexcept -> storage_type const&
+{
+  return x_;
+}
+
+template <typename F, std::size_t N, triangle T>
+  requires(N >= 1)
+constexpr auto triangular_matrix<F, N, T>::packed() noexcept -> storage_type&
+{
+  return x_;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr symmetric_factor<F, N>::symmetric_factor(symmetric_matrix<F, N> const& a)
+  : l_(lower_triangular<F, N>::identity())
+{
+  detail::factor::ldlt<N>(a, l_, d_, reciprocal_);
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_factor<F, N>::lower() const noexcept -> lower_triangular<F, N> const&
+{
+  return l_;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_factor<F, N>::diagonal() const noexcept -> nani::vector<F, N> const&
+{
+  return d_;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_factor<F, N>::solve(nani::vector<F, N> const& b) const noexcept
+  -> nani::vector<F, N>
+{
+  auto x = b;
+  detail::factor::ldlt_solve<N>(l_, reciprocal_, x);
+  return x;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+template <std::size_t C>
+constexpr auto symmetric_factor<F, N>::solve(nani::matrix<F, N, C> const& b) const noexcept
+  -> nani::matrix<F, N, C>
+{
+  auto result = nani::matrix<F, N, C>();
+  for (std::size_t j = 0; j < C; ++j) {
+    auto x = detail::structured::column(b, j);
+    detail::factor::ldlt_solve<N>(l_, reciprocal_, x);
+    detail::structured::set_column(result, j, x);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1)
+constexpr auto symmetric_factor<F, N>::determinant() const noexcept -> F
+{
+  auto result = F(1);
+  for (std::size_t i = 0; i < N; ++i) {
+    result *= d_[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto ldlt(symmetric_matrix<F, N> const& a) -> symmetric_factor<F, N>
+{
+  return symmetric_factor<F, N>(a);
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator+(symmetric_matrix<F, N> const& a, symmetric_matrix<F, N> const& b)
+  -> symmetric_matrix<F, N>
+{
+  auto result = symmetric_matrix<F, N>();
+  result.packed() = detail::structured::zip(a.packed(), b.packed(), std::plus<>());
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator-(symmetric_matrix<F, N> const& a, symmetric_matrix<F, N> const& b)
+  -> symmetric_matrix<F, N>
+{
+  auto result = symmetric_matrix<F, N>();
+  result.packed() = detail::structured::zip(a.packed(), b.packed(), std::minus<>());
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator*(symmetric_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> symmetric_matrix<F, N>
+{
+  auto result = a;
+  for (auto& x : result.packed()) {
+    x *= s;
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator*(std::type_identity_t<F> s, symmetric_matrix<F, N> const& a)
+  -> symmetric_matrix<F, N>
+{
+  return a * s;
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator/(symmetric_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> symmetric_matrix<F, N>
+{
+  auto result = a;
+  for (auto& x : result.packed()) {
+    x /= s;
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator+(diagonal_matrix<F, N> const& a, diagonal_matrix<F, N> const& b)
+  -> diagonal_matrix<F, N>
+{
+  return diagonal_matrix<F, N>(a.diagonal() + b.diagonal());
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator-(diagonal_matrix<F, N> const& a, diagonal_matrix<F, N> const& b)
+  -> diagonal_matrix<F, N>
+{
+  return diagonal_matrix<F, N>(a.diagonal() - b.diagonal());
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator*(diagonal_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> diagonal_matrix<F, N>
+{
+  return diagonal_matrix<F, N>(a.diagonal() * s);
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator*(std::type_identity_t<F> s, diagonal_matrix<F, N> const& a)
+  -> diagonal_matrix<F, N>
+{
+  return diagonal_matrix<F, N>(s * a.diagonal());
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator/(diagonal_matrix<F, N> const& a, std::type_identity_t<F> s)
+  -> diagonal_matrix<F, N>
+{
+  return diagonal_matrix<F, N>(a.diagonal() / s);
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator+(triangular_matrix<F, N, T> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>
+{
+  auto result = triangular_matrix<F, N, T>();
+  result.packed() = detail::structured::zip(a.packed(), b.packed(), std::plus<>());
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator-(triangular_matrix<F, N, T> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>
+{
+  auto result = triangular_matrix<F, N, T>();
+  result.packed() = detail::structured::zip(a.packed(), b.packed(), std::minus<>());
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, std::type_identity_t<F> s)
+  -> triangular_matrix<F, N, T>
+{
+  auto result = a;
+  for (auto& x : result.packed()) {
+    x *= s;
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(std::type_identity_t<F> s, triangular_matrix<F, N, T> const& a)
+  -> triangular_matrix<F, N, T>
+{
+  return a * s;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator/(triangular_matrix<F, N, T> const& a, std::type_identity_t<F> s)
+  -> triangular_matrix<F, N, T>
+{
+  auto result = a;
+  for (auto& x : result.packed()) {
+    x /= s;
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == N)
+constexpr auto operator*(symmetric_matrix<F, N> const& a, B const& b) -> nani::vector<F, N>
+{
+  auto result = nani::vector<F, N>();
+  detail::structured::symmetric_product(a, b, result);
+  return result;
+}
+
+template <typename F, std::size_t N, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == N)
+constexpr auto operator*(diagonal_matrix<F, N> const& a, B const& b) -> nani::vector<F, N>
+{
+  auto result = nani::vector<F, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    result[i] = a[i] * b[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T, vector_like B>
+  requires std::is_same_v<F, vector_value_t<B>> and (vector_dim_v<B> == N)
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, B const& b) -> nani::vector<F, N>
+{
+  auto result = nani::vector<F, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    result[i] = F(0);
+    auto const last = detail::structured::row_last<T, N>(i);
+    for (auto j = detail::structured::row_first<T>(i); j < last; ++j) {
+      result[i] += a(i, j) * b[j];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == N)
+constexpr auto operator*(symmetric_matrix<F, N> const& a, B const& b)
+  -> nani::matrix<F, N, matrix_cols_v<B>>
+{
+  constexpr auto C = matrix_cols_v<B>;
+  auto result = nani::matrix<F, N, C>::zero();
+  auto const& p = a.packed();
+  // Every stored entry updates rows i and j of the result at once.
+  auto e = std::size_t(0);
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < i; ++j, ++e) {
+      for (std::size_t k = 0; k < C; ++k) {
+        result[i][k] += p[e] * b[j][k];
+        result[j][k] += p[e] * b[i][k];
+      }
+    }
+    for (std::size_t k = 0; k < C; ++k) {
+      result[i][k] += p[e] * b[i][k];
+    }
+    ++e;
+  }
+  return result;
+}
+
+template <matrix_like A, typename F, std::size_t N>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == N)
+constexpr auto operator*(A const& a, symmetric_matrix<F, N> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, N>
+{
+  // Row r of a b is b times row r of a, as b is symmetric.
+  auto result = nani::matrix<F, matrix_rows_v<A>, N>();
+  for (std::size_t r = 0; r < matrix_rows_v<A>; ++r) {
+    detail::structured::symmetric_product(b, a[r], result[r]);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == N)
+constexpr auto operator*(diagonal_matrix<F, N> const& a, B const& b)
+  -> nani::matrix<F, N, matrix_cols_v<B>>
+{
+  auto result = nani::matrix<F, N, matrix_cols_v<B>>();
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t k = 0; k < matrix_cols_v<B>; ++k) {
+      result[i][k] = a[i] * b[i][k];
+    }
+  }
+  return result;
+}
+
+template <matrix_like A, typename F, std::size_t N>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == N)
+constexpr auto operator*(A const& a, diagonal_matrix<F, N> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, N>
+{
+  auto result = nani::matrix<F, matrix_rows_v<A>, N>();
+  for (std::size_t r = 0; r < matrix_rows_v<A>; ++r) {
+    for (std::size_t j = 0; j < N; ++j) {
+      result[r][j] = a[r][j] * b[j];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T, matrix_like B>
+  requires std::is_same_v<F, matrix_value_t<B>> and (matrix_rows_v<B> == N)
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, B const& b)
+  -> nani::matrix<F, N, matrix_cols_v<B>>
+{
+  constexpr auto C = matrix_cols_v<B>;
+  auto result = nani::matrix<F, N, C>::zero();
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const last = detail::structured::row_last<T, N>(i);
+    for (auto j = detail::structured::row_first<T>(i); j < last; ++j) {
+      auto const aij = a(i, j);
+      for (std::size_t k = 0; k < C; ++k) {
+        result[i][k] += aij * b[j][k];
+      }
+    }
+  }
+  return result;
+}
+
+template <matrix_like A, typename F, std::size_t N, triangle T>
+  requires std::is_same_v<F, matrix_value_t<A>> and (matrix_cols_v<A> == N)
+constexpr auto operator*(A const& a, triangular_matrix<F, N, T> const& b)
+  -> nani::matrix<F, matrix_rows_v<A>, N>
+{
+  auto result = nani::matrix<F, matrix_rows_v<A>, N>::zero();
+  for (std::size_t r = 0; r < matrix_rows_v<A>; ++r) {
+    for (std::size_t k = 0; k < N; ++k) {
+      auto const ark = a[r][k];
+      auto const last = detail::structured::row_last<T, N>(k);
+      for (auto j = detail::structured::row_first<T>(k); j < last; ++j) {
+        result[r][j] += ark * b(k, j);
+      }
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto operator*(diagonal_matrix<F, N> const& a, diagonal_matrix<F, N> const& b)
+  -> diagonal_matrix<F, N>
+{
+  auto result = diagonal_matrix<F, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    result[i] = a[i] * b[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>
+{
+  // (a b)(i, j) sums over the k that lie between i and j, in both triangles.
+  auto result = triangular_matrix<F, N, T>();
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const last = detail::structured::row_last<T, N>(i);
+    for (auto j = detail::structured::row_first<T>(i); j < last; ++j) {
+      auto sum = F(0);
+      auto const k_last = T == triangle::lower ? i + 1 : j + 1;
+      for (auto k = T == triangle::lower ? j : i; k < k_last; ++k) {
+        sum += a(i, k) * b(k, j);
+      }
+      result(i, j) = sum;
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(diagonal_matrix<F, N> const& a, triangular_matrix<F, N, T> const& b)
+  -> triangular_matrix<F, N, T>
+{
+  auto result = b;
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const last = detail::structured::row_last<T, N>(i);
+    for (auto j = detail::structured::row_first<T>(i); j < last; ++j) {
+      result(i, j) *= a[i];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto operator*(triangular_matrix<F, N, T> const& a, diagonal_matrix<F, N> const& b)
+  -> triangular_matrix<F, N, T>
+{
+  auto result = a;
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const last = detail::structured::row_last<T, N>(i);
+    for (auto j = detail::structured::row_first<T>(i); j < last; ++j) {
+      result(i, j) *= b[j];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto transpose(symmetric_matrix<F, N> const& a) -> symmetric_matrix<F, N>
+{
+  return a;
+}
+
+template <typename F, std::size_t N>
+constexpr auto transpose(diagonal_matrix<F, N> const& a) -> diagonal_matrix<F, N>
+{
+  return a;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto transpose(triangular_matrix<F, N, T> const& a)
+  -> triangular_matrix<F, N, T == triangle::lower ? triangle::upper : triangle::lower>
+{
+  auto result = triangular_matrix<F, N, T == triangle::lower ? triangle::upper : triangle::lower>();
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const last = detail::structured::row_last<T, N>(i);
+    for (auto j = detail::structured::row_first<T>(i); j < last; ++j) {
+      result(j, i) = a(i, j);
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto solve(symmetric_matrix<F, N> const& a, nani::vector<F, N> const& b)
+  -> nani::vector<F, N>
+{
+  return ldlt(a).solve(b);
+}
+
+template <typename F, std::size_t N>
+constexpr auto solve(diagonal_matrix<F, N> const& a, nani::vector<F, N> const& b)
+  -> nani::vector<F, N>
+{
+  auto x = nani::vector<F, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    x[i] = b[i] / a[i];
+  }
+  return x;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto solve(triangular_matrix<F, N, T> const& a, nani::vector<F, N> const& b)
+  -> nani::vector<F, N>
+{
+  auto x = b;
+  detail::structured::substitute(a, x);
+  return x;
+}
+
+template <typename F, std::size_t N, std::size_t C>
+constexpr auto solve(symmetric_matrix<F, N> const& a, nani::matrix<F, N, C> const& b)
+  -> nani::matrix<F, N, C>
+{
+  return ldlt(a).solve(b);
+}
+
+template <typename F, std::size_t N, std::size_t C>
+constexpr auto solve(diagonal_matrix<F, N> const& a, nani::matrix<F, N, C> const& b)
+  -> nani::matrix<F, N, C>
+{
+  auto result = nani::matrix<F, N, C>();
+  for (std::size_t i = 0; i < N; ++i) {
+    auto const r = F(1) / a[i];
+    for (std::size_t j = 0; j < C; ++j) {
+      result[i][j] = r * b[i][j];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t C, triangle T>
+constexpr auto solve(triangular_matrix<F, N, T> const& a, nani::matrix<F, N, C> const& b)
+  -> nani::matrix<F, N, C>
+{
+  auto result = nani::matrix<F, N, C>();
+  for (std::size_t j = 0; j < C; ++j) {
+    auto x = detail::structured::column(b, j);
+    detail::structured::substitute(a, x);
+    detail::structured::set_column(result, j, x);
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto determinant(symmetric_matrix<F, N> const& a) -> F
+{
+  return ldlt(a).determinant();
+}
+
+template <typename F, std::size_t N>
+constexpr auto determinant(diagonal_matrix<F, N> const& a) -> F
+{
+  auto result = F(1);
+  for (std::size_t i = 0; i < N; ++i) {
+    result *= a[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, triangle T>
+constexpr auto determinant(triangular_matrix<F, N, T> const& a) -> F
+{
+  auto result = F(1);
+  for (std::size_t i = 0; i < N; ++i) {
+    result *= a(i, i);
+  }
+  return result;
+}
+} // namespace nani
+
+#endif // NANI_STRUCTURED_HPP
@@ -0,0 +1,282 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_SUMFACT_HPP
+#define NANI_SUMFACT_HPP
+
+#include <array>
+#include <cstddef>
+#include <nani/matrix.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/tiled.hpp>
+#include <nani/vector.hpp>
+#include <utility>
+
+/** Sum Factorization
+ *
+ * Kernels on the nodal values of a tensor-product element in D dimensions with N nodes per
+ * direction, stored in a `vector<T, N^D>` with the node (i_0, ..., i_{D-1}) at position
+ * (...(i_0 N + i_1) N + ...) + i_{D-1}: direction 0 is the slowest and direction D - 1 is
+ * contiguous.
+ *
+ * An operator that is the tensor product of 1D operators A (M x N) is applied one direction at a
+ * time, each a batch of small products with A, so that it costs O(M N^D + ... + M^D N) instead of
+ * the O(M^D N^D) of the assembled operator. The 1D operators are the matrices of
+ * `nani::quadrature`: `interpolation` to other nodes or quadrature points, and
+ * `differentiation`.
+ *
+ * T is a scalar or a `pack`. A `vector<pack<F, W>, N^D>` holds W elements, one per lane, which is
+ * exactly a tile of a `tiled_field<F, N^D, W>`: the overloads on tiled fields run every kernel on
+ * W elements at once with the scalar coefficients of A broadcast to all lanes.
+ **/
+namespace nani::sumfact {
+/* Number of tiles handed to a thread at once by the batched kernels. */
+inline constexpr std::size_t grain = 64;
+
+/* \brief Number of nodes N^D of an element with N nodes per direction */
+template <std::size_t N, std::size_t D>
+inline constexpr std::size_t nodes_v = N * nodes_v<N, D - 1>;
+
+template <std::size_t N>
+inline constexpr std::size_t nodes_v<N, 0> = 1;
+
+/* \brief Values at the M^D points of the tensor-product interpolation a (M x N) of u */
+template <std::size_t D, typename F, std::size_t M, std::size_t N, typename T>
+constexpr auto interpolate(nani::matrix<F, M, N> const& a, nani::vector<T, nodes_v<N, D>> const& u)
+  -> nani::vector<T, nodes_v<M, D>>;
+
+/* \brief Derivative of u along direction K, with the 1D differentiation matrix d */
+template <std::size_t K, std::size_t D, typename F, std::size_t N, typename T>
+  requires(K < D)
+constexpr auto derivative(nani::matrix<F, N, N> const& d, nani::vector<T, nodes_v<N, D>> const& u)
+  -> nani::vector<T, nodes_v<N, D>>;
+
+/* \brief Derivatives of u along all D directions */
+template <std::size_t D, typename F, std::size_t N, typename T>
+constexpr auto gradient(nani::matrix<F, N, N> const& d, nani::vector<T, nodes_v<N, D>> const& u)
+  -> std::array<nani::vector<T, nodes_v<N, D>>, D>;
+
+/* \brief Integrals of f against the N^D basis functions
+ *
+ * f holds values at the M^D quadrature points with 1D weights w, and a (M x N) interpolates the
+ * basis to those points: the result is r_i = sum_q A_qi w_q f_q with A and w the tensor products,
+ * the transpose of `interpolate` applied to the weighted values.
+ */
+template <std::size_t D, typename F, std::size_t M, std::size_t N, typename T>
+constexpr auto integrate(
+  nani::matrix<F, M, N> const& a,
+  nani::vector<F, M> const& w,
+  nani::vector<T, nodes_v<M, D>> const& f) -> nani::vector<T, nodes_v<N, D>>;
+
+/* \brief `interpolate` on every element of u
+ *
+ * PreConditions : v.size() == u.size()
+ */
+template <std::size_t D, typename F, std::size_t M, std::size_t N, std::size_t W>
+void interpolate(
+  nani::matrix<F, M, N> const& a,
+  nani::tiled_field<F, nodes_v<N, D>, W> const& u,
+  nani::tiled_field<F, nodes_v<M, D>, W>& v);
+
+/* \brief `gradient` on every element of u
+ *
+ * PreConditions : g[k].size() == u.size()
+ */
+template <std::size_t D, typename F, std::size_t N, std::size_t W>
+void gradient(
+  nani::matrix<F, N, N> const& d,
+  nani::tiled_field<F, nodes_v<N, D>, W> const& u,
+  std::array<nani::tiled_field<F, nodes_v<N, D>, W>, D>& g);
+
+/* \brief `integrate` on every element of f
+ *
+ * PreConditions : r.size() == f.size()
+ */
+template <std::size_t D, typename F, std::size_t M, std::size_t N, std::size_t W>
+void integrate(
+  nani::matrix<F, M, N> const& a,
+  nani::vector<F, M> const& w,
+  nani::tiled_field<F, nodes_v<M, D>, W> const& f,
+  nani::tiled_field<F, nodes_v<N, D>, W>& r);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail {
+/* Applies a (M x N), or its transpose (N x M) if Transposed, along the middle direction of u with
+ * extents (Outer, N, Inner), or (Outer, M, Inner) if Transposed. The innermost loop runs over the
+ * contiguous Inner values, each one product of a scalar coefficient and a value.
+ */
+template <
+  bool Transposed,
+  std::size_t Outer,
+  std::size_t Inner,
+  typename F,
+  std::size_t M,
+  std::size_t N,
+  typename T>
+constexpr auto apply(
+  nani::matrix<F, M, N> const& a, nani::vector<T, Outer * (Transposed ? M : N) * Inner> const& u)
+{
+  constexpr auto from = Transposed ? M : N;
+  constexpr auto to = Transposed ? N : M;
+  auto result = nani::vector<T, Outer * to * Inner>();
+  for (std::size_t o = 0; o < Outer; ++o) {
+    for (std::size_t m = 0; m < to; ++m) {
+      auto* out = &result[(o * to + m) * Inner];
+      for (std::size_t i = 0; i < Inner; ++i) {
+        out[i] = T(0);
+      }
+      for (std::size_t n = 0; n < from; ++n) {
+        auto const c = Transposed ? a[n][m] : a[m][n];
+        auto const* in = &u[(o * from + n) * Inner];
+        for (std::size_t i = 0; i < Inner; ++i) {
+          out[i] += c * in[i];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/* Applies a in directions K, K + 1, ..., D - 1 of u, directions before K already having M
+ * points.
+ */
+template <
+  bool Transposed,
+  std::size_t K,
+  std::size_t D,
+  typename F,
+  std::size_t M,
+  std::size_t N,
+  typename T,
+  std::size_t S>
+constexpr auto apply_all(nani::matrix<F, M, N> const& a, nani::vector<T, S> const& u)
+{
+  constexpr auto from = Transposed ? M : N;
+  constexpr auto to = Transposed ? N : M;
+  if constexpr (K == D) {
+    return u;
+  }
+  else {
+    auto const v
+      = apply<Transposed, nodes_v<to, K>, nodes_v<from, D - K - 1>, F, M, N, T>(a, u);
+    return apply_all<Transposed, K + 1, D>(a, v);
+  }
+}
+
+/* Weights of the M^D quadrature points, the products of the 1D weights. */
+template <std::size_t D, typename F, std::size_t M>
+constexpr auto weights(nani::vector<F, M> const& w) -> nani::vector<F, nodes_v<M, D>>
+{
+  auto result = nani::vector<F, nodes_v<M, D>>();
+  for (std::size_t q = 0; q < nodes_v<M, D>; ++q) {
+    auto product = F(1);
+    auto index = q;
+    for (std::size_t k = 0; k < D; ++k) {
+      product *= w[index % M];
+      index /= M;
+    }
+    result[q] = product;
+  }
+  return result;
+}
+} // namespace detail
+
+template <std::size_t D, typename F, std::size_t M, std::size_t N, typename T>
+constexpr auto interpolate(nani::matrix<F, M, N> const& a, nani::vector<T, nodes_v<N, D>> const& u)
+  -> nani::vector<T, nodes_v<M, D>>
+{
+  return detail::apply_all<false, 0, D>(a, u);
+}
+
+template <std::size_t K, std::size_t D, typename F, std::size_t N, typename T>
+  requires(K < D)
+constexpr auto derivative(nani::matrix<F, N, N> const& d, nani::vector<T, nodes_v<N, D>> const& u)
+  -> nani::vector<T, nodes_v<N, D>>
+{
+  return detail::apply<false, nodes_v<N, K>, nodes_v<N, D - K - 1>, F, N, N, T>(d, u);
+}
+
+template <std::size_t D, typename F, std::size_t N, typename T>
+constexpr auto gradient(nani::matrix<F, N, N> const& d, nani::vector<T, nodes_v<N, D>> const& u)
+  -> std::array<nani::vector<T, nodes_v<N, D>>, D>
+{
+  return [&]<std::size_t... K>(std::index_sequence<K...>) {
+    return std::array<nani::vector<T, nodes_v<N, D>>, D>{derivative<K, D>(d, u)...};
+  }(std::make_index_sequence<D>());
+}
+
+template <std::size_t D, typename F, std::size_t M, std::size_t N, typename T>
+constexpr auto integrate(
+  nani::matrix<F, M, N> const& a,
+  nani::vector<F, M> const& w,
+  nani::vector<T, nodes_v<M, D>> const& f) -> nani::vector<T, nodes_v<N, D>>
+{
+  auto const weight = detail::weights<D>(w);
+  auto weighted = nani::vector<T, nodes_v<M, D>>();
+  for (std::size_t q = 0; q < nodes_v<M, D>; ++q) {
+    weighted[q] = weight[q] * f[q];
+  }
+  return detail::apply_all<true, 0, D>(a, weighted);
+}
+
+template <std::size_t D, typename F, std::size_t M, std::size_t N, std::size_t W>
+void interpolate(
+  nani::matrix<F, M, N> const& a,
+  nani::tiled_field<F, nodes_v<N, D>, W> const& u,
+  nani::tiled_field<F, nodes_v<M, D>, W>& v)
+{
+  meta::check_size(u.size(), v.size());
+  auto const in = u.tiles();
+  auto const out = v.tiles();
+  nani::parallel_for(in.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t t = begin; t < end; ++t) {
+      out[t] = interpolate<D>(a, in[t]);
+    }
+  });
+}
+
+template <std::size_t D, typename F, std::size_t N, std::size_t W>
+void gradient(
+  nani::matrix<F, N, N> const& d,
+  nani::tiled_field<F, nodes_v<N, D>, W> const& u,
+  std::array<nani::tiled_field<F, nodes_v<N, D>, W>, D>& g)
+{
+  for (auto const& component : g) {
+    meta::check_size(u.size(), component.size());
+  }
+  auto const in = u.tiles();
+  nani::parallel_for(in.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t t = begin; t < end; ++t) {
+      [&]<std::size_t... K>(std::index_sequence<K...>) {
+        ((g[K].tiles()[t] = derivative<K, D>(d, in[t])), ...);
+      }(std::make_index_sequence<D>());
+    }
+  });
+}
+
+template <std::size_t D, typename F, std::size_t M, std::size_t N, std::size_t W>
+void integrate(
+  nani::matrix<F, M, N> const& a,
+  nani::vector<F, M> const& w,
+  nani::tiled_field<F, nodes_v<M, D>, W> const& f,
+  nani::tiled_field<F, nodes_v<N, D>, W>& r)
+{
+  meta::check_size(f.size(), r.size());
+  auto const in = f.tiles();
+  auto const out = r.tiles();
+  nani::parallel_for(in.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t t = begin; t < end; ++t) {
+      out[t] = integrate<D>(a, w, in[t]);
+    }
+  });
+}
+} // namespace nani::sumfact
+
+#endif // NANI_SUMFACT_HPP
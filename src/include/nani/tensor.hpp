@@ -0,0 +1,572 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_TENSOR_HPP
+#define NANI_TENSOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <nani/matrix.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/** Fixed-Size Tensors and Index Contraction
+ *
+ * `tensor<F, D0, D1, ...>` is a dense tensor of rank sizeof...(D) with its entries stored row by
+ * row (the last index is contiguous). `contract<"...">(operands...)` evaluates a contraction
+ * written in Einstein notation at compile time:
+ *
+ *     auto c = nani::contract<"ijk,kl->ijl">(a, b);   // c_ijl = sum_k a_ijk b_kl
+ *     auto t = nani::contract<"ii">(m);               // trace, a scalar
+ *     auto y = nani::contract<"ij,j">(m, x);          // implicit output: the labels seen once
+ *
+ * Operands are tensors, vectors (rank 1) and matrices (rank 2), views included, read in place.
+ * Without an explicit `->` the output labels are those that appear exactly once, in alphabetical
+ * order, as in numpy's einsum. Ranks and extents are checked at compile time.
+ *
+ * The contraction is a single loop nest over all the labels, accumulating products into the
+ * result, which the compiler contracts into fused multiply-adds on FMA targets. Labels are nested
+ * by decreasing total stride over the operands and the result, so that the innermost loop is the
+ * one that is contiguous in the most of them. When the whole iteration space has at most
+ * `unroll_limit` points, the nest is generated fully unrolled with every offset a constant.
+ **/
+namespace nani {
+/* \brief Largest iteration space of a contraction that is generated fully unrolled */
+inline constexpr std::size_t unroll_limit = 512;
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+class tensor {
+public:
+  using value_type = F;
+  static constexpr std::size_t rank = sizeof...(D);
+  static constexpr std::array<std::size_t, rank> extents = {D...};
+  static constexpr std::size_t size = (D * ...);
+  using storage_type = nani::static_array<F, size>;
+
+public:
+  tensor() = default;
+
+  /* \brief Rank-1 tensor with the components of v */
+  constexpr explicit tensor(nani::vector<F, size> const& v) noexcept
+    requires(rank == 1);
+
+  /* \brief Rank-2 tensor with the entries of a */
+  constexpr explicit tensor(nani::matrix<F, extents[0], extents[rank - 1]> const& a) noexcept
+    requires(rank == 2);
+
+  static constexpr auto zero() noexcept -> tensor;
+
+public:
+  constexpr explicit operator nani::vector<F, size>() const noexcept
+    requires(rank == 1);
+
+  constexpr explicit operator nani::matrix<F, extents[0], extents[rank - 1]>() const noexcept
+    requires(rank == 2);
+
+public:
+  template <typename... I>
+    requires(sizeof...(I) == sizeof...(D) and (std::is_convertible_v<I, std::size_t> and ...))
+  constexpr auto operator()(I... i) const noexcept -> F const&;
+
+  template <typename... I>
+    requires(sizeof...(I) == sizeof...(D) and (std::is_convertible_v<I, std::size_t> and ...))
+  constexpr auto operator()(I... i) noexcept -> F&;
+
+  /* \brief The entries, row by row */
+  constexpr auto values() const noexcept -> storage_type const&;
+
+  constexpr auto values() noexcept -> storage_type&;
+
+private:
+  storage_type x_{};
+};
+
+template <typename F, std::size_t... D>
+constexpr auto operator+(tensor<F, D...> const& a, tensor<F, D...> const& b) -> tensor<F, D...>;
+
+template <typename F, std::size_t... D>
+constexpr auto operator-(tensor<F, D...> const& a, tensor<F, D...> const& b) -> tensor<F, D...>;
+
+template <typename F, std::size_t... D>
+constexpr auto operator*(std::type_identity_t<F> s, tensor<F, D...> const& a) -> tensor<F, D...>;
+
+template <typename F, std::size_t... D>
+constexpr auto operator*(tensor<F, D...> const& a, std::type_identity_t<F> s) -> tensor<F, D...>;
+
+namespace detail::tensor {
+/* A contraction in Einstein notation, as a template argument. */
+template <std::size_t N>
+struct expression {
+  std::array<char, N> text;
+
+  consteval expression(char const (&s)[N]) // NOLINT(google-explicit-constructor)
+  {
+    for (std::size_t i = 0; i < N; ++i) {
+      text[i] = s[i];
+    }
+  }
+};
+} // namespace detail::tensor
+
+/* \brief The contraction E of the operands, a tensor, or a scalar if E has no output labels */
+template <detail::tensor::expression E, typename... Operand>
+constexpr auto contract(Operand const&... operand);
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace detail::tensor {
+inline constexpr std::size_t max_rank = 8;
+inline constexpr std::size_t max_operands = 8;
+inline constexpr std::size_t max_labels = 16;
+
+/* Rank, extents and value type of the operands of `contract`. */
+template <typename T>
+struct traits {};
+
+template <typename F, std::size_t... D>
+struct traits<nani::tensor<F, D...>> {
+  using value_type = F;
+  static constexpr std::size_t rank = sizeof...(D);
+  static constexpr std::array<std::size_t, rank> extents = {D...};
+};
+
+template <vector_like V>
+struct traits<V> {
+  using value_type = vector_value_t<V>;
+  static constexpr std::size_t rank = 1;
+  static constexpr std::array<std::size_t, rank> extents = {vector_dim_v<V>};
+};
+
+template <matrix_like M>
+struct traits<M> {
+  using value_type = matrix_value_t<M>;
+  static constexpr std::size_t rank = 2;
+  static constexpr std::array<std::size_t, rank> extents = {matrix_rows_v<M>, matrix_cols_v<M>};
+};
+
+template <typename F, std::size_t... D, typename... I>
+constexpr auto at(nani::tensor<F, D...> const& t, I... i) noexcept -> F
+{
+  return t(i...);
+}
+
+template <vector_like V>
+constexpr auto at(V const& v, std::size_t i) noexcept -> vector_value_t<V>
+{
+  return v[i];
+}
+
+template <matrix_like M>
+constexpr auto at(M const& m, std::size_t i, std::size_t j) noexcept -> matrix_value_t<M>
+{
+  return m[i][j];
+}
+
+/* The loop nest of a contraction: labels are numbered in order of appearance. */
+struct plan {
+  std::size_t noperand = 0;
+  std::size_t nlabel = 0;
+  std::array<char, max_labels> label{};
+  std::array<std::size_t, max_labels> extent{};
+  std::array<std::size_t, max_operands> rank{};
+  // position[k][d] is the label of index d of operand k; operand `noperand` is the result.
+  std::array<std::array<std::size_t, max_rank>, max_operands + 1> position{};
+  // order[0] is the outermost loop.
+  std::array<std::size_t, max_labels> order{};
+  std::size_t points = 1;
+};
+
+constexpr auto is_label(char c) noexcept -> bool
+{
+  return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z');
+}
+
+template <std::size_t N, std::size_t K>
+consteval auto make_plan(
+  expression<N> const& e,
+  std::array<std::size_t, K> const& rank,
+  std::array<std::array<std::size_t, max_rank>, K> const& extent) -> plan
+{
+  static_assert(K <= max_operands, "contract: too many operands");
+  auto p = plan();
+  p.noperand = K;
+
+  auto find = [&](char c) {
+    for (std::size_t l = 0; l < p.nlabel; ++l) {
+      if (p.label[l] == c) {
+        return l;
+      }
+    }
+    if (p.nlabel == max_labels) {
+      throw std::invalid_argument("contract: too many labels");
+    }
+    p.label[p.nlabel] = c;
+    return p.nlabel++;
+  };
+
+  // Operands, up to the arrow or the end.
+  auto k = std::size_t(0);
+  auto d = std::size_t(0);
+  auto i = std::size_t(0);
+  auto output = false;
+  for (; i + 1 < N; ++i) {
+    auto const c = e.text[i];
+    if (c == ' ') {
+      continue;
+    }
+    if (c == '-' and i + 2 < N and e.text[i + 1] == '>') {
+      output = true;
+      i += 2;
+      break;
+    }
+    if (c == ',') {
+      if (d != rank[k]) {
+        throw std::invalid_argument("contract: the labels of an operand do not match its rank");
+      }
+      ++k;
+      d = 0;
+      continue;
+    }
+    if (not is_label(c) or k >= K or d >= rank[k]) {
+      throw std::invalid_argument("contract: the labels do not match the operands");
+    }
+    auto const l = find(c);
+    if (p.extent[l] != 0 and p.extent[l] != extent[k][d]) {
+      throw std::invalid_argument("contract: a label has two different extents");
+    }
+    p.extent[l] = extent[k][d];
+    p.position[k][d++] = l;
+  }
+  if (k + 1 != K or d != rank[k]) {
+    throw std::invalid_argument("contract: the labels do not match the operands");
+  }
+  for (std::size_t o = 0; o < K; ++o) {
+    p.rank[o] = rank[o];
+  }
+
+  // Result: the given labels, or those that appear once, alphabetically.
+  auto nout = std::size_t(0);
+  if (output) {
+    for (; i + 1 < N; ++i) {
+      auto const c = e.text[i];
+      if (c == ' ') {
+        continue;
+      }
+      auto known = false;
+      for (std::size_t l = 0; l < p.nlabel; ++l) {
+        known = known or p.label[l] == c;
+      }
+      if (not is_label(c) or not known or nout == max_rank) {
+        throw std::invalid_argument("contract: an output label is not an operand label");
+      }
+      for (std::size_t o = 0; o < nout; ++o) {
+        if (p.label[p.position[K][o]] == c) {
+          throw std::invalid_argument("contract: an output label is repeated");
+        }
+      }
+      p.position[K][nout++] = find(c);
+    }
+  }
+  else {
+    for (char c = 'A'; c <= 'z'; ++c) {
+      auto count = std::size_t(0);
+      for (std::size_t o = 0; o < K; ++o) {
+        for (std::size_t r = 0; r < rank[o]; ++r) {
+          count += p.label[p.position[o][r]] == c ? 1 : 0;
+        }
+      }
+      if (count == 1) {
+        p.position[K][nout++] = find(c);
+      }
+    }
+  }
+  p.rank[K] = nout;
+
+  // Loop order by decreasing total stride, the output labels first among equals.
+  auto weight = std::array<std::size_t, max_labels>{};
+  for (std::size_t o = 0; o <= K; ++o) {
+    auto stride = std::size_t(1);
+    for (auto r = p.rank[o]; r-- > 0;) {
+      weight[p.position[o][r]] += stride;
+      stride *= p.extent[p.position[o][r]];
+    }
+  }
+  auto n = std::size_t(0);
+  for (std::size_t r = 0; r < nout; ++r) {
+    p.order[n++] = p.position[K][r];
+  }
+  for (std::size_t l = 0; l < p.nlabel; ++l) {
+    auto summed = true;
+    for (std::size_t r = 0; r < nout; ++r) {
+      summed = summed and p.position[K][r] != l;
+    }
+    if (summed) {
+      p.order[n++] = l;
+    }
+  }
+  for (std::size_t a = 1; a < p.nlabel; ++a) {
+    for (auto b = a; b > 0 and weight[p.order[b - 1]] < weight[p.order[b]]; --b) {
+      auto const t = p.order[b - 1];
+      p.order[b - 1] = p.order[b];
+      p.order[b] = t;
+    }
+  }
+
+  for (std::size_t l = 0; l < p.nlabel; ++l) {
+    p.points *= p.extent[l];
+  }
+  return p;
+}
+
+template <std::size_t R>
+constexpr auto padded(std::array<std::size_t, R> const& extents) noexcept
+  -> std::array<std::size_t, max_rank>
+{
+  auto result = std::array<std::size_t, max_rank>{};
+  for (std::size_t r = 0; r < R; ++r) {
+    result[r] = extents[r];
+  }
+  return result;
+}
+
+template <expression E, typename... Operand>
+struct contraction {
+  static constexpr auto p = make_plan(
+    E,
+    std::array<std::size_t, sizeof...(Operand)>{traits<Operand>::rank...},
+    std::array<std::array<std::size_t, max_rank>, sizeof...(Operand)>{
+      padded(traits<Operand>::extents)...});
+
+  using value_type = std::common_type_t<typename traits<Operand>::value_type...>;
+
+  template <std::size_t... R>
+  static constexpr auto result_type(std::index_sequence<R...>)
+  {
+    if constexpr (sizeof...(R) == 0) {
+      return value_type();
+    }
+    else {
+      return nani::tensor<value_type, p.extent[p.position[p.noperand][R]]...>();
+    }
+  }
+
+  using result = decltype(result_type(std::make_index_sequence<p.rank[p.noperand]>()));
+
+  using index_type = std::array<std::size_t, max_labels>;
+
+  /* Entry of operand k, or of the result for k == noperand, at the label indices. */
+  template <std::size_t K, typename T>
+  static constexpr decltype(auto) entry(T& t, index_type const& index) noexcept
+  {
+    return [&]<std::size_t... D>(std::index_sequence<D...>) -> decltype(auto) {
+      if constexpr (K == p.noperand) {
+        if constexpr (sizeof...(D) == 0) {
+          return (t);
+        }
+        else {
+          return t(index[p.position[K][D]]...);
+        }
+      }
+      else {
+        return at(t, index[p.position[K][D]]...);
+      }
+    }(std::make_index_sequence<p.rank[K]>());
+  }
+
+  template <typename Tuple>
+  static constexpr void body(result& c, Tuple const& operand, index_type const& index) noexcept
+  {
+    [&]<std::size_t... K>(std::index_sequence<K...>) {
+      entry<p.noperand>(c, index) += (entry<K>(std::get<K>(operand), index) * ...);
+    }(std::make_index_sequence<p.noperand>());
+  }
+
+  template <std::size_t Depth, typename Tuple>
+  static constexpr void nest(result& c, Tuple const& operand, index_type& index) noexcept
+  {
+    if constexpr (Depth == p.nlabel) {
+      body(c, operand, index);
+    }
+    else {
+      constexpr auto l = p.order[Depth];
+      if constexpr (p.points <= unroll_limit) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          ((index[l] = I, nest<Depth + 1>(c, operand, index)), ...);
+        }(std::make_index_sequence<p.extent[l]>());
+      }
+      else {
+        for (std::size_t i = 0; i < p.extent[l]; ++i) {
+          index[l] = i;
+          nest<Depth + 1>(c, operand, index);
+        }
+      }
+    }
+  }
+};
+
+template <std::size_t... D>
+constexpr auto offset(std::array<std::size_t, sizeof...(D)> const& index) noexcept -> std::size_t
+{
+  constexpr auto extents = std::array<std::size_t, sizeof...(D)>{D...};
+  auto result = std::size_t(0);
+  for (std::size_t r = 0; r < sizeof...(D); ++r) {
+    result = result * extents[r] + index[r];
+  }
+  return result;
+}
+} // namespace detail::tensor
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+constexpr tensor<F, D...>::tensor(nani::vector<F, size> const& v) noexcept
+  requires(rank == 1)
+{
+  for (std::size_t i = 0; i < size; ++i) {
+    x_[i] = v[i];
+  }
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+constexpr tensor<F, D...>::tensor(nani::matrix<F, extents[0], extents[rank - 1]> const& a) noexcept
+  requires(rank == 2)
+{
+  for (std::size_t i = 0; i < extents[0]; ++i) {
+    for (std::size_t j = 0; j < extents[1]; ++j) {
+      x_[i * extents[1] + j] = a[i][j];
+    }
+  }
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+constexpr auto tensor<F, D...>::zero() noexcept -> tensor
+{
+  auto result = tensor();
+  result.x_ = F(0);
+  return result;
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+constexpr tensor<F, D...>::operator nani::vector<F, size>() const noexcept
+  requires(rank == 1)
+{
+  auto result = nani::vector<F, size>();
+  for (std::size_t i = 0; i < size; ++i) {
+    result[i] = x_[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+constexpr tensor<F, D...>::operator nani::matrix<F, extents[0], extents[rank - 1]>() const noexcept
+  requires(rank == 2)
+{
+  auto result = nani::matrix<F, extents[0], extents[1]>();
+  for (std::size_t i = 0; i < extents[0]; ++i) {
+    for (std::size_t j = 0; j < extents[1]; ++j) {
+      result[i][j] = x_[i * extents[1] + j];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+template <typename... I>
+  requires(sizeof...(I) == sizeof...(D) and (std::is_convertible_v<I, std::size_t> and ...))
+constexpr auto tensor<F, D...>::operator()(I... i) const noexcept -> F const&
+{
+  return x_[detail::tensor::offset<D...>({static_cast<std::size_t>(i)...})];
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+template <typename... I>
+  requires(sizeof...(I) == sizeof...(D) and (std::is_convertible_v<I, std::size_t> and ...))
+constexpr auto tensor<F, D...>::operator()(I... i) noexcept -> F&
+{
+  return x_[detail::tensor::offset<D...>({static_cast<std::size_t>(i)...})];
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+constexpr auto tensor<F, D...>::values() const noexcept -> storage_type const&
+{
+  return x_;
+}
+
+template <typename F, std::size_t... D>
+  requires(sizeof...(D) >= 1 and ((D >= 1) and ...))
+constexpr auto tensor<F, D...>::values() noexcept -> storage_type&
+{
+  return x_;
+}
+
+template <typename F, std::size_t... D>
+constexpr auto operator+(tensor<F, D...> const& a, tensor<F, D...> const& b) -> tensor<F, D...>
+{
+  auto result = tensor<F, D...>();
+  for (std::size_t e = 0; e < result.size; ++e) {
+    result.values()[e] = a.values()[e] + b.values()[e];
+  }
+  return result;
+}
+
+template <typename F, std::size_t... D>
+constexpr auto operator-(tensor<F, D...> const& a, tensor<F, D...> const& b) -> tensor<F, D...>
+{
+  auto result = tensor<F, D...>();
+  for (std::size_t e = 0; e < result.size; ++e) {
+    result.values()[e] = a.values()[e] - b.values()[e];
+  }
+  return result;
+}
+
+template <typename F, std::size_t... D>
+constexpr auto operator*(std::type_identity_t<F> s, tensor<F, D...> const& a) -> tensor<F, D...>
+{
+  auto result = a;
+  for (auto& x : result.values()) {
+    x *= s;
+  }
+  return result;
+}
+
+template <typename F, std::size_t... D>
+constexpr auto operator*(tensor<F, D...> const& a, std::type_identity_t<F> s) -> tensor<F, D...>
+{
+  return s * a;
+}
+
+template <detail::tensor::expression E, typename... Operand>
+constexpr auto contract(Operand const&... operand)
+{
+  using contraction = detail::tensor::contraction<E, Operand...>;
+  using result_type = typename contraction::result;
+
+  auto c = result_type();
+  if constexpr (std::is_arithmetic_v<result_type>) {
+    c = result_type(0);
+  }
+  else {
+    c = result_type::zero();
+  }
+  auto index = typename contraction::index_type{};
+  contraction::template nest<0>(c, std::forward_as_tuple(operand...), index);
+  return c;
+}
+} // namespace nani
+
+#endif // NANI_TENSOR_HPP
@@ -0,0 +1,717 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_TEXT_HPP
+#define NANI_TEXT_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <nani/matrix.hpp>
+#include <nani/meta.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/** Text Input and Output
+ *
+ * `to_chars` and `from_chars` format and parse a `vector` or a `matrix` as its components in
+ * order, separated by a single character, with the shortest representation that reads back to
+ * the same value. They neither allocate nor depend on the locale. `max_chars_v<T>` bounds the
+ * length of the text of a T, so that a buffer can be sized once in advance.
+ *
+ * The functions of `nani::text` write and read whole fields with one element per line. Writing
+ * formats chunks of `text::grain` lines in parallel into one preallocated buffer and writes the
+ * chunks to the stream in order. Reading splits the text at line boundaries and parses the pieces
+ * in parallel. On top of these, `write_csv` / `read_csv` handle comma-separated files with a
+ * header line, and `vtk_writer` / `read_vtk` handle the point and cell fields of legacy VTK
+ * unstructured grids.
+ **/
+namespace nani {
+/* \brief Upper bound on the number of characters `to_chars` writes for a T */
+template <typename T>
+inline constexpr std::size_t max_chars_v = 0;
+
+template <typename F>
+  requires std::is_arithmetic_v<F>
+inline constexpr std::size_t max_chars_v<F>
+  = std::is_floating_point_v<F>
+      // sign, digits, point, 'e', exponent sign and exponent digits
+      ? std::size_t(std::numeric_limits<F>::max_digits10) + 4
+          + (std::numeric_limits<F>::max_exponent10 >= 1000  ? 4
+             : std::numeric_limits<F>::max_exponent10 >= 100 ? 3
+                                                             : 2)
+      : std::size_t(std::numeric_limits<F>::digits10) + 2;
+
+template <typename F, std::size_t N>
+inline constexpr std::size_t max_chars_v<nani::vector<F, N>> = N * (max_chars_v<F> + 1) - 1;
+
+template <typename F, std::size_t R, std::size_t C>
+inline constexpr std::size_t max_chars_v<nani::matrix<F, R, C>>
+  = R * C * (max_chars_v<F> + 1) - 1;
+
+/* \brief Components of v, separated by `separator`
+ *
+ * Returns {last, std::errc::value_too_large} if the text does not fit in [first, last).
+ */
+template <typename F, std::size_t N>
+auto to_chars(char* first, char* last, nani::vector<F, N> const& v, char separator = ' ')
+  -> std::to_chars_result;
+
+/* \brief Entries of a row by row, separated by `separator` */
+template <typename F, std::size_t R, std::size_t C>
+auto to_chars(char* first, char* last, nani::matrix<F, R, C> const& a, char separator = ' ')
+  -> std::to_chars_result;
+
+/* \brief Components of v from text written by `to_chars`
+ *
+ * The values may be separated by any number of spaces, tabs and commas. Parsing stops after the
+ * last component; on failure `ptr` points at the value that could not be read.
+ */
+template <typename F, std::size_t N>
+auto from_chars(char const* first, char const* last, nani::vector<F, N>& v)
+  -> std::from_chars_result;
+
+template <typename F, std::size_t R, std::size_t C>
+auto from_chars(char const* first, char const* last, nani::matrix<F, R, C>& a)
+  -> std::from_chars_result;
+} // namespace nani
+
+namespace nani::text {
+/* Number of lines formatted by a thread at once. */
+inline constexpr std::size_t grain = 1024;
+
+/* \brief Writes one element of the field per line */
+template <typename F, std::size_t N>
+void write(std::ostream& out, std::span<nani::vector<F, N> const> field, char separator = ' ');
+
+template <typename F, std::size_t N>
+void write(std::ostream& out, nani::soa_span<F const, N> field, char separator = ' ');
+
+/* \brief Elements written by `write`, one per non-blank line
+ *
+ * Throws std::runtime_error naming the line if a line does not hold exactly N values.
+ */
+template <typename F, std::size_t N>
+auto read(std::string_view text) -> std::vector<nani::vector<F, N>>;
+
+/* \brief Comma-separated values, with a header line naming the columns
+ *
+ * The columns are `name` for a scalar field, and `name_0`, `name_1`, ... otherwise.
+ */
+template <typename F, std::size_t N>
+void write_csv(std::ostream& out, std::string_view name, std::span<nani::vector<F, N> const> field);
+
+template <typename F, std::size_t N>
+void write_csv(std::ostream& out, std::string_view name, nani::soa_span<F const, N> field);
+
+/* \brief Elements of a file written by `write_csv`, skipping its header line */
+template <typename F, std::size_t N>
+auto read_csv(std::string_view text) -> std::vector<nani::vector<F, N>>;
+
+/* Cell types of the VTK file format. */
+enum class vtk_cell : std::uint8_t {
+  vertex = 1,
+  line = 3,
+  triangle = 5,
+  polygon = 7,
+  quad = 9,
+  tetra = 10,
+  hexahedron = 12,
+  wedge = 13,
+  pyramid = 14
+};
+
+/** Legacy VTK Writer
+ *
+ * Writes an ASCII unstructured grid: the constructor writes the mesh, and `cell_field` /
+ * `point_field` append fields. The format stores all the cell fields in one section and all the
+ * point fields in another, so the fields of one kind must be written one after the other.
+ *
+ * Fields with one component are written as SCALARS, with three as VECTORS, and with two or four
+ * as SCALARS with that many components. Names must not contain whitespace.
+ **/
+class vtk_writer {
+public:
+  /* \brief Writes the header, the points and the cells of the mesh
+   *
+   * The vertices of cell c are `point[connectivity[offset[c]]] ...
+   * point[connectivity[offset[c + 1] - 1]]` (compressed row storage), in VTK order. Points with
+   * fewer than three coordinates are padded with zeros.
+   *
+   * PreConditions : offset.size() == type.size() + 1, connectivity[k] < point.size()
+   */
+  template <typename F, std::size_t D, std::integral I>
+    requires(D >= 1 and D <= 3)
+  vtk_writer(
+    std::ostream& out,
+    std::string_view title,
+    std::span<nani::vector<F, D> const> point,
+    std::span<I const> offset,
+    std::span<I const> connectivity,
+    std::span<vtk_cell const> type);
+
+public:
+  template <typename F, std::size_t N>
+    requires(N >= 1 and N <= 4)
+  void point_field(std::string_view name, std::span<nani::vector<F, N> const> field);
+
+  template <typename F, std::size_t N>
+    requires(N >= 1 and N <= 4)
+  void point_field(std::string_view name, nani::soa_span<F const, N> field);
+
+  template <typename F, std::size_t N>
+    requires(N >= 1 and N <= 4)
+  void cell_field(std::string_view name, std::span<nani::vector<F, N> const> field);
+
+  template <typename F, std::size_t N>
+    requires(N >= 1 and N <= 4)
+  void cell_field(std::string_view name, nani::soa_span<F const, N> field);
+
+private:
+  enum class section { mesh, cell, point };
+
+  void header(std::string_view title);
+
+  /* Starts a field of `components` values of `type` in section s, checking its size. */
+  void begin_field(
+    section s,
+    std::string_view name,
+    std::string_view type,
+    std::size_t components,
+    std::size_t size);
+
+  template <typename F, std::size_t N, typename Load>
+  void field(section s, std::string_view name, std::size_t size, Load const& load);
+
+  std::ostream* out_;
+  std::size_t npoint_;
+  std::size_t ncell_;
+  section section_ = section::mesh;
+  bool cell_written_ = false;
+  bool point_written_ = false;
+};
+
+/* \brief The field `name` of a file written by `vtk_writer`, with as many elements as the points
+ * or the cells
+ *
+ * Throws std::runtime_error if the file has no such field or the field has the wrong size.
+ */
+template <typename F, std::size_t N>
+auto read_vtk(std::string_view text, std::string_view name) -> std::vector<nani::vector<F, N>>;
+} // namespace nani::text
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+namespace nani::detail::text {
+/* Characters that may separate the values of one line. */
+constexpr auto is_separator(char c) noexcept -> bool
+{
+  return c == ' ' or c == '\t' or c == '\r' or c == ',';
+}
+
+template <typename F>
+auto write_value(char* first, char* last, F x, bool separate, char separator)
+  -> std::to_chars_result
+{
+  if (separate) {
+    if (first == last) {
+      return {last, std::errc::value_too_large};
+    }
+    *first++ = separator;
+  }
+  return std::to_chars(first, last, x);
+}
+
+/* Reads one value after any separators; a leading '+' is accepted. */
+template <typename F>
+auto read_value(char const* first, char const* last, F& x) -> std::from_chars_result
+{
+  while (first != last and is_separator(*first)) {
+    ++first;
+  }
+  auto const start = first;
+  if (first != last and *first == '+') {
+    ++first;
+  }
+  auto const result = std::from_chars(first, last, x);
+  if (result.ec != std::errc()) {
+    return {start, result.ec};
+  }
+  return result;
+}
+
+/* Writes lines [0, n) to out, line i formatted by format(i, first, last) into at most `line`
+ * characters, newline included. Chunks of `grain` lines are formatted in parallel into one
+ * buffer, reused for every block of chunks, and then written in order.
+ */
+template <typename Format>
+void write_lines(std::ostream& out, std::size_t n, std::size_t line, Format const& format)
+{
+  using nani::text::grain;
+  auto const nchunk = 2 * nani::thread_count();
+  auto buffer = std::vector<char>(nchunk * grain * line);
+  auto used = std::vector<std::size_t>(nchunk);
+  for (std::size_t block = 0; block < n; block += nchunk * grain) {
+    auto const count = std::min(n - block, nchunk * grain);
+    nani::parallel_for(count, grain, [&](std::size_t begin, std::size_t end) {
+      auto const chunk = begin / grain;
+      auto* const start = buffer.data() + chunk * grain * line;
+      auto* p = start;
+      for (std::size_t i = begin; i < end; ++i) {
+        p = format(block + i, p, p + line - 1);
+        *p++ = '\n';
+      }
+      used[chunk] = static_cast<std::size_t>(p - start);
+    });
+    for (std::size_t chunk = 0; chunk * grain < count; ++chunk) {
+      out.write(buffer.data() + chunk * grain * line, static_cast<std::streamsize>(used[chunk]));
+    }
+  }
+}
+
+inline void csv_header(std::ostream& out, std::string_view name, std::size_t n)
+{
+  for (std::size_t c = 0; c < n; ++c) {
+    out << (c == 0 ? "" : ",") << name;
+    if (n > 1) {
+      out << '_' << c;
+    }
+  }
+  out << '\n';
+}
+
+template <typename F, std::size_t N, typename Load>
+void write_field(std::ostream& out, std::size_t n, Load const& load, char separator)
+{
+  constexpr auto line = max_chars_v<nani::vector<F, N>> + 1;
+  write_lines(out, n, line, [&](std::size_t i, char* first, char* last) {
+    return nani::to_chars(first, last, load(i), separator).ptr;
+  });
+}
+
+/* Values of one piece of the text, and the position of its first error if any. */
+template <typename F>
+struct piece {
+  std::vector<F> value;
+  char const* error = nullptr;
+};
+
+/* Parses the values in [first, last). If `per_line`, every non-blank line holds `n` values. */
+template <typename F>
+void parse_piece(char const* first, char const* last, std::size_t n, bool per_line, piece<F>& p)
+{
+  while (first != last) {
+    auto const line = first;
+    auto count = std::size_t(0);
+    while (true) {
+      while (first != last and is_separator(*first)) {
+        ++first;
+      }
+      if (first == last or *first == '\n') {
+        break;
+      }
+      auto x = F();
+      auto const result = read_value(first, last, x);
+      auto const end = result.ptr;
+      if (
+        result.ec != std::errc()
+        or (end != last and not is_separator(*end) and *end != '\n')) {
+        p.error = first;
+        return;
+      }
+      p.value.push_back(x);
+      first = end;
+      ++count;
+    }
+    if (per_line and count != 0 and count != n) {
+      p.error = line;
+      return;
+    }
+    if (first != last) {
+      ++first;
+    }
+  }
+}
+
+[[noreturn]] inline void parse_error(std::string_view text, char const* position)
+{
+  auto const line = std::count(text.data(), position, '\n') + 1;
+  throw std::runtime_error("nani::text: cannot parse line " + std::to_string(line));
+}
+
+/* Values in text, parsed in parallel in pieces cut at line boundaries, and grouped by N. */
+template <typename F, std::size_t N>
+auto parse(std::string_view text, std::string_view whole, bool per_line)
+  -> std::vector<nani::vector<F, N>>
+{
+  constexpr std::size_t piece_bytes = std::size_t(1) << 16;
+  auto const first = text.data();
+  auto const last = text.data() + text.size();
+  auto const npiece
+    = std::clamp<std::size_t>(text.size() / piece_bytes, 1, 4 * nani::thread_count());
+
+  auto bound = std::vector<char const*>(npiece + 1, last);
+  bound[0] = first;
+  for (std::size_t k = 1; k < npiece; ++k) {
+    auto const guess = std::max(first + k * (text.size() / npiece), bound[k - 1]);
+    auto const newline = std::find(guess, last, '\n');
+    bound[k] = newline == last ? last : newline + 1;
+  }
+
+  auto pieces = std::vector<piece<F>>(npiece);
+  nani::parallel_for(npiece, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t k = begin; k < end; ++k) {
+      parse_piece(bound[k], bound[k + 1], N, per_line, pieces[k]);
+    }
+  });
+
+  auto total = std::size_t(0);
+  for (auto const& p : pieces) {
+    if (p.error != nullptr) {
+      parse_error(whole, p.error);
+    }
+    total += p.value.size();
+  }
+  if (total % N != 0) {
+    throw std::runtime_error("nani::text: the number of values is not a multiple of the size");
+  }
+
+  auto result = std::vector<nani::vector<F, N>>(total / N);
+  auto index = std::size_t(0);
+  for (auto const& p : pieces) {
+    for (auto const x : p.value) {
+      result[index / N][index % N] = x;
+      ++index;
+    }
+  }
+  return result;
+}
+
+template <typename F>
+constexpr auto vtk_type() -> std::string_view
+{
+  if constexpr (std::is_same_v<F, float>) {
+    return "float";
+  }
+  else if constexpr (std::is_same_v<F, double>) {
+    return "double";
+  }
+  else if constexpr (std::is_integral_v<F> and sizeof(F) == 4) {
+    return std::is_signed_v<F> ? "int" : "unsigned_int";
+  }
+  else if constexpr (std::is_integral_v<F> and sizeof(F) == 8) {
+    return std::is_signed_v<F> ? "vtktypeint64" : "vtktypeuint64";
+  }
+  else {
+    static_assert(std::is_same_v<F, float>, "vtk_writer: no VTK type for this value type");
+  }
+}
+
+template <typename F, std::size_t N>
+auto aos_loader(std::span<nani::vector<F, N> const> field)
+{
+  return [field](std::size_t i) -> nani::vector<F, N> const& { return field[i]; };
+}
+
+template <typename F, std::size_t N>
+auto soa_loader(nani::soa_span<F const, N> field)
+{
+  return [field](std::size_t i) { return field.load(i); };
+}
+
+/* Line [first, end of line) that starts with `keyword` followed by a space, at the start of a
+ * line, after `from`.
+ */
+inline auto find_line(std::string_view text, std::string_view keyword, std::size_t from = 0)
+  -> std::string_view
+{
+  for (auto at = text.find(keyword, from); at != std::string_view::npos;
+       at = text.find(keyword, at + 1)) {
+    auto const start = at == 0 or text[at - 1] == '\n';
+    auto const end = at + keyword.size();
+    if (start and end < text.size() and text[end] == ' ') {
+      auto const newline = text.find('\n', at);
+      return text.substr(at, newline == std::string_view::npos ? text.size() - at : newline - at);
+    }
+  }
+  return {};
+}
+} // namespace nani::detail::text
+
+namespace nani {
+template <typename F, std::size_t N>
+auto to_chars(char* first, char* last, nani::vector<F, N> const& v, char separator)
+  -> std::to_chars_result
+{
+  auto result = std::to_chars_result{first, std::errc()};
+  for (std::size_t i = 0; i < N and result.ec == std::errc(); ++i) {
+    result = detail::text::write_value(result.ptr, last, v[i], i != 0, separator);
+  }
+  return result;
+}
+
+template <typename F, std::size_t R, std::size_t C>
+auto to_chars(char* first, char* last, nani::matrix<F, R, C> const& a, char separator)
+  -> std::to_chars_result
+{
+  auto result = std::to_chars_result{first, std::errc()};
+  for (std::size_t i = 0; i < R and result.ec == std::errc(); ++i) {
+    for (std::size_t j = 0; j < C and result.ec == std::errc(); ++j) {
+      result = detail::text::write_value(result.ptr, last, a[i][j], i + j != 0, separator);
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+auto from_chars(char const* first, char const* last, nani::vector<F, N>& v)
+  -> std::from_chars_result
+{
+  auto x = v;
+  auto result = std::from_chars_result{first, std::errc()};
+  for (std::size_t i = 0; i < N and result.ec == std::errc(); ++i) {
+    result = detail::text::read_value(result.ptr, last, x[i]);
+  }
+  if (result.ec == std::errc()) {
+    v = x;
+  }
+  return result;
+}
+
+template <typename F, std::size_t R, std::size_t C>
+auto from_chars(char const* first, char const* last, nani::matrix<F, R, C>& a)
+  -> std::from_chars_result
+{
+  auto x = a;
+  auto result = std::from_chars_result{first, std::errc()};
+  for (std::size_t i = 0; i < R and result.ec == std::errc(); ++i) {
+    for (std::size_t j = 0; j < C and result.ec == std::errc(); ++j) {
+      result = detail::text::read_value(result.ptr, last, x[i][j]);
+    }
+  }
+  if (result.ec == std::errc()) {
+    a = x;
+  }
+  return result;
+}
+} // namespace nani
+
+namespace nani::text {
+template <typename F, std::size_t N>
+void write(std::ostream& out, std::span<nani::vector<F, N> const> field, char separator)
+{
+  detail::text::write_field<F, N>(
+    out, field.size(), detail::text::aos_loader(field), separator);
+}
+
+template <typename F, std::size_t N>
+void write(std::ostream& out, nani::soa_span<F const, N> field, char separator)
+{
+  detail::text::write_field<F, N>(
+    out, field.size(), detail::text::soa_loader(field), separator);
+}
+
+template <typename F, std::size_t N>
+auto read(std::string_view text) -> std::vector<nani::vector<F, N>>
+{
+  return detail::text::parse<F, N>(text, text, true);
+}
+
+template <typename F, std::size_t N>
+void write_csv(std::ostream& out, std::string_view name, std::span<nani::vector<F, N> const> field)
+{
+  detail::text::csv_header(out, name, N);
+  write(out, field, ',');
+}
+
+template <typename F, std::size_t N>
+void write_csv(std::ostream& out, std::string_view name, nani::soa_span<F const, N> field)
+{
+  detail::text::csv_header(out, name, N);
+  write(out, field, ',');
+}
+
+template <typename F, std::size_t N>
+auto read_csv(std::string_view text) -> std::vector<nani::vector<F, N>>
+{
+  auto const newline = text.find('\n');
+  if (newline == std::string_view::npos) {
+    return {};
+  }
+  return detail::text::parse<F, N>(text.substr(newline + 1), text, true);
+}
+
+template <typename F, std::size_t D, std::integral I>
+  requires(D >= 1 and D <= 3)
+vtk_writer::vtk_writer(
+  std::ostream& out,
+  std::string_view title,
+  std::span<nani::vector<F, D> const> point,
+  std::span<I const> offset,
+  std::span<I const> connectivity,
+  std::span<vtk_cell const> type)
+: out_(&out), npoint_(point.size()), ncell_(type.size())
+{
+  meta::check_size(ncell_ + 1, offset.size());
+  header(title);
+
+  *out_ << "POINTS " << npoint_ << ' ' << detail::text::vtk_type<F>() << '\n';
+  detail::text::write_field<F, 3>(
+    *out_,
+    npoint_,
+    [&](std::size_t i) {
+      auto x = nani::vector<F, 3>::fill(0);
+      for (std::size_t d = 0; d < D; ++d) {
+        x[d] = point[i][d];
+      }
+      return x;
+    },
+    ' ');
+
+  auto width = std::size_t(0);
+  for (std::size_t c = 0; c < ncell_; ++c) {
+    width = std::max(width, static_cast<std::size_t>(offset[c + 1] - offset[c]));
+  }
+  auto const total = ncell_ + static_cast<std::size_t>(offset[ncell_] - offset[0]);
+  *out_ << "CELLS " << ncell_ << ' ' << total << '\n';
+  detail::text::write_lines(
+    *out_, ncell_, (width + 1) * (max_chars_v<I> + 1), [&](std::size_t c, char* first, char* last) {
+      auto const begin = static_cast<std::size_t>(offset[c]);
+      auto const end = static_cast<std::size_t>(offset[c + 1]);
+      first = std::to_chars(first, last, end - begin).ptr;
+      for (auto k = begin; k < end; ++k) {
+        *first++ = ' ';
+        first = std::to_chars(first, last, connectivity[k]).ptr;
+      }
+      return first;
+    });
+
+  *out_ << "CELL_TYPES " << ncell_ << '\n';
+  detail::text::write_lines(*out_, ncell_, 4, [&](std::size_t c, char* first, char* last) {
+    return std::to_chars(first, last, static_cast<unsigned>(type[c])).ptr;
+  });
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1 and N <= 4)
+void vtk_writer::point_field(std::string_view name, std::span<nani::vector<F, N> const> field)
+{
+  this->field<F, N>(section::point, name, field.size(), detail::text::aos_loader(field));
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1 and N <= 4)
+void vtk_writer::point_field(std::string_view name, nani::soa_span<F const, N> field)
+{
+  this->field<F, N>(section::point, name, field.size(), detail::text::soa_loader(field));
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1 and N <= 4)
+void vtk_writer::cell_field(std::string_view name, std::span<nani::vector<F, N> const> field)
+{
+  this->field<F, N>(section::cell, name, field.size(), detail::text::aos_loader(field));
+}
+
+template <typename F, std::size_t N>
+  requires(N >= 1 and N <= 4)
+void vtk_writer::cell_field(std::string_view name, nani::soa_span<F const, N> field)
+{
+  this->field<F, N>(section::cell, name, field.size(), detail::text::soa_loader(field));
+}
+
+template <typename F, std::size_t N, typename Load>
+void vtk_writer::field(section s, std::string_view name, std::size_t size, Load const& load)
+{
+  begin_field(s, name, detail::text::vtk_type<F>(), N, size);
+  detail::text::write_field<F, N>(*out_, size, load, ' ');
+}
+
+template <typename F, std::size_t N>
+auto read_vtk(std::string_view text, std::string_view name) -> std::vector<nani::vector<F, N>>
+{
+  // The field header, "SCALARS name type N" or "VECTORS name type".
+  auto field = std::string_view();
+  for (auto const keyword : {std::string_view("SCALARS"), std::string_view("VECTORS")}) {
+    for (auto from = std::size_t(0); field.empty();) {
+      auto const line = detail::text::find_line(text, keyword, from);
+      if (line.empty()) {
+        break;
+      }
+      from = static_cast<std::size_t>(line.data() - text.data()) + 1;
+      auto const rest = line.substr(keyword.size() + 1);
+      if (rest.starts_with(name) and rest.size() > name.size() and rest[name.size()] == ' ') {
+        field = line;
+      }
+    }
+  }
+  if (field.empty()) {
+    throw std::runtime_error("nani::text: no VTK field " + std::string(name));
+  }
+  auto const at = static_cast<std::size_t>(field.data() - text.data());
+
+  // Size of the enclosing section: the last POINT_DATA or CELL_DATA before the field.
+  auto size = std::size_t(0);
+  auto section = std::size_t(0);
+  for (auto const keyword : {std::string_view("POINT_DATA"), std::string_view("CELL_DATA")}) {
+    for (auto from = std::size_t(0);;) {
+      auto const line = detail::text::find_line(text, keyword, from);
+      if (line.empty()) {
+        break;
+      }
+      // Only a line found in text points into it.
+      auto const position = static_cast<std::size_t>(line.data() - text.data());
+      if (position > at) {
+        break;
+      }
+      if (position >= section) {
+        section = position;
+        auto const digits = line.substr(keyword.size() + 1);
+        std::from_chars(digits.data(), digits.data() + digits.size(), size);
+      }
+      from = position + 1;
+    }
+  }
+
+  // The values, after the LOOKUP_TABLE line of scalars, up to the next upper-case keyword.
+  auto begin = at + field.size() + 1;
+  if (text.substr(std::min(begin, text.size())).starts_with("LOOKUP_TABLE")) {
+    begin = text.find('\n', begin);
+    begin = begin == std::string_view::npos ? text.size() : begin + 1;
+  }
+  begin = std::min(begin, text.size());
+  auto end = begin;
+  while (end < text.size()) {
+    if (text[end] >= 'A' and text[end] <= 'Z') {
+      break;
+    }
+    auto const newline = text.find('\n', end);
+    end = newline == std::string_view::npos ? text.size() : newline + 1;
+  }
+
+  auto result = detail::text::parse<F, N>(text.substr(begin, end - begin), text, false);
+  if (result.size() != size) {
+    throw std::runtime_error(
+      "nani::text: the VTK field " + std::string(name) + " has the wrong size");
+  }
+  return result;
+}
+} // namespace nani::text
+
+#endif // NANI_TEXT_HPP
@@ -0,0 +1,212 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_TILED_HPP
+#define NANI_TILED_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <nani/aligned_allocator.hpp>
+#include <nani/meta.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <vector>
+
+namespace nani {
+/** Tiled Field
+ *
+ * Array-of-structures-of-arrays storage for a field of `vector<F, N>`. Cells are grouped in tiles
+ * of W, and a tile stores its N components one after the other, each as W contiguous lanes. A tile
+ * is therefore exactly a `vector<pack<F, W>, N>`: iterating over `tiles()` and copying a tile
+ * loads all components of W cells into SIMD registers, and a point-wise kernel written for
+ * `vector<F, N>` runs unchanged on a whole tile.
+ *
+ * W defaults to the SIMD width of the target. The last tile is padded with zero-valued cells,
+ * which kernels may process like any other and which are never copied out.
+ **/
+template <typename F, std::size_t N, std::size_t W = simd_width_v<F>>
+class tiled_field {
+public:
+  using value_type = F;
+  using vector_type = nani::vector<F, N>;
+  using pack_type = nani::pack<F, W>;
+  using tile_type = nani::vector<pack_type, N>;
+  using size_type = std::size_t;
+  static constexpr std::size_t dim = N;
+  static constexpr std::size_t width = W;
+
+public:
+  tiled_field() = default;
+
+  explicit tiled_field(size_type size);
+
+  explicit tiled_field(std::span<vector_type const> aos);
+
+  explicit tiled_field(soa_span<F const, N> soa);
+
+public:
+  auto size() const noexcept -> size_type;
+
+  auto ntile() const noexcept -> size_type;
+
+  auto tiles() noexcept -> std::span<tile_type>;
+
+  auto tiles() const noexcept -> std::span<tile_type const>;
+
+public:
+  auto load(size_type i) const noexcept -> vector_type;
+
+  void store(size_type i, vector_type const& v) noexcept;
+
+  /* \brief Copy the field to an array of structures of the same size */
+  void copy_to(std::span<vector_type> aos) const;
+
+  /* \brief Copy the field to a structure of arrays of the same size */
+  void copy_to(soa_span<F, N> soa) const;
+
+private:
+  static constexpr std::size_t alignment_ = std::max<std::size_t>(64, alignof(tile_type));
+  static constexpr std::size_t grain_ = 1024;
+
+  size_type size_ = 0;
+  std::vector<tile_type, nani::aligned_allocator<tile_type, alignment_>> tile_;
+};
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename F, std::size_t N, std::size_t W>
+tiled_field<F, N, W>::tiled_field(size_type size) : size_(size), tile_((size + W - 1) / W)
+{
+}
+
+template <typename F, std::size_t N, std::size_t W>
+tiled_field<F, N, W>::tiled_field(std::span<vector_type const> aos) : tiled_field(aos.size())
+{
+  nani::parallel_for(ntile(), grain_, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t t = begin; t < end; ++t) {
+      auto const count = std::min(W, size_ - t * W);
+      auto& tile = tile_[t];
+      for (std::size_t l = 0; l < count; ++l) {
+        auto const& v = aos[t * W + l];
+        for (std::size_t c = 0; c < N; ++c) {
+          tile[c].set(l, v[c]);
+        }
+      }
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::size_t W>
+tiled_field<F, N, W>::tiled_field(soa_span<F const, N> soa) : tiled_field(soa.size())
+{
+  nani::parallel_for(ntile(), grain_, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t t = begin; t < end; ++t) {
+      auto const count = std::min(W, size_ - t * W);
+      auto& tile = tile_[t];
+      for (std::size_t c = 0; c < N; ++c) {
+        auto const* data = soa.data(c) + t * W;
+        if (count == W) {
+          tile[c] = pack_type::load(data);
+          continue;
+        }
+        for (std::size_t l = 0; l < count; ++l) {
+          tile[c].set(l, data[l]);
+        }
+      }
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::size_t W>
+auto tiled_field<F, N, W>::size() const noexcept -> size_type
+{
+  return size_;
+}
+
+template <typename F, std::size_t N, std::size_t W>
+auto tiled_field<F, N, W>::ntile() const noexcept -> size_type
+{
+  return tile_.size();
+}
+
+template <typename F, std::size_t N, std::size_t W>
+auto tiled_field<F, N, W>::tiles() noexcept -> std::span<tile_type>
+{
+  return std::span<tile_type>(tile_);
+}
+
+template <typename F, std::size_t N, std::size_t W>
+auto tiled_field<F, N, W>::tiles() const noexcept -> std::span<tile_type const>
+{
+  return std::span<tile_type const>(tile_);
+}
+
+template <typename F, std::size_t N, std::size_t W>
+auto tiled_field<F, N, W>::load(size_type i) const noexcept -> vector_type
+{
+  auto const& tile = tile_[i / W];
+  auto result = vector_type();
+  for (std::size_t c = 0; c < N; ++c) {
+    result[c] = tile[c][i % W];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N, std::size_t W>
+void tiled_field<F, N, W>::store(size_type i, vector_type const& v) noexcept
+{
+  auto& tile = tile_[i / W];
+  for (std::size_t c = 0; c < N; ++c) {
+    tile[c].set(i % W, v[c]);
+  }
+}
+
+template <typename F, std::size_t N, std::size_t W>
+void tiled_field<F, N, W>::copy_to(std::span<vector_type> aos) const
+{
+  meta::check_size(size_, aos.size());
+  nani::parallel_for(ntile(), grain_, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t t = begin; t < end; ++t) {
+      auto const count = std::min(W, size_ - t * W);
+      auto const& tile = tile_[t];
+      for (std::size_t l = 0; l < count; ++l) {
+        auto& v = aos[t * W + l];
+        for (std::size_t c = 0; c < N; ++c) {
+          v[c] = tile[c][l];
+        }
+      }
+    }
+  });
+}
+
+template <typename F, std::size_t N, std::size_t W>
+void tiled_field<F, N, W>::copy_to(soa_span<F, N> soa) const
+{
+  meta::check_size(size_, soa.size());
+  nani::parallel_for(ntile(), grain_, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t t = begin; t < end; ++t) {
+      auto const count = std::min(W, size_ - t * W);
+      auto const& tile = tile_[t];
+      for (std::size_t c = 0; c < N; ++c) {
+        auto* data = soa.data(c) + t * W;
+        if (count == W) {
+          tile[c].store(data);
+          continue;
+        }
+        for (std::size_t l = 0; l < count; ++l) {
+          data[l] = tile[c][l];
+        }
+      }
+    }
+  });
+}
+} // namespace nani
+
+#endif // NANI_TILED_HPP
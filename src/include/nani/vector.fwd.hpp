@@ -7,9 +7,51 @@
 #define NANI_VECTOR_FWD_HPP
 
 #include <cstddef>
+#include <type_traits>
 
 namespace nani {
 template <typename F, std::size_t N>
 class vector;
+
+template <typename F, std::size_t N>
+class vector_view;
+
+/** Vector Traits
+ *
+ * Opt-in description of the types that the free vector operators accept: the owning `vector` and
+ * the non-owning `vector_view`. Specializations provide `value_type` and `dim`.
+ **/
+template <typename T>
+struct vector_traits {};
+
+template <typename F, std::size_t N>
+struct vector_traits<vector<F, N>> {
+  using value_type = F;
+  static constexpr std::size_t dim = N;
+};
+
+template <typename F, std::size_t N>
+struct vector_traits<vector_view<F, N>> {
+  using value_type = std::remove_cv_t<F>;
+  static constexpr std::size_t dim = N;
+};
+
+template <typename T>
+concept vector_like = requires { typename vector_traits<std::remove_cvref_t<T>>::value_type; };
+
+template <vector_like T>
+using vector_value_t = typename vector_traits<std::remove_cvref_t<T>>::value_type;
+
+template <vector_like T>
+inline constexpr std::size_t vector_dim_v = vector_traits<std::remove_cvref_t<T>>::dim;
+
+/* Owning vector type with the shape of T, the result type of the free operators. */
+template <vector_like T>
+using vector_of = vector<vector_value_t<T>, vector_dim_v<T>>;
+
+template <typename A, typename B>
+concept same_vector_shape = vector_like<A> and vector_like<B>
+                            and std::is_same_v<vector_value_t<A>, vector_value_t<B>>
+                            and vector_dim_v<A> == vector_dim_v<B>;
 } // namespace nani
 #endif // NANI_VECTOR_FWD_HPP
@@ -74,8 +74,8 @@ public:
   constexpr auto size() const noexcept -> size_type;
 
 public:
-  auto operator-=(vector const& other) noexcept -> vector&;
-  auto operator+=(vector const& other) noexcept -> vector&;
+  constexpr auto operator-=(vector const& other) noexcept -> vector&;
+  constexpr auto operator+=(vector const& other) noexcept -> vector&;
 
 private:
   nani::static_array<value_type, dim> x_{};
@@ -90,53 +90,85 @@ constexpr vector<T, N>::vector(U... u)
 {
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator==(vector<F, N> const& a, vector<F, N> const& b) noexcept -> bool;
-
-template <typename F, std::size_t N>
-
-constexpr auto operator!=(vector<F, N> const& a, vector<F, N> const& b) noexcept -> bool;
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator==(A const& a, B const& b) noexcept -> bool;
 
-template <typename F, std::size_t N>
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator!=(A const& a, B const& b) noexcept -> bool;
 
-constexpr auto operator+(vector<F, N> const& a, vector<F, N> const& b) noexcept -> vector<F, N>;
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator+(A const& a, B const& b) noexcept -> vector_of<A>;
 
-template <typename F, std::size_t N>
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator-(A const& a, B const& b) noexcept -> vector_of<A>;
 
-constexpr auto operator-(vector<F, N> const& a, vector<F, N> const& b) noexcept -> vector<F, N>;
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator*(A const& a, B const& b) noexcept -> vector_value_t<A>;
 
-template <typename F, std::size_t N>
+template <vector_like A>
+constexpr auto operator*(A const& a, vector_value_t<A> b) noexcept -> vector_of<A>;
 
-constexpr auto operator*(vector<F, N> const& a, vector<F, N> const& b) noexcept -> F;
-
-template <typename F, std::size_t N>
+template <vector_like B>
+constexpr auto operator*(vector_value_t<B> a, B const& b) noexcept -> vector_of<B>;
 
-constexpr auto operator*(vector<F, N> const& a, F b) noexcept -> vector<F, N>;
+template <vector_like A>
+constexpr auto operator/(A const& a, vector_value_t<A> b) noexcept -> vector_of<A>;
 
-template <typename F, std::size_t N>
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B> and (vector_dim_v<A> == 2)
+constexpr auto operator^(A const& a, B const& b) noexcept -> vector_value_t<A>;
 
-constexpr auto operator*(F a, vector<F, N> const& b) noexcept -> vector<F, N>;
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B> and (vector_dim_v<A> == 3)
+constexpr auto operator^(A const& a, B const& b) noexcept -> vector_of<A>;
 
-template <typename F, std::size_t N>
+/* \brief Scalar triple product a . (b ^ c)
+ *
+ * Six times the signed volume of the tetrahedron spanned by a, b and c.
+ */
+template <vector_like A, vector_like B, vector_like C>
+  requires same_vector_shape<A, B> and same_vector_shape<A, C> and (vector_dim_v<A> == 3)
+constexpr auto triple(A const& a, B const& b, C const& c) noexcept -> vector_value_t<A>;
 
-constexpr auto operator/(vector<F, N> const& a, F b) noexcept -> vector<F, N>;
+template <vector_like A>
+constexpr auto normalize(A const& a) noexcept -> vector_of<A>;
 
-template <typename F>
+template <vector_like A>
+constexpr auto l2_norm(A const& a) noexcept -> vector_value_t<A>;
 
-constexpr auto operator^(vector<F, 2> const& a, vector<F, 2> const& b) noexcept -> F;
+template <vector_like A>
+  requires(vector_dim_v<A> == 2)
+constexpr auto normal(A const& a) noexcept -> vector_of<A>;
 
-template <typename F, std::size_t N>
+/* \brief Component-wise |a|
+ *
+ * The component-wise functions apply the scalar ones of `smath.hpp` (or of `pack.hpp`, for a
+ * vector of packs) to every component, without branches. Comparisons and `select` are in
+ * `mask.hpp`.
+ */
+template <vector_like A>
+constexpr auto abs(A const& a) noexcept -> vector_of<A>;
 
-constexpr auto normalize(vector<F, N> const& a) noexcept -> vector<F, N>;
+/* \brief Component-wise -1, 0 or 1 */
+template <vector_like A>
+constexpr auto sign(A const& a) noexcept -> vector_of<A>;
 
-template <typename F, std::size_t N>
+template <vector_like A>
+constexpr auto min(A const& a, A const& b) noexcept -> vector_of<A>;
 
-constexpr auto l2_norm(vector<F, N> const& a) noexcept -> F;
+template <vector_like A>
+constexpr auto max(A const& a, A const& b) noexcept -> vector_of<A>;
 
-template <typename F>
+/* \brief Component-wise product */
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto hadamard(A const& a, B const& b) noexcept -> vector_of<A>;
 
-constexpr auto normal(vector<F, 2> const& a) noexcept -> vector<F, 2>;
 //------------------------------------------------------------------------------
 // Implementation
 //------------------------------------------------------------------------------
@@ -242,7 +274,7 @@ constexpr auto vector<F, N>::size() const noexcept -> size_type
 
 template <typename F, std::size_t N>
 
-auto vector<F, N>::operator-=(vector const& other) noexcept -> vector&
+constexpr auto vector<F, N>::operator-=(vector const& other) noexcept -> vector&
 {
   for (std::size_t i = 0; i < N; ++i) {
     x_[i] -= other[i];
@@ -252,7 +284,7 @@ auto vector<F, N>::operator-=(vector const& other) noexcept -> vector&
 
 template <typename F, std::size_t N>
 
-auto vector<F, N>::operator+=(vector const& other) noexcept -> vector&
+constexpr auto vector<F, N>::operator+=(vector const& other) noexcept -> vector&
 {
   for (std::size_t i = 0; i < N; ++i) {
     x_[i] += other[i];
@@ -260,131 +292,200 @@ auto vector<F, N>::operator+=(vector const& other) noexcept -> vector&
   return *this;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator==(vector<F, N> const& a, vector<F, N> const& b) noexcept -> bool
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator==(A const& a, B const& b) noexcept -> bool
 {
-  for (std::size_t i = 0; i < N; ++i) {
-    if (nani::abs(a[i] - b[i]) > 0) {
-      return false;
-    }
+  // No early exit: the comparison of all components vectorizes.
+  auto equal = true;
+  for (std::size_t i = 0; i < vector_dim_v<A>; ++i) {
+    equal &= (a[i] == b[i]);
   }
-  return true;
+  return equal;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator!=(vector<F, N> const& a, vector<F, N> const& b) noexcept -> bool
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator!=(A const& a, B const& b) noexcept -> bool
 {
   return (not(a == b));
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator+(vector<F, N> const& a, vector<F, N> const& b) noexcept -> vector<F, N>
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator+(A const& a, B const& b) noexcept -> vector_of<A>
 {
-  using type = vector<F, N>;
+  using type = vector_of<A>;
   auto result = type();
-  for (std::size_t i = 0; i < N; ++i) {
+  for (std::size_t i = 0; i < type::dim; ++i) {
     result[i] = a[i] + b[i];
   }
   return result;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator-(vector<F, N> const& a, vector<F, N> const& b) noexcept -> vector<F, N>
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator-(A const& a, B const& b) noexcept -> vector_of<A>
 {
-  using type = vector<F, N>;
+  using type = vector_of<A>;
   auto result = type();
-  for (std::size_t i = 0; i < N; ++i) {
+  for (std::size_t i = 0; i < type::dim; ++i) {
     result[i] = a[i] - b[i];
   }
   return result;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator*(vector<F, N> const& a, vector<F, N> const& b) noexcept -> F
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto operator*(A const& a, B const& b) noexcept -> vector_value_t<A>
 {
-  F result = 0;
-  for (std::size_t i = 0; i < N; ++i) {
+  vector_value_t<A> result = 0;
+  for (std::size_t i = 0; i < vector_dim_v<A>; ++i) {
     result += a[i] * b[i];
   }
   return result;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator*(vector<F, N> const& a, F b) noexcept -> vector<F, N>
+template <vector_like A>
+constexpr auto operator*(A const& a, vector_value_t<A> b) noexcept -> vector_of<A>
 {
-  using type = vector<F, N>;
+  using type = vector_of<A>;
   auto result = type();
-  for (std::size_t i = 0; i < N; ++i) {
+  for (std::size_t i = 0; i < type::dim; ++i) {
     result[i] = a[i] * b;
   }
   return result;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator*(F a, vector<F, N> const& b) noexcept -> vector<F, N>
+template <vector_like B>
+constexpr auto operator*(vector_value_t<B> a, B const& b) noexcept -> vector_of<B>
 {
-  using type = vector<F, N>;
+  using type = vector_of<B>;
   auto result = type();
-  for (std::size_t i = 0; i < N; ++i) {
+  for (std::size_t i = 0; i < type::dim; ++i) {
     result[i] = b[i] * a;
   }
   return result;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto operator/(vector<F, N> const& a, F b) noexcept -> vector<F, N>
+template <vector_like A>
+constexpr auto operator/(A const& a, vector_value_t<A> b) noexcept -> vector_of<A>
 {
-  using type = vector<F, N>;
+  using type = vector_of<A>;
   auto result = type();
-  for (std::size_t i = 0; i < N; ++i) {
+  for (std::size_t i = 0; i < type::dim; ++i) {
     result[i] = a[i] / b;
   }
   return result;
 }
 
-template <typename F, std::size_t N>
-
-constexpr auto l2_norm(vector<F, N> const& a) noexcept -> F
+template <vector_like A>
+constexpr auto l2_norm(A const& a) noexcept -> vector_value_t<A>
 {
-  F norm = 0.0;
-  for (std::size_t i = 0; i < N; ++i) {
+  vector_value_t<A> norm = 0.0;
+  for (std::size_t i = 0; i < vector_dim_v<A>; ++i) {
     norm += a[i] * a[i];
   }
   return nani::sqrt(norm);
 }
 
-template <typename F>
-
-constexpr auto operator^(vector<F, 2> const& a, vector<F, 2> const& b) noexcept -> F
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B> and (vector_dim_v<A> == 2)
+constexpr auto operator^(A const& a, B const& b) noexcept -> vector_value_t<A>
 {
   return a[0] * b[1] - a[1] * b[0];
 }
 
-template <typename F, std::size_t N>
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B> and (vector_dim_v<A> == 3)
+constexpr auto operator^(A const& a, B const& b) noexcept -> vector_of<A>
+{
+  return vector_of<A>(
+    a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]);
+}
 
-constexpr auto normalize(vector<F, N> const& a) noexcept -> vector<F, N>
+template <vector_like A, vector_like B, vector_like C>
+  requires same_vector_shape<A, B> and same_vector_shape<A, C> and (vector_dim_v<A> == 3)
+constexpr auto triple(A const& a, B const& b, C const& c) noexcept -> vector_value_t<A>
 {
-  auto result = a;
+  return a[0] * (b[1] * c[2] - b[2] * c[1]) + a[1] * (b[2] * c[0] - b[0] * c[2])
+         + a[2] * (b[0] * c[1] - b[1] * c[0]);
+}
+
+template <vector_like A>
+constexpr auto normalize(A const& a) noexcept -> vector_of<A>
+{
+  using type = vector_of<A>;
+  auto result = type();
   auto const norm = l2_norm(a);
-  for (std::size_t i = 0; i < N; ++i) {
-    result[i] /= norm;
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = a[i] / norm;
   }
   return result;
 }
 
-template <typename F>
+template <vector_like A>
+  requires(vector_dim_v<A> == 2)
+constexpr auto normal(A const& a) noexcept -> vector_of<A>
+{
+  using F = vector_value_t<A>;
+  return vector_of<A>::create(nani::static_array<F, 2>(-a[1], a[0]));
+}
+
+template <vector_like A>
+constexpr auto abs(A const& a) noexcept -> vector_of<A>
+{
+  using type = vector_of<A>;
+  auto result = type();
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = nani::abs(a[i]);
+  }
+  return result;
+}
 
-constexpr auto normal(vector<F, 2> const& a) noexcept -> vector<F, 2>
+template <vector_like A>
+constexpr auto sign(A const& a) noexcept -> vector_of<A>
 {
-  return vector<F, 2>::create(nani::static_array<F, 2>(-a[1], a[0]));
+  using type = vector_of<A>;
+  auto result = type();
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = nani::sign(a[i]);
+  }
+  return result;
+}
+
+template <vector_like A>
+constexpr auto min(A const& a, A const& b) noexcept -> vector_of<A>
+{
+  using type = vector_of<A>;
+  auto result = type();
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = nani::min(a[i], b[i]);
+  }
+  return result;
+}
+
+template <vector_like A>
+constexpr auto max(A const& a, A const& b) noexcept -> vector_of<A>
+{
+  using type = vector_of<A>;
+  auto result = type();
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = nani::max(a[i], b[i]);
+  }
+  return result;
+}
+
+template <vector_like A, vector_like B>
+  requires same_vector_shape<A, B>
+constexpr auto hadamard(A const& a, B const& b) noexcept -> vector_of<A>
+{
+  using type = vector_of<A>;
+  auto result = type();
+  for (std::size_t i = 0; i < type::dim; ++i) {
+    result[i] = a[i] * b[i];
+  }
+  return result;
 }
 } // namespace nani
 
@@ -0,0 +1,452 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef NANI_VIEW_HPP
+#define NANI_VIEW_HPP
+
+#include <cstddef>
+#include <memory>
+#include <nani/matrix.fwd.hpp>
+#include <nani/matrix.hpp>
+#include <nani/vector.fwd.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <type_traits>
+#include <version>
+
+#if defined(__cpp_lib_mdspan)
+#include <mdspan>
+#endif
+
+namespace nani {
+/** Vector View
+ *
+ * Non-owning, strided view of N values of type F that live elsewhere: in a solver array, an MPI
+ * buffer or a mapped file. Element `i` is `data[i * stride]`. The view is accepted by every free
+ * operator that accepts a `vector`; results of those operators are owning vectors.
+ *
+ * Like `std::span`, copying a view copies the reference, not the values. Writing through a view
+ * goes through `assign`, `+=` and `-=`. `F` may be const-qualified for read-only views.
+ **/
+template <typename F, std::size_t N>
+class vector_view {
+public:
+  using element_type = F;
+  using value_type = std::remove_cv_t<F>;
+  static constexpr std::size_t dim = N;
+
+public:
+  using size_type = std::size_t;
+  using reference = element_type&;
+  using pointer = element_type*;
+
+public:
+  constexpr explicit vector_view(pointer data, std::ptrdiff_t stride = 1) noexcept;
+
+  constexpr vector_view(vector<value_type, N>& v) noexcept;
+
+  constexpr vector_view(vector<value_type, N> const& v) noexcept
+    requires(std::is_const_v<F>);
+
+  template <typename G>
+  constexpr vector_view(vector_view<G, N> const& other) noexcept
+    requires(std::is_convertible_v<G (*)[], F (*)[]> and not std::is_same_v<G, F>);
+
+public:
+  constexpr operator vector<value_type, N>() const noexcept;
+
+public:
+  constexpr auto operator[](std::size_t i) const noexcept -> reference;
+
+  constexpr auto size() const noexcept -> size_type;
+
+  constexpr auto data() const noexcept -> pointer;
+
+  constexpr auto stride() const noexcept -> std::ptrdiff_t;
+
+public:
+  template <vector_like B>
+    requires same_vector_shape<vector_view, B>
+  constexpr auto assign(B const& other) const noexcept -> vector_view const&
+    requires(not std::is_const_v<F>);
+
+  template <vector_like B>
+    requires same_vector_shape<vector_view, B>
+  constexpr auto operator+=(B const& other) const noexcept -> vector_view const&
+    requires(not std::is_const_v<F>);
+
+  template <vector_like B>
+    requires same_vector_shape<vector_view, B>
+  constexpr auto operator-=(B const& other) const noexcept -> vector_view const&
+    requires(not std::is_const_v<F>);
+
+private:
+  pointer data_;
+  std::ptrdiff_t stride_;
+};
+
+/** Matrix View
+ *
+ * Non-owning, strided R x C view; entry (i, j) is `data[i * row_stride + j * col_stride]`, and
+ * row `i` is a `vector_view`, so `a[i][j]` works as it does for `matrix`.
+ **/
+template <typename F, std::size_t R, std::size_t C>
+class matrix_view {
+public:
+  using element_type = F;
+  using value_type = std::remove_cv_t<F>;
+  using row_type = vector_view<F, C>;
+  using pointer = element_type*;
+
+public:
+  constexpr matrix_view(
+    pointer data, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride) noexcept;
+
+  constexpr matrix_view(matrix<value_type, R, C>& m) noexcept;
+
+  constexpr matrix_view(matrix<value_type, R, C> const& m) noexcept
+    requires(std::is_const_v<F>);
+
+public:
+  constexpr operator matrix<value_type, R, C>() const noexcept;
+
+public:
+  constexpr auto operator[](std::size_t i) const noexcept -> row_type;
+
+  constexpr auto data() const noexcept -> pointer;
+
+  constexpr auto row_stride() const noexcept -> std::ptrdiff_t;
+
+  constexpr auto col_stride() const noexcept -> std::ptrdiff_t;
+
+  /* \brief The transpose, as a view of the same values */
+  constexpr auto transposed() const noexcept -> matrix_view<F, C, R>;
+
+public:
+  template <matrix_like B>
+    requires same_matrix_shape<matrix_view, B>
+  constexpr auto assign(B const& other) const noexcept -> matrix_view const&
+    requires(not std::is_const_v<F>);
+
+private:
+  pointer data_;
+  std::ptrdiff_t row_stride_;
+  std::ptrdiff_t col_stride_;
+};
+
+/* \brief View of element `i` of an array of structures */
+template <typename F, std::size_t N>
+constexpr auto view(std::span<vector<F, N>> field, std::size_t i) noexcept -> vector_view<F, N>;
+
+template <typename F, std::size_t N>
+constexpr auto view(std::span<vector<F, N> const> field, std::size_t i) noexcept
+  -> vector_view<F const, N>;
+
+/** Aligned Accessor
+ *
+ * `std::mdspan` accessor policy that promises `Alignment` for the data handle, so that the
+ * compiler can use aligned loads. Offsetting loses the promise, hence `std::default_accessor` as
+ * the offset policy, to which the accessor converts.
+ **/
+template <typename F, std::size_t Alignment>
+struct aligned_accessor;
+
+/** Restrict Accessor
+ *
+ * `std::mdspan` accessor policy whose data handle is a `__restrict` pointer, so that kernels may
+ * assume the viewed field does not alias any other.
+ **/
+template <typename F>
+struct restrict_accessor {
+  using offset_policy = restrict_accessor;
+  using element_type = F;
+  using reference = F&;
+  using data_handle_type = F* __restrict;
+
+  constexpr auto access(data_handle_type p, std::size_t i) const noexcept -> reference
+  {
+    return p[i];
+  }
+
+  constexpr auto offset(data_handle_type p, std::size_t i) const noexcept -> F*
+  {
+    return p + i;
+  }
+};
+
+template <typename F, std::size_t Alignment>
+struct aligned_accessor {
+#if defined(__cpp_lib_mdspan)
+  using offset_policy = std::default_accessor<F>;
+#endif
+  using element_type = F;
+  using reference = F&;
+  using data_handle_type = F*;
+
+  constexpr auto access(data_handle_type p, std::size_t i) const noexcept -> reference
+  {
+    return std::assume_aligned<Alignment>(p)[i];
+  }
+
+  constexpr auto offset(data_handle_type p, std::size_t i) const noexcept -> F*
+  {
+    return p + i;
+  }
+
+#if defined(__cpp_lib_mdspan)
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  constexpr operator std::default_accessor<F>() const noexcept
+  {
+    return std::default_accessor<F>();
+  }
+#endif
+};
+
+#if defined(__cpp_lib_mdspan)
+/* \brief An array of structures as a (cells x N) `std::mdspan` */
+template <typename F, std::size_t N>
+auto to_mdspan(std::span<vector<F, N>> field) noexcept
+  -> std::mdspan<F, std::extents<std::size_t, std::dynamic_extent, N>>;
+
+/* \brief View of a rank-1 `std::mdspan` with static extent N */
+template <typename F, typename E, typename L, typename A>
+  requires(E::rank() == 1 and E::static_extent(0) != std::dynamic_extent)
+auto view(std::mdspan<F, E, L, A> const& m) noexcept -> vector_view<F, E::static_extent(0)>;
+
+/* \brief View of a rank-2 `std::mdspan` with static extents R x C */
+template <typename F, typename E, typename L, typename A>
+  requires(
+    E::rank() == 2 and E::static_extent(0) != std::dynamic_extent
+    and E::static_extent(1) != std::dynamic_extent)
+auto view(std::mdspan<F, E, L, A> const& m) noexcept
+  -> matrix_view<F, E::static_extent(0), E::static_extent(1)>;
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// Implementation
+// -------------------------------------------------------------------------------------------------
+
+template <typename F, std::size_t N>
+constexpr vector_view<F, N>::vector_view(pointer data, std::ptrdiff_t stride) noexcept
+: data_(data), stride_(stride)
+{
+}
+
+template <typename F, std::size_t N>
+constexpr vector_view<F, N>::vector_view(vector<value_type, N>& v) noexcept
+: data_(&v[0]), stride_(1)
+{
+}
+
+template <typename F, std::size_t N>
+constexpr vector_view<F, N>::vector_view(vector<value_type, N> const& v) noexcept
+  requires(std::is_const_v<F>)
+: data_(&v[0]), stride_(1)
+{
+}
+
+template <typename F, std::size_t N>
+template <typename G>
+constexpr vector_view<F, N>::vector_view(vector_view<G, N> const& other) noexcept
+  requires(std::is_convertible_v<G (*)[], F (*)[]> and not std::is_same_v<G, F>)
+: data_(other.data()), stride_(other.stride())
+{
+}
+
+template <typename F, std::size_t N>
+constexpr vector_view<F, N>::operator vector<value_type, N>() const noexcept
+{
+  auto result = vector<value_type, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    result[i] = (*this)[i];
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+constexpr auto vector_view<F, N>::operator[](std::size_t i) const noexcept -> reference
+{
+  return data_[static_cast<std::ptrdiff_t>(i) * stride_];
+}
+
+template <typename F, std::size_t N>
+constexpr auto vector_view<F, N>::size() const noexcept -> size_type
+{
+  return dim;
+}
+
+template <typename F, std::size_t N>
+constexpr auto vector_view<F, N>::data() const noexcept -> pointer
+{
+  return data_;
+}
+
+template <typename F, std::size_t N>
+constexpr auto vector_view<F, N>::stride() const noexcept -> std::ptrdiff_t
+{
+  return stride_;
+}
+
+template <typename F, std::size_t N>
+template <vector_like B>
+  requires same_vector_shape<vector_view<F, N>, B>
+constexpr auto vector_view<F, N>::assign(B const& other) const noexcept -> vector_view const&
+  requires(not std::is_const_v<F>)
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    (*this)[i] = other[i];
+  }
+  return *this;
+}
+
+template <typename F, std::size_t N>
+template <vector_like B>
+  requires same_vector_shape<vector_view<F, N>, B>
+constexpr auto vector_view<F, N>::operator+=(B const& other) const noexcept -> vector_view const&
+  requires(not std::is_const_v<F>)
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    (*this)[i] += other[i];
+  }
+  return *this;
+}
+
+template <typename F, std::size_t N>
+template <vector_like B>
+  requires same_vector_shape<vector_view<F, N>, B>
+constexpr auto vector_view<F, N>::operator-=(B const& other) const noexcept -> vector_view const&
+  requires(not std::is_const_v<F>)
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    (*this)[i] -= other[i];
+  }
+  return *this;
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr matrix_view<F, R, C>::matrix_view(
+  pointer data, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride) noexcept
+: data_(data), row_stride_(row_stride), col_stride_(col_stride)
+{
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr matrix_view<F, R, C>::matrix_view(matrix<value_type, R, C>& m) noexcept
+: data_(&m[0][0]), row_stride_(C), col_stride_(1)
+{
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr matrix_view<F, R, C>::matrix_view(matrix<value_type, R, C> const& m) noexcept
+  requires(std::is_const_v<F>)
+: data_(&m[0][0]), row_stride_(C), col_stride_(1)
+{
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr matrix_view<F, R, C>::operator matrix<value_type, R, C>() const noexcept
+{
+  auto result = matrix<value_type, R, C>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result[i][j] = (*this)[i][j];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr auto matrix_view<F, R, C>::operator[](std::size_t i) const noexcept -> row_type
+{
+  return row_type(data_ + static_cast<std::ptrdiff_t>(i) * row_stride_, col_stride_);
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr auto matrix_view<F, R, C>::data() const noexcept -> pointer
+{
+  return data_;
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr auto matrix_view<F, R, C>::row_stride() const noexcept -> std::ptrdiff_t
+{
+  return row_stride_;
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr auto matrix_view<F, R, C>::col_stride() const noexcept -> std::ptrdiff_t
+{
+  return col_stride_;
+}
+
+template <typename F, std::size_t R, std::size_t C>
+constexpr auto matrix_view<F, R, C>::transposed() const noexcept -> matrix_view<F, C, R>
+{
+  return matrix_view<F, C, R>(data_, col_stride_, row_stride_);
+}
+
+template <typename F, std::size_t R, std::size_t C>
+template <matrix_like B>
+  requires same_matrix_shape<matrix_view<F, R, C>, B>
+constexpr auto matrix_view<F, R, C>::assign(B const& other) const noexcept -> matrix_view const&
+  requires(not std::is_const_v<F>)
+{
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      (*this)[i][j] = other[i][j];
+    }
+  }
+  return *this;
+}
+
+template <typename F, std::size_t N>
+constexpr auto view(std::span<vector<F, N>> field, std::size_t i) noexcept -> vector_view<F, N>
+{
+  return vector_view<F, N>(field[i]);
+}
+
+template <typename F, std::size_t N>
+constexpr auto view(std::span<vector<F, N> const> field, std::size_t i) noexcept
+  -> vector_view<F const, N>
+{
+  return vector_view<F const, N>(field[i]);
+}
+
+#if defined(__cpp_lib_mdspan)
+template <typename F, std::size_t N>
+auto to_mdspan(std::span<vector<F, N>> field) noexcept
+  -> std::mdspan<F, std::extents<std::size_t, std::dynamic_extent, N>>
+{
+  static_assert(sizeof(vector<F, N>) == N * sizeof(F));
+  auto* const data = field.empty() ? nullptr : &field[0][0];
+  return std::mdspan<F, std::extents<std::size_t, std::dynamic_extent, N>>(data, field.size());
+}
+
+template <typename F, typename E, typename L, typename A>
+  requires(E::rank() == 1 and E::static_extent(0) != std::dynamic_extent)
+auto view(std::mdspan<F, E, L, A> const& m) noexcept -> vector_view<F, E::static_extent(0)>
+{
+  static_assert(std::is_convertible_v<typename A::data_handle_type, F*>);
+  auto const stride = static_cast<std::ptrdiff_t>(m.stride(0));
+  return vector_view<F, E::static_extent(0)>(m.data_handle() + m.mapping()(0), stride);
+}
+
+template <typename F, typename E, typename L, typename A>
+  requires(
+    E::rank() == 2 and E::static_extent(0) != std::dynamic_extent
+    and E::static_extent(1) != std::dynamic_extent)
+auto view(std::mdspan<F, E, L, A> const& m) noexcept
+  -> matrix_view<F, E::static_extent(0), E::static_extent(1)>
+{
+  static_assert(std::is_convertible_v<typename A::data_handle_type, F*>);
+  return matrix_view<F, E::static_extent(0), E::static_extent(1)>(
+    m.data_handle() + m.mapping()(0, 0),
+    static_cast<std::ptrdiff_t>(m.stride(0)),
+    static_cast<std::ptrdiff_t>(m.stride(1)));
+}
+#endif
+} // namespace nani
+
+#endif // NANI_VIEW_HPP
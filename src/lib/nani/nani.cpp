@@ -3,5 +3,583 @@
 // SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
 // -------------------------------------------------------------------------------------------------
 
+// The kernels below are instantiated with register types wider than the baseline of this
+// translation unit. They are only ever inlined into functions compiled for the wider instruction
+// set, so the ABI of passing such registers by value never comes into play.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <nani/flux.hpp>
+#include <nani/indirect.hpp>
+#include <nani/isa.hpp>
+#include <nani/layout.hpp>
+#include <nani/primitive.hpp>
+#include <nani/stage.hpp>
+#include <string_view>
+#include <utility>
 
+namespace nani {
+namespace {
+auto cpu_isa() noexcept -> isa
+{
+#if NANI_X86
+  __builtin_cpu_init();
+  if (
+    __builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512bw")
+    and __builtin_cpu_supports("avx512dq") and __builtin_cpu_supports("avx512vl")) {
+    return isa::avx512;
+  }
+  if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")) {
+    return isa::avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return isa::sse4_2;
+  }
+#endif
+  return isa::generic;
+}
+
+auto initial_isa() noexcept -> isa
+{
+  auto const detected = detected_isa();
+  // NOLINTNEXTLINE(concurrency-mt-unsafe)
+  auto const* env = std::getenv("NANI_ISA");
+  if (env == nullptr) {
+    return detected;
+  }
+
+  for (auto candidate : {isa::generic, isa::sse4_2, isa::avx2, isa::avx512}) {
+    if (to_string(candidate) == std::string_view(env)) {
+      return std::min(candidate, detected);
+    }
+  }
+  return detected;
+}
+
+} // namespace
+
+auto detected_isa() noexcept -> isa
+{
+  static auto const detected = cpu_isa();
+  return detected;
+}
+
+auto active_isa() noexcept -> isa
+{
+  static auto const active = initial_isa();
+  return active;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Layout
+// -------------------------------------------------------------------------------------------------
+
+namespace layout::detail {
+namespace {
+template <typename F, std::size_t N>
+NANI_TARGET_AVX512 NANI_FLATTEN void to_soa_avx512(
+  F const* aos, soa_span<F, N> const& soa, std::size_t begin, std::size_t end, bool nt) noexcept
+{
+  to_soa_range<F, N, isa_width_v<isa::avx512, F>>(aos, soa, begin, end, nt);
+}
+
+template <typename F, std::size_t N>
+NANI_TARGET_AVX2 NANI_FLATTEN void to_soa_avx2(
+  F const* aos, soa_span<F, N> const& soa, std::size_t begin, std::size_t end, bool nt) noexcept
+{
+  to_soa_range<F, N, isa_width_v<isa::avx2, F>>(aos, soa, begin, end, nt);
+}
+
+template <typename F, std::size_t N>
+NANI_TARGET_SSE4_2 NANI_FLATTEN void to_soa_sse4_2(
+  F const* aos, soa_span<F, N> const& soa, std::size_t begin, std::size_t end, bool nt) noexcept
+{
+  to_soa_range<F, N, isa_width_v<isa::sse4_2, F>>(aos, soa, begin, end, nt);
+}
+
+template <typename F, std::size_t N>
+NANI_TARGET_AVX512 NANI_FLATTEN void to_aos_avx512(
+  soa_span<F const, N> const& soa, F* aos, std::size_t begin, std::size_t end, bool nt) noexcept
+{
+  to_aos_range<F, N, isa_width_v<isa::avx512, F>>(soa, aos, begin, end, nt);
+}
+
+template <typename F, std::size_t N>
+NANI_TARGET_AVX2 NANI_FLATTEN void to_aos_avx2(
+  soa_span<F const, N> const& soa, F* aos, std::size_t begin, std::size_t end, bool nt) noexcept
+{
+  to_aos_range<F, N, isa_width_v<isa::avx2, F>>(soa, aos, begin, end, nt);
+}
+
+template <typename F, std::size_t N>
+NANI_TARGET_SSE4_2 NANI_FLATTEN void to_aos_sse4_2(
+  soa_span<F const, N> const& soa, F* aos, std::size_t begin, std::size_t end, bool nt) noexcept
+{
+  to_aos_range<F, N, isa_width_v<isa::sse4_2, F>>(soa, aos, begin, end, nt);
+}
+} // namespace
+
+template <typename F, std::size_t N>
+void to_soa_dispatch(
+  isa target,
+  F const* aos,
+  soa_span<F, N> const& soa,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept
+{
+  switch (target) {
+  case isa::avx512:
+    return to_soa_avx512(aos, soa, begin, end, streaming);
+  case isa::avx2:
+    return to_soa_avx2(aos, soa, begin, end, streaming);
+  case isa::sse4_2:
+    return to_soa_sse4_2(aos, soa, begin, end, streaming);
+  default:
+    return to_soa_range<F, N, isa_width_v<isa::generic, F>>(aos, soa, begin, end, streaming);
+  }
+}
+
+template <typename F, std::size_t N>
+void to_aos_dispatch(
+  isa target,
+  soa_span<F const, N> const& soa,
+  F* aos,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept
+{
+  switch (target) {
+  case isa::avx512:
+    return to_aos_avx512(soa, aos, begin, end, streaming);
+  case isa::avx2:
+    return to_aos_avx2(soa, aos, begin, end, streaming);
+  case isa::sse4_2:
+    return to_aos_sse4_2(soa, aos, begin, end, streaming);
+  default:
+    return to_aos_range<F, N, isa_width_v<isa::generic, F>>(soa, aos, begin, end, streaming);
+  }
+}
+} // namespace layout::detail
+
+// -------------------------------------------------------------------------------------------------
+// Indirect
+// -------------------------------------------------------------------------------------------------
+
+namespace indirect::detail {
+namespace {
+template <typename F, std::size_t N, typename I>
+NANI_TARGET_AVX512 NANI_FLATTEN void gather_range_avx512(
+  F const* base,
+  I const* index,
+  soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  gather_range<isa::avx512>(base, index, out, begin, end);
+}
+
+template <typename F, std::size_t N, typename I>
+NANI_TARGET_AVX2 NANI_FLATTEN void gather_range_avx2(
+  F const* base,
+  I const* index,
+  soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  gather_range<isa::avx2>(base, index, out, begin, end);
+}
+} // namespace
+
+template <typename F, std::size_t N, typename I>
+void gather_dispatch(
+  isa target,
+  F const* base,
+  I const* index,
+  soa_span<F, N> const& out,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  switch (target) {
+  case isa::avx512:
+    return gather_range_avx512(base, index, out, begin, end);
+  case isa::avx2:
+    return gather_range_avx2(base, index, out, begin, end);
+  default:
+    return gather_range<isa::generic>(base, index, out, begin, end);
+  }
+}
+} // namespace indirect::detail
+
+// -------------------------------------------------------------------------------------------------
+// Flux
+// -------------------------------------------------------------------------------------------------
+
+namespace flux::detail {
+namespace {
+template <scheme S, typename F>
+NANI_TARGET_AVX512 NANI_FLATTEN void evaluate_avx512(
+  soa_span<F const, 4> const& left,
+  soa_span<F const, 4> const& right,
+  soa_span<F const, 2> const& normal,
+  F const* length,
+  ideal_gas<F> const& gas,
+  soa_span<F, 4> const& flux,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  evaluate_range<S, F, isa_width_v<isa::avx512, F>>(
+    left, right, normal, length, gas, flux, begin, end);
+}
+
+template <scheme S, typename F>
+NANI_TARGET_AVX2 NANI_FLATTEN void evaluate_avx2(
+  soa_span<F const, 4> const& left,
+  soa_span<F const, 4> const& right,
+  soa_span<F const, 2> const& normal,
+  F const* length,
+  ideal_gas<F> const& gas,
+  soa_span<F, 4> const& flux,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  evaluate_range<S, F, isa_width_v<isa::avx2, F>>(
+    left, right, normal, length, gas, flux, begin, end);
+}
+
+template <scheme S, typename F>
+NANI_TARGET_SSE4_2 NANI_FLATTEN void evaluate_sse4_2(
+  soa_span<F const, 4> const& left,
+  soa_span<F const, 4> const& right,
+  soa_span<F const, 2> const& normal,
+  F const* length,
+  ideal_gas<F> const& gas,
+  soa_span<F, 4> const& flux,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  evaluate_range<S, F, isa_width_v<isa::sse4_2, F>>(
+    left, right, normal, length, gas, flux, begin, end);
+}
+} // namespace
+
+template <scheme S, typename F>
+void evaluate_dispatch(
+  isa target,
+  soa_span<F const, 4> const& left,
+  soa_span<F const, 4> const& right,
+  soa_span<F const, 2> const& normal,
+  F const* length,
+  ideal_gas<F> const& gas,
+  soa_span<F, 4> const& flux,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  switch (target) {
+  case isa::avx512:
+    return evaluate_avx512<S>(left, right, normal, length, gas, flux, begin, end);
+  case isa::avx2:
+    return evaluate_avx2<S>(left, right, normal, length, gas, flux, begin, end);
+  case isa::sse4_2:
+    return evaluate_sse4_2<S>(left, right, normal, length, gas, flux, begin, end);
+  default:
+    return evaluate_range<S, F, isa_width_v<isa::generic, F>>(
+      left, right, normal, length, gas, flux, begin, end);
+  }
+}
+} // namespace flux::detail
+
+// -------------------------------------------------------------------------------------------------
+// Primitive
+// -------------------------------------------------------------------------------------------------
+
+namespace primitive::detail {
+namespace {
+template <typename F, std::size_t N, typename Gas>
+NANI_TARGET_AVX512 NANI_FLATTEN auto from_conservative_avx512(
+  soa_span<F const, N> const& u,
+  Gas const& gas,
+  soa_span<F, N> const& w,
+  F* sound,
+  std::size_t begin,
+  std::size_t end) noexcept -> F
+{
+  return from_conservative_range<F, N, isa_width_v<isa::avx512, F>>(u, gas, w, sound, begin, end);
+}
+
+template <typename F, std::size_t N, typename Gas>
+NANI_TARGET_AVX2 NANI_FLATTEN auto from_conservative_avx2(
+  soa_span<F const, N> const& u,
+  Gas const& gas,
+  soa_span<F, N> const& w,
+  F* sound,
+  std::size_t begin,
+  std::size_t end) noexcept -> F
+{
+  return from_conservative_range<F, N, isa_width_v<isa::avx2, F>>(u, gas, w, sound, begin, end);
+}
+
+template <typename F, std::size_t N, typename Gas>
+NANI_TARGET_SSE4_2 NANI_FLATTEN auto from_conservative_sse4_2(
+  soa_span<F const, N> const& u,
+  Gas const& gas,
+  soa_span<F, N> const& w,
+  F* sound,
+  std::size_t begin,
+  std::size_t end) noexcept -> F
+{
+  return from_conservative_range<F, N, isa_width_v<isa::sse4_2, F>>(u, gas, w, sound, begin, end);
+}
+
+template <typename F, std::size_t N, typename Gas>
+NANI_TARGET_AVX512 NANI_FLATTEN void to_conservative_avx512(
+  soa_span<F const, N> const& w,
+  Gas const& gas,
+  soa_span<F, N> const& u,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  to_conservative_range<F, N, isa_width_v<isa::avx512, F>>(w, gas, u, begin, end);
+}
+
+template <typename F, std::size_t N, typename Gas>
+NANI_TARGET_AVX2 NANI_FLATTEN void to_conservative_avx2(
+  soa_span<F const, N> const& w,
+  Gas const& gas,
+  soa_span<F, N> const& u,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  to_conservative_range<F, N, isa_width_v<isa::avx2, F>>(w, gas, u, begin, end);
+}
+
+template <typename F, std::size_t N, typename Gas>
+NANI_TARGET_SSE4_2 NANI_FLATTEN void to_conservative_sse4_2(
+  soa_span<F const, N> const& w,
+  Gas const& gas,
+  soa_span<F, N> const& u,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  to_conservative_range<F, N, isa_width_v<isa::sse4_2, F>>(w, gas, u, begin, end);
+}
+} // namespace
+
+template <typename F, std::size_t N, typename Gas>
+auto from_conservative_dispatch(
+  isa target,
+  soa_span<F const, N> const& u,
+  Gas const& gas,
+  soa_span<F, N> const& w,
+  F* sound,
+  std::size_t begin,
+  std::size_t end) noexcept -> F
+{
+  switch (target) {
+  case isa::avx512:
+    return from_conservative_avx512(u, gas, w, sound, begin, end);
+  case isa::avx2:
+    return from_conservative_avx2(u, gas, w, sound, begin, end);
+  case isa::sse4_2:
+    return from_conservative_sse4_2(u, gas, w, sound, begin, end);
+  default:
+    return from_conservative_range<F, N, isa_width_v<isa::generic, F>>(
+      u, gas, w, sound, begin, end);
+  }
+}
+
+template <typename F, std::size_t N, typename Gas>
+void to_conservative_dispatch(
+  isa target,
+  soa_span<F const, N> const& w,
+  Gas const& gas,
+  soa_span<F, N> const& u,
+  std::size_t begin,
+  std::size_t end) noexcept
+{
+  switch (target) {
+  case isa::avx512:
+    return to_conservative_avx512(w, gas, u, begin, end);
+  case isa::avx2:
+    return to_conservative_avx2(w, gas, u, begin, end);
+  case isa::sse4_2:
+    return to_conservative_sse4_2(w, gas, u, begin, end);
+  default:
+    return to_conservative_range<F, N, isa_width_v<isa::generic, F>>(w, gas, u, begin, end);
+  }
+}
+} // namespace primitive::detail
+
+// -------------------------------------------------------------------------------------------------
+// Stage
+// -------------------------------------------------------------------------------------------------
+
+namespace stage::detail {
+namespace {
+template <typename F, std::size_t K, bool Norm>
+NANI_TARGET_AVX512 NANI_FLATTEN auto combine_avx512(
+  static_array<F, K> const& coefficient,
+  static_array<F const*, K> const& input,
+  F* out,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept -> F
+{
+  return combine_range<F, K, isa_width_v<isa::avx512, F>, Norm>(
+    coefficient, input, out, begin, end, streaming);
+}
+
+template <typename F, std::size_t K, bool Norm>
+NANI_TARGET_AVX2 NANI_FLATTEN auto combine_avx2(
+  static_array<F, K> const& coefficient,
+  static_array<F const*, K> const& input,
+  F* out,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept -> F
+{
+  return combine_range<F, K, isa_width_v<isa::avx2, F>, Norm>(
+    coefficient, input, out, begin, end, streaming);
+}
+
+template <typename F, std::size_t K, bool Norm>
+NANI_TARGET_SSE4_2 NANI_FLATTEN auto combine_sse4_2(
+  static_array<F, K> const& coefficient,
+  static_array<F const*, K> const& input,
+  F* out,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept -> F
+{
+  return combine_range<F, K, isa_width_v<isa::sse4_2, F>, Norm>(
+    coefficient, input, out, begin, end, streaming);
+}
+} // namespace
+
+template <typename F, std::size_t K, bool Norm>
+auto combine_dispatch(
+  isa target,
+  static_array<F, K> const& coefficient,
+  static_array<F const*, K> const& input,
+  F* out,
+  std::size_t begin,
+  std::size_t end,
+  bool streaming) noexcept -> F
+{
+  switch (target) {
+  case isa::avx512:
+    return combine_avx512<F, K, Norm>(coefficient, input, out, begin, end, streaming);
+  case isa::avx2:
+    return combine_avx2<F, K, Norm>(coefficient, input, out, begin, end, streaming);
+  case isa::sse4_2:
+    return combine_sse4_2<F, K, Norm>(coefficient, input, out, begin, end, streaming);
+  default:
+    return combine_range<F, K, isa_width_v<isa::generic, F>, Norm>(
+      coefficient, input, out, begin, end, streaming);
+  }
+}
+} // namespace stage::detail
+
+// -------------------------------------------------------------------------------------------------
+// Instantiations: every type the headers report as dispatched
+// -------------------------------------------------------------------------------------------------
+
+#define NANI_LAYOUT_DISPATCH(F, N)                                                                 \
+  template void layout::detail::to_soa_dispatch<F, N>(                                             \
+    isa, F const*, soa_span<F, N> const&, std::size_t, std::size_t, bool) noexcept;                \
+  template void layout::detail::to_aos_dispatch<F, N>(                                             \
+    isa, soa_span<F const, N> const&, F*, std::size_t, std::size_t, bool) noexcept;
+
+#define NANI_LAYOUT_DISPATCH_ALL(F)                                                                \
+  NANI_LAYOUT_DISPATCH(F, 2)                                                                       \
+  NANI_LAYOUT_DISPATCH(F, 3)                                                                       \
+  NANI_LAYOUT_DISPATCH(F, 4)                                                                       \
+  NANI_LAYOUT_DISPATCH(F, 5)                                                                       \
+  NANI_LAYOUT_DISPATCH(F, 6)                                                                       \
+  NANI_LAYOUT_DISPATCH(F, 7)                                                                       \
+  NANI_LAYOUT_DISPATCH(F, 8)
+
+#define NANI_GATHER_DISPATCH(F, N, I)                                                              \
+  template void indirect::detail::gather_dispatch<F, N, I>(                                        \
+    isa, F const*, I const*, soa_span<F, N> const&, std::size_t, std::size_t) noexcept;
+
+#define NANI_GATHER_DISPATCH_ALL(F, I)                                                             \
+  NANI_GATHER_DISPATCH(F, 1, I)                                                                    \
+  NANI_GATHER_DISPATCH(F, 2, I)                                                                    \
+  NANI_GATHER_DISPATCH(F, 3, I)                                                                    \
+  NANI_GATHER_DISPATCH(F, 4, I)                                                                    \
+  NANI_GATHER_DISPATCH(F, 5, I)                                                                    \
+  NANI_GATHER_DISPATCH(F, 6, I)                                                                    \
+  NANI_GATHER_DISPATCH(F, 7, I)                                                                    \
+  NANI_GATHER_DISPATCH(F, 8, I)
+
+#define NANI_FLUX_DISPATCH(S, F)                                                                   \
+  template void flux::detail::evaluate_dispatch<flux::scheme::S, F>(                               \
+    isa,                                                                                           \
+    soa_span<F const, 4> const&,                                                                   \
+    soa_span<F const, 4> const&,                                                                   \
+    soa_span<F const, 2> const&,                                                                   \
+    F const*,                                                                                      \
+    ideal_gas<F> const&,                                                                           \
+    soa_span<F, 4> const&,                                                                         \
+    std::size_t,                                                                                   \
+    std::size_t) noexcept;
+
+#define NANI_FLUX_DISPATCH_ALL(F)                                                                  \
+  NANI_FLUX_DISPATCH(rusanov, F)                                                                   \
+  NANI_FLUX_DISPATCH(hll, F)                                                                       \
+  NANI_FLUX_DISPATCH(hllc, F)                                                                      \
+  NANI_FLUX_DISPATCH(roe, F)
+
+#define NANI_PRIMITIVE_DISPATCH(F, N, GAS)                                                         \
+  template auto primitive::detail::from_conservative_dispatch<F, N, GAS<F>>(                       \
+    isa, soa_span<F const, N> const&, GAS<F> const&, soa_span<F, N> const&, F*, std::size_t,       \
+    std::size_t) noexcept -> F;                                                                    \
+  template void primitive::detail::to_conservative_dispatch<F, N, GAS<F>>(                         \
+    isa, soa_span<F const, N> const&, GAS<F> const&, soa_span<F, N> const&, std::size_t,           \
+    std::size_t) noexcept;
+
+#define NANI_PRIMITIVE_DISPATCH_ALL(F)                                                             \
+  NANI_PRIMITIVE_DISPATCH(F, 4, ideal_gas)                                                         \
+  NANI_PRIMITIVE_DISPATCH(F, 5, ideal_gas)                                                         \
+  NANI_PRIMITIVE_DISPATCH(F, 4, stiffened_gas)                                                     \
+  NANI_PRIMITIVE_DISPATCH(F, 5, stiffened_gas)
+
+#define NANI_STAGE_DISPATCH(F, K, NORM)                                                            \
+  template auto stage::detail::combine_dispatch<F, K, NORM>(                                       \
+    isa, static_array<F, K> const&, static_array<F const*, K> const&, F*, std::size_t,             \
+    std::size_t, bool) noexcept -> F;
+
+#define NANI_STAGE_DISPATCH_ALL(F)                                                                 \
+  NANI_STAGE_DISPATCH(F, 1, false)                                                                 \
+  NANI_STAGE_DISPATCH(F, 2, false)                                                                 \
+  NANI_STAGE_DISPATCH(F, 3, false)                                                                 \
+  NANI_STAGE_DISPATCH(F, 4, false)                                                                 \
+  NANI_STAGE_DISPATCH(F, 5, false)                                                                 \
+  NANI_STAGE_DISPATCH(F, 1, true)                                                                  \
+  NANI_STAGE_DISPATCH(F, 2, true)                                                                  \
+  NANI_STAGE_DISPATCH(F, 3, true)                                                                  \
+  NANI_STAGE_DISPATCH(F, 4, true)                                                                  \
+  NANI_STAGE_DISPATCH(F, 5, true)
+
+NANI_LAYOUT_DISPATCH_ALL(float)
+NANI_LAYOUT_DISPATCH_ALL(double)
+
+NANI_GATHER_DISPATCH_ALL(float, std::int32_t)
+NANI_GATHER_DISPATCH_ALL(float, std::uint32_t)
+NANI_GATHER_DISPATCH_ALL(double, std::int32_t)
+NANI_GATHER_DISPATCH_ALL(double, std::uint32_t)
+
+NANI_FLUX_DISPATCH_ALL(float)
+NANI_FLUX_DISPATCH_ALL(double)
+
+NANI_PRIMITIVE_DISPATCH_ALL(float)
+NANI_PRIMITIVE_DISPATCH_ALL(double)
+
+NANI_STAGE_DISPATCH_ALL(float)
+NANI_STAGE_DISPATCH_ALL(double)
+} // namespace nani
@@ -0,0 +1,163 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <nani/parallel.hpp>
+#include <thread>
+#include <vector>
+
+namespace nani {
+namespace {
+auto initial_thread_count() noexcept -> std::size_t
+{
+  // NOLINTNEXTLINE(concurrency-mt-unsafe)
+  if (auto const* env = std::getenv("NANI_NUM_THREADS"); env != nullptr) {
+    auto const requested = std::strtoul(env, nullptr, 10);
+    if (requested > 0) {
+      return requested;
+    }
+  }
+  return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// Whether the current thread is running a task, in which case nested calls run inline.
+thread_local bool in_task = false;
+
+/* Thread Pool
+ *
+ * Persistent worker threads that sleep on a condition variable between tasks. A task is published
+ * under a new generation number; the first `nworker` threads run it and the submitting thread
+ * waits for them to finish. Submissions from different threads are serialized.
+ */
+class thread_pool {
+public:
+  explicit thread_pool(std::size_t size);
+  thread_pool(thread_pool const&) = delete;
+  thread_pool(thread_pool&&) = delete;
+  auto operator=(thread_pool const&) -> thread_pool& = delete;
+  auto operator=(thread_pool&&) -> thread_pool& = delete;
+  ~thread_pool();
+
+public:
+  [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+  void run(void (*task)(void*), void* context, std::size_t nworker);
+
+private:
+  void loop(std::size_t id);
+
+private:
+  std::mutex submit_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  void (*task_)(void*) = nullptr;
+  void* context_ = nullptr;
+  std::size_t nworker_ = 0;
+  std::size_t pending_ = 0;
+  std::uint64_t generation_ = 0;
+  bool stop_ = false;
+  std::vector<std::jthread> thread_;
+};
+
+thread_pool::thread_pool(std::size_t size)
+{
+  thread_.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    thread_.emplace_back([this, i]() { loop(i); });
+  }
+}
+
+thread_pool::~thread_pool()
+{
+  {
+    auto const lock = std::scoped_lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+}
+
+auto thread_pool::size() const noexcept -> std::size_t
+{
+  return thread_.size();
+}
+
+void thread_pool::run(void (*task)(void*), void* context, std::size_t nworker)
+{
+  auto const submit = std::scoped_lock(submit_);
+  {
+    auto const lock = std::scoped_lock(mutex_);
+    task_ = task;
+    context_ = context;
+    nworker_ = nworker;
+    pending_ = nworker;
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  in_task = true;
+  task(context);
+  in_task = false;
+
+  auto lock = std::unique_lock(mutex_);
+  done_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+void thread_pool::loop(std::size_t id)
+{
+  in_task = true;
+  std::uint64_t seen = 0;
+  auto lock = std::unique_lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [&]() { return stop_ or generation_ != seen; });
+    if (stop_) {
+      return;
+    }
+    seen = generation_;
+    if (id >= nworker_) {
+      continue;
+    }
+
+    auto* const task = task_;
+    auto* const context = context_;
+    lock.unlock();
+    task(context);
+    lock.lock();
+
+    if (--pending_ == 0) {
+      done_.notify_one();
+    }
+  }
+}
+
+auto pool() -> thread_pool&
+{
+  static auto instance = thread_pool(thread_count() - 1);
+  return instance;
+}
+} // namespace
+
+auto thread_count() noexcept -> std::size_t
+{
+  static auto const count = initial_thread_count();
+  return count;
+}
+
+namespace detail::parallel {
+void run(void (*task)(void*), void* context, std::size_t nworker)
+{
+  if (in_task or nworker == 0) {
+    task(context);
+    return;
+  }
+
+  auto& instance = pool();
+  instance.run(task, context, std::min(nworker, instance.size()));
+}
+} // namespace detail::parallel
+} // namespace nani
@@ -0,0 +1,54 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <nani/text.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace nani::text {
+void vtk_writer::header(std::string_view title)
+{
+  // The title is a single line of at most 256 characters.
+  auto line = std::string(title.substr(0, 255));
+  std::replace(line.begin(), line.end(), '\n', ' ');
+  *out_ << "# vtk DataFile Version 3.0\n" << line << "\nASCII\nDATASET UNSTRUCTURED_GRID\n";
+}
+
+void vtk_writer::begin_field(
+  section s,
+  std::string_view name,
+  std::string_view type,
+  std::size_t components,
+  std::size_t size)
+{
+  if (name.empty() or name.find_first_of(" \t\r\n") != std::string_view::npos) {
+    throw std::runtime_error("vtk_writer: invalid field name '" + std::string(name) + "'");
+  }
+
+  auto const expected = s == section::cell ? ncell_ : npoint_;
+  if (size != expected) {
+    throw std::runtime_error("vtk_writer: field " + std::string(name) + " has the wrong size");
+  }
+
+  if (s != section_) {
+    auto& written = s == section::cell ? cell_written_ : point_written_;
+    if (written) {
+      throw std::runtime_error(
+        "vtk_writer: the fields of the cells and of the points cannot be interleaved");
+    }
+    written = true;
+    section_ = s;
+    *out_ << (s == section::cell ? "CELL_DATA " : "POINT_DATA ") << expected << '\n';
+  }
+
+  if (components == 3) {
+    *out_ << "VECTORS " << name << ' ' << type << '\n';
+  }
+  else {
+    *out_ << "SCALARS " << name << ' ' << type << ' ' << components << "\nLOOKUP_TABLE default\n";
+  }
+}
+} // namespace nani::text
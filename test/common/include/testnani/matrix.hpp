@@ -0,0 +1,49 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#ifndef TESTNANI_MATRIX_HPP
+#define TESTNANI_MATRIX_HPP
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/vector.hpp>
+
+namespace testnani {
+/* \brief A dense matrix with entries in [-1, 2], different for every seed */
+template <typename F, std::size_t R, std::size_t C>
+auto sample(std::size_t seed) -> nani::matrix<F, R, C>
+{
+  auto result = nani::matrix<F, R, C>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result[i][j] = F(((seed + 2) * (i + 1) * 5 + j * 11) % 13) / F(4) - F(1);
+    }
+  }
+  return result;
+}
+
+/* \brief Requires every entry of a to be within `tolerance` of the one of b */
+template <typename F, std::size_t R, std::size_t C>
+void check_equal(nani::matrix<F, R, C> const& a, nani::matrix<F, R, C> const& b, F tolerance)
+{
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      REQUIRE(nani::abs(a[i][j] - b[i][j]) <= tolerance);
+    }
+  }
+}
+
+template <typename F, std::size_t N>
+void check_equal(nani::vector<F, N> const& a, nani::vector<F, N> const& b, F tolerance)
+{
+  for (std::size_t i = 0; i < N; ++i) {
+    REQUIRE(nani::abs(a[i] - b[i]) <= tolerance);
+  }
+}
+} // namespace testnani
+
+#endif // TESTNANI_MATRIX_HPP
@@ -0,0 +1,63 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <nani/accumulate.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/accumulate")
+
+namespace {
+// Use a pool also on single-core runners; read by nani::thread_count() on first use.
+auto const threads = setenv("NANI_NUM_THREADS", "4", 1); // NOLINT(concurrency-mt-unsafe)
+} // namespace
+
+TEST_CASE("scatter_add strategies agree", "[all]")
+{
+  // Otherwise every strategy takes the sequential loop.
+  REQUIRE(threads == 0);
+  REQUIRE(nani::thread_count() > 1);
+
+  using state = nani::vector<double, 2>;
+  using nani::accumulate::strategy;
+
+  auto const nitem = std::size_t{50000};
+  auto const ntarget = std::size_t{1000};
+  auto index = std::vector<std::uint32_t>(nitem);
+  auto value = nani::soa_field<double, 2>(nitem);
+  for (std::size_t k = 0; k < nitem; ++k) {
+    index[k] = static_cast<std::uint32_t>((k * 7919) % ntarget);
+    // Small integers keep every sum exact, whatever the order of the additions.
+    value.store(k, state(static_cast<double>(k % 3), 1.0));
+  }
+
+  auto expected = std::vector<state>(ntarget, state::fill(0.0));
+  for (std::size_t k = 0; k < nitem; ++k) {
+    expected[index[k]] += value.load(k);
+  }
+
+  for (auto const s :
+       {strategy::atomic, strategy::privatized, strategy::striped, strategy::automatic}) {
+    auto field = std::vector<state>(ntarget, state::fill(0.0));
+    nani::accumulate::scatter_add<double, 2, std::uint32_t>(value.span(), index, field, s);
+    REQUIRE(field == expected);
+  }
+}
+
+TEST_CASE("choose", "[all]")
+{
+  using nani::accumulate::choose;
+  using nani::accumulate::strategy;
+
+  REQUIRE(choose(1000, 100000, 8) == strategy::atomic);
+  REQUIRE(choose(1000000, 1000, 8) == strategy::privatized);
+  REQUIRE(choose(1000000, 500000, 8) == strategy::striped);
+}
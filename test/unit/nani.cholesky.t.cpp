@@ -0,0 +1,213 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <limits>
+#include <nani/cholesky.hpp>
+#include <nani/matrix.hpp>
+#include <nani/meta.hpp>
+#include <nani/smath.hpp>
+#include <nani/vector.hpp>
+#include <span>
+#include <stdexcept>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/cholesky")
+
+namespace {
+/* B B^T + R I for a deterministic B, symmetric positive definite. */
+template <typename F, std::size_t R>
+auto spd(std::size_t seed) -> nani::matrix<F, R, R>
+{
+  auto b = nani::matrix<F, R, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < R; ++j) {
+      b[i][j] = F(((seed + 3) * (i + 1) * 7 + j * 13) % 17) / F(8) - F(1);
+    }
+  }
+  auto result = nani::matrix<F, R, R>::zero();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < R; ++j) {
+      for (std::size_t k = 0; k < R; ++k) {
+        result[i][j] += b[i][k] * b[j][k];
+      }
+    }
+    result[i][i] += F(R);
+  }
+  return result;
+}
+
+template <typename F, std::size_t R>
+auto rhs(std::size_t seed) -> nani::vector<F, R>
+{
+  auto result = nani::vector<F, R>();
+  for (std::size_t i = 0; i < R; ++i) {
+    result[i] = F((seed + i * 5) % 9) - F(4);
+  }
+  return result;
+}
+
+template <typename F, std::size_t R>
+auto residual(nani::matrix<F, R, R> const& a, nani::vector<F, R> const& x, nani::vector<F, R> b)
+  -> F
+{
+  auto result = F(0);
+  for (std::size_t i = 0; i < R; ++i) {
+    auto r = -b[i];
+    for (std::size_t j = 0; j < R; ++j) {
+      r += a[i][j] * x[j];
+    }
+    result = nani::max(result, nani::abs(r));
+  }
+  return result;
+}
+
+template <typename F, std::size_t R>
+void check_factor(F tolerance)
+{
+  for (std::size_t seed = 0; seed < 5; ++seed) {
+    auto const a = spd<F, R>(seed);
+    auto const b = rhs<F, R>(seed);
+    auto const c = nani::cholesky(a);
+    auto const d = nani::ldlt(a);
+
+    // L L^T == A and L D L^T == A.
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < R; ++j) {
+        auto llt = F(0);
+        auto ldl = F(0);
+        for (std::size_t k = 0; k < R; ++k) {
+          llt += c.lower()[i][k] * c.lower()[j][k];
+          ldl += d.lower()[i][k] * d.diagonal()[k] * d.lower()[j][k];
+        }
+        REQUIRE(nani::abs(llt - a[i][j]) <= tolerance * F(R));
+        REQUIRE(nani::abs(ldl - a[i][j]) <= tolerance * F(R));
+      }
+      for (auto j = i + 1; j < R; ++j) {
+        REQUIRE(c.lower()[i][j] == F(0));
+        REQUIRE(d.lower()[i][j] == F(0));
+      }
+      REQUIRE(d.lower()[i][i] == F(1));
+    }
+
+    REQUIRE(residual(a, c.solve(b), b) <= tolerance * F(R));
+    REQUIRE(residual(a, d.solve(b), b) <= tolerance * F(R));
+
+    auto const identity = c.inverse() * a;
+    auto const identity_ldlt = d.inverse() * a;
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < R; ++j) {
+        auto const e = i == j ? F(1) : F(0);
+        REQUIRE(nani::abs(identity[i][j] - e) <= tolerance * F(R));
+        REQUIRE(nani::abs(identity_ldlt[i][j] - e) <= tolerance * F(R));
+      }
+    }
+
+    if constexpr (R < 6) {
+      auto const det = F(nani::determinant(a));
+      REQUIRE(nani::abs(c.determinant() - det) <= tolerance * nani::abs(det));
+      REQUIRE(nani::abs(d.determinant() - det) <= tolerance * nani::abs(det));
+    }
+  }
+}
+
+template <typename F, std::size_t R>
+void check_batched(std::size_t count)
+{
+  auto a = std::vector<nani::matrix<F, R, R>>(count);
+  auto b = std::vector<nani::vector<F, R>>(count);
+  for (std::size_t m = 0; m < count; ++m) {
+    a[m] = spd<F, R>(m);
+    b[m] = rhs<F, R>(m);
+  }
+
+  auto c = std::vector<nani::cholesky_factor<F, R>>(count);
+  auto d = std::vector<nani::ldlt_factor<F, R>>(count);
+  nani::cholesky(std::span<nani::matrix<F, R, R> const>(a), std::span(c));
+  nani::ldlt(std::span<nani::matrix<F, R, R> const>(a), std::span(d));
+
+  auto x = std::vector<nani::vector<F, R>>(count);
+  auto y = std::vector<nani::vector<F, R>>(count);
+  auto const rhs_span = std::span<nani::vector<F, R> const>(b);
+  nani::solve(std::span<nani::cholesky_factor<F, R> const>(c), rhs_span, std::span(x));
+  nani::solve(std::span<nani::ldlt_factor<F, R> const>(d), rhs_span, std::span(y));
+
+  // Same operations as the scalar factors, lane by lane, up to contraction into FMAs.
+  auto const tolerance = F(64) * std::numeric_limits<F>::epsilon();
+  for (std::size_t m = 0; m < count; ++m) {
+    auto const single = nani::cholesky(a[m]);
+    auto const single_ldlt = nani::ldlt(a[m]);
+    auto const xs = single.solve(b[m]);
+    auto const ys = single_ldlt.solve(b[m]);
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < R; ++j) {
+        REQUIRE(nani::abs(c[m].lower()[i][j] - single.lower()[i][j]) <= tolerance);
+        REQUIRE(nani::abs(d[m].lower()[i][j] - single_ldlt.lower()[i][j]) <= tolerance);
+      }
+      REQUIRE(nani::abs(x[m][i] - xs[i]) <= tolerance * (F(1) + nani::abs(xs[i])));
+      REQUIRE(nani::abs(y[m][i] - ys[i]) <= tolerance * (F(1) + nani::abs(ys[i])));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("factor", "[all]")
+{
+  check_factor<double, 1>(1e-12);
+  check_factor<double, 2>(1e-12);
+  check_factor<double, 3>(1e-12);
+  check_factor<double, 4>(1e-12);
+  check_factor<double, 5>(1e-12);
+  check_factor<double, 8>(1e-12);
+  check_factor<double, 12>(1e-11);
+  check_factor<float, 3>(1e-4F);
+  check_factor<float, 7>(1e-4F);
+}
+
+TEST_CASE("indefinite", "[all]")
+{
+  // LDL^T handles symmetric indefinite matrices with nonzero leading minors.
+  auto a = nani::matrix<double, 2, 2>();
+  a[0][0] = 1.0;
+  a[0][1] = a[1][0] = 2.0;
+  a[1][1] = 1.0;
+  auto const d = nani::ldlt(a);
+  REQUIRE(d.diagonal()[1] == -3.0);
+  REQUIRE(d.determinant() == -3.0);
+  auto const x = d.solve(nani::vector<double, 2>(3.0, 3.0));
+  REQUIRE(nani::abs(x[0] - 1.0) <= 1e-14);
+  REQUIRE(nani::abs(x[1] - 1.0) <= 1e-14);
+}
+
+TEST_CASE("batched", "[all]")
+{
+  check_batched<double, 3>(1000);
+  check_batched<double, 4>(37);
+  check_batched<double, 8>(2051);
+  check_batched<float, 5>(333);
+  check_batched<float, 1>(17);
+}
+
+TEST_CASE("batched pivot check", "[all]")
+{
+  // The matrix that is not positive definite falls in the tail handled one lane at a time; the
+  // check is made on the calling thread, after the workers are done.
+  auto a = std::vector<nani::matrix<double, 3, 3>>(17, nani::matrix<double, 3, 3>::identity());
+  a.back()[1][1] = -1.0;
+  auto factor = std::vector<nani::cholesky_factor<double, 3>>(a.size());
+  auto const run = [&]() {
+    nani::cholesky(
+      std::span<nani::matrix<double, 3, 3> const>(a),
+      std::span<nani::cholesky_factor<double, 3>>(factor));
+  };
+  if constexpr (nani::meta::is_debug_build()) {
+    REQUIRE_THROWS_AS(run(), std::runtime_error);
+  }
+  else {
+    run();
+    REQUIRE(factor.front().lower()[1][1] == 1.0);
+  }
+}
@@ -0,0 +1,185 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <nani/compressed.hpp>
+#include <nani/soa.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <utility>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/compressed")
+
+namespace {
+/* A smooth field with a little noise, as left behind by a flow solver. */
+template <typename F, std::size_t N>
+auto smooth(std::size_t size) -> nani::soa_field<F, N>
+{
+  auto result = nani::soa_field<F, N>(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const x = F(i) / F(size);
+    for (std::size_t c = 0; c < N; ++c) {
+      auto const noise = F((i * 2654435761U + c) % 1024) * F(1e-9);
+      result.component(c)[i] = std::sin(F(6) * x + F(c)) * F(c + 1) + F(2) + noise;
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+auto decompressed(nani::compressed_field<F, N> const& field) -> nani::soa_field<F, N>
+{
+  auto result = nani::soa_field<F, N>(field.size());
+  field.decompress(result.span());
+  return result;
+}
+
+template <typename F, std::size_t N>
+void check_lossless(nani::soa_field<F, N> const& data)
+{
+  auto const field = nani::compressed_field<F, N>(data.span(), nani::compression::lossless());
+  auto const back = decompressed(field);
+  for (std::size_t c = 0; c < N; ++c) {
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      using U = std::conditional_t<sizeof(F) == 4, std::uint32_t, std::uint64_t>;
+      REQUIRE(std::bit_cast<U>(back.component(c)[i]) == std::bit_cast<U>(data.component(c)[i]));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("lossless", "[all]")
+{
+  for (auto const size : {std::size_t(1), std::size_t(64), std::size_t(1000)}) {
+    check_lossless(smooth<double, 4>(size));
+    check_lossless(smooth<float, 3>(size));
+  }
+
+  // Special values and sign changes survive bit for bit.
+  auto special = nani::soa_field<double, 1>(7);
+  auto const values = {0.0, -0.0, 1.0, -1.0, std::numeric_limits<double>::infinity(),
+                       std::numeric_limits<double>::quiet_NaN(),
+                       std::numeric_limits<double>::denorm_min()};
+  auto i = std::size_t(0);
+  for (auto const v : values) {
+    special.component(0)[i++] = v;
+  }
+  check_lossless(special);
+
+  // Smooth fields shrink even without loss.
+  auto const data = smooth<double, 4>(100000);
+  auto const field = nani::compressed_field<double, 4>(data.span(), nani::compression::lossless());
+  REQUIRE(field.bytes() < data.size() * 4 * sizeof(double));
+}
+
+TEST_CASE("accuracy", "[all]")
+{
+  auto const size = std::size_t(100000);
+  auto const data = smooth<double, 4>(size);
+  for (auto const tolerance : {1e-3, 1e-6, 1e-9}) {
+    auto const field
+      = nani::compressed_field<double, 4>(data.span(), nani::compression::accuracy(tolerance));
+    auto const back = decompressed(field);
+    for (std::size_t c = 0; c < 4; ++c) {
+      for (std::size_t i = 0; i < size; ++i) {
+        REQUIRE(std::abs(back.component(c)[i] - data.component(c)[i]) <= tolerance);
+      }
+    }
+  }
+
+  // At an engineering tolerance the field takes a fraction of its size.
+  auto const field
+    = nani::compressed_field<double, 4>(data.span(), nani::compression::accuracy(1e-6));
+  REQUIRE(2 * field.bytes() < size * 4 * sizeof(double));
+}
+
+TEST_CASE("rate", "[all]")
+{
+  auto const size = std::size_t(6400);
+  auto const data = smooth<float, 2>(size);
+  auto const bits = 16U;
+  auto const field = nani::compressed_field<float, 2>(data.span(), nani::compression::rate(bits));
+
+  // Fixed rate: the size is known in advance. Every block holds a 16 bit exponent and 64 values
+  // per stream, padded to whole words.
+  auto const block_bits = 2 * (16 + 64 * bits);
+  auto const payload = field.nblock() * ((block_bits + 63) / 64) * 8;
+  REQUIRE(field.bytes() - (field.nblock() + 1) * sizeof(std::size_t) == payload);
+
+  auto const back = decompressed(field);
+  for (std::size_t c = 0; c < 2; ++c) {
+    for (std::size_t i = 0; i < size; ++i) {
+      // Every value of the smooth field is below 8 in magnitude.
+      REQUIRE(std::abs(back.component(c)[i] - data.component(c)[i]) <= std::ldexp(8.0, 2 - 16));
+    }
+  }
+}
+
+TEST_CASE("access", "[all]")
+{
+  auto const size = std::size_t(20000) + 17;
+  auto const data = smooth<double, 3>(size);
+  auto field = nani::compressed_field<double, 3>(data.span(), nani::compression::accuracy(1e-8));
+  auto const back = decompressed(field);
+
+  // Random access, hopping between blocks.
+  for (std::size_t k = 0; k < 5000; ++k) {
+    auto const i = (k * 7919) % size;
+    REQUIRE(field.load(i) == back.load(i));
+  }
+
+  // Streaming into a batched reduction. Catch2 assertions are not thread safe, so the callback
+  // only records what it saw, and the checks run here.
+  struct range {
+    std::size_t begin;
+    std::size_t size;
+    bool equal;
+  };
+  auto mutex = std::mutex();
+  auto ranges = std::vector<range>();
+  auto sum = std::atomic<double>(0);
+  field.stream([&](std::size_t begin, nani::soa_span<double const, 3> values) {
+    auto local = 0.0;
+    auto equal = true;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      equal = equal and values.load(i) == back.load(begin + i);
+      local += values.data(1)[i];
+    }
+    auto expected = sum.load();
+    while (not sum.compare_exchange_weak(expected, expected + local)) {
+    }
+    auto const lock = std::scoped_lock(mutex);
+    ranges.push_back({begin, values.size(), equal});
+  });
+
+  std::sort(ranges.begin(), ranges.end(), [](auto const& a, auto const& b) {
+    return a.begin < b.begin;
+  });
+  auto next = std::size_t(0);
+  for (auto const& r : ranges) {
+    REQUIRE(r.begin == next);
+    REQUIRE(r.size > 0);
+    REQUIRE(r.size <= field.stream_grain);
+    REQUIRE(r.equal);
+    next += r.size;
+  }
+  REQUIRE(next == size);
+
+  auto total = 0.0;
+  for (std::size_t i = 0; i < size; ++i) {
+    total += back.component(1)[i];
+  }
+  REQUIRE(std::abs(sum.load() - total) <= 1e-12 * std::abs(total));
+
+  // Reassignment re-encodes and drops the cached blocks.
+  field.assign(std::as_const(back).span());
+  REQUIRE(field.load(3) == back.load(3));
+}
@@ -0,0 +1,132 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/dual.hpp>
+#include <nani/flux.hpp>
+#include <nani/gas.hpp>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <type_traits>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/dual")
+
+namespace {
+template <typename F, std::size_t M, std::size_t N, typename Function>
+auto central_difference(Function const& f, nani::vector<F, N> const& x, F h)
+  -> nani::matrix<F, M, N>
+{
+  auto result = nani::matrix<F, M, N>();
+  for (std::size_t j = 0; j < N; ++j) {
+    auto xp = x;
+    auto xm = x;
+    xp[j] += h;
+    xm[j] -= h;
+    auto const d = (f(xp) - f(xm)) / (F(2) * h);
+    for (std::size_t i = 0; i < M; ++i) {
+      result[i][j] = d[i];
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t M, std::size_t N>
+void check_close(nani::matrix<F, M, N> const& a, nani::matrix<F, M, N> const& b, F tolerance)
+{
+  for (std::size_t i = 0; i < M; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      REQUIRE(nani::abs(a[i][j] - b[i][j]) <= tolerance * (F(1) + nani::abs(b[i][j])));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("arithmetic", "[all]")
+{
+  using d3 = nani::dual<double, 3>;
+  static_assert(d3::pack_type::width == 4);
+
+  auto const x = d3::variable(2.0, 0);
+  auto const y = d3::variable(-3.0, 1);
+  auto const z = d3::variable(0.5, 2);
+
+  // f = x y / z + x^3 - sqrt(x) sin(y) + cos(z)
+  auto const f = x * y / z + nani::pow(x, 3) - nani::sqrt(x) * nani::sin(y) + nani::cos(z);
+  auto const sx = std::sqrt(2.0);
+  REQUIRE(nani::abs(f.value() - (-12.0 + 8.0 - sx * std::sin(-3.0) + std::cos(0.5))) <= 1e-14);
+  REQUIRE(nani::abs(f.derivative(0) - (-6.0 + 12.0 - std::sin(-3.0) / (2.0 * sx))) <= 1e-14);
+  REQUIRE(nani::abs(f.derivative(1) - (4.0 - sx * std::cos(-3.0))) <= 1e-14);
+  REQUIRE(nani::abs(f.derivative(2) - (24.0 - std::sin(0.5))) <= 1e-13);
+
+  // Piecewise functions follow the branch of the value.
+  REQUIRE(nani::abs(y).derivative(1) == -1.0);
+  REQUIRE(nani::max(x, y).derivative(0) == 1.0);
+  REQUIRE(nani::min(x, y).derivative(1) == 1.0);
+  REQUIRE(nani::sign(y).value() == -1.0);
+  REQUIRE(nani::sign(y).derivative(1) == 0.0);
+  REQUIRE(x > y);
+  REQUIRE(x == 2.0);
+
+  // Compound assignment and scalar operands.
+  auto w = x;
+  w *= 3.0;
+  w -= y;
+  w /= 2.0;
+  REQUIRE(w.value() == 4.5);
+  REQUIRE(w.derivative(0) == 1.5);
+  REQUIRE(w.derivative(1) == -0.5);
+}
+
+TEST_CASE("containers", "[all]")
+{
+  using d2 = nani::dual<double, 2>;
+  auto const v = nani::seed(nani::vector<double, 2>(1.0, 2.0));
+  auto const a = nani::matrix<d2, 2, 2>::identity();
+  auto const b = a * a;
+  auto const y = b * v + v;
+  auto const d = nani::derivatives(y);
+  REQUIRE(nani::values(y) == nani::vector<double, 2>(2.0, 4.0));
+  REQUIRE(d[0][0] == 2.0);
+  REQUIRE(d[0][1] == 0.0);
+  REQUIRE(d[1][1] == 2.0);
+  REQUIRE((v * v).derivative(1) == 4.0);
+}
+
+TEST_CASE("jacobian", "[all]")
+{
+  auto const gas = nani::ideal_gas<double>();
+  auto const u = nani::vector<double, 4>(1.2, 0.3, -0.4, 2.5);
+  auto const w = nani::vector<double, 4>(0.9, -0.1, 0.2, 2.0);
+  auto const n = nani::vector<double, 2>(0.6, 0.8);
+
+  auto const physical = [&](auto const& q) {
+    using T = typename std::remove_cvref_t<decltype(q)>::value_type;
+    return nani::flux::physical(q, nani::vector<T, 2>(T(n[0]), T(n[1])), gas);
+  };
+  auto const exact = nani::jacobian(physical, u);
+  check_close(exact, central_difference<double, 4>(physical, u, 1e-6), 1e-7);
+
+  // Jacobian of a numerical flux with respect to the left state, the right one held constant.
+  auto const rusanov = [&](auto const& q) {
+    using T = typename std::remove_cvref_t<decltype(q)>::value_type;
+    auto r = nani::vector<T, 4>();
+    for (std::size_t i = 0; i < 4; ++i) {
+      r[i] = T(w[i]);
+    }
+    return nani::flux::rusanov(q, r, nani::vector<T, 2>(T(n[0]), T(n[1])), gas);
+  };
+  auto const left = nani::jacobian(rusanov, u);
+  check_close(left, central_difference<double, 4>(rusanov, u, 1e-6), 1e-7);
+
+  auto const product = [](auto const& q) {
+    using T = typename std::remove_cvref_t<decltype(q)>::value_type;
+    return nani::vector<T, 1>(q[0] * q[1]);
+  };
+  auto const single = nani::jacobian(product, nani::vector<float, 2>(3.0F, 4.0F));
+  REQUIRE(single[0][0] == 4.0F);
+  REQUIRE(single[0][1] == 3.0F);
+}
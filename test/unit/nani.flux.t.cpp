@@ -0,0 +1,148 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/flux.hpp>
+#include <nani/gas.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <utility>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/flux")
+
+namespace {
+using nani::flux::scheme;
+
+template <typename F>
+auto conservative(F rho, F u, F v, F p) -> nani::vector<F, 4>
+{
+  auto const gas = nani::ideal_gas<F>();
+  return nani::vector<F, 4>(
+    rho, rho * u, rho * v, gas.internal_energy(rho, p) + F(0.5) * rho * (u * u + v * v));
+}
+
+template <typename F>
+auto unit(F angle) -> nani::vector<F, 2>
+{
+  return nani::vector<F, 2>(nani::cos(angle), nani::sin(angle));
+}
+
+template <typename F>
+auto close(nani::vector<F, 4> const& a, nani::vector<F, 4> const& b, F tolerance) -> bool
+{
+  for (std::size_t c = 0; c < 4; ++c) {
+    if (nani::abs(a[c] - b[c]) > tolerance * (F(1) + nani::abs(b[c]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <scheme S>
+void check_face()
+{
+  auto const gas = nani::ideal_gas<double>();
+  auto const ul = conservative(1.0, 0.3, -0.2, 1.0);
+  auto const ur = conservative(0.125, -0.1, 0.4, 0.1);
+  auto const n = unit(0.7);
+
+  // Consistency: a face between equal states carries the exact flux.
+  auto const exact = nani::flux::physical(ul, n, gas);
+  REQUIRE(close(nani::flux::numerical<S>(ul, ul, n, gas), exact, 1e-14));
+
+  // Conservation: the neighbour sees the same flux through the opposite normal.
+  auto const forward = nani::flux::numerical<S>(ul, ur, n, gas);
+  auto const backward = nani::flux::numerical<S>(ur, ul, -1.0 * n, gas);
+  REQUIRE(close(forward, -1.0 * backward, 1e-13));
+}
+
+template <scheme S, typename F>
+void check_batch(std::size_t size)
+{
+  auto const gas = nani::ideal_gas<F>();
+  auto left = nani::soa_field<F, 4>(size);
+  auto right = nani::soa_field<F, 4>(size);
+  auto normal = nani::soa_field<F, 2>(size);
+  auto length = std::vector<F>(size);
+  auto flux = nani::soa_field<F, 4>(size);
+
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const x = F(i % 17) / F(17);
+    left.store(i, conservative(F(1) + x, F(0.5) - x, x, F(1)));
+    right.store(i, conservative(F(0.5), F(2) * x, F(-0.3), F(0.4) + x));
+    normal.store(i, unit(F(0.37) * F(i)));
+    length[i] = F(1) + x;
+  }
+
+  nani::flux::evaluate<S>(
+    std::as_const(left).span(),
+    std::as_const(right).span(),
+    std::as_const(normal).span(),
+    std::span<F const>(length),
+    gas,
+    flux.span());
+
+  auto const tolerance = std::is_same_v<F, float> ? F(1e-5) : F(1e-13);
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const expected
+      = nani::flux::numerical<S>(left.load(i), right.load(i), normal.load(i), gas) * length[i];
+    REQUIRE(close(flux.load(i), expected, tolerance));
+  }
+}
+} // namespace
+
+TEST_CASE("consistency and conservation", "[all]")
+{
+  check_face<scheme::rusanov>();
+  check_face<scheme::hll>();
+  check_face<scheme::hllc>();
+  check_face<scheme::roe>();
+}
+
+TEST_CASE("supersonic upwinding", "[all]")
+{
+  auto const gas = nani::ideal_gas<double>();
+  auto const n = nani::vector<double, 2>(1.0, 0.0);
+  auto const ul = conservative(1.0, 3.0, 0.5, 1.0);
+  auto const ur = conservative(0.8, 2.5, -0.5, 0.9);
+
+  auto const upwind = nani::flux::physical(ul, n, gas);
+  REQUIRE(close(nani::flux::hll(ul, ur, n, gas), upwind, 1e-14));
+  REQUIRE(close(nani::flux::hllc(ul, ur, n, gas), upwind, 1e-14));
+
+  // Seen from the other side, the flow leaves through the face towards the first argument.
+  auto const reversed = nani::flux::physical(ul, -1.0 * n, gas);
+  REQUIRE(close(nani::flux::hll(ur, ul, -1.0 * n, gas), reversed, 1e-14));
+  REQUIRE(close(nani::flux::hllc(ur, ul, -1.0 * n, gas), reversed, 1e-14));
+}
+
+TEST_CASE("contact", "[all]")
+{
+  // A stationary contact is resolved exactly by HLLC and Roe, and smeared by Rusanov and HLL.
+  auto const gas = nani::ideal_gas<double>();
+  auto const n = nani::vector<double, 2>(1.0, 0.0);
+  auto const ul = conservative(1.0, 0.0, 0.0, 1.0);
+  auto const ur = conservative(0.25, 0.0, 0.0, 1.0);
+  auto const exact = nani::vector<double, 4>(0.0, 1.0, 0.0, 0.0);
+
+  REQUIRE(close(nani::flux::hllc(ul, ur, n, gas), exact, 1e-14));
+  REQUIRE(close(nani::flux::roe(ul, ur, n, gas), exact, 1e-14));
+  REQUIRE(not close(nani::flux::rusanov(ul, ur, n, gas), exact, 1e-3));
+  REQUIRE(not close(nani::flux::hll(ul, ur, n, gas), exact, 1e-3));
+}
+
+TEST_CASE("batched", "[all]")
+{
+  for (auto const size : {std::size_t(0), std::size_t(1), std::size_t(13), std::size_t(10007)}) {
+    check_batch<scheme::rusanov, double>(size);
+    check_batch<scheme::hll, double>(size);
+    check_batch<scheme::hllc, double>(size);
+    check_batch<scheme::roe, double>(size);
+    check_batch<scheme::hllc, float>(size);
+    check_batch<scheme::roe, float>(size);
+  }
+}
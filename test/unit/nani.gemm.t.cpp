@@ -0,0 +1,132 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/gemm.hpp>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/vector.hpp>
+#include <nani/view.hpp>
+#include <testmol/compat/catch_main.hpp>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/gemm")
+
+namespace {
+template <typename F, std::size_t R, std::size_t C>
+auto sample(F seed) -> nani::matrix<F, R, C>
+{
+  auto result = nani::matrix<F, R, C>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result[i][j] = seed * F(i + 1) - F(j) / F(C + 1);
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t R, std::size_t T, typename C>
+void check_product(C const& c, nani::matrix<F, R, T> const& expected)
+{
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < T; ++j) {
+      auto const e = expected[i][j];
+      REQUIRE(nani::abs(c[i][j] - e) <= F(1e-5) * (F(1) + nani::abs(e)));
+    }
+  }
+}
+
+template <typename F, std::size_t R, std::size_t S, std::size_t T>
+void check_shape()
+{
+  using nani::gemm::variant;
+  auto const a = sample<F, R, S>(F(0.5));
+  auto const b = sample<F, S, T>(F(-0.25));
+
+  auto expected = nani::matrix<F, R, T>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < T; ++j) {
+      auto sum = 0.0;
+      for (std::size_t k = 0; k < S; ++k) {
+        sum += double(a[i][k]) * double(b[k][j]);
+      }
+      expected[i][j] = F(sum);
+    }
+  }
+
+  for (auto const v :
+       {variant::inner, variant::outer, variant::unrolled, variant::packed, variant::tiled}) {
+    auto c = nani::matrix<F, R, T>::zero();
+    switch (v) {
+    case variant::inner:
+      nani::gemm::multiply<variant::inner>(a, b, c);
+      break;
+    case variant::outer:
+      nani::gemm::multiply<variant::outer>(a, b, c);
+      break;
+    case variant::unrolled:
+      nani::gemm::multiply<variant::unrolled>(a, b, c);
+      break;
+    case variant::packed:
+      nani::gemm::multiply<variant::packed>(a, b, c);
+      break;
+    case variant::tiled:
+      nani::gemm::multiply<variant::tiled>(a, b, c);
+      break;
+    }
+    check_product(c, expected);
+  }
+
+  check_product(a * b, expected);
+
+  // Views, which the packed variants handle through the fallback.
+  auto const bt = sample<F, T, S>(F(0.75));
+  auto c = nani::matrix<F, R, T>();
+  auto cv = nani::matrix_view<F, R, T>(c);
+  nani::gemm::multiply<variant::tiled>(a, nani::matrix_view<F const, T, S>(bt).transposed(), cv);
+  auto const reference = nani::matrix<F, S, T>(nani::matrix_view<F const, T, S>(bt).transposed());
+  auto expected_view = nani::matrix<F, R, T>();
+  nani::gemm::multiply<variant::inner>(a, reference, expected_view);
+  check_product(c, expected_view);
+}
+} // namespace
+
+TEST_CASE("variants", "[all]")
+{
+  check_shape<double, 1, 1, 1>();
+  check_shape<double, 3, 5, 7>();
+  check_shape<double, 4, 4, 4>();
+  check_shape<double, 5, 3, 16>();
+  check_shape<double, 9, 2, 9>();
+  check_shape<double, 16, 16, 16>();
+  check_shape<float, 2, 3, 1>();
+  check_shape<float, 4, 8, 12>();
+  check_shape<float, 7, 16, 16>();
+  check_shape<float, 16, 5, 17>();
+}
+
+TEST_CASE("tuned", "[all]")
+{
+  // Whichever variant is picked, the product is the same.
+  auto const a = sample<double, 6, 4>(1.0);
+  auto const b = sample<double, 4, 8>(2.0);
+  auto c = nani::matrix<double, 6, 8>();
+  auto d = nani::matrix<double, 6, 8>();
+  nani::gemm::multiply(a, b, c);
+  nani::gemm::multiply<nani::gemm::variant::inner>(a, b, d);
+  check_product(c, d);
+  REQUIRE(not nani::gemm::to_string(nani::gemm::tuned_v<double, 6, 4, 8>).empty());
+
+  // The constant-evaluated product takes the plain loops.
+  constexpr auto one = nani::matrix<double, 2, 2>::identity();
+  constexpr auto e = one * one;
+  static_assert(e[0][0] == 1.0 and e[0][1] == 0.0);
+}
+
+TEST_CASE("column", "[all]")
+{
+  auto const v = nani::vector<double, 3>(1.0, 2.0, 3.0);
+  auto const back = nani::vector<double, 3>(nani::matrix<double, 3, 1>(v));
+  REQUIRE(back == v);
+}
@@ -0,0 +1,159 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <limits>
+#include <nani/geometry.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/geometry")
+
+namespace {
+using point = nani::vector<double, 2>;
+using edge = nani::static_array<std::uint32_t, 2>;
+
+// Unit square split into two counter-clockwise cells, [0, 0.5] x [0, 1] and [0.5, 1] x [0, 1].
+auto const vertex = std::vector<point>{
+  point(0.0, 0.0),
+  point(0.5, 0.0),
+  point(1.0, 0.0),
+  point(0.0, 1.0),
+  point(0.5, 1.0),
+  point(1.0, 1.0)};
+} // namespace
+
+TEST_CASE("face_metrics", "[all]")
+{
+  constexpr auto tol = 4 * std::numeric_limits<double>::epsilon();
+  auto const face = std::vector<edge>{
+    edge(std::uint32_t{0}, std::uint32_t{2}), edge(std::uint32_t{1}, std::uint32_t{4})};
+
+  auto normal = nani::soa_field<double, 2>(face.size());
+  auto length = std::vector<double>(face.size());
+  nani::geometry::face_metrics<double, std::uint32_t>(vertex, face, normal.span(), length);
+
+  REQUIRE(nani::abs(length[0] - 1.0) < tol);
+  REQUIRE(nani::abs(length[1] - 1.0) < tol);
+  REQUIRE(normal.load(0) == point(-0.0, 1.0));
+  REQUIRE(normal.load(1) == point(-1.0, 0.0));
+
+  auto centroid = nani::soa_field<double, 2>(face.size());
+  nani::geometry::face_centroids<double, std::uint32_t>(vertex, face, centroid.span());
+  REQUIRE(centroid.load(0) == point(0.5, 0.0));
+  REQUIRE(centroid.load(1) == point(0.5, 0.5));
+}
+
+TEST_CASE("cell_metrics, fixed vertex count", "[all]")
+{
+  constexpr auto tol = 4 * std::numeric_limits<double>::epsilon();
+  using quad = nani::static_array<std::uint32_t, 4>;
+  auto const cell = std::vector<quad>{
+    quad(std::uint32_t{0}, std::uint32_t{1}, std::uint32_t{4}, std::uint32_t{3}),
+    quad(std::uint32_t{1}, std::uint32_t{2}, std::uint32_t{5}, std::uint32_t{4})};
+
+  auto area = std::vector<double>(cell.size());
+  auto centroid = nani::soa_field<double, 2>(cell.size());
+  nani::geometry::cell_metrics<double, std::uint32_t, 4>(vertex, cell, area, centroid.span());
+
+  REQUIRE(nani::abs(area[0] - 0.5) < tol);
+  REQUIRE(nani::abs(area[1] - 0.5) < tol);
+  REQUIRE(nani::l2_norm(centroid.load(0) - point(0.25, 0.5)) < tol);
+  REQUIRE(nani::l2_norm(centroid.load(1) - point(0.75, 0.5)) < tol);
+}
+
+TEST_CASE("cell_metrics, compressed row storage", "[all]")
+{
+  constexpr auto tol = 4 * std::numeric_limits<double>::epsilon();
+  // A triangle and the quad to its right, sharing the edge 1-4.
+  auto const offset = std::vector<std::uint32_t>{0, 3, 7};
+  auto const connectivity = std::vector<std::uint32_t>{0, 1, 4, 1, 2, 5, 4};
+
+  auto area = std::vector<double>(2);
+  auto centroid = nani::soa_field<double, 2>(2);
+  nani::geometry::cell_metrics<double, std::uint32_t>(
+    vertex, offset, connectivity, area, centroid.span());
+
+  REQUIRE(nani::abs(area[0] - 0.25) < tol);
+  REQUIRE(nani::abs(area[1] - 0.5) < tol);
+  REQUIRE(nani::l2_norm(centroid.load(0) - point(1.0 / 3.0, 1.0 / 3.0)) < tol);
+  REQUIRE(nani::l2_norm(centroid.load(1) - point(0.75, 0.5)) < tol);
+}
+
+TEST_CASE("tetrahedron and hexahedron volumes", "[all]")
+{
+  constexpr auto tol = 16 * std::numeric_limits<double>::epsilon();
+  using point3 = nani::vector<double, 3>;
+
+  constexpr auto tet = nani::geometry::tetrahedron_volume(
+    point3(0.0, 0.0, 0.0), point3(1.0, 0.0, 0.0), point3(0.0, 1.0, 0.0), point3(0.0, 0.0, 1.0));
+  static_assert(nani::abs(tet - 1.0 / 6.0) < tol);
+
+  // Parallelepiped spanned by (2, 0, 0), (1, 3, 0) and (0, 1, 4).
+  constexpr auto hex = nani::geometry::hexahedron_volume(nani::static_array<point3, 8>(
+    point3(0.0, 0.0, 0.0),
+    point3(2.0, 0.0, 0.0),
+    point3(3.0, 3.0, 0.0),
+    point3(1.0, 3.0, 0.0),
+    point3(0.0, 1.0, 4.0),
+    point3(2.0, 1.0, 4.0),
+    point3(3.0, 4.0, 4.0),
+    point3(1.0, 4.0, 4.0)));
+  static_assert(nani::abs(hex - 24.0) < 24.0 * tol);
+}
+
+TEST_CASE("face_area_vectors and cell_volumes", "[all]")
+{
+  constexpr auto tol = 16 * std::numeric_limits<double>::epsilon();
+  using point3 = nani::vector<double, 3>;
+  using quad = nani::static_array<std::uint32_t, 4>;
+
+  // Two unit cubes stacked along z, sharing the face 4-5-6-7.
+  auto vertex3 = std::vector<point3>();
+  for (double z = 0; z < 3; z += 1) {
+    vertex3.emplace_back(0.0, 0.0, z);
+    vertex3.emplace_back(1.0, 0.0, z);
+    vertex3.emplace_back(1.0, 1.0, z);
+    vertex3.emplace_back(0.0, 1.0, z);
+  }
+  auto const q = [](std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t d) {
+    return quad(a, b, c, d);
+  };
+  auto const face = std::vector<quad>{
+    q(0, 3, 2, 1), q(0, 1, 5, 4), q(1, 2, 6, 5), q(2, 3, 7, 6), q(3, 0, 4, 7), q(4, 5, 6, 7),
+    q(4, 5, 9, 8), q(5, 6, 10, 9), q(6, 7, 11, 10), q(7, 4, 8, 11), q(8, 9, 10, 11)};
+  auto const owner = std::vector<std::uint32_t>{0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1};
+  auto const offset = std::vector<std::uint32_t>{0, 6, 12};
+  auto const cell_face = std::vector<std::uint32_t>{0, 1, 2, 3, 4, 5, 5, 6, 7, 8, 9, 10};
+
+  auto area = nani::soa_field<double, 3>(face.size());
+  auto center = nani::soa_field<double, 3>(face.size());
+  nani::geometry::face_area_vectors<double, std::uint32_t, 4>(
+    vertex3, face, area.span(), center.span());
+  REQUIRE(nani::l2_norm(area.load(0) - point3(0.0, 0.0, -1.0)) < tol);
+  REQUIRE(nani::l2_norm(center.load(5) - point3(0.5, 0.5, 1.0)) < tol);
+
+  auto volume = std::vector<double>(2);
+  nani::geometry::cell_volumes<double, std::uint32_t>(
+    area.span(), center.span(), owner, offset, cell_face, volume);
+  REQUIRE(nani::abs(volume[0] - 1.0) < tol);
+  REQUIRE(nani::abs(volume[1] - 1.0) < tol);
+
+  // Cells without faces, in the middle and at the end, where no face follows in cell_face.
+  auto const sparse_owner = std::vector<std::uint32_t>{0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2};
+  auto const sparse_offset = std::vector<std::uint32_t>{0, 6, 6, 12, 12};
+  auto sparse_volume = std::vector<double>(4, -1.0);
+  nani::geometry::cell_volumes<double, std::uint32_t>(
+    area.span(), center.span(), sparse_owner, sparse_offset, cell_face, sparse_volume);
+  REQUIRE(nani::abs(sparse_volume[0] - 1.0) < tol);
+  REQUIRE(sparse_volume[1] == 0.0);
+  REQUIRE(nani::abs(sparse_volume[2] - 1.0) < tol);
+  REQUIRE(sparse_volume[3] == 0.0);
+}
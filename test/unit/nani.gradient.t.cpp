@@ -0,0 +1,157 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nani/gradient.hpp>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <utility>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/gradient")
+
+namespace {
+/* Cells of an n^D lattice with jittered centroids, each connected to its face neighbours. */
+template <typename F, std::size_t D>
+struct lattice {
+  nani::soa_field<F, D> centroid;
+  std::vector<std::int32_t> offset;
+  std::vector<std::int32_t> neighbour;
+};
+
+template <typename F, std::size_t D>
+auto make_lattice(std::size_t n) -> lattice<F, D>
+{
+  auto size = std::size_t(1);
+  for (std::size_t d = 0; d < D; ++d) {
+    size *= n;
+  }
+
+  auto result = lattice<F, D>{nani::soa_field<F, D>(size), {0}, {}};
+  for (std::size_t c = 0; c < size; ++c) {
+    auto stride = std::size_t(1);
+    for (std::size_t d = 0; d < D; ++d) {
+      auto const i = c / stride % n;
+      auto const jitter = F((c * 7 + d * 13) % 11) / F(40);
+      result.centroid.component(d)[c] = F(i) + jitter;
+      if (i > 0) {
+        result.neighbour.push_back(static_cast<std::int32_t>(c - stride));
+      }
+      if (i + 1 < n) {
+        result.neighbour.push_back(static_cast<std::int32_t>(c + stride));
+      }
+      stride *= n;
+    }
+    result.offset.push_back(static_cast<std::int32_t>(result.neighbour.size()));
+  }
+  return result;
+}
+
+template <typename F, std::size_t D>
+void check_linear(std::size_t n, nani::gradient::weighting weight, F tolerance)
+{
+  auto const mesh = make_lattice<F, D>(n);
+  auto const size = mesh.centroid.size();
+  auto const lsq = nani::gradient::least_squares(
+    mesh.centroid.span(),
+    std::span<std::int32_t const>(mesh.offset),
+    std::span<std::int32_t const>(mesh.neighbour),
+    weight);
+  REQUIRE(lsq.size() == size);
+
+  // Two linear fields, which least squares reproduces exactly.
+  auto u = nani::soa_field<F, 2>(size);
+  for (std::size_t c = 0; c < size; ++c) {
+    auto const x = mesh.centroid.load(c);
+    auto a = F(1);
+    auto b = F(-2);
+    for (std::size_t d = 0; d < D; ++d) {
+      a += F(d + 1) * x[d];
+      b += F(0.5) * x[d] * F(d % 2 == 0 ? 1 : -1);
+    }
+    u.store(c, nani::vector<F, 2>(a, b));
+  }
+
+  auto gradient = nani::soa_field<F, 2 * D>(size);
+  lsq.apply(std::as_const(u).span(), gradient.span());
+
+  for (std::size_t c = 0; c < size; ++c) {
+    auto const single = lsq.evaluate(std::as_const(u).span(), c);
+    for (std::size_t d = 0; d < D; ++d) {
+      auto const a = F(d + 1);
+      auto const b = F(0.5) * F(d % 2 == 0 ? 1 : -1);
+      REQUIRE(nani::abs(gradient.component(d)[c] - a) <= tolerance);
+      REQUIRE(nani::abs(gradient.component(D + d)[c] - b) <= tolerance);
+      REQUIRE(nani::abs(single[0][d] - gradient.component(d)[c]) <= tolerance);
+      REQUIRE(nani::abs(single[1][d] - gradient.component(D + d)[c]) <= tolerance);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("linear", "[all]")
+{
+  using nani::gradient::weighting;
+  check_linear<double, 2>(37, weighting::inverse_distance, 1e-10);
+  check_linear<double, 2>(5, weighting::uniform, 1e-10);
+  check_linear<double, 3>(11, weighting::inverse_distance, 1e-10);
+  check_linear<float, 3>(9, weighting::uniform, 1e-3F);
+  check_linear<double, 1>(100, weighting::uniform, 1e-10);
+}
+
+TEST_CASE("inverse", "[all]")
+{
+  auto const mesh = make_lattice<double, 3>(4);
+  auto const lsq = nani::gradient::least_squares(
+    mesh.centroid.span(),
+    std::span<std::int32_t const>(mesh.offset),
+    std::span<std::int32_t const>(mesh.neighbour),
+    nani::gradient::weighting::uniform);
+
+  for (std::size_t c = 0; c < mesh.centroid.size(); ++c) {
+    auto m = nani::matrix<double, 3, 3>::zero();
+    for (auto k = mesh.offset[c]; k < mesh.offset[c + 1]; ++k) {
+      auto const dx = mesh.centroid.load(static_cast<std::size_t>(mesh.neighbour[k]))
+                      - mesh.centroid.load(c);
+      m = m + nani::outer(dx, dx);
+    }
+    auto const identity = lsq.inverse(c) * m;
+    for (std::size_t i = 0; i < 3; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        REQUIRE(nani::abs(identity[i][j] - (i == j ? 1.0 : 0.0)) <= 1e-12);
+      }
+    }
+  }
+}
+
+TEST_CASE("degenerate", "[all]")
+{
+  // Three cells on a line in 2D: the neighbours do not span the plane.
+  auto centroid = nani::soa_field<double, 2>(3);
+  for (std::size_t c = 0; c < 3; ++c) {
+    centroid.store(c, nani::vector<double, 2>(double(c), 2.0 * double(c)));
+  }
+  auto const offset = std::vector<std::int32_t>{0, 1, 3, 4};
+  auto const neighbour = std::vector<std::int32_t>{1, 0, 2, 1};
+  auto const lsq = nani::gradient::least_squares(
+    std::as_const(centroid).span(),
+    std::span<std::int32_t const>(offset),
+    std::span<std::int32_t const>(neighbour));
+
+  auto u = nani::soa_field<double, 1>(3);
+  for (std::size_t c = 0; c < 3; ++c) {
+    u.component(0)[c] = double(c);
+  }
+  auto gradient = nani::soa_field<double, 2>(3);
+  lsq.apply(std::as_const(u).span(), gradient.span());
+  for (std::size_t c = 0; c < 3; ++c) {
+    REQUIRE(lsq.inverse(c)[0][0] == 0.0);
+    REQUIRE(gradient.load(c) == nani::vector<double, 2>());
+  }
+}
@@ -0,0 +1,188 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <nani/indirect.hpp>
+#include <nani/parallel.hpp>
+#include <nani/soa.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/indirect")
+
+namespace {
+// Use a pool also on single-core runners; read by nani::thread_count() on first use.
+auto const threads = setenv("NANI_NUM_THREADS", "4", 1); // NOLINT(concurrency-mt-unsafe)
+
+using state = nani::vector<double, 3>;
+using edge = nani::static_array<std::uint32_t, 2>;
+
+auto make_field(std::size_t n) -> std::vector<state>
+{
+  auto field = std::vector<state>(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto const x = static_cast<double>(i);
+    field[i] = state(x, 10 * x, 100 * x);
+  }
+  return field;
+}
+
+// k-th index of a scattered access pattern into n cells.
+auto scattered(std::size_t k, std::size_t n) -> std::uint32_t
+{
+  return static_cast<std::uint32_t>((7919 * k + 3) % n);
+}
+
+// A ring of n cells, edge i connecting cell i and cell i + 1.
+auto make_ring(std::size_t n) -> std::vector<edge>
+{
+  auto ring = std::vector<edge>(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    ring[i] = edge(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>((i + 1) % n));
+  }
+  return ring;
+}
+} // namespace
+
+TEST_CASE("gather", "[all]")
+{
+  auto const field = make_field(100);
+  auto index = std::vector<std::uint32_t>(37);
+  for (std::size_t k = 0; k < index.size(); ++k) {
+    index[k] = static_cast<std::uint32_t>((7 * k + 3) % field.size());
+  }
+
+  auto out = nani::soa_field<double, 3>(index.size());
+  nani::indirect::gather<double, 3, std::uint32_t>(field, index, out.span());
+  for (std::size_t k = 0; k < index.size(); ++k) {
+    REQUIRE(out.load(k) == field[index[k]]);
+  }
+
+  // Several grains, so that the threads each gather part of the range, with 32 bit indices for
+  // the hardware gathers and 64 bit ones for the portable loop.
+  REQUIRE(threads == 0);
+  REQUIRE(nani::thread_count() > 1);
+  auto const large = make_field(50000);
+  auto index32 = std::vector<std::uint32_t>(3 * nani::indirect::grain + 5);
+  auto index64 = std::vector<std::int64_t>(index32.size());
+  for (std::size_t k = 0; k < index32.size(); ++k) {
+    index32[k] = scattered(k, large.size());
+    index64[k] = static_cast<std::int64_t>(index32[k]);
+  }
+  auto out32 = nani::soa_field<double, 3>(index32.size());
+  auto out64 = nani::soa_field<double, 3>(index64.size());
+  nani::indirect::gather<double, 3, std::uint32_t>(large, index32, out32.span());
+  nani::indirect::gather<double, 3, std::int64_t>(large, index64, out64.span());
+  auto mismatch = std::size_t(0);
+  for (std::size_t k = 0; k < index32.size(); ++k) {
+    mismatch += out32.load(k) == large[index32[k]] and out64.load(k) == large[index32[k]] ? 0 : 1;
+  }
+  REQUIRE(mismatch == 0);
+
+  auto const ring = make_ring(field.size());
+  auto left = nani::soa_field<double, 3>(ring.size());
+  auto right = nani::soa_field<double, 3>(ring.size());
+  nani::indirect::gather<double, 3, std::uint32_t>(field, ring, left.span(), right.span());
+  for (std::size_t e = 0; e < ring.size(); ++e) {
+    REQUIRE(left.load(e) == field[ring[e][0]]);
+    REQUIRE(right.load(e) == field[ring[e][1]]);
+  }
+}
+
+TEST_CASE("colour", "[all]")
+{
+  auto const ring = make_ring(101);
+  auto const colour = nani::indirect::colour<std::uint32_t, 2>(ring, 101);
+
+  REQUIRE(colour.ncolour() == 3);
+  REQUIRE(colour.order.size() == ring.size());
+  for (std::size_t c = 0; c < colour.ncolour(); ++c) {
+    auto touched = std::vector<bool>(101, false);
+    for (auto j = colour.offset[c]; j < colour.offset[c + 1]; ++j) {
+      for (auto const cell : ring[colour.order[j]]) {
+        REQUIRE(not touched[cell]);
+        touched[cell] = true;
+      }
+    }
+  }
+}
+
+TEST_CASE("colour past 64 colours", "[all]")
+{
+  // A star: every edge touches cell 0, so that each one needs a colour of its own and the
+  // colouring runs several rounds of 64.
+  auto star = std::vector<edge>(200);
+  for (std::size_t i = 0; i < star.size(); ++i) {
+    star[i] = edge(std::uint32_t{0}, static_cast<std::uint32_t>(i + 1));
+  }
+  auto const colour = nani::indirect::colour<std::uint32_t, 2>(star, star.size() + 1);
+
+  REQUIRE(colour.ncolour() == star.size());
+  auto seen = std::vector<bool>(star.size(), false);
+  for (std::size_t c = 0; c < colour.ncolour(); ++c) {
+    REQUIRE(colour.offset[c + 1] == colour.offset[c] + 1);
+    auto const e = colour.order[colour.offset[c]];
+    REQUIRE(not seen[e]);
+    seen[e] = true;
+  }
+}
+
+TEST_CASE("scatter_add and scatter_flux", "[all]")
+{
+  auto const n = std::size_t{64};
+  auto const ring = make_ring(n);
+  auto value = nani::soa_field<double, 3>(n);
+  for (std::size_t e = 0; e < n; ++e) {
+    value.store(e, state::fill(static_cast<double>(e)));
+  }
+
+  auto const colour = nani::indirect::colour<std::uint32_t, 2>(ring, n);
+  auto field = std::vector<state>(n, state::fill(0.0));
+  nani::indirect::scatter_flux<double, 3, std::uint32_t>(value.span(), ring, colour, field);
+  // Cell i receives +i from edge i and -(i - 1) from edge i - 1.
+  REQUIRE(field[0] == state::fill(-static_cast<double>(n - 1)));
+  for (std::size_t i = 1; i < n; ++i) {
+    REQUIRE(field[i] == state::fill(1.0));
+  }
+
+  auto index = std::vector<std::uint32_t>(n, 0);
+  auto expected = state::fill(field[0][0]);
+  for (std::size_t e = 0; e < n; ++e) {
+    expected += value.load(e);
+  }
+  nani::indirect::scatter_add<double, 3, std::uint32_t>(value.span(), index, field);
+  REQUIRE(field[0] == expected);
+}
+
+TEST_CASE("coloured scatter_add", "[all]")
+{
+  // Two colours of more than a grain each, so that every colour is split among the threads.
+  auto const ncell = 2 * nani::indirect::grain + 7;
+  auto const nitem = 2 * ncell;
+  auto index = std::vector<std::uint32_t>(nitem);
+  auto target = std::vector<nani::static_array<std::uint32_t, 1>>(nitem);
+  auto value = nani::soa_field<double, 3>(nitem);
+  for (std::size_t k = 0; k < nitem; ++k) {
+    index[k] = scattered(k, ncell);
+    target[k] = nani::static_array<std::uint32_t, 1>(index[k]);
+    value.store(k, state(1.0, static_cast<double>(k), -2.0));
+  }
+  auto const colour = nani::indirect::colour<std::uint32_t, 1>(target, ncell);
+  REQUIRE(colour.ncolour() == 2);
+
+  auto expected = std::vector<state>(ncell, state::fill(0.0));
+  nani::indirect::scatter_add<double, 3, std::uint32_t>(value.span(), index, expected);
+  auto field = std::vector<state>(ncell, state::fill(0.0));
+  nani::indirect::scatter_add<double, 3, std::uint32_t>(value.span(), index, colour, field);
+  auto mismatch = std::size_t(0);
+  for (std::size_t i = 0; i < ncell; ++i) {
+    mismatch += field[i] == expected[i] ? 0 : 1;
+  }
+  REQUIRE(mismatch == 0);
+}
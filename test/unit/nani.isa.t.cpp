@@ -0,0 +1,31 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/isa.hpp>
+#include <testmol/compat/catch_main.hpp>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/isa")
+
+TEST_CASE("isa-properties", "[all]")
+{
+  static_assert(nani::register_bytes(nani::isa::avx512) == 64);
+  static_assert(nani::register_bytes(nani::isa::avx2) == 32);
+  static_assert(nani::register_bytes(nani::isa::generic) == 16);
+  static_assert(nani::isa_width_v<nani::isa::avx2, float> == 8);
+  static_assert(nani::isa_width_v<nani::isa::avx512, double> == 8);
+  static_assert(nani::to_string(nani::isa::sse4_2) == "sse4.2");
+  static_assert(nani::isa::generic < nani::isa::avx512);
+}
+
+TEST_CASE("isa-selection", "[all]")
+{
+  // The library may be selected below what the processor supports, never above.
+  REQUIRE(nani::active_isa() <= nani::detected_isa());
+  REQUIRE(nani::active_isa() == nani::active_isa());
+
+  // A translation unit compiled for an instruction set can only run where it is supported.
+  REQUIRE(nani::compiled_isa <= nani::detected_isa());
+}
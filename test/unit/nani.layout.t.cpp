@@ -0,0 +1,61 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/layout.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <utility>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/layout")
+
+namespace {
+template <typename F, std::size_t N>
+auto round_trip(std::size_t size) -> bool
+{
+  auto aos = std::vector<nani::vector<F, N>>(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    for (std::size_t c = 0; c < N; ++c) {
+      aos[i][c] = static_cast<F>(i * N + c);
+    }
+  }
+
+  auto soa = nani::soa_field<F, N>(size);
+  nani::layout::to_soa(std::span<nani::vector<F, N> const>(aos), soa.span());
+  for (std::size_t c = 0; c < N; ++c) {
+    for (std::size_t i = 0; i < size; ++i) {
+      if (soa.component(c)[i] != static_cast<F>(i * N + c)) {
+        return false;
+      }
+    }
+  }
+
+  auto back = std::vector<nani::vector<F, N>>(size);
+  nani::layout::to_aos(nani::soa_span<F const, N>(soa.span()), std::span(back));
+  return back == aos;
+}
+
+template <typename F, std::size_t... N>
+auto round_trip_all(std::size_t size, std::index_sequence<N...> /*unused*/) -> bool
+{
+  return (round_trip<F, N + 2>(size) and ...);
+}
+} // namespace
+
+TEST_CASE("layout-round-trip", "[all]")
+{
+  for (std::size_t size : {std::size_t{0}, std::size_t{3}, std::size_t{61}, std::size_t{40000}}) {
+    REQUIRE(round_trip_all<double>(size, std::make_index_sequence<7>()));
+    REQUIRE(round_trip_all<float>(size, std::make_index_sequence<7>()));
+  }
+}
+
+TEST_CASE("layout-streaming", "[all]")
+{
+  constexpr std::size_t size = nani::layout::streaming_bytes / (3 * sizeof(double)) + 123;
+  REQUIRE(round_trip<double, 3>(size));
+}
@@ -0,0 +1,105 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <nani/limiter.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <utility>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/limiter")
+
+namespace {
+using nani::limiter::kind;
+
+/* The textbook definitions, with branches. */
+template <kind K>
+auto reference(double a, double b) -> double
+{
+  if (a * b <= 0.0) {
+    return 0.0;
+  }
+  auto const s = a > 0.0 ? 1.0 : -1.0;
+  auto const x = nani::abs(a);
+  auto const y = nani::abs(b);
+  switch (K) {
+  case kind::minmod:
+    return s * std::min(x, y);
+  case kind::van_leer:
+    return 2.0 * a * b / (a + b);
+  case kind::superbee:
+    return s * std::max(std::min(2.0 * x, y), std::min(x, 2.0 * y));
+  default:
+    return s * std::min({2.0 * x, 2.0 * y, 0.5 * (x + y)});
+  }
+}
+
+template <kind K>
+void check_scalar()
+{
+  auto const values = {-3.0, -1.0, -0.25, 0.0, 0.5, 1.0, 2.5};
+  for (auto const a : values) {
+    for (auto const b : values) {
+      auto const limited = nani::limiter::limit<K>(a, b);
+      REQUIRE(nani::abs(limited - reference<K>(a, b)) <= 1e-15);
+      // Symmetric in its arguments.
+      REQUIRE(limited == nani::limiter::limit<K>(b, a));
+    }
+  }
+}
+
+template <kind K>
+void check_batch(std::size_t size)
+{
+  auto backward = nani::soa_field<double, 3>(size);
+  auto forward = nani::soa_field<double, 3>(size);
+  auto slope = nani::soa_field<double, 3>(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const x = static_cast<double>(i % 11) - 5.0;
+    backward.store(i, nani::vector<double, 3>(x, 0.5 * x, -x));
+    forward.store(i, nani::vector<double, 3>(1.0, x * x - 4.0, 0.25 * x));
+  }
+
+  nani::limiter::apply<K>(
+    std::as_const(backward).span(), std::as_const(forward).span(), slope.span());
+
+  for (std::size_t i = 0; i < size; ++i) {
+    REQUIRE(slope.load(i) == nani::limiter::limit<K>(backward.load(i), forward.load(i)));
+  }
+}
+} // namespace
+
+TEST_CASE("scalar", "[all]")
+{
+  static_assert(nani::limiter::minmod(1.0, 3.0) == 1.0);
+  static_assert(nani::limiter::superbee(1.0, 3.0) == 2.0);
+  static_assert(nani::limiter::mc(-1.0, -3.0) == -2.0);
+  static_assert(nani::limiter::van_leer(0.0, 0.0) == 0.0);
+
+  check_scalar<kind::minmod>();
+  check_scalar<kind::van_leer>();
+  check_scalar<kind::superbee>();
+  check_scalar<kind::mc>();
+}
+
+TEST_CASE("vector", "[all]")
+{
+  constexpr auto a = nani::vector<double, 3>(1.0, -1.0, 2.0);
+  constexpr auto b = nani::vector<double, 3>(3.0, 1.0, 2.0);
+  static_assert(
+    nani::limiter::limit<kind::minmod>(a, b) == nani::vector<double, 3>(1.0, 0.0, 2.0));
+}
+
+TEST_CASE("batched", "[all]")
+{
+  for (auto const size : {std::size_t(0), std::size_t(5), std::size_t(20001)}) {
+    check_batch<kind::minmod>(size);
+    check_batch<kind::van_leer>(size);
+    check_batch<kind::superbee>(size);
+    check_batch<kind::mc>(size);
+  }
+}
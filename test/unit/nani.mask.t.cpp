@@ -0,0 +1,109 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/mask.hpp>
+#include <nani/pack.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <type_traits>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/mask")
+
+TEST_CASE("elementwise", "[all]")
+{
+  constexpr auto a = nani::vector<double, 4>(1.0, -2.0, 0.0, 4.0);
+  constexpr auto b = nani::vector<double, 4>(-1.0, 3.0, 0.0, 4.0);
+
+  static_assert(nani::abs(a) == nani::vector<double, 4>(1.0, 2.0, 0.0, 4.0));
+  static_assert(nani::sign(a) == nani::vector<double, 4>(1.0, -1.0, 0.0, 1.0));
+  static_assert(nani::min(a, b) == nani::vector<double, 4>(-1.0, -2.0, 0.0, 4.0));
+  static_assert(nani::max(a, b) == nani::vector<double, 4>(1.0, 3.0, 0.0, 4.0));
+  static_assert(nani::hadamard(a, b) == nani::vector<double, 4>(-1.0, -6.0, 0.0, 16.0));
+
+  // The scalar overloads are still picked for scalars.
+  static_assert(nani::max(1.0, 2.0) == 2.0 and nani::min(1, 2) == 1 and nani::abs(-3) == 3);
+}
+
+TEST_CASE("mask", "[all]")
+{
+  constexpr auto a = nani::vector<double, 4>(1.0, -2.0, 0.0, 4.0);
+  constexpr auto b = nani::vector<double, 4>(-1.0, 3.0, 0.0, 4.0);
+
+  constexpr auto lt = nani::less(a, b);
+  static_assert(not lt[0] and lt[1] and not lt[2] and not lt[3]);
+  static_assert(nani::count(nani::equal(a, b)) == 2);
+  static_assert(nani::all(nani::less_equal(a, b) | nani::greater(a, b)));
+  static_assert(nani::none(nani::less(a, b) & nani::greater_equal(a, b)));
+  static_assert(nani::all(nani::not_equal(a, b) ^ nani::equal(a, b)));
+  static_assert(nani::any(!lt) and not nani::all(!lt));
+  static_assert(nani::count(nani::mask<3>::fill(true)) == 3);
+
+  static_assert(nani::select(lt, a, b) == nani::vector<double, 4>(-1.0, -2.0, 0.0, 4.0));
+  static_assert(nani::select(!lt, a, b) == nani::max(a, b));
+}
+
+TEST_CASE("vector of packs", "[all]")
+{
+  using pack = nani::pack<double, nani::simd_width_v<double>>;
+  auto const a = nani::vector<pack, 2>(pack(-1.5), pack(2.0));
+  auto const b = nani::vector<pack, 2>(pack(0.5), pack(-3.0));
+
+  auto const low = nani::min(a, b);
+  auto const magnitude = nani::abs(b);
+  auto const direction = nani::sign(a);
+  for (std::size_t k = 0; k < pack::width; ++k) {
+    REQUIRE(low[0][k] == -1.5);
+    REQUIRE(low[1][k] == -3.0);
+    REQUIRE(magnitude[1][k] == 3.0);
+    REQUIRE(direction[0][k] == -1.0);
+  }
+}
+
+TEST_CASE("mask of packs", "[all]")
+{
+  using pack = nani::pack<double, nani::simd_width_v<double>>;
+  auto x = pack();
+  auto y = pack();
+  for (std::size_t k = 0; k < pack::width; ++k) {
+    x.set(k, static_cast<double>(k));
+    y.set(k, 1.0);
+  }
+
+  // Lane-wise comparisons and a blend.
+  auto const lane = x < y;
+  REQUIRE(lane[0]);
+  REQUIRE(nani::count(lane) == 1);
+  REQUIRE(nani::count(x >= y) == pack::width - 1);
+  REQUIRE(nani::all((x <= y) | (x > y)));
+  REQUIRE(nani::none((x == y) & (x != y)));
+  REQUIRE(nani::any(!lane));
+  auto const picked = nani::select(lane, x, y);
+  for (std::size_t k = 0; k < pack::width; ++k) {
+    REQUIRE(picked[k] == (k == 0 ? 0.0 : 1.0));
+  }
+
+  // Component-wise on a vector of packs: a mask per lane of every component.
+  auto const a = nani::vector<pack, 2>(x, pack(2.0));
+  auto const b = nani::vector<pack, 2>(y, pack(-3.0));
+  auto const m = nani::less(a, b);
+  using mask = nani::mask<2, nani::pack_mask<double, pack::width>>;
+  static_assert(std::is_same_v<decltype(m), mask const>);
+  REQUIRE(nani::count(m) == 1);
+  REQUIRE(nani::count(nani::greater(a, b)) == 2 * pack::width - 2);
+  REQUIRE(nani::all(nani::less_equal(a, b) | nani::greater(a, b)));
+  REQUIRE(nani::none(nani::equal(a, b) & nani::not_equal(a, b)));
+  REQUIRE(not nani::all(nani::greater_equal(a, b)));
+
+  auto const low = nani::select(m, a, b);
+  auto const high = nani::select(!m, a, b);
+  for (std::size_t k = 0; k < pack::width; ++k) {
+    REQUIRE(low[0][k] == (k == 0 ? 0.0 : 1.0));
+    REQUIRE(low[1][k] == -3.0);
+    REQUIRE(high[0][k] == static_cast<double>(k == 0 ? 1 : k));
+    REQUIRE(high[1][k] == 2.0);
+  }
+  REQUIRE(nani::count(mask::fill(true)) == 2 * pack::width);
+}
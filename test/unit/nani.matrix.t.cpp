@@ -0,0 +1,127 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/static_array.hpp>
+#include <nani/vector.hpp>
+#include <numbers>
+#include <testmol/compat/catch_main.hpp>
+#include <testnani/matrix.hpp>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/matrix")
+
+namespace {
+using testnani::check_equal;
+
+using vector3 = nani::vector<double, 3>;
+using matrix3 = nani::matrix<double, 3, 3>;
+
+auto transposed(matrix3 const& a) -> matrix3
+{
+  auto result = matrix3();
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      result[i][j] = a[j][i];
+    }
+  }
+  return result;
+}
+
+// Orthogonal with determinant 1.
+void check_rotation(matrix3 const& q)
+{
+  check_equal(q * transposed(q), matrix3::identity(), 1e-14);
+  REQUIRE(nani::abs(nani::determinant(q) - 1.0) <= 1e-14);
+}
+} // namespace
+
+TEST_CASE("sin and cos", "[all]")
+{
+  // The series of constant evaluation agree with the library functions.
+  constexpr auto pi = std::numbers::pi;
+  constexpr auto s = nani::sin(pi / 6);
+  constexpr auto c = nani::cos(pi / 3);
+  constexpr auto far = nani::sin(10.0 * pi + 0.25);
+  static_assert(s > 0.5 - 1e-14 and s < 0.5 + 1e-14);
+  static_assert(c > 0.5 - 1e-14 and c < 0.5 + 1e-14);
+  REQUIRE(nani::abs(far - nani::sin(0.25)) <= 1e-13);
+  for (auto const x : {-7.5, -1.0, 0.0, 0.3, 2.0, 4.0}) {
+    REQUIRE(nani::abs(nani::sin(x) * nani::sin(x) + nani::cos(x) * nani::cos(x) - 1.0) <= 1e-15);
+  }
+}
+
+TEST_CASE("cross_matrix", "[all]")
+{
+  auto const a = vector3(0.5, -2.0, 3.0);
+  auto const b = vector3(4.0, 1.0, -1.5);
+  check_equal(nani::cross_matrix(a) * b, a ^ b, 1e-15);
+  check_equal(transposed(nani::cross_matrix(a)), -1.0 * nani::cross_matrix(a), 0.0);
+}
+
+TEST_CASE("rotation", "[all]")
+{
+  auto const axis = normalize(vector3(1.0, 2.0, -2.0));
+  auto const q = nani::rotation(axis, 0.7);
+  check_rotation(q);
+  check_equal(q * axis, axis, 1e-15);
+  check_equal(nani::rotation(axis, 0.0), matrix3::identity(), 0.0);
+
+  // A quarter turn about z takes x to y.
+  auto const z = nani::rotation(vector3::unit(2), std::numbers::pi / 2);
+  check_equal(z * vector3::unit(0), vector3::unit(1), 1e-15);
+}
+
+TEST_CASE("frame", "[all]")
+{
+  auto const normal = std::array<vector3, 3>{
+    vector3(1.0, 0.0, 0.0),
+    normalize(vector3(0.3, -0.4, 0.8)),
+    normalize(vector3(-1.0, 1e-9, 2.0))};
+  for (auto const& n : normal) {
+    auto const f = nani::frame(n);
+    check_rotation(f);
+    // The normal is the first coordinate in the frame.
+    check_equal(f * n, vector3::unit(0), 1e-15);
+  }
+}
+
+TEST_CASE("vector conversion", "[all]")
+{
+  constexpr auto v = nani::vector<double, 3>(1.0, -2.0, 4.0);
+  constexpr auto row = nani::matrix<double, 1, 3>(v);
+  constexpr auto column = nani::matrix<double, 3, 1>(v);
+  static_assert(row[0][2] == 4.0 and column[1][0] == -2.0);
+  static_assert(nani::vector<double, 3>(row) == v);
+  static_assert(nani::vector<double, 3>(column) == v);
+}
+
+TEST_CASE("adjugate and inverse", "[all]")
+{
+  auto const a1 = nani::matrix<double, 1, 1>(4.0);
+  auto a2 = nani::matrix<double, 2, 2>();
+  a2[0] = nani::static_array<double, 2>(3.0, 1.0);
+  a2[1] = nani::static_array<double, 2>(-2.0, 5.0);
+  auto a3 = matrix3();
+  a3[0] = nani::static_array<double, 3>(2.0, -1.0, 0.5);
+  a3[1] = nani::static_array<double, 3>(1.0, 3.0, -2.0);
+  a3[2] = nani::static_array<double, 3>(0.0, 4.0, 1.0);
+
+  // a * adjugate(a) == determinant(a) * I, for every size.
+  check_equal(a1 * nani::adjugate(a1), nani::matrix<double, 1, 1>(1.0) * 4.0, 0.0);
+  check_equal(a2 * nani::adjugate(a2), 17.0 * nani::matrix<double, 2, 2>::identity(), 0.0);
+  auto const det = nani::determinant(a3);
+  check_equal(a3 * nani::adjugate(a3), det * matrix3::identity(), 1e-13);
+  check_equal(nani::adjugate(a3) * a3, det * matrix3::identity(), 1e-13);
+
+  check_equal(nani::inverse(a1), nani::matrix<double, 1, 1>(0.25), 0.0);
+  check_equal(a2 * nani::inverse(a2), nani::matrix<double, 2, 2>::identity(), 1e-15);
+  check_equal(a3 * nani::inverse(a3), matrix3::identity(), 1e-15);
+  check_equal(nani::inverse(a3) * a3, matrix3::identity(), 1e-15);
+  check_equal(nani::inverse(nani::inverse(a3)), a3, 1e-14);
+}
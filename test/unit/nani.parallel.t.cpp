@@ -0,0 +1,77 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <nani/parallel.hpp>
+#include <stdexcept>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/parallel")
+
+namespace {
+// Use a pool also on single-core runners; read by nani::thread_count() on first use.
+auto const threads = setenv("NANI_NUM_THREADS", "4", 1); // NOLINT(concurrency-mt-unsafe)
+} // namespace
+
+TEST_CASE("parallel_for", "[all]")
+{
+  REQUIRE(threads == 0);
+  REQUIRE(nani::thread_count() > 1);
+
+  SECTION("covers the range once, in grain-aligned chunks")
+  {
+    // Repeated calls reuse the same pool.
+    for (std::size_t repeat = 0; repeat < 100; ++repeat) {
+      auto const n = std::size_t{1000} + repeat;
+      auto hit = std::vector<std::atomic<int>>(n);
+      nani::parallel_for(n, 16, [&](std::size_t begin, std::size_t end) {
+        if (begin % 16 != 0) {
+          throw std::logic_error("misaligned chunk");
+        }
+        for (auto i = begin; i < end; ++i) {
+          hit[i].fetch_add(1);
+        }
+      });
+      for (auto const& h : hit) {
+        REQUIRE(h.load() == 1);
+      }
+    }
+  }
+
+  SECTION("nested calls run on the calling thread")
+  {
+    std::atomic<std::size_t> total{0};
+    nani::parallel_for(64, 1, [&](std::size_t begin, std::size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        nani::parallel_for(100, 1, [&](std::size_t first, std::size_t last) {
+          total.fetch_add(last - first);
+        });
+      }
+    });
+    REQUIRE(total.load() == 6400);
+  }
+
+  SECTION("an exception in a worker reaches the caller")
+  {
+    auto const run = []() {
+      nani::parallel_for(10000, 10, [](std::size_t begin, std::size_t) {
+        if (begin == 5000) {
+          throw std::runtime_error("chunk failed");
+        }
+      });
+    };
+    REQUIRE_THROWS_AS(run(), std::runtime_error);
+
+    // The pool is still usable afterwards.
+    std::atomic<std::size_t> total{0};
+    nani::parallel_for(10000, 10, [&](std::size_t begin, std::size_t end) {
+      total.fetch_add(end - begin);
+    });
+    REQUIRE(total.load() == 10000);
+  }
+}
@@ -0,0 +1,107 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/gas.hpp>
+#include <nani/primitive.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/primitive")
+
+namespace {
+template <typename F, std::size_t N>
+auto close(nani::vector<F, N> const& a, nani::vector<F, N> const& b, F tolerance) -> bool
+{
+  for (std::size_t c = 0; c < N; ++c) {
+    if (nani::abs(a[c] - b[c]) > tolerance * (F(1) + nani::abs(b[c]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename F, std::size_t N, typename Gas>
+auto sample(std::size_t i, Gas const& gas) -> nani::vector<F, N>
+{
+  auto const x = F(i % 23) / F(23);
+  auto w = nani::vector<F, N>();
+  w[0] = F(1) + x;
+  for (std::size_t d = 1; d + 1 < N; ++d) {
+    w[d] = F(d) * (x - F(0.5));
+  }
+  w[N - 1] = F(1) + F(2) * x;
+  return nani::primitive::to_conservative(w, gas);
+}
+
+template <typename F, std::size_t N, typename Gas>
+void check_batch(std::size_t size, Gas const& gas)
+{
+  auto u = nani::soa_field<F, N>(size);
+  auto w = nani::soa_field<F, N>(size);
+  auto sound = std::vector<F>(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    u.store(i, sample<F, N>(i, gas));
+  }
+
+  auto const fastest = nani::primitive::from_conservative(
+    std::as_const(u).span(), gas, w.span(), std::span<F>(sound));
+
+  auto const tolerance = std::is_same_v<F, float> ? F(1e-5) : F(1e-13);
+  auto expected = F(0);
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const wi = nani::primitive::from_conservative(u.load(i), gas);
+    REQUIRE(close(w.load(i), wi, tolerance));
+    REQUIRE(nani::abs(sound[i] - gas.sound_speed(wi[0], wi[N - 1])) <= tolerance * sound[i]);
+    expected = nani::max(expected, nani::primitive::wave_speed(wi, gas));
+  }
+  REQUIRE(nani::abs(fastest - expected) <= tolerance * expected);
+
+  // Back in place.
+  nani::primitive::to_conservative(std::as_const(w).span(), gas, w.span());
+  for (std::size_t i = 0; i < size; ++i) {
+    REQUIRE(close(w.load(i), u.load(i), tolerance));
+  }
+}
+} // namespace
+
+TEST_CASE("point", "[all]")
+{
+  constexpr auto gas = nani::ideal_gas<double>();
+  constexpr auto w = nani::vector<double, 4>(2.0, 1.0, -3.0, 0.8);
+  constexpr auto u = nani::primitive::to_conservative(w, gas);
+  static_assert(u[1] == 2.0 and u[2] == -6.0);
+  static_assert(u[3] == gas.internal_energy(2.0, 0.8) + 10.0);
+  REQUIRE(close(nani::primitive::from_conservative(u, gas), w, 1e-15));
+
+  // A stiffened gas without stiffening is the ideal gas.
+  auto const air = nani::stiffened_gas<double>{1.4, 0.0};
+  REQUIRE(close(nani::primitive::to_conservative(w, air), u, 1e-15));
+
+  auto const liquid = nani::stiffened_gas<double>();
+  auto const state = nani::vector<double, 5>(1000.0, 1.0, 2.0, -2.0, 1e5);
+  auto const back = nani::primitive::from_conservative(
+    nani::primitive::to_conservative(state, liquid), liquid);
+  REQUIRE(close(back, state, 1e-12));
+  REQUIRE(nani::primitive::wave_speed(state, liquid) > 1600.0);
+}
+
+TEST_CASE("batched", "[all]")
+{
+  auto const ideal = nani::ideal_gas<double>();
+  auto const stiffened = nani::stiffened_gas<double>{4.4, 0.5};
+  for (auto const size : {std::size_t(0), std::size_t(3), std::size_t(29), std::size_t(20011)}) {
+    check_batch<double, 4>(size, ideal);
+    check_batch<double, 5>(size, ideal);
+    check_batch<double, 4>(size, stiffened);
+    check_batch<float, 4>(size, nani::ideal_gas<float>());
+    check_batch<float, 5>(size, nani::stiffened_gas<float>{4.4F, 0.5F});
+    check_batch<double, 3>(size, ideal);
+  }
+}
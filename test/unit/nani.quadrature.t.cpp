@@ -0,0 +1,100 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <limits>
+#include <nani/quadrature.hpp>
+#include <nani/smath.hpp>
+#include <testmol/compat/catch_main.hpp>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/quadrature")
+
+namespace {
+/* Integral of x^k over [-1, 1] with the rule r. */
+template <typename Rule>
+constexpr auto integrate(Rule const& r, std::size_t k) -> double
+{
+  double sum = 0;
+  for (std::size_t i = 0; i < r.node.size(); ++i) {
+    sum += r.weight[i] * nani::pow(r.node[i], k);
+  }
+  return sum;
+}
+
+constexpr auto exact(std::size_t k) -> double
+{
+  return (k % 2 == 1) ? 0.0 : 2.0 / static_cast<double>(k + 1);
+}
+} // namespace
+
+TEST_CASE("gauss-legendre", "[all]")
+{
+  constexpr auto tol = 16 * std::numeric_limits<double>::epsilon();
+
+  constexpr auto r2 = nani::quadrature::gauss_legendre_v<double, 2>;
+  static_assert(nani::abs(r2.node[1] - 1.0 / nani::sqrt(3.0)) < tol);
+  static_assert(nani::abs(r2.node[0] + r2.node[1]) < tol);
+  static_assert(nani::abs(r2.weight[0] - 1.0) < tol);
+
+  constexpr auto r5 = nani::quadrature::gauss_legendre_v<double, 5>;
+  static_assert(nani::abs(r5.node[2]) < tol);
+  static_assert(nani::abs(integrate(r5, 0) - exact(0)) < tol);
+  static_assert(nani::abs(integrate(r5, 8) - exact(8)) < tol);
+  static_assert(nani::abs(integrate(r5, 9) - exact(9)) < tol);
+
+  constexpr auto r9 = nani::quadrature::gauss_legendre_v<double, 9>;
+  static_assert(nani::abs(integrate(r9, 16) - exact(16)) < tol);
+}
+
+TEST_CASE("gauss-lobatto", "[all]")
+{
+  constexpr auto tol = 16 * std::numeric_limits<double>::epsilon();
+
+  constexpr auto r3 = nani::quadrature::gauss_lobatto_v<double, 3>;
+  static_assert(nani::abs(r3.node[1]) < tol);
+  static_assert(nani::abs(r3.weight[0] - 1.0 / 3.0) < tol);
+  static_assert(nani::abs(r3.weight[1] - 4.0 / 3.0) < tol);
+
+  constexpr auto r9 = nani::quadrature::gauss_lobatto_v<double, 9>;
+  static_assert(r9.node[0] == -1.0 and r9.node[8] == 1.0);
+  static_assert(nani::abs(integrate(r9, 14) - exact(14)) < tol);
+}
+
+TEST_CASE("differentiation and interpolation", "[all]")
+{
+  constexpr auto tol = 64 * std::numeric_limits<double>::epsilon();
+  constexpr auto x = nani::quadrature::gauss_lobatto_v<double, 5>.node;
+  constexpr auto d = nani::quadrature::lobatto_differentiation_v<double, 5>;
+
+  constexpr auto cube = [](auto const& v) {
+    auto r = v;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+      r[i] = v[i] * v[i] * v[i];
+    }
+    return r;
+  };
+  constexpr auto derivative = d * cube(x);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    REQUIRE(nani::abs(derivative[i] - 3 * x[i] * x[i]) < tol);
+  }
+
+  constexpr auto y = nani::vector<double, 2>(-0.3, 0.7);
+  constexpr auto interpolated = nani::quadrature::interpolation(x, y) * cube(x);
+  static_assert(nani::abs(interpolated[0] + 0.027) < tol);
+  static_assert(nani::abs(interpolated[1] - 0.343) < tol);
+
+  // The orthonormal basis is orthonormal under an exact rule.
+  constexpr auto r = nani::quadrature::gauss_legendre_v<double, 4>;
+  constexpr auto v = nani::quadrature::vandermonde<double, 4>(r.node);
+  for (std::size_t j = 0; j < 4; ++j) {
+    for (std::size_t k = 0; k < 4; ++k) {
+      double m = 0;
+      for (std::size_t i = 0; i < 4; ++i) {
+        m += r.weight[i] * v[i][j] * v[i][k];
+      }
+      REQUIRE(nani::abs(m - (j == k ? 1.0 : 0.0)) < tol);
+    }
+  }
+}
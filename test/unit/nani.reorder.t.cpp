@@ -0,0 +1,105 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nani/reorder.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/reorder")
+
+namespace {
+using point = nani::vector<double, 2>;
+
+auto make_grid(std::size_t n) -> std::vector<point>
+{
+  auto grid = std::vector<point>();
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      grid.emplace_back(static_cast<double>(i), static_cast<double>(j));
+    }
+  }
+  return grid;
+}
+} // namespace
+
+TEST_CASE("morton key", "[all]")
+{
+  constexpr auto domain = nani::reorder::box<double, 2>{point(0.0, 0.0), point(1.0, 1.0)};
+  using nani::reorder::curve;
+
+  static_assert(nani::reorder::key<curve::morton>(point(0.0, 0.0), domain) == 0);
+  static_assert(nani::reorder::key<curve::morton>(point(1.0, 1.0), domain) == ~std::uint64_t{0});
+  // x is the more significant coordinate of every bit pair.
+  static_assert(
+    nani::reorder::key<curve::morton>(point(1.0, 0.0), domain)
+    > nani::reorder::key<curve::morton>(point(0.0, 1.0), domain));
+}
+
+TEST_CASE("hilbert order visits neighbouring points", "[all]")
+{
+  auto const grid = make_grid(16);
+  auto key = std::vector<std::uint64_t>(grid.size());
+  nani::reorder::keys<nani::reorder::curve::hilbert, double, 2>(grid, key);
+
+  auto const order = nani::reorder::sort<std::uint32_t>(key);
+  for (std::size_t i = 1; i < order.size(); ++i) {
+    REQUIRE(nani::l2_norm(grid[order[i]] - grid[order[i - 1]]) == 1.0);
+  }
+}
+
+TEST_CASE("radix sort", "[all]")
+{
+  auto key = std::vector<std::uint64_t>(100000);
+  std::uint64_t state = 88172645463325252ULL;
+  for (auto& k : key) {
+    state ^= state << 13U;
+    state ^= state >> 7U;
+    state ^= state << 17U;
+    k = state >> (state & 31U);
+  }
+
+  auto const order = nani::reorder::sort<std::uint32_t>(key);
+  for (std::size_t i = 1; i < order.size(); ++i) {
+    REQUIRE(key[order[i - 1]] <= key[order[i]]);
+  }
+  auto const inverse = nani::reorder::inverse<std::uint32_t>(order);
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    REQUIRE(inverse[order[i]] == i);
+  }
+}
+
+TEST_CASE("reverse cuthill-mckee on a scrambled path", "[all]")
+{
+  // Path 0 - 3 - 1 - 4 - 2, so that neighbours in the path are far apart in numbering.
+  auto const offset = std::vector<std::uint32_t>{0, 1, 3, 4, 6, 8};
+  auto const adjacency = std::vector<std::uint32_t>{3, 3, 4, 4, 0, 1, 1, 2};
+
+  auto const order = nani::reorder::reverse_cuthill_mckee<std::uint32_t>(offset, adjacency);
+  auto const inverse = nani::reorder::inverse<std::uint32_t>(order);
+
+  for (std::size_t v = 0; v + 1 < offset.size(); ++v) {
+    for (auto k = offset[v]; k < offset[v + 1]; ++k) {
+      auto const a = inverse[v];
+      auto const b = inverse[adjacency[k]];
+      REQUIRE(std::max(a, b) - std::min(a, b) == 1);
+    }
+  }
+}
+
+TEST_CASE("permute", "[all]")
+{
+  auto const field = make_grid(4);
+  auto const order =
+    std::vector<std::uint32_t>{3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+  auto out = std::vector<point>(field.size());
+  nani::reorder::permute<point, std::uint32_t>(field, order, out);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    REQUIRE(out[i] == field[order[i]]);
+  }
+}
@@ -0,0 +1,150 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/sparse.hpp>
+#include <nani/vector.hpp>
+#include <nani/view.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <testnani/matrix.hpp>
+#include <type_traits>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/sparse")
+
+namespace {
+using testnani::check_equal;
+using testnani::sample;
+
+// Entries are sums of a few products of sample entries.
+constexpr auto tol = 1e-12;
+
+/* The dense matrix with the entries off the pattern set to zero. */
+template <auto P, typename F>
+auto mask(nani::matrix<F, P.rows, P.cols> a)
+  -> nani::matrix<F, P.rows, P.cols>
+{
+  for (std::size_t i = 0; i < P.rows; ++i) {
+    for (std::size_t j = 0; j < P.cols; ++j) {
+      a[i][j] = P(i, j) ? a[i][j] : F(0);
+    }
+  }
+  return a;
+}
+
+// Rotation of the momentum of a 2D state (density, momentum, energy) into a face frame.
+constexpr auto rotate = nani::sparse_pattern<4, 4>::parse(
+  "x . . ."
+  ". x x ."
+  ". x x ."
+  ". . . x");
+
+constexpr auto jacobian = nani::sparse_pattern<4, 3>::parse(
+  "x . ."
+  "x x ."
+  ". x x"
+  "x . x");
+} // namespace
+
+TEST_CASE("pattern", "[all]")
+{
+  static_assert(rotate.count() == 6);
+  static_assert(rotate.index(2, 1) == 3 and rotate.index(3, 3) == 5);
+  static_assert(rotate(1, 2) and not rotate(0, 1));
+  static_assert(nani::sparse_pattern<3, 3>::dense().count() == 9);
+  static_assert(nani::sparse_pattern<3, 5>::diagonal().count() == 3);
+  static_assert(nani::sparse_pattern<4, 4>::block(1, 1, 2, 2) == rotate.block(1, 1, 2, 2));
+  static_assert((nani::sparse_pattern<4, 4>::diagonal() | rotate) == rotate);
+  static_assert(transpose(transpose(jacobian)) == jacobian);
+  static_assert(product(rotate, jacobian) == nani::sparse_pattern<4, 3>::parse("x.. xxx xxx x.x"));
+  static_assert(sizeof(nani::sparse_matrix<double, rotate>) == 6 * sizeof(double));
+
+  constexpr auto identity = nani::matrix<double, 3, 3>::identity();
+  static_assert(
+    nani::sparse_pattern<3, 3>::of(identity) == nani::sparse_pattern<3, 3>::diagonal());
+}
+
+TEST_CASE("product", "[all]")
+{
+  auto const a = mask<rotate>(sample<double, 4, 4>(1));
+  auto const b = mask<jacobian>(sample<double, 4, 3>(2));
+  auto const r = nani::sparse_matrix<double, rotate>(sample<double, 4, 4>(1));
+  auto const j = nani::sparse_matrix<double, jacobian>(b);
+  auto const v = nani::vector<double, 4>(1.0, -2.0, 0.5, 3.0);
+  auto const w = nani::vector<double, 3>(0.25, 4.0, -1.0);
+  auto const m = sample<double, 4, 5>(3);
+  auto const n = sample<double, 2, 4>(4);
+
+  check_equal(nani::matrix<double, 4, 4>(r), a, tol);
+  REQUIRE(r(0, 1) == 0.0);
+  REQUIRE(r(2, 1) == a[2][1]);
+
+  check_equal(r * v, a * v, tol);
+  check_equal(v * r, v * a, tol);
+  check_equal(j * w, b * w, tol);
+  check_equal(r * m, a * m, tol);
+  check_equal(n * r, n * a, tol);
+
+  auto const rj = r * j;
+  using product_type = nani::sparse_matrix<double, product(rotate, jacobian)>;
+  static_assert(std::is_same_v<std::remove_const_t<decltype(rj)>, product_type>);
+  check_equal(nani::matrix<double, 4, 3>(rj), a * b, tol);
+  auto const bt = nani::matrix<double, 3, 4>(nani::matrix_view<double const, 4, 3>(b).transposed());
+  check_equal(nani::matrix<double, 3, 4>(transpose(j)), bt, tol);
+
+  // Orthogonal patterns: the columns of p meet only zero rows of q, so that the product is zero.
+  constexpr auto left = nani::sparse_pattern<4, 4>::block(0, 0, 4, 2);
+  constexpr auto right = nani::sparse_pattern<4, 3>::block(2, 0, 2, 3);
+  auto const p = nani::sparse_matrix<double, left>(sample<double, 4, 4>(5));
+  auto const q = nani::sparse_matrix<double, right>(sample<double, 4, 3>(6));
+  auto const pq = p * q;
+  static_assert(decltype(pq)::size == 0);
+  check_equal(nani::matrix<double, 4, 3>(pq), nani::matrix<double, 4, 3>::zero(), tol);
+  check_equal(pq * w, nani::vector<double, 4>::fill(0.0), tol);
+}
+
+TEST_CASE("sum", "[all]")
+{
+  constexpr auto diagonal = nani::sparse_pattern<4, 4>::diagonal();
+  constexpr auto corner = nani::sparse_pattern<4, 4>::block(0, 2, 2, 2);
+  auto const r = nani::sparse_matrix<double, rotate>(sample<double, 4, 4>(5));
+  auto const d = nani::sparse_matrix<double, diagonal>(sample<double, 4, 4>(6));
+  auto const c = nani::sparse_matrix<double, corner>(sample<double, 4, 4>(7));
+
+  using dense = nani::matrix<double, 4, 4>;
+  check_equal(dense(r + d), dense(r) + dense(d), tol);
+  check_equal(dense(r - c), dense(r) - dense(c), tol);
+  check_equal(dense(2.0 * r), 2.0 * dense(r), tol);
+  check_equal(dense(r / 4.0), dense(r) / 4.0, tol);
+  static_assert(decltype(r + c)::size == 9);
+
+  auto const u = nani::vector<double, 4>(1.0, 2.0, 3.0, 4.0);
+  auto const x = nani::outer<rotate>(u, u);
+  check_equal(dense(x), mask<rotate>(nani::outer(u, u)), tol);
+}
+
+TEST_CASE("constexpr", "[all]")
+{
+  constexpr auto r = nani::sparse_matrix<double, rotate>(nani::matrix<double, 4, 4>::identity());
+  constexpr auto y = r * nani::vector<double, 4>(1.0, 2.0, 3.0, 4.0);
+  static_assert(y[0] == 1.0 and y[2] == 3.0 and y[3] == 4.0);
+}
+
+TEST_CASE("identity", "[all]")
+{
+  // Equal patterns, however they are made, are the same template argument.
+  constexpr auto diagonal = nani::sparse_pattern<4, 4>::diagonal();
+  constexpr auto corner = nani::sparse_pattern<4, 4>::block(0, 2, 2, 2);
+  static_assert(not std::is_same_v<
+                nani::sparse_matrix<double, diagonal>,
+                nani::sparse_matrix<double, corner>>);
+  static_assert(std::is_same_v<
+                nani::sparse_matrix<double, diagonal | rotate>,
+                nani::sparse_matrix<double, rotate>>);
+  static_assert(std::is_same_v<
+                nani::sparse_matrix<double, transpose(transpose(jacobian))>,
+                nani::sparse_matrix<double, jacobian>>);
+}
@@ -0,0 +1,110 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/layout.hpp>
+#include <nani/soa.hpp>
+#include <nani/stage.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <type_traits>
+#include <utility>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/stage")
+
+namespace {
+template <typename F, std::size_t N>
+auto field(std::size_t size, F seed) -> nani::soa_field<F, N>
+{
+  auto result = nani::soa_field<F, N>(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    for (std::size_t c = 0; c < N; ++c) {
+      result.component(c)[i] = seed * F(c + 1) + F(i % 7) / F(8);
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+void check_stage(std::size_t size)
+{
+  auto const u0 = field<F, N>(size, F(1));
+  auto const u1 = field<F, N>(size, F(-2));
+  auto const r = field<F, N>(size, F(0.5));
+  auto u = nani::soa_field<F, N>(size);
+
+  // Third stage of the SSP RK3 method, u = 1/3 u0 + 2/3 u1 + 2/3 dt R.
+  auto const dt = F(0.125);
+  auto const norm = nani::stage::combine_norm(
+    u.span(),
+    nani::stage::term{F(1) / F(3), u0.span()},
+    nani::stage::term{F(2) / F(3), u1.span()},
+    nani::stage::term{F(2) / F(3) * dt, r.span()});
+
+  auto const tolerance = std::is_same_v<F, float> ? F(1e-5) : F(1e-13);
+  auto expected = nani::vector<double, N>();
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const x = F(1) / F(3) * u0.load(i) + F(2) / F(3) * u1.load(i)
+                   + (F(2) / F(3) * dt) * r.load(i);
+    auto const ui = u.load(i);
+    for (std::size_t c = 0; c < N; ++c) {
+      REQUIRE(nani::abs(ui[c] - x[c]) <= tolerance * (F(1) + nani::abs(x[c])));
+      expected[c] += double(r.load(i)[c]) * double(r.load(i)[c]);
+    }
+  }
+  for (std::size_t c = 0; c < N; ++c) {
+    auto const e = F(nani::sqrt(expected[c]));
+    // The norm sums in another order than the reference, hence the looser bound.
+    REQUIRE(nani::abs(norm[c] - e) <= F(10) * tolerance * e);
+  }
+}
+} // namespace
+
+TEST_CASE("terms", "[all]")
+{
+  auto const size = std::size_t(1037);
+  auto const a = field<double, 3>(size, 1.0);
+  auto const b = field<double, 3>(size, 2.0);
+  auto out = nani::soa_field<double, 3>(size);
+
+  nani::stage::combine(out.span(), nani::stage::term{2.0, a.span()});
+  REQUIRE(out.load(1000) == 2.0 * a.load(1000));
+
+  nani::stage::combine(
+    out.span(),
+    nani::stage::term{1.0, a.span()},
+    nani::stage::term{-1.0, b.span()},
+    nani::stage::term{1.0, b.span()},
+    nani::stage::term{-1.0, a.span()},
+    nani::stage::term{0.5, a.span()});
+  for (std::size_t i = 0; i < size; ++i) {
+    REQUIRE(out.load(i) == 0.5 * a.load(i));
+  }
+
+  // In place, as in a low-storage scheme: u = u + 2 a.
+  nani::stage::combine(
+    out.span(),
+    nani::stage::term{1.0, std::as_const(out).span()},
+    nani::stage::term{2.0, a.span()});
+  for (std::size_t i = 0; i < size; ++i) {
+    REQUIRE(out.load(i) == 2.5 * a.load(i));
+  }
+}
+
+TEST_CASE("stage", "[all]")
+{
+  for (auto const size : {std::size_t(0), std::size_t(1), std::size_t(17), std::size_t(50001)}) {
+    check_stage<double, 4>(size);
+    check_stage<float, 5>(size);
+    check_stage<double, 1>(size);
+  }
+}
+
+TEST_CASE("streaming", "[all]")
+{
+  // Large enough for the output to bypass the cache.
+  auto const size = nani::layout::streaming_bytes / (4 * sizeof(double)) + 4099;
+  check_stage<double, 4>(size);
+}
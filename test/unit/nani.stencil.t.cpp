@@ -0,0 +1,287 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <nani/grid.hpp>
+#include <nani/smath.hpp>
+#include <nani/pack.hpp>
+#include <nani/parallel.hpp>
+#include <nani/stencil.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <type_traits>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/stencil")
+
+namespace {
+/* Sets component c of u, halo included, to f(c, index). */
+template <typename F, std::size_t N, std::size_t D, typename Function>
+void fill(nani::grid_field<F, N, D>& u, Function const& f)
+{
+  auto const h = static_cast<std::ptrdiff_t>(u.halo());
+  auto i = std::array<std::ptrdiff_t, D>();
+  i.fill(-h);
+  while (true) {
+    for (std::size_t c = 0; c < N; ++c) {
+      u(c, i) = f(c, i);
+    }
+    auto d = D;
+    while (d-- > 0) {
+      if (++i[d] < static_cast<std::ptrdiff_t>(u.extent()[d]) + h) {
+        break;
+      }
+      i[d] = -h;
+    }
+    if (d == std::size_t(-1)) {
+      return;
+    }
+  }
+}
+
+/* Calls f(index) for every interior point. */
+template <std::size_t D, typename Function>
+void for_interior(std::array<std::size_t, D> const& extent, Function const& f)
+{
+  auto i = std::array<std::ptrdiff_t, D>();
+  while (true) {
+    f(i);
+    auto d = D;
+    while (d-- > 0) {
+      if (++i[d] < static_cast<std::ptrdiff_t>(extent[d])) {
+        break;
+      }
+      i[d] = 0;
+    }
+    if (d == std::size_t(-1)) {
+      return;
+    }
+  }
+}
+
+// Use a pool also on single-core runners; read by nani::thread_count() on first use.
+auto const threads = setenv("NANI_NUM_THREADS", "4", 1); // NOLINT(concurrency-mt-unsafe)
+
+auto noise(std::size_t c, std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t z = 0) -> double
+{
+  auto const k = static_cast<std::size_t>((a + 7) * 131 + (b + 7) * 71 + (z + 7) * 29) + c * 13;
+  return static_cast<double>(k * 2654435761U % 1000) / 1000.0;
+}
+
+/* Runs iterate<S> on noise plainly and blocked, and checks the first against plain loops and the
+ * second against the first to the bit.
+ */
+template <auto S, std::size_t N>
+void check_iterate(
+  std::array<std::size_t, S.dim> const& extent, std::size_t steps, std::size_t block)
+{
+  constexpr auto D = S.dim;
+  auto u = nani::grid_field<double, N, D>(extent, S.radius());
+  fill(u, [](std::size_t c, auto const& i) {
+    if constexpr (D == 2) {
+      return noise(c, i[0], i[1]);
+    }
+    else {
+      return noise(c, i[0], i[1], i[2]);
+    }
+  });
+
+  // Reference: plain loops over a copy.
+  auto reference = u;
+  for (std::size_t s = 0; s < steps; ++s) {
+    auto const previous = reference;
+    for_interior(extent, [&](auto const& i) {
+      for (std::size_t c = 0; c < N; ++c) {
+        auto sum = previous(c, i);
+        for (std::size_t k = 0; k < S.size; ++k) {
+          auto j = i;
+          for (std::size_t d = 0; d < D; ++d) {
+            j[d] += S.offset[k][d];
+          }
+          sum += 0.1 * S.weight[k] * previous(c, j);
+        }
+        reference(c, i) = sum;
+      }
+    });
+  }
+
+  auto plain = u;
+  nani::stencil::iterate<S>(plain, steps, 0.1);
+  auto blocked = u;
+  nani::stencil::iterate<S>(blocked, steps, 0.1, block);
+  auto error = 0.0;
+  auto mismatch = std::size_t(0);
+  for_interior(extent, [&](auto const& i) {
+    for (std::size_t c = 0; c < N; ++c) {
+      error = std::max(error, nani::abs(plain(c, i) - reference(c, i)));
+      mismatch += blocked(c, i) != plain(c, i) ? 1 : 0;
+    }
+  });
+  REQUIRE(error <= 1e-13);
+  REQUIRE(mismatch == 0);
+
+  // The halo is held fixed.
+  for (std::size_t d = 0; d < D; ++d) {
+    auto i = std::array<std::ptrdiff_t, D>();
+    i.fill(1);
+    for (auto const x : {std::ptrdiff_t(-1), static_cast<std::ptrdiff_t>(extent[d])}) {
+      i[d] = x;
+      for (std::size_t c = 0; c < N; ++c) {
+        REQUIRE(blocked(c, i) == u(c, i));
+      }
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("grid", "[all]")
+{
+  auto u = nani::grid_field<double, 2, 3>({3, 4, 5}, 2);
+  REQUIRE(u.stride()[2] == 1);
+  REQUIRE(u.stride()[1] % static_cast<std::ptrdiff_t>(nani::simd_width_v<double>) == 0);
+  REQUIRE(u.stride()[0] == u.stride()[1] * 8);
+  auto const bytes = nani::simd_width_v<double> * sizeof(double);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(u.data(1)) % bytes == 0);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(u.data(0) + u.stride()[1]) % bytes == 0);
+
+  u.store({-2, 5, 6}, nani::vector<double, 2>(1.0, 2.0));
+  u(0, {2, 3, 4}) = 3.0;
+  REQUIRE(u.load({-2, 5, 6}) == nani::vector<double, 2>(1.0, 2.0));
+  REQUIRE(u.data(0)[2 * u.stride()[0] + 3 * u.stride()[1] + 4] == 3.0);
+  REQUIRE(u.slice(1, -2) + (u.data(1) - u.slice(1, 0)) + 5 * u.stride()[1] + 6
+          == &u(1, {-2, 5, 6}));
+}
+
+TEST_CASE("coefficients", "[all]")
+{
+  constexpr auto dx = nani::stencil::central<3, 4>(2);
+  static_assert(dx.radius() == 2);
+  static_assert(dx.offset[0][2] == -2 and dx.offset[0][0] == 0);
+  constexpr auto lap = nani::stencil::laplacian<2>();
+  static_assert(lap.size == 5 and lap.weight[0] == -4.0 and lap.offset[3][1] == -1);
+  static_assert(nani::stencil::laplacian<3, 4>().size == 13);
+  static_assert(nani::stencil::upwind<1, 3>(0, -1).offset[0][0] == 2);
+
+  // Equal stencils are one template argument.
+  using first = std::integral_constant<decltype(dx), nani::stencil::central<3, 4>(2)>;
+  using second = std::integral_constant<decltype(dx), dx>;
+  static_assert(std::is_same_v<first, second>);
+}
+
+TEST_CASE("apply", "[all]")
+{
+  // Second-order differences are exact on quadratics, extents not multiples of the SIMD width.
+  auto const extent = std::array<std::size_t, 2>{23, 37};
+  auto u = nani::grid_field<double, 2, 2>(extent, 1);
+  fill(u, [](std::size_t c, auto const& i) {
+    auto const x = static_cast<double>(i[0]);
+    auto const y = static_cast<double>(i[1]);
+    return c == 0 ? x * x + 2.0 * y * y : x * y - y;
+  });
+  auto v = nani::grid_field<double, 2, 2>(extent, 0);
+  nani::stencil::apply<nani::stencil::laplacian<2>()>(u, v, 0.5);
+  for_interior(extent, [&](auto const& i) {
+    REQUIRE(v(0, i) == 3.0);
+    REQUIRE(v(1, i) == 0.0);
+  });
+
+  // Third-order upwinding is exact on cubics, in both directions.
+  auto const line = std::array<std::size_t, 1>{50};
+  auto w = nani::grid_field<double, 1, 1>(line, 2);
+  fill(w, [](std::size_t, auto const& i) {
+    auto const x = static_cast<double>(i[0]) * 0.1;
+    return x * x * x - x;
+  });
+  auto left = nani::grid_field<double, 1, 1>(line, 0);
+  auto right = nani::grid_field<double, 1, 1>(line, 0);
+  nani::stencil::apply<nani::stencil::upwind<1>(0)>(w, left, 10.0);
+  nani::stencil::apply<nani::stencil::upwind<1>(0, -1)>(w, right, 10.0);
+  for_interior(line, [&](auto const& i) {
+    auto const x = static_cast<double>(i[0]) * 0.1;
+    REQUIRE(nani::abs(left(0, i) - (3.0 * x * x - 1.0)) <= 1e-12);
+    REQUIRE(nani::abs(right(0, i) - (3.0 * x * x - 1.0)) <= 1e-12);
+  });
+
+  REQUIRE_THROWS_AS(
+    (nani::stencil::apply<nani::stencil::central<1, 6>(0)>(w, left)), std::runtime_error);
+}
+
+TEST_CASE("gradient", "[all]")
+{
+  // Rows long enough to be split into several tiles.
+  auto const extent = std::array<std::size_t, 3>{5, 9, 700};
+  auto u = nani::grid_field<double, 1, 3>(extent, 2);
+  fill(u, [](std::size_t, auto const& i) {
+    auto const x = static_cast<double>(i[0]);
+    auto const y = static_cast<double>(i[1]);
+    auto const z = static_cast<double>(i[2]) * 0.01;
+    return x * x * y + z * z * z;
+  });
+  auto g = nani::grid_field<double, 3, 3>(extent, 0);
+  nani::stencil::gradient<nani::stencil::central<1, 4>(0)>(u, g);
+  for_interior(extent, [&](auto const& i) {
+    auto const x = static_cast<double>(i[0]);
+    auto const y = static_cast<double>(i[1]);
+    auto const z = static_cast<double>(i[2]) * 0.01;
+    REQUIRE(nani::abs(g(0, i) - 2.0 * x * y) <= 1e-10);
+    REQUIRE(nani::abs(g(1, i) - x * x) <= 1e-10);
+    REQUIRE(nani::abs(100.0 * g(2, i) - 3.0 * z * z) <= 1e-8);
+  });
+
+  // Divergence of (x^2, x y) is 3 x.
+  auto const plane = std::array<std::size_t, 2>{31, 19};
+  auto q = nani::grid_field<double, 2, 2>(plane, 1);
+  fill(q, [](std::size_t c, auto const& i) {
+    auto const x = static_cast<double>(i[0]);
+    auto const y = static_cast<double>(i[1]);
+    return c == 0 ? x * x : x * y;
+  });
+  auto div = nani::grid_field<double, 1, 2>(plane, 1);
+  nani::stencil::divergence<nani::stencil::central<1>(0)>(q, div);
+  for_interior(plane, [&](auto const& i) {
+    REQUIRE(div(0, i) == 3.0 * static_cast<double>(i[0]));
+  });
+}
+
+TEST_CASE("iterate", "[all]")
+{
+  // Blocking needs a tile per thread.
+  REQUIRE(threads == 0);
+  REQUIRE(nani::thread_count() == 4);
+  constexpr auto width = static_cast<std::ptrdiff_t>(nani::simd_width_v<double>);
+
+  SECTION("3D")
+  {
+    // Large enough that the blocked sweeps cut the cross-section into several tiles.
+    auto const plan
+      = nani::stencil::detail::plan<3>({40, 60, 100}, 1, 3, 2 * sizeof(double), width);
+    REQUIRE(plan.depth == 3);
+    REQUIRE(plan.tile[1] < 60);
+    check_iterate<nani::stencil::laplacian<3>(), 2>({40, 60, 100}, 7, 3);
+  }
+
+  SECTION("2D")
+  {
+    // The rows are cut into tiles of whole packs.
+    auto const plan = nani::stencil::detail::plan<2>({200, 300}, 1, 3, 2 * sizeof(double), width);
+    REQUIRE(plan.depth == 3);
+    REQUIRE(plan.tile[1] < 300);
+    REQUIRE(plan.tile[1] % width == 0);
+    check_iterate<nani::stencil::laplacian<2>(), 2>({200, 300}, 7, 3);
+  }
+
+  SECTION("radius 2")
+  {
+    auto const plan = nani::stencil::detail::plan<2>({200, 300}, 2, 4, sizeof(double), width);
+    REQUIRE(plan.depth == 4);
+    REQUIRE(plan.tile[1] < 300);
+    check_iterate<nani::stencil::laplacian<2, 4>(), 1>({200, 300}, 9, 4);
+    check_iterate<nani::stencil::laplacian<3, 4>(), 1>({30, 40, 70}, 5, 2);
+  }
+}
@@ -0,0 +1,217 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <nani/cholesky.hpp>
+#include <nani/matrix.hpp>
+#include <nani/meta.hpp>
+#include <nani/smath.hpp>
+#include <nani/structured.hpp>
+#include <nani/vector.hpp>
+#include <stdexcept>
+#include <testmol/compat/catch_main.hpp>
+#include <testnani/matrix.hpp>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/structured")
+
+namespace {
+using testnani::check_equal;
+using testnani::sample;
+
+/* Dense symmetric matrix, diagonally dominant so that it is well conditioned. */
+template <typename F, std::size_t N>
+auto symmetric(std::size_t seed) -> nani::matrix<F, N, N>
+{
+  auto const b = sample<F, N, N>(seed);
+  auto result = nani::matrix<F, N, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      result[i][j] = b[i][j] + b[j][i] + (i == j ? F(4 * N) : F(0));
+    }
+  }
+  return result;
+}
+
+template <typename F, std::size_t N>
+void check_symmetric(F tolerance)
+{
+  using dense = nani::matrix<F, N, N>;
+  auto const a = symmetric<F, N>(1);
+  auto const s = nani::symmetric_matrix<F, N>(a);
+  auto const t = nani::symmetric_matrix<F, N>(symmetric<F, N>(4));
+  auto const v = nani::vector<F, N>(sample<F, N, 1>(7));
+  auto const m = sample<F, N, 3>(9);
+  auto const n = sample<F, 2, N>(3);
+
+  static_assert(sizeof(s) == sizeof(F) * N * (N + 1) / 2);
+  check_equal(dense(s), a, F(0));
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      REQUIRE(&s(i, j) == &s(j, i));
+    }
+  }
+
+  check_equal(s * v, a * v, tolerance);
+  check_equal(s * m, a * m, tolerance);
+  check_equal(n * s, n * a, tolerance);
+  check_equal(dense(s + t), a + dense(t), F(0));
+  check_equal(dense(s - t), a - dense(t), F(0));
+  check_equal(dense(F(2) * s), 2.0 * a, F(0));
+  check_equal(dense(s / F(2)), a / 2.0, F(0));
+
+  auto const x = solve(s, v);
+  check_equal(a * x, v, tolerance);
+  auto const y = solve(s, m);
+  check_equal(a * y, m, tolerance);
+
+  if constexpr (N < 6) {
+    auto const det = F(nani::determinant(a));
+    REQUIRE(nani::abs(determinant(s) - det) <= tolerance * nani::abs(det));
+  }
+}
+
+template <typename F, std::size_t N>
+void check_diagonal(F tolerance)
+{
+  using dense = nani::matrix<F, N, N>;
+  auto const d = nani::diagonal_matrix<F, N>(symmetric<F, N>(3));
+  auto const e = nani::diagonal_matrix<F, N>(sample<F, N, N>(5));
+  auto const a = dense(d);
+  auto const v = nani::vector<F, N>(sample<F, N, 1>(7));
+  auto const m = sample<F, N, 3>(9);
+  auto const n = sample<F, 2, N>(3);
+
+  static_assert(sizeof(d) == sizeof(F) * N);
+  for (std::size_t i = 0; i < N; ++i) {
+    REQUIRE(e[i] == sample<F, N, N>(5)[i][i]);
+  }
+
+  check_equal(d * v, a * v, tolerance);
+  check_equal(d * m, a * m, tolerance);
+  check_equal(n * d, n * a, tolerance);
+  check_equal(dense(d * e), a * dense(e), tolerance);
+  check_equal(dense(d + e), a + dense(e), F(0));
+  check_equal(dense(d - e), a - dense(e), F(0));
+  check_equal(dense(d * F(2)), a * 2.0, F(0));
+
+  check_equal(d * solve(d, v), v, tolerance);
+  check_equal(d * solve(d, m), m, tolerance);
+
+  auto det = F(1);
+  for (std::size_t i = 0; i < N; ++i) {
+    det *= a[i][i];
+  }
+  REQUIRE(determinant(d) == det);
+}
+
+template <typename F, std::size_t N, nani::triangle T>
+void check_triangular(F tolerance)
+{
+  using dense = nani::matrix<F, N, N>;
+  auto const full = symmetric<F, N>(2);
+  auto const t = nani::triangular_matrix<F, N, T>(full);
+  auto const u = nani::triangular_matrix<F, N, T>(sample<F, N, N>(6));
+  auto const d = nani::diagonal_matrix<F, N>(sample<F, N, N>(8));
+  auto const a = dense(t);
+  auto const v = nani::vector<F, N>(sample<F, N, 1>(7));
+  auto const m = sample<F, N, 3>(9);
+  auto const n = sample<F, 2, N>(3);
+
+  static_assert(sizeof(t) == sizeof(F) * N * (N + 1) / 2);
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      REQUIRE(a[i][j] == (t.stored(i, j) ? full[i][j] : F(0)));
+    }
+  }
+
+  check_equal(t * v, a * v, tolerance);
+  check_equal(t * m, a * m, tolerance);
+  check_equal(n * t, n * a, tolerance);
+  check_equal(dense(t * u), a * dense(u), tolerance);
+  check_equal(dense(d * t), dense(d) * a, tolerance);
+  check_equal(dense(t * d), a * dense(d), tolerance);
+  check_equal(dense(t + u), a + dense(u), F(0));
+  check_equal(dense(t - u), a - dense(u), F(0));
+  check_equal(dense(F(3) * t), 3.0 * a, F(0));
+
+  auto const tt = dense(transpose(t));
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      REQUIRE(tt[i][j] == a[j][i]);
+    }
+  }
+
+  check_equal(a * solve(t, v), v, tolerance);
+  check_equal(a * solve(t, m), m, tolerance);
+
+  auto det = F(1);
+  for (std::size_t i = 0; i < N; ++i) {
+    det *= a[i][i];
+  }
+  REQUIRE(determinant(t) == det);
+}
+} // namespace
+
+TEST_CASE("symmetric", "[all]")
+{
+  check_symmetric<double, 1>(1e-12);
+  check_symmetric<double, 2>(1e-12);
+  check_symmetric<double, 3>(1e-12);
+  check_symmetric<double, 5>(1e-12);
+  check_symmetric<double, 9>(1e-11);
+  check_symmetric<float, 4>(1e-4F);
+}
+
+TEST_CASE("diagonal", "[all]")
+{
+  check_diagonal<double, 1>(1e-12);
+  check_diagonal<double, 4>(1e-12);
+  check_diagonal<float, 7>(1e-5F);
+}
+
+TEST_CASE("triangular", "[all]")
+{
+  using nani::triangle;
+  check_triangular<double, 1, triangle::lower>(1e-12);
+  check_triangular<double, 3, triangle::lower>(1e-12);
+  check_triangular<double, 3, triangle::upper>(1e-12);
+  check_triangular<double, 8, triangle::lower>(1e-11);
+  check_triangular<double, 8, triangle::upper>(1e-11);
+  check_triangular<float, 5, triangle::upper>(1e-4F);
+}
+
+TEST_CASE("constexpr", "[all]")
+{
+  constexpr auto s = nani::symmetric_matrix<double, 3>::identity();
+  constexpr auto l = nani::lower_triangular<double, 3>::identity();
+  static_assert(determinant(s) == 1.0 and determinant(l) == 1.0);
+  static_assert((s * nani::vector<double, 3>(1.0, 2.0, 3.0))[2] == 3.0);
+}
+
+TEST_CASE("ldlt", "[all]")
+{
+  // The same factorization as the dense ldlt_factor, on the stored entries only.
+  auto const a = symmetric<double, 5>(2);
+  auto const f = nani::ldlt(nani::symmetric_matrix<double, 5>(a));
+  auto const g = nani::ldlt(a);
+  for (std::size_t i = 0; i < 5; ++i) {
+    REQUIRE(f.diagonal()[i] == g.diagonal()[i]);
+    for (std::size_t j = 0; j <= i; ++j) {
+      REQUIRE(f.lower()(i, j) == g.lower()[i][j]);
+    }
+  }
+
+  // Nonsingular, but with a zero leading minor, which the factorization without pivoting rejects.
+  auto swap = nani::symmetric_matrix<double, 2>::zero();
+  swap(1, 0) = 1.0;
+  if constexpr (nani::meta::is_debug_build()) {
+    REQUIRE_THROWS_AS(nani::ldlt(swap), std::runtime_error);
+  }
+  else {
+    auto const x = solve(swap, nani::vector<double, 2>(1.0, 2.0));
+    REQUIRE(not(std::isfinite(x[0]) and std::isfinite(x[1])));
+  }
+}
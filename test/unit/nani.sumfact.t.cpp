@@ -0,0 +1,175 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <nani/matrix.hpp>
+#include <nani/quadrature.hpp>
+#include <nani/smath.hpp>
+#include <nani/sumfact.hpp>
+#include <nani/tiled.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/sumfact")
+
+namespace {
+// Order 3 elements: 4 Gauss-Lobatto nodes per direction, 5 Gauss-Legendre quadrature points.
+constexpr auto lobatto = nani::quadrature::gauss_lobatto_v<double, 4>;
+constexpr auto legendre = nani::quadrature::gauss_legendre_v<double, 5>;
+constexpr auto to_points = nani::quadrature::interpolation(lobatto.node, legendre.node);
+constexpr auto derivative = nani::quadrature::lobatto_differentiation_v<double, 4>;
+
+/* A polynomial of degree 3 in each coordinate and two of its derivatives. */
+auto f(double x, double y, double z) -> double
+{
+  return (1.0 + x - 2.0 * x * x * x) * (0.5 - y * y + y * y * y) * (2.0 + z * z);
+}
+
+auto dfdx(double x, double y, double z) -> double
+{
+  return (1.0 - 6.0 * x * x) * (0.5 - y * y + y * y * y) * (2.0 + z * z);
+}
+
+auto dfdz(double x, double y, double z) -> double
+{
+  return (1.0 + x - 2.0 * x * x * x) * (0.5 - y * y + y * y * y) * (2.0 * z);
+}
+
+/* Values of f at the tensor-product points x, direction 0 first. */
+template <std::size_t N>
+auto nodal(nani::vector<double, N> const& x, double scale = 1.0)
+  -> nani::vector<double, nani::sumfact::nodes_v<N, 3>>
+{
+  auto result = nani::vector<double, nani::sumfact::nodes_v<N, 3>>();
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      for (std::size_t k = 0; k < N; ++k) {
+        result[(i * N + j) * N + k] = scale * f(x[i], x[j], x[k]);
+      }
+    }
+  }
+  return result;
+}
+
+auto close(double a, double b) -> bool
+{
+  return nani::abs(a - b) <= 1e-12 * (1.0 + nani::abs(b));
+}
+} // namespace
+
+TEST_CASE("interpolate", "[all]")
+{
+  static_assert(nani::sumfact::nodes_v<4, 3> == 64);
+  auto const u = nodal(lobatto.node);
+  auto const v = nani::sumfact::interpolate<3>(to_points, u);
+  auto const expected = nodal(legendre.node);
+  for (std::size_t q = 0; q < expected.size(); ++q) {
+    REQUIRE(close(v[q], expected[q]));
+  }
+
+  // One direction: a 2D element of 4 x 4 nodes to 5 x 5 points.
+  auto const x = lobatto.node;
+  auto u2 = nani::vector<double, 16>();
+  for (std::size_t i = 0; i < 4; ++i) {
+    for (std::size_t j = 0; j < 4; ++j) {
+      u2[i * 4 + j] = f(x[i], x[j], 0.0);
+    }
+  }
+  auto const v2 = nani::sumfact::interpolate<2>(to_points, u2);
+  auto const y = legendre.node;
+  REQUIRE(close(v2[3 * 5 + 1], f(y[3], y[1], 0.0)));
+}
+
+TEST_CASE("gradient", "[all]")
+{
+  auto const x = lobatto.node;
+  auto const u = nodal(x);
+  auto const g = nani::sumfact::gradient<3>(derivative, u);
+  auto const dz = nani::sumfact::derivative<2, 3>(derivative, u);
+  for (std::size_t i = 0; i < 4; ++i) {
+    for (std::size_t j = 0; j < 4; ++j) {
+      for (std::size_t k = 0; k < 4; ++k) {
+        auto const n = (i * 4 + j) * 4 + k;
+        REQUIRE(nani::abs(g[0][n] - dfdx(x[i], x[j], x[k])) <= 1e-11);
+        REQUIRE(nani::abs(g[2][n] - dfdz(x[i], x[j], x[k])) <= 1e-11);
+        REQUIRE(dz[n] == g[2][n]);
+      }
+    }
+  }
+}
+
+TEST_CASE("integrate", "[all]")
+{
+  auto const fq = nodal(legendre.node);
+  auto const r = nani::sumfact::integrate<3>(to_points, legendre.weight, fq);
+
+  // Against the assembled operator: r_i = sum_q A_qi w_q f_q.
+  auto const y = legendre.node;
+  auto const w = legendre.weight;
+  for (std::size_t n = 0; n < 64; n += 7) {
+    auto const i = n / 16;
+    auto const j = (n / 4) % 4;
+    auto const k = n % 4;
+    auto expected = 0.0;
+    for (std::size_t a = 0; a < 5; ++a) {
+      for (std::size_t b = 0; b < 5; ++b) {
+        for (std::size_t c = 0; c < 5; ++c) {
+          expected += to_points[a][i] * to_points[b][j] * to_points[c][k] * w[a] * w[b] * w[c]
+                      * f(y[a], y[b], y[c]);
+        }
+      }
+    }
+    REQUIRE(close(r[n], expected));
+  }
+
+  // The Lagrange basis sums to one: the sum of r is the integral of f.
+  auto total = 0.0;
+  for (std::size_t n = 0; n < 64; ++n) {
+    total += r[n];
+  }
+  REQUIRE(close(total, 2.0 * (1.0 - 2.0 / 3.0) * (4.0 + 2.0 / 3.0)));
+}
+
+TEST_CASE("batched", "[all]")
+{
+  constexpr auto width = nani::simd_width_v<double>;
+  constexpr std::size_t nodes = nani::sumfact::nodes_v<4, 3>;
+  constexpr std::size_t points = nani::sumfact::nodes_v<5, 3>;
+  auto const size = 3 * width + 1;
+
+  auto elements = std::vector<nani::vector<double, nodes>>();
+  for (std::size_t e = 0; e < size; ++e) {
+    elements.push_back(nodal(lobatto.node, 1.0 + 0.5 * static_cast<double>(e)));
+  }
+  auto const u = nani::tiled_field<double, nodes>(elements);
+
+  auto v = nani::tiled_field<double, points>(size);
+  nani::sumfact::interpolate<3>(to_points, u, v);
+  auto g = std::array<nani::tiled_field<double, nodes>, 3>{
+    nani::tiled_field<double, nodes>(size),
+    nani::tiled_field<double, nodes>(size),
+    nani::tiled_field<double, nodes>(size)};
+  nani::sumfact::gradient<3>(derivative, u, g);
+  auto r = nani::tiled_field<double, nodes>(size);
+  nani::sumfact::integrate<3>(to_points, legendre.weight, v, r);
+
+  for (std::size_t e = 0; e < size; e += 3) {
+    auto const ve = nani::sumfact::interpolate<3>(to_points, elements[e]);
+    auto const ge = nani::sumfact::gradient<3>(derivative, elements[e]);
+    auto const re = nani::sumfact::integrate<3>(to_points, legendre.weight, ve);
+    auto const vb = v.load(e);
+    auto const rb = r.load(e);
+    auto const gb = g[1].load(e);
+    for (std::size_t q = 0; q < points; ++q) {
+      REQUIRE(close(vb[q], ve[q]));
+    }
+    for (std::size_t n = 0; n < nodes; ++n) {
+      REQUIRE(close(rb[n], re[n]));
+      REQUIRE(close(gb[n], ge[1][n]));
+    }
+  }
+}
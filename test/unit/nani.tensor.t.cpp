@@ -0,0 +1,159 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <nani/matrix.hpp>
+#include <nani/smath.hpp>
+#include <nani/tensor.hpp>
+#include <nani/vector.hpp>
+#include <nani/view.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <type_traits>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/tensor")
+
+namespace {
+template <typename F, std::size_t... D>
+auto sample(std::size_t seed) -> nani::tensor<F, D...>
+{
+  auto result = nani::tensor<F, D...>();
+  for (std::size_t e = 0; e < result.size; ++e) {
+    result.values()[e] = F(((seed + 2) * (e + 1) * 7 + e * 3) % 17) / F(4) - F(2);
+  }
+  return result;
+}
+
+template <std::size_t R, std::size_t C>
+constexpr auto rows(std::array<double, R * C> const& x) -> nani::matrix<double, R, C>
+{
+  auto result = nani::matrix<double, R, C>();
+  for (std::size_t i = 0; i < R; ++i) {
+    for (std::size_t j = 0; j < C; ++j) {
+      result[i][j] = x[i * C + j];
+    }
+  }
+  return result;
+}
+
+template <typename F>
+auto close(F a, F b) -> bool
+{
+  return nani::abs(a - b) <= F(1e-12) * (F(1) + nani::abs(b));
+}
+} // namespace
+
+TEST_CASE("layout", "[all]")
+{
+  using t234 = nani::tensor<double, 2, 3, 4>;
+  static_assert(t234::rank == 3 and t234::size == 24);
+  static_assert(sizeof(t234) == 24 * sizeof(double));
+
+  auto t = t234::zero();
+  t(1, 2, 3) = 5.0;
+  t(0, 1, 0) = 2.0;
+  REQUIRE(t.values()[23] == 5.0);
+  REQUIRE(t.values()[4] == 2.0);
+
+  auto const a = rows<2, 3>({1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+  auto const ta = nani::tensor<double, 2, 3>(a);
+  REQUIRE(ta(1, 0) == 4.0);
+  REQUIRE(nani::matrix<double, 2, 3>(ta)[0][2] == 3.0);
+
+  auto const v = nani::vector<double, 3>(1.0, 2.0, 3.0);
+  REQUIRE(nani::vector<double, 3>(nani::tensor<double, 3>(v)) == v);
+
+  auto const s = 2.0 * (t + t) - t;
+  REQUIRE(s(1, 2, 3) == 15.0);
+}
+
+TEST_CASE("contract", "[all]")
+{
+  auto const a = sample<double, 2, 3, 4>(1);
+  auto const b = sample<double, 4, 5>(2);
+
+  auto const c = nani::contract<"ijk,kl->ijl">(a, b);
+  static_assert(std::is_same_v<std::remove_const_t<decltype(c)>, nani::tensor<double, 2, 3, 5>>);
+  for (std::size_t i = 0; i < 2; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      for (std::size_t l = 0; l < 5; ++l) {
+        auto expected = 0.0;
+        for (std::size_t k = 0; k < 4; ++k) {
+          expected += a(i, j, k) * b(k, l);
+        }
+        REQUIRE(close(c(i, j, l), expected));
+      }
+    }
+  }
+
+  // Permuted output, and a sum over two labels.
+  auto const d = nani::contract<"ijk -> kji">(a);
+  REQUIRE(d(3, 1, 0) == a(0, 1, 3));
+  auto const e = nani::contract<"ijk,ijk->">(a, a);
+  auto expected = 0.0;
+  for (auto x : a.values()) {
+    expected += x * x;
+  }
+  REQUIRE(close(e, expected));
+  auto const g = sample<double, 3, 2>(3);
+  auto const f = nani::contract<"ijk,jl->ikl">(a, g);
+  auto const f120 = a(1, 0, 2) * g(0, 0) + a(1, 1, 2) * g(1, 0) + a(1, 2, 2) * g(2, 0);
+  REQUIRE(close(f(1, 2, 0), f120));
+}
+
+TEST_CASE("matrix", "[all]")
+{
+  auto const a = rows<3, 3>({2.0, 1.0, 0.0, 1.0, 3.0, 1.0, 0.0, 1.0, 4.0});
+  auto const x = nani::vector<double, 3>(1.0, -2.0, 0.5);
+
+  // Implicit output: the labels that appear once, alphabetically.
+  auto const y = nani::contract<"ij,j">(a, x);
+  REQUIRE(nani::vector<double, 3>(y) == a * x);
+  REQUIRE(nani::contract<"ii">(a) == 9.0);
+  REQUIRE(nani::contract<"i,ij,j">(x, a, x) == x * (a * x));
+
+  auto const b = nani::contract<"ik,kj->ij">(a, nani::matrix_view<double const, 3, 3>(a));
+  auto const ab = a * a;
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      REQUIRE(close(b(i, j), ab[i][j]));
+    }
+  }
+  auto const t = nani::contract<"ji">(a);
+  REQUIRE(t(0, 1) == a[1][0]);
+}
+
+TEST_CASE("large", "[all]")
+{
+  // Past the unrolling limit the same nest runs as loops.
+  auto const a = sample<double, 8, 8, 8>(4);
+  auto const b = sample<double, 8, 8>(5);
+  static_assert(8 * 8 * 8 * 8 > nani::unroll_limit);
+  auto const c = nani::contract<"ijk,kl->ijl">(a, b);
+  auto const r = nani::contract<"ijk,lk->ijl">(a, b);
+  for (std::size_t i = 0; i < 8; i += 3) {
+    for (std::size_t j = 0; j < 8; ++j) {
+      for (std::size_t l = 0; l < 8; l += 2) {
+        auto expected = 0.0;
+        auto transposed = 0.0;
+        for (std::size_t k = 0; k < 8; ++k) {
+          expected += a(i, j, k) * b(k, l);
+          transposed += a(i, j, k) * b(l, k);
+        }
+        REQUIRE(close(c(i, j, l), expected));
+        REQUIRE(close(r(i, j, l), transposed));
+      }
+    }
+  }
+}
+
+TEST_CASE("constexpr", "[all]")
+{
+  constexpr auto a = rows<2, 2>({1.0, 2.0, 3.0, 4.0});
+  constexpr auto x = nani::vector<double, 2>(1.0, 1.0);
+  constexpr auto y = nani::contract<"ij,j->i">(a, x);
+  static_assert(y(0) == 3.0 and y(1) == 7.0);
+  static_assert(nani::contract<"ii">(a) == 5.0);
+}
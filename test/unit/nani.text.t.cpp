@@ -0,0 +1,180 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <nani/matrix.hpp>
+#include <nani/soa.hpp>
+#include <nani/text.hpp>
+#include <nani/vector.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/text")
+
+namespace {
+auto sample(std::size_t n) -> std::vector<nani::vector<double, 3>>
+{
+  auto result = std::vector<nani::vector<double, 3>>(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto const x = static_cast<double>(i);
+    result[i] = nani::vector<double, 3>(x / 3.0, -1e-300 * x, 1.0 + 0.1 * x);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("chars", "[all]")
+{
+  static_assert(nani::max_chars_v<double> == 24);
+  static_assert(nani::max_chars_v<float> == 15);
+  static_assert(nani::max_chars_v<nani::vector<double, 3>> == 74);
+
+  auto buffer = std::array<char, nani::max_chars_v<nani::vector<double, 3>>>();
+  auto const v = nani::vector<double, 3>(0.1, -1.0 / 3.0, 2.5e-308);
+  auto const [end, ec] = nani::to_chars(buffer.data(), buffer.data() + buffer.size(), v);
+  REQUIRE(ec == std::errc());
+  REQUIRE(std::string(buffer.data(), end).starts_with("0.1 -0.3333333333333333 2.5e-308"));
+
+  auto w = nani::vector<double, 3>();
+  auto const parsed = nani::from_chars(buffer.data(), end, w);
+  REQUIRE(parsed.ec == std::errc());
+  REQUIRE(parsed.ptr == end);
+  REQUIRE(w == v);
+
+  // Too small a buffer, and separators other than spaces.
+  REQUIRE(nani::to_chars(buffer.data(), buffer.data() + 5, v).ec == std::errc::value_too_large);
+  auto const text = std::string_view("+1.5,\t-2 ,3e2");
+  REQUIRE(nani::from_chars(text.data(), text.data() + text.size(), w).ec == std::errc());
+  REQUIRE(w == nani::vector<double, 3>(1.5, -2.0, 300.0));
+  auto const bad = std::string_view("1 x 3");
+  auto const failed = nani::from_chars(bad.data(), bad.data() + bad.size(), w);
+  REQUIRE(failed.ec == std::errc::invalid_argument);
+  REQUIRE(failed.ptr == bad.data() + 2);
+  REQUIRE(w[0] == 1.5);
+
+  auto a = nani::matrix<float, 2, 2>();
+  a[0][0] = 1.0F;
+  a[0][1] = 0.1F;
+  a[1][0] = -3.0F;
+  a[1][1] = 1e-20F;
+  auto matrix_buffer = std::array<char, nani::max_chars_v<nani::matrix<float, 2, 2>>>();
+  auto const written = nani::to_chars(
+    matrix_buffer.data(), matrix_buffer.data() + matrix_buffer.size(), a, ',');
+  REQUIRE(std::string(matrix_buffer.data(), written.ptr) == "1,0.1,-3,1e-20");
+  auto b = nani::matrix<float, 2, 2>();
+  REQUIRE(nani::from_chars(matrix_buffer.data(), written.ptr, b).ec == std::errc());
+  REQUIRE(b[0][1] == 0.1F);
+  REQUIRE(b[1][1] == 1e-20F);
+}
+
+TEST_CASE("field", "[all]")
+{
+  // Several blocks of chunks on any number of threads.
+  auto const n = 2 * 64 * nani::text::grain + 17;
+  auto const field = sample(n);
+  auto const aos = std::span<nani::vector<double, 3> const>(field);
+
+  auto out = std::ostringstream();
+  nani::text::write(out, aos);
+  auto const text = out.str();
+  REQUIRE(text.starts_with("0 -0 1\n0.3333333333333333 -1e-300 1.1\n"));
+  REQUIRE(nani::text::read<double, 3>(text) == field);
+
+  auto soa = nani::soa_field<double, 3>(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    soa.store(i, field[i]);
+  }
+  auto soa_out = std::ostringstream();
+  nani::text::write(soa_out, nani::soa_span<double const, 3>(soa.span()));
+  REQUIRE(soa_out.str() == text);
+
+  // Blank lines are skipped; a short line is an error naming its line.
+  auto const blank = nani::text::read<double, 2>("1 2\n\n  \n3 4\n");
+  REQUIRE(blank.size() == 2);
+  REQUIRE(blank[1] == nani::vector<double, 2>(3.0, 4.0));
+  REQUIRE_THROWS_AS((nani::text::read<double, 2>("1 2\n3\n")), std::runtime_error);
+  REQUIRE_THROWS_AS((nani::text::read<double, 2>("1 2\n3 four\n")), std::runtime_error);
+}
+
+TEST_CASE("csv", "[all]")
+{
+  auto const field = sample(100);
+  auto out = std::ostringstream();
+  nani::text::write_csv(out, "u", std::span<nani::vector<double, 3> const>(field));
+  auto const text = out.str();
+  REQUIRE(text.starts_with("u_0,u_1,u_2\n0,-0,1\n"));
+  REQUIRE(nani::text::read_csv<double, 3>(text) == field);
+
+  auto scalar = std::ostringstream();
+  auto const rho = std::vector<nani::vector<float, 1>>(3, nani::vector<float, 1>(0.5F));
+  nani::text::write_csv(scalar, "rho", std::span<nani::vector<float, 1> const>(rho));
+  REQUIRE(scalar.str() == "rho\n0.5\n0.5\n0.5\n");
+}
+
+TEST_CASE("vtk", "[all]")
+{
+  // Two triangles and a quad sharing edges.
+  auto const point = std::vector<nani::vector<double, 2>>{
+    nani::vector<double, 2>(0.0, 0.0),
+    nani::vector<double, 2>(1.0, 0.0),
+    nani::vector<double, 2>(0.0, 1.0),
+    nani::vector<double, 2>(1.0, 1.0),
+    nani::vector<double, 2>(2.0, 0.0),
+    nani::vector<double, 2>(2.0, 1.0)};
+  auto const offset = std::vector<int>{0, 3, 6, 10};
+  auto const connectivity = std::vector<int>{0, 1, 2, 2, 1, 3, 1, 4, 5, 3};
+  auto const type = std::vector<nani::text::vtk_cell>{
+    nani::text::vtk_cell::triangle, nani::text::vtk_cell::triangle, nani::text::vtk_cell::quad};
+
+  auto const pressure = std::vector<nani::vector<double, 1>>{
+    nani::vector<double, 1>(1.0), nani::vector<double, 1>(2.5), nani::vector<double, 1>(-4.0)};
+  auto const velocity = sample(6);
+  auto const speed = std::vector<nani::vector<float, 1>>(6, nani::vector<float, 1>(0.25F));
+
+  auto out = std::ostringstream();
+  auto vtk = nani::text::vtk_writer(
+    out,
+    "two triangles\nand a quad",
+    std::span<nani::vector<double, 2> const>(point),
+    std::span<int const>(offset),
+    std::span<int const>(connectivity),
+    std::span<nani::text::vtk_cell const>(type));
+  vtk.cell_field("pressure", std::span<nani::vector<double, 1> const>(pressure));
+  vtk.point_field("velocity", std::span<nani::vector<double, 3> const>(velocity));
+  vtk.point_field("speed", std::span<nani::vector<float, 1> const>(speed));
+  auto const text = out.str();
+
+  REQUIRE(text.starts_with(
+    "# vtk DataFile Version 3.0\ntwo triangles and a quad\nASCII\nDATASET UNSTRUCTURED_GRID\n"
+    "POINTS 6 double\n0 0 0\n1 0 0\n"));
+  REQUIRE(text.find("CELLS 3 13\n3 0 1 2\n3 2 1 3\n4 1 4 5 3\nCELL_TYPES 3\n5\n5\n9\n")
+          != std::string::npos);
+  REQUIRE(text.find("CELL_DATA 3\nSCALARS pressure double 1\nLOOKUP_TABLE default\n1\n2.5\n-4\n")
+          != std::string::npos);
+  REQUIRE(text.find("POINT_DATA 6\nVECTORS velocity double\n") != std::string::npos);
+  REQUIRE(text.ends_with(
+    "SCALARS speed float 1\nLOOKUP_TABLE default\n0.25\n0.25\n0.25\n0.25\n0.25\n0.25\n"));
+
+  REQUIRE(nani::text::read_vtk<double, 1>(text, "pressure") == pressure);
+  REQUIRE(nani::text::read_vtk<double, 3>(text, "velocity") == velocity);
+  REQUIRE(nani::text::read_vtk<float, 1>(text, "speed") == speed);
+  REQUIRE_THROWS_AS((nani::text::read_vtk<double, 1>(text, "density")), std::runtime_error);
+  // A field outside of any POINT_DATA or CELL_DATA section has no size to match.
+  auto const orphan = std::string_view("SCALARS p double 1\nLOOKUP_TABLE default\n1\n2\n");
+  REQUIRE_THROWS_AS((nani::text::read_vtk<double, 1>(orphan, "p")), std::runtime_error);
+
+  // Wrong sizes, and cell fields after the point fields.
+  REQUIRE_THROWS_AS(
+    vtk.point_field("speed", std::span<nani::vector<double, 1> const>(pressure)),
+    std::runtime_error);
+  REQUIRE_THROWS_AS(
+    vtk.cell_field("p", std::span<nani::vector<double, 1> const>(pressure)), std::runtime_error);
+}
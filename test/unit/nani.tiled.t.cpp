@@ -0,0 +1,103 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <catch2/catch_test_macros.hpp>
+#include <nani/pack.hpp>
+#include <nani/soa.hpp>
+#include <nani/tiled.hpp>
+#include <nani/vector.hpp>
+#include <testmol/compat/catch_main.hpp>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/tiled")
+
+namespace {
+/* A point-wise kernel written once for scalars and reused on packs. */
+template <typename F>
+auto kernel(nani::vector<F, 3> const& u) -> F
+{
+  return nani::sqrt(u * u) + nani::max(u[0], u[1]) - F(0.5) * u[2];
+}
+
+auto sample(std::size_t i) -> nani::vector<double, 3>
+{
+  auto const x = static_cast<double>(i);
+  return nani::vector<double, 3>(x, 1.0 - x, 0.25 * x);
+}
+} // namespace
+
+TEST_CASE("pack", "[all]")
+{
+  constexpr auto width = nani::simd_width_v<double>;
+  using pack = nani::pack<double, width>;
+  static_assert(width * sizeof(double) == nani::simd_bytes);
+
+  constexpr auto a = pack(2.0);
+  static_assert((a * a)[width - 1] == 4.0);
+  static_assert((1.0 + a)[0] == 3.0);
+  static_assert(nani::reduce(a) == 2.0 * width);
+
+  auto values = std::vector<double>(width);
+  for (std::size_t i = 0; i < width; ++i) {
+    values[i] = (i % 2 == 0) ? double(i * i) : -double(i * i);
+  }
+
+  auto const p = pack::load(values.data());
+  auto const root = nani::sqrt(nani::abs(p));
+  auto const positive = nani::max(p, pack(0.0));
+  auto const negative = nani::min(p, pack(0.0));
+  for (std::size_t i = 0; i < width; ++i) {
+    REQUIRE(root[i] == double(i));
+    REQUIRE(positive[i] == ((i % 2 == 0) ? double(i * i) : 0.0));
+    REQUIRE(negative[i] == ((i % 2 == 0) ? 0.0 : -double(i * i)));
+  }
+
+  (-p).store(values.data());
+  REQUIRE(values[1] == 1.0);
+}
+
+TEST_CASE("tiled-field-conversion", "[all]")
+{
+  for (std::size_t size : {std::size_t{0}, std::size_t{1}, std::size_t{37}, std::size_t{4096}}) {
+    auto aos = std::vector<nani::vector<double, 3>>(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      aos[i] = sample(i);
+    }
+
+    auto const tiled = nani::tiled_field<double, 3>(std::span<nani::vector<double, 3> const>(aos));
+    REQUIRE(tiled.size() == size);
+    REQUIRE(tiled.ntile() * tiled.width >= size);
+    for (std::size_t i = 0; i < size; ++i) {
+      REQUIRE(tiled.load(i) == aos[i]);
+    }
+
+    auto soa = nani::soa_field<double, 3>(size);
+    tiled.copy_to(soa.span());
+    auto const round = nani::tiled_field<double, 3>(nani::soa_span<double const, 3>(soa.span()));
+
+    auto back = std::vector<nani::vector<double, 3>>(size);
+    round.copy_to(std::span<nani::vector<double, 3>>(back));
+    REQUIRE(back == aos);
+  }
+}
+
+TEST_CASE("tiled-field-kernel", "[all]")
+{
+  constexpr std::size_t size = 101;
+  auto field = nani::tiled_field<double, 3>(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    field.store(i, sample(i));
+  }
+
+  auto result = std::vector<double>(field.ntile() * field.width);
+  for (std::size_t t = 0; t < field.ntile(); ++t) {
+    auto const tile = field.tiles()[t];
+    kernel(tile).store(result.data() + t * field.width);
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    REQUIRE(nani::abs(result[i] - kernel(sample(i))) < 1e-12);
+  }
+}
@@ -194,3 +194,28 @@ TEST_CASE("normal", "[all]")
   static_assert(nani::abs(c[0] + 4.0) < tol * nani::l2_norm(c));
   static_assert(nani::abs(c[1] - 3.0) < tol * nani::l2_norm(c));
 }
+
+TEST_CASE("3d cross product", "[all]")
+{
+  constexpr auto tol = std::numeric_limits<double>::epsilon();
+  constexpr auto a = nani::vector<double, 3>(1.0, 2.0, 3.0);
+  constexpr auto b = nani::vector<double, 3>(4.0, 5.0, 6.0);
+
+  constexpr auto c = a ^ b;
+  static_assert(nani::abs(c[0] + 3.0) < tol);
+  static_assert(nani::abs(c[1] - 6.0) < tol);
+  static_assert(nani::abs(c[2] + 3.0) < tol);
+  static_assert(nani::abs(c * a) < tol);
+  static_assert(nani::abs(c * b) < tol);
+}
+
+TEST_CASE("triple product", "[all]")
+{
+  constexpr auto tol = std::numeric_limits<double>::epsilon();
+  constexpr auto a = nani::vector<double, 3>(1.0, 2.0, 3.0);
+  constexpr auto b = nani::vector<double, 3>(4.0, 5.0, 6.0);
+  constexpr auto c = nani::vector<double, 3>(2.0, -1.0, 7.0);
+
+  static_assert(nani::abs(nani::triple(a, b, c) - a * (b ^ c)) < tol * 64);
+  static_assert(nani::abs(nani::triple(a, b, c) + nani::triple(b, a, c)) < tol * 64);
+}
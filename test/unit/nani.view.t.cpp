@@ -0,0 +1,138 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <nani/matrix.hpp>
+#include <nani/soa.hpp>
+#include <nani/vector.hpp>
+#include <nani/view.hpp>
+#include <span>
+#include <testmol/compat/catch_main.hpp>
+#include <type_traits>
+#include <vector>
+
+TESTMOL_CATCH_MAIN("test/unit/cpp/nani/view")
+
+namespace {
+constexpr auto strided_dot() -> double
+{
+  // Two interleaved 3-vectors: a = (1, 2, 3), b = (4, 5, 6).
+  auto buffer = std::array<double, 6>{1, 4, 2, 5, 3, 6};
+  auto a = nani::vector_view<double const, 3>(buffer.data(), 2);
+  auto b = nani::vector_view<double const, 3>(buffer.data() + 1, 2);
+  return a * b;
+}
+
+constexpr auto view_cross() -> nani::vector<double, 3>
+{
+  auto x = nani::vector<double, 3>(1.0, 0.0, 0.0);
+  auto buffer = std::array<double, 3>{0, 1, 0};
+  auto y = nani::vector_view<double, 3>(buffer.data());
+  return x ^ y;
+}
+} // namespace
+
+TEST_CASE("vector-view-operators", "[all]")
+{
+  static_assert(nani::vector_like<nani::vector_view<double, 3>>);
+  static_assert(nani::vector_like<nani::vector_view<double const, 3>>);
+  static_assert(not nani::vector_like<double>);
+  static_assert(nani::same_vector_shape<nani::vector<float, 2>, nani::vector_view<float const, 2>>);
+  static_assert(strided_dot() == 32);
+  static_assert(view_cross() == nani::vector<double, 3>(0.0, 0.0, 1.0));
+
+  auto buffer = std::vector<double>{1, 10, 2, 20, 3, 30};
+  auto a = nani::vector_view<double, 3>(buffer.data(), 2);
+  auto b = nani::vector_view<double const, 3>(buffer.data() + 1, 2);
+
+  auto const sum = a + b;
+  static_assert(std::is_same_v<decltype(sum), nani::vector<double, 3> const>);
+  REQUIRE(sum == nani::vector<double, 3>(11.0, 22.0, 33.0));
+  REQUIRE(2.0 * a == nani::vector<double, 3>(2.0, 4.0, 6.0));
+  REQUIRE(b / 10.0 == a);
+
+  a += nani::vector<double, 3>(1.0, 1.0, 1.0);
+  REQUIRE(buffer == std::vector<double>{2, 10, 3, 20, 4, 30});
+
+  a.assign(b);
+  REQUIRE(buffer == std::vector<double>{10, 10, 20, 20, 30, 30});
+
+  nani::vector<double, 3> const copy = a;
+  a -= copy;
+  REQUIRE(buffer == std::vector<double>{0, 10, 0, 20, 0, 30});
+}
+
+TEST_CASE("matrix-view", "[all]")
+{
+  auto m = nani::matrix<double, 2, 3>::zero();
+  for (std::size_t i = 0; i < 2; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      m[i][j] = static_cast<double>(3 * i + j + 1);
+    }
+  }
+
+  auto v = nani::matrix_view<double, 2, 3>(m);
+  REQUIRE(v[1][2] == 6);
+
+  auto const t = v.transposed();
+  REQUIRE(t[2][1] == 6);
+  REQUIRE(t[0][1] == 4);
+
+  auto const x = nani::vector<double, 3>(1.0, 1.0, 1.0);
+  REQUIRE(v * x == m * x);
+  REQUIRE(t * nani::vector<double, 2>(1.0, 1.0) == nani::vector<double, 3>(5.0, 7.0, 9.0));
+
+  auto const product = t * m;
+  static_assert(std::is_same_v<decltype(product), nani::matrix<double, 3, 3> const>);
+  REQUIRE(product[0][0] == 17);
+  REQUIRE(product[2][1] == 36);
+
+  auto const square = nani::matrix_view<double const, 2, 2>(&m[0][0], 3, 1);
+  REQUIRE(nani::determinant(square) == -3);
+  REQUIRE(nani::determinant(square.transposed()) == -3);
+
+  v[0].assign(nani::vector<double, 3>(7.0, 8.0, 9.0));
+  REQUIRE(m[0][0] == 7);
+  REQUIRE(m[0][2] == 9);
+}
+
+TEST_CASE("soa-field-view", "[all]")
+{
+  auto field = nani::soa_field<double, 2>(5);
+  field.store(3, nani::vector<double, 2>(1.0, 2.0));
+
+  auto v = field.view(3);
+  REQUIRE(nani::vector<double, 2>(v) == nani::vector<double, 2>(1.0, 2.0));
+
+  v += nani::vector<double, 2>(1.0, 1.0);
+  REQUIRE(field.load(3) == nani::vector<double, 2>(2.0, 3.0));
+  REQUIRE(field.component(1)[3] == 3);
+}
+
+#if defined(__cpp_lib_mdspan)
+TEST_CASE("mdspan", "[all]")
+{
+  auto field = std::vector<nani::vector<double, 3>>(4, nani::vector<double, 3>::fill(0.0));
+  field[2] = nani::vector<double, 3>(1.0, 2.0, 3.0);
+  auto const m = nani::to_mdspan(std::span(field));
+  REQUIRE(m.extent(0) == 4);
+  REQUIRE(m[2, 1] == 2.0);
+
+  auto const row = std::mdspan<double, std::extents<std::size_t, 3>>(&m[2, 0]);
+  REQUIRE(nani::vector<double, 3>(nani::view(row)) == field[2]);
+
+  // The aligned accessor converts to its offset policy, the default accessor.
+  using accessor = nani::aligned_accessor<double, 64>;
+  static_assert(std::is_same_v<accessor::offset_policy, std::default_accessor<double>>);
+  static_assert(std::is_constructible_v<accessor::offset_policy, accessor>);
+  alignas(64) auto buffer = std::array<double, 6>{1, 2, 3, 4, 5, 6};
+  using extents = std::extents<std::size_t, 2, 3>;
+  auto const aligned = std::mdspan<double, extents, std::layout_right, accessor>(buffer.data());
+  REQUIRE(aligned[1, 2] == 6.0);
+  auto const square = nani::view(aligned);
+  REQUIRE(square[1][0] == 4.0);
+}
+#endif
@@ -0,0 +1,182 @@
+// -------------------------------------------------------------------------------------------------
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: (C) 2022 Jayesh Badwaik <j.badwaik@fz-juelich.de>
+// -------------------------------------------------------------------------------------------------
+
+/** nani-gemm-autotune
+ *
+ * Times every variant of `gemm::multiply` for every shape (R, S, T) with sizes from
+ * NANI_GEMM_TUNE_SIZES, in float and double, and writes a header of specializations of
+ * `gemm::tuned` naming the fastest one:
+ *
+ *   nani-gemm-autotune <directory>
+ *
+ * writes <directory>/nani/gemm.tuned.hpp. Put <directory> on the include path of later builds,
+ * compiled with the same flags as the tool.
+ *
+ * Every variant is instantiated for each of the n^3 shapes of n sizes, in both types, all in this
+ * one translation unit, so its compile time and memory grow with n^3: about two minutes for the
+ * default five sizes, over ten minutes and 1.5 GB for seven. Shapes not in the table keep the
+ * heuristic.
+ **/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <nani/gemm.hpp>
+#include <nani/isa.hpp>
+#include <nani/matrix.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if not defined(NANI_GEMM_TUNE_SIZES)
+#define NANI_GEMM_TUNE_SIZES 1, 2, 3, 4, 8
+#endif
+
+namespace {
+constexpr auto sizes = std::to_array<std::size_t>({NANI_GEMM_TUNE_SIZES});
+constexpr auto nsize = sizes.size();
+
+constexpr auto variants = std::array{
+  nani::gemm::variant::inner,
+  nani::gemm::variant::outer,
+  nani::gemm::variant::unrolled,
+  nani::gemm::variant::packed,
+  nani::gemm::variant::tiled};
+
+/* Products per timed batch, enough to hide the loop overhead and small enough to stay in L1. */
+constexpr std::size_t batch = 64;
+
+/* Best of this many repetitions of a batch is kept, which filters out interrupts. */
+constexpr std::size_t repetitions = 1000;
+
+/* Relative speedup below which two variants count as equally fast. */
+constexpr double margin = 0.03;
+
+/* Keeps the compiler from discarding or hoisting the products. */
+template <typename T>
+void clobber(T& x) noexcept
+{
+  asm volatile("" : : "g"(&x) : "memory");
+}
+
+template <typename F>
+constexpr auto type_name() noexcept -> std::string_view
+{
+  return sizeof(F) == 4 ? "float" : "double";
+}
+
+/* Nanoseconds per product of the fastest repetition. */
+template <nani::gemm::variant V, typename F, std::size_t R, std::size_t S, std::size_t T>
+auto measure(
+  std::vector<nani::matrix<F, R, S>> const& a,
+  std::vector<nani::matrix<F, S, T>> const& b,
+  std::vector<nani::matrix<F, R, T>>& c) -> double
+{
+  using clock = std::chrono::steady_clock;
+  auto best = std::numeric_limits<double>::max();
+  for (std::size_t r = 0; r < repetitions; ++r) {
+    auto const start = clock::now();
+    for (std::size_t n = 0; n < batch; ++n) {
+      nani::gemm::multiply<V>(a[n], b[n], c[n]);
+      clobber(c[n]);
+    }
+    auto const stop = clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  return best / batch;
+}
+
+template <typename F, std::size_t R, std::size_t S, std::size_t T>
+auto fastest() -> nani::gemm::variant
+{
+  auto a = std::vector<nani::matrix<F, R, S>>(batch);
+  auto b = std::vector<nani::matrix<F, S, T>>(batch);
+  auto c = std::vector<nani::matrix<F, R, T>>(batch);
+  for (std::size_t n = 0; n < batch; ++n) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t k = 0; k < S; ++k) {
+        a[n][i][k] = F(1) / F(1 + n + i + k);
+      }
+    }
+    for (std::size_t k = 0; k < S; ++k) {
+      for (std::size_t j = 0; j < T; ++j) {
+        b[n][k][j] = F(1) / F(2 + n + k + j);
+      }
+    }
+  }
+
+  auto time = std::array<double, variants.size()>();
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    ((time[I] = measure<variants[I], F, R, S, T>(a, b, c)), ...);
+  }(std::make_index_sequence<variants.size()>());
+
+  // A later, more elaborate variant has to win by a margin, so that timing noise does not pick
+  // between kernels that compile to the same code (`packed` and `tiled` for R < 4).
+  auto best = std::size_t(0);
+  for (std::size_t v = 1; v < variants.size(); ++v) {
+    if (time[v] < (1 - margin) * time[best]) {
+      best = v;
+    }
+  }
+  return variants[best];
+}
+
+template <typename F, std::size_t I>
+void tune(std::ostream& out)
+{
+  constexpr auto R = sizes[I / (nsize * nsize)];
+  constexpr auto S = sizes[I / nsize % nsize];
+  constexpr auto T = sizes[I % nsize];
+  auto const v = fastest<F, R, S, T>();
+  out << "template <>\nstruct tuned<" << type_name<F>() << ", " << R << ", " << S << ", " << T
+      << "> {\n  static constexpr variant value = variant::" << nani::gemm::to_string(v)
+      << ";\n};\n\n";
+}
+
+template <typename F>
+void tune_all(std::ostream& out)
+{
+  std::cerr << "timing " << type_name<F>() << '\n';
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    (tune<F, I>(out), ...);
+  }(std::make_index_sequence<nsize * nsize * nsize>());
+}
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <directory>\n";
+    return 1;
+  }
+
+  auto const directory = std::filesystem::path(argv[1]) / "nani";
+  std::filesystem::create_directories(directory);
+  auto const path = directory / "gemm.tuned.hpp";
+  auto out = std::ofstream(path);
+  if (not out) {
+    std::cerr << "cannot write " << path << '\n';
+    return 1;
+  }
+
+  out << "// Generated by nani-gemm-autotune for "
+      << nani::to_string(nani::compiled_isa) << " (" << nani::simd_bytes
+      << " byte packs); do not edit.\n\n"
+      << "#ifndef NANI_GEMM_TUNED_HPP\n#define NANI_GEMM_TUNED_HPP\n\n"
+      << "#include <nani/gemm.hpp>\n\nnamespace nani::gemm {\n";
+  tune_all<float>(out);
+  tune_all<double>(out);
+  out << "} // namespace nani::gemm\n\n#endif // NANI_GEMM_TUNED_HPP\n";
+
+  std::cerr << "wrote " << path << '\n';
+  return out ? 0 : 1;
+}